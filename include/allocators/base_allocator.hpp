@@ -114,6 +114,18 @@ public:
      *      По-умолчанию делегирует аллокацию в объект m_parent
      */
     virtual void deallocate(void* ptr, std::size_t sz);
+
+    /**
+     * Возвращает true, если распределитель монотонный: deallocate ничего не освобождает,
+     * а память возвращается только сбросом или уничтожением всего распределителя.
+     * 
+     * Контейнеры на узлах используют это, чтобы не обходить узлы при очистке,
+     * если их элементы не требуют вызова деструктора.
+     * 
+     * @return
+     *      По-умолчанию false.
+     */
+    virtual bool is_monotonic() const;
 };
 
 }
@@ -107,6 +107,14 @@ public:
      * 
      */
     void deallocate(void* ptr) override;
+
+    /**
+     * Линейный распределитель освобождает память только через reset().
+     * 
+     * @return
+     *      true.
+     */
+    bool is_monotonic() const override;
     
     /**
      * Возвращает строковое представление объекта.
@@ -5,6 +5,7 @@
 #include <allocators/Helpers.hpp>
 #include <allocators/pool_allocator.hpp>
 #include <cpp/lang/utils/shared_ptr.hpp>
+#include <cpp/lang/utils/arrays.hpp>
 
 #include <cstring>
 #include <cstddef>
@@ -261,17 +262,8 @@ namespace tca {
 
     template<typename T>
     /*static*/ void compact_linear_allocator::mov(void* dst, void* src, std::size_t count) {
-        if (std::is_trivially_copyable<T>::value) {
-            memcpy(dst, src, sizeof(T) * count);
-        } else {
-            using non_const_type = typename jstd::remove_cv<T>::type;
-            non_const_type* d = const_cast<non_const_type*>(reinterpret_cast<T*>(dst));
-            non_const_type* s = const_cast<non_const_type*>(reinterpret_cast<T*>(src));
-            for (std::size_t i = 0; i < count; ++i) {
-                new(&d[i]) T(std::move(s[i]));
-                s[i].~T();
-            }
-        }
+        using non_const_type = typename jstd::remove_cv<T>::type;
+        jstd::relocate(reinterpret_cast<non_const_type*>(dst), reinterpret_cast<non_const_type*>(src), count);
     }
 
     template<typename T, typename... ARGS>
@@ -408,8 +408,7 @@ public:
 
     template<typename T>
     void array<T>::set(const T& value) {
-        for (std::size_t i = 0, len = length; i < len; ++i)
-            _data[i] = value;
+        objects::fill(_data, length, value);
     }
 
     template<typename T>
@@ -448,5 +447,13 @@ public:
     T* array<T>::end() const {
         return _data + length;
     }
+
+    /**
+     *
+     */
+    template<typename T>
+    struct is_trivially_relocatable<array<T>> {
+        static const bool value = true;
+    };
 }
 #endif//JSTDLIB_CPP_LANG_ARRAY_H_
\ No newline at end of file
@@ -0,0 +1,647 @@
+#ifndef JSTD_CPP_LANG_CONCURRENCY_PARALLEL_H
+#define JSTD_CPP_LANG_CONCURRENCY_PARALLEL_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/concurrency/pools/thread_pool.hpp>
+#include <cpp/lang/concurrency/mutex.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cpp/lang/utils/sort.hpp>
+#include <cpp/lang/utils/temp_buffer.hpp>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+#include <utility>
+#include <new>
+
+namespace jstd
+{
+
+/**
+ * Параллельные алгоритмы над непрерывными диапазонами элементов.
+ *
+ * Диапазон делится на порции (grain), которые разбираются рабочими потоками переданного пула
+ * и вызывающим потоком. Вызов блокируется до обработки всех порций.
+ * Если пул равен nullptr или диапазон помещается в одну порцию, алгоритм выполняется последовательно
+ * в вызывающем потоке.
+ *
+ * Размер порции выбирается автоматически, если параметр grain равен 0.
+ * Исключение, выброшенное пользовательской функцией, останавливает раздачу порций и пробрасывается
+ * в вызывающий поток после завершения уже начатых порций.
+ *
+ * Функции нельзя вызывать из задачи, исполняемой тем же пулом: вызывающий поток ожидает
+ * завершения вспомогательных задач, которые могут не получить свободный поток.
+ */
+namespace parallel
+{
+
+    /**
+     * Минимальный размер порции при автоматическом выборе.
+     */
+    const std::size_t MIN_GRAIN = chunking::MIN_GRAIN;
+
+    /**
+     * Минимальный размер отрезка, сортируемого одним потоком.
+     */
+    const std::size_t MIN_SORT_GRAIN = 4096;
+
+    /**
+     * Количество порций на поток при автоматическом выборе: сглаживает неравномерную нагрузку.
+     */
+    const std::size_t CHUNKS_PER_THREAD = chunking::CHUNKS_PER_THREAD;
+
+namespace internal
+{
+    /**
+     * Общее состояние одного параллельного запуска.
+     */
+    struct run_state {
+        std::atomic<std::size_t>    next;
+        std::size_t                 count;
+        mutex                       error_mutex;
+        std::exception_ptr          error;
+
+        run_state(std::size_t count) : next(0), count(count), error_mutex(), error() {}
+    };
+
+    /**
+     * Разбирает порции, пока они не закончатся.
+     */
+    template<typename BODY>
+    void run_chunks(run_state& state, BODY& body) {
+        std::size_t idx;
+        while ((idx = state.next.fetch_add(1, std::memory_order_relaxed)) < state.count) {
+            try {
+                body(idx);
+            } catch (...) {
+                unique_lock lock(state.error_mutex);
+                if (!state.error)
+                    state.error = std::current_exception();
+                state.next.store(state.count, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Задача пула, разбирающая порции общего запуска.
+     */
+    template<typename BODY>
+    class chunk_task : public concurrency::task {
+        run_state*  m_state;
+        BODY*       m_body;
+    public:
+        chunk_task(run_state* state, BODY* body) : task(), m_state(state), m_body(body) {}
+
+        void execute() override {
+            run_chunks(*m_state, *m_body);
+        }
+    };
+
+    /**
+     * Количество потоков, участвующих в вычислении (рабочие потоки пула и вызывающий поток).
+     */
+    inline std::size_t count_threads(concurrency::thread_pool* pool) {
+        return pool == nullptr ? 1 : pool->get_count_threads() + 1;
+    }
+
+    /**
+     * Возвращает grain, если он задан, иначе размер порции, дающий CHUNKS_PER_THREAD порций на поток.
+     */
+    inline std::size_t select_grain(concurrency::thread_pool* pool, std::size_t len, std::size_t grain) {
+        return chunking::select_grain(count_threads(pool), len, grain);
+    }
+
+    using chunking::count_chunks;
+
+    /**
+     * Вызывает body(idx) для каждого idx из [0, count) в потоках пула и в вызывающем потоке.
+     */
+    template<typename BODY>
+    void run(concurrency::thread_pool* pool, std::size_t count, BODY& body) {
+        if (count == 0)
+            return;
+        run_state state(count);
+        std::size_t helpers = count_threads(pool) - 1;
+        if (helpers > count - 1)
+            helpers = count - 1;
+
+        if (helpers == 0) {
+            run_chunks(state, body);
+        } else {
+            tca::allocator* allocator = tca::get_default_allocator();
+            const std::size_t tasks_size    = sizeof(chunk_task<BODY>) * helpers;
+            const std::size_t pointers_size = sizeof(concurrency::task*) * helpers;
+            chunk_task<BODY>* tasks = reinterpret_cast<chunk_task<BODY>*>(allocator->allocate_align(tasks_size, alignof(chunk_task<BODY>)));
+            if (tasks == nullptr)
+                throw_except<out_of_memory_error>("Out of memory!");
+            concurrency::task** pointers = reinterpret_cast<concurrency::task**>(allocator->allocate(pointers_size));
+            if (pointers == nullptr) {
+                allocator->deallocate(tasks, tasks_size);
+                throw_except<out_of_memory_error>("Out of memory!");
+            }
+
+            for (std::size_t i = 0; i < helpers; ++i)
+                pointers[i] = new (tasks + i) chunk_task<BODY>(&state, &body);
+
+            bool submitted = false;
+            try {
+                pool->submit(pointers, helpers);
+                submitted = true;
+            } catch (...) {
+                for (std::size_t i = 0; i < helpers; ++i)
+                    tasks[i].~chunk_task<BODY>();
+                allocator->deallocate(pointers, pointers_size);
+                allocator->deallocate(tasks, tasks_size);
+                throw;
+            }
+
+            if (submitted) {
+                run_chunks(state, body);
+                //join() может вернуться до завершения задачи, поэтому флаг перепроверяется
+                for (std::size_t i = 0; i < helpers; ++i) {
+                    while (!tasks[i].is_done())
+                        tasks[i].join();
+                }
+            }
+
+            for (std::size_t i = 0; i < helpers; ++i)
+                tasks[i].~chunk_task<BODY>();
+            allocator->deallocate(pointers, pointers_size);
+            allocator->deallocate(tasks, tasks_size);
+        }
+
+        if (state.error)
+            std::rethrow_exception(state.error);
+    }
+
+    template<typename RANGE_BODY>
+    void run_ranges(concurrency::thread_pool* pool, std::size_t len, std::size_t grain, RANGE_BODY& body) {
+        chunking::range_body<RANGE_BODY> chunk(body, len, grain);
+        run(pool, count_chunks(len, grain), chunk);
+    }
+
+    /**
+     * Количество элементов, взятых из a среди первых k элементов слияния a и b.
+     * При равенстве первым идёт элемент a, что сохраняет устойчивость слияния.
+     */
+    template<typename T, typename LESS>
+    std::size_t co_rank(std::size_t k, const T* a, std::size_t a_len, const T* b, std::size_t b_len, LESS& less) {
+        std::size_t lo = k > b_len ? k - b_len : 0;
+        std::size_t hi = k < a_len ? k : a_len;
+        while (lo < hi) {
+            const std::size_t i = lo + (hi - lo) / 2;
+            const std::size_t j = k - i;
+            if (j > 0 && !less(b[j - 1], a[i]))
+                lo = i + 1;
+            else
+                hi = i;
+        }
+        return lo;
+    }
+
+    /**
+     * Сливает отсортированные отрезки ширины width из src в dst. Каждое слияние делится на куски по piece элементов.
+     *
+     * Слияние перемещает элементы из src, поэтому границы всех кусков вычисляются
+     * отдельным проходом (split) до начала слияния (merge).
+     */
+    template<typename T, typename T_COMPARATOR>
+    class merge_body {
+        T*          m_src;
+        T*          m_dst;
+        std::size_t m_len;
+        std::size_t m_width;
+        std::size_t m_piece;
+        std::size_t m_pieces_per_merge;
+        std::size_t* m_splits;
+
+        void bounds(std::size_t idx, std::size_t* merge_begin, std::size_t* a_len, std::size_t* b_len) const {
+            *merge_begin = (idx / m_pieces_per_merge) * 2 * m_width;
+            *a_len = m_len - *merge_begin < m_width ? m_len - *merge_begin : m_width;
+            const std::size_t b_begin = *merge_begin + *a_len;
+            *b_len = m_len - b_begin < m_width ? m_len - b_begin : m_width;
+        }
+
+        std::size_t piece_begin(std::size_t idx, std::size_t merge_len) const {
+            const std::size_t k = (idx % m_pieces_per_merge) * m_piece;
+            return k < merge_len ? k : merge_len;
+        }
+    public:
+        merge_body(T* src, T* dst, std::size_t len, std::size_t width, std::size_t piece) :
+        m_src(src), m_dst(dst), m_len(len), m_width(width), m_piece(piece), m_pieces_per_merge(count_chunks(2 * width, piece)), m_splits(nullptr) {}
+
+        std::size_t count_pieces() const {
+            return count_chunks(m_len, 2 * m_width) * m_pieces_per_merge;
+        }
+
+        void set_splits(std::size_t* splits) {
+            m_splits = splits;
+        }
+
+        /**
+         * Вычисляет, сколько элементов левого отрезка предшествует куску idx.
+         */
+        void split(std::size_t idx) {
+            std::size_t merge_begin, a_len, b_len;
+            bounds(idx, &merge_begin, &a_len, &b_len);
+            T_COMPARATOR compare;
+            jstd::internal::sort_less<T, T_COMPARATOR> less = {compare};
+            const T* a = m_src + merge_begin;
+            m_splits[idx] = co_rank(piece_begin(idx, a_len + b_len), a, a_len, a + a_len, b_len, less);
+        }
+
+        void operator()(std::size_t idx) {
+            std::size_t merge_begin, a_len, b_len;
+            bounds(idx, &merge_begin, &a_len, &b_len);
+            const std::size_t merge_len = a_len + b_len;
+            const std::size_t k0 = piece_begin(idx, merge_len);
+            const bool last = (idx + 1) % m_pieces_per_merge == 0;
+            const std::size_t k1 = last ? merge_len : piece_begin(idx + 1, merge_len);
+            if (k0 == k1)
+                return;
+
+            T_COMPARATOR compare;
+            jstd::internal::sort_less<T, T_COMPARATOR> less = {compare};
+
+            T* a = m_src + merge_begin;
+            T* b = a + a_len;
+            std::size_t i = m_splits[idx];
+            std::size_t j = k0 - i;
+            const std::size_t i_end = last ? a_len : m_splits[idx + 1];
+            const std::size_t j_end = k1 - i_end;
+
+            T* out = m_dst + merge_begin + k0;
+            while (i < i_end && j < j_end) {
+                if (less(b[j], a[i]))
+                    *out++ = std::move(b[j++]);
+                else
+                    *out++ = std::move(a[i++]);
+            }
+            while (i < i_end)
+                *out++ = std::move(a[i++]);
+            while (j < j_end)
+                *out++ = std::move(b[j++]);
+        }
+    };
+
+    template<typename T, typename T_COMPARATOR>
+    class split_body {
+        merge_body<T, T_COMPARATOR>& m_merge;
+    public:
+        split_body(merge_body<T, T_COMPARATOR>& merge) : m_merge(merge) {}
+
+        void operator()(std::size_t idx) {
+            m_merge.split(idx);
+        }
+    };
+
+    template<typename T, typename T_COMPARATOR, bool STABLE>
+    void sort(concurrency::thread_pool* pool, T* array, std::size_t len, tca::allocator* allocator, std::size_t grain) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        if (grain == 0) {
+            const std::size_t threads = count_threads(pool);
+            grain = (len + threads - 1) / threads;
+            if (grain < MIN_SORT_GRAIN)
+                grain = MIN_SORT_GRAIN;
+        }
+
+        if (pool == nullptr || len <= grain) {
+            if (STABLE)
+                utils::stable_sort<T, T_COMPARATOR>(array, len, allocator);
+            else
+                utils::sort<T, T_COMPARATOR>(array, len);
+            return;
+        }
+
+        //1. каждый отрезок сортируется независимо
+        struct sort_runs {
+            T*              array;
+            tca::allocator* allocator;
+            void operator()(std::size_t begin, std::size_t end, std::size_t) {
+                if (STABLE)
+                    utils::stable_sort<T, T_COMPARATOR>(array + begin, end - begin, allocator);
+                else
+                    utils::sort<T, T_COMPARATOR>(array + begin, end - begin);
+            }
+        } runs = {array, allocator};
+        run_ranges(pool, len, grain, runs);
+
+        //2. буфер слияния: элементы перемещаются, после чего оба массива содержат живые объекты
+        temp_buffer<T> buffer(allocator, len);
+        struct move_construct {
+            T* src;
+            T* dst;
+            void operator()(std::size_t begin, std::size_t end, std::size_t) {
+                for (std::size_t i = begin; i < end; ++i)
+                    new (dst + i) T(std::move(src[i]));
+            }
+        } to_buffer = {array, buffer.data()};
+        const std::size_t move_grain = select_grain(pool, len, 0);
+        run_ranges(pool, len, move_grain, to_buffer);
+        buffer.set_constructed(len);
+
+        //3. попарное слияние отрезков, ширина удваивается на каждом уровне
+        T* src = buffer.data();
+        T* dst = array;
+        for (std::size_t width = grain; width < len; width *= 2) {
+            merge_body<T, T_COMPARATOR> merge(src, dst, len, width, move_grain);
+            const std::size_t pieces = merge.count_pieces();
+            temp_buffer<std::size_t> splits(allocator, pieces);
+            merge.set_splits(splits.data());
+            split_body<T, T_COMPARATOR> split(merge);
+            run(pool, pieces, split);
+            run(pool, pieces, merge);
+            T* tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+
+        if (src != array) {
+            struct move_assign {
+                T* src;
+                T* dst;
+                void operator()(std::size_t begin, std::size_t end, std::size_t) {
+                    for (std::size_t i = begin; i < end; ++i)
+                        dst[i] = std::move(src[i]);
+                }
+            } back = {src, array};
+            run_ranges(pool, len, move_grain, back);
+        }
+    }
+}
+
+    /**
+     * Исполнитель пакетных операций контейнеров (например, hash_map::from_range),
+     * разбирающий порции в потоках пула и в вызывающем потоке.
+     *
+     * @see chunking
+     */
+    class pool_runner {
+        concurrency::thread_pool* m_pool;
+    public:
+        /**
+         * @param pool
+         *      Пул потоков. Если nullptr - выполняется последовательно.
+         */
+        explicit pool_runner(concurrency::thread_pool* pool) : m_pool(pool) {
+
+        }
+
+        std::size_t count_threads() const {
+            return internal::count_threads(m_pool);
+        }
+
+        template<typename BODY>
+        void run(std::size_t count, BODY& body) const {
+            internal::run(m_pool, count, body);
+        }
+    };
+
+    /**
+     * Применяет func к каждому элементу массива.
+     *
+     * @param pool
+     *      Пул потоков. Если nullptr - выполняется последовательно.
+     *
+     * @param array
+     *      Массив элементов.
+     *
+     * @param len
+     *      Количество элементов.
+     *
+     * @param func
+     *      Функция {@code void(T&)}. Вызывается одновременно из нескольких потоков.
+     *
+     * @param grain
+     *      Размер порции. 0 - выбрать автоматически.
+     *
+     * @throws null_pointer_exception
+     *      Если array == nullptr и len != 0.
+     */
+    template<typename T, typename FUNC>
+    void for_each(concurrency::thread_pool* pool, T* array, std::size_t len, FUNC func, std::size_t grain = 0) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        grain = internal::select_grain(pool, len, grain);
+        if (pool == nullptr || len <= grain) {
+            for (std::size_t i = 0; i < len; ++i)
+                func(array[i]);
+            return;
+        }
+        struct body {
+            T*      array;
+            FUNC&   func;
+            void operator()(std::size_t begin, std::size_t end, std::size_t) {
+                for (std::size_t i = begin; i < end; ++i)
+                    func(array[i]);
+            }
+        } chunk = {array, func};
+        internal::run_ranges(pool, len, grain, chunk);
+    }
+
+    /**
+     * Записывает dst[i] = func(src[i]) для каждого элемента.
+     * Массивы src и dst могут совпадать.
+     *
+     * @param func
+     *      Функция {@code R(const T&)}. Вызывается одновременно из нескольких потоков.
+     *
+     * @see for_each
+     */
+    template<typename T, typename R, typename FUNC>
+    void transform(concurrency::thread_pool* pool, const T* src, std::size_t len, R* dst, FUNC func, std::size_t grain = 0) {
+        JSTD_DEBUG_CODE(
+            if ((src == nullptr || dst == nullptr) && len != 0)
+                throw_except<null_pointer_exception>("src and dst must be != null");
+        )
+        grain = internal::select_grain(pool, len, grain);
+        if (pool == nullptr || len <= grain) {
+            for (std::size_t i = 0; i < len; ++i)
+                dst[i] = func(src[i]);
+            return;
+        }
+        struct body {
+            const T*    src;
+            R*          dst;
+            FUNC&       func;
+            void operator()(std::size_t begin, std::size_t end, std::size_t) {
+                for (std::size_t i = begin; i < end; ++i)
+                    dst[i] = func(src[i]);
+            }
+        } chunk = {src, dst, func};
+        internal::run_ranges(pool, len, grain, chunk);
+    }
+
+    /**
+     * Сворачивает массив ассоциативной операцией op.
+     *
+     * Каждая порция сворачивается отдельно начиная с identity, затем частичные результаты
+     * сворачиваются в порядке порций. Для ассоциативной op результат совпадает с последовательным.
+     *
+     * @param identity
+     *      Нейтральный элемент: op(identity, x) == x.
+     *
+     * @param op
+     *      Функция {@code T(const T&, const T&)}.
+     *
+     * @return
+     *      op(...op(op(identity, array[0]), array[1])..., array[len - 1])
+     *
+     * @see for_each
+     */
+    template<typename T, typename OP>
+    T reduce(concurrency::thread_pool* pool, const T* array, std::size_t len, T identity, OP op, std::size_t grain = 0) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        grain = internal::select_grain(pool, len, grain);
+        if (pool == nullptr || len <= grain) {
+            T acc = identity;
+            for (std::size_t i = 0; i < len; ++i)
+                acc = op(acc, array[i]);
+            return acc;
+        }
+
+        temp_buffer<T> partials(tca::get_default_allocator(), internal::count_chunks(len, grain));
+        partials.fill(identity);
+        struct body {
+            const T*    array;
+            T*          partials;
+            OP&         op;
+            void operator()(std::size_t begin, std::size_t end, std::size_t idx) {
+                T acc = partials[idx];
+                for (std::size_t i = begin; i < end; ++i)
+                    acc = op(acc, array[i]);
+                partials[idx] = std::move(acc);
+            }
+        } chunk = {array, partials.data(), op};
+        internal::run_ranges(pool, len, grain, chunk);
+
+        const std::size_t count = internal::count_chunks(len, grain);
+        T acc = identity;
+        for (std::size_t i = 0; i < count; ++i)
+            acc = op(acc, partials.data()[i]);
+        return acc;
+    }
+
+    /**
+     * Включающая префиксная свёртка: dst[i] = op(...op(op(identity, src[0]), src[1])..., src[i]).
+     *
+     * Выполняется в два прохода: свёртка каждой порции, последовательная префиксная свёртка
+     * частичных результатов и повторный проход порций со своим начальным значением.
+     * Массивы src и dst могут совпадать.
+     *
+     * @param identity
+     *      Нейтральный элемент: op(identity, x) == x.
+     *
+     * @param op
+     *      Ассоциативная функция {@code T(const T&, const T&)}.
+     *
+     * @see reduce
+     */
+    template<typename T, typename OP>
+    void scan(concurrency::thread_pool* pool, const T* src, std::size_t len, T* dst, T identity, OP op, std::size_t grain = 0) {
+        JSTD_DEBUG_CODE(
+            if ((src == nullptr || dst == nullptr) && len != 0)
+                throw_except<null_pointer_exception>("src and dst must be != null");
+        )
+        grain = internal::select_grain(pool, len, grain);
+        if (pool == nullptr || len <= grain) {
+            T acc = identity;
+            for (std::size_t i = 0; i < len; ++i) {
+                acc = op(acc, src[i]);
+                dst[i] = acc;
+            }
+            return;
+        }
+
+        const std::size_t count = internal::count_chunks(len, grain);
+        temp_buffer<T> sums(tca::get_default_allocator(), count);
+        sums.fill(identity);
+
+        struct sum_body {
+            const T*    src;
+            T*          sums;
+            OP&         op;
+            std::size_t last;
+            void operator()(std::size_t begin, std::size_t end, std::size_t idx) {
+                //сумма последней порции не нужна
+                if (idx == last)
+                    return;
+                T acc = sums[idx];
+                for (std::size_t i = begin; i < end; ++i)
+                    acc = op(acc, src[i]);
+                sums[idx] = std::move(acc);
+            }
+        } pass1 = {src, sums.data(), op, count - 1};
+        internal::run_ranges(pool, len, grain, pass1);
+
+        T carry = identity;
+        for (std::size_t i = 0; i < count; ++i) {
+            T sum = std::move(sums.data()[i]);
+            sums.data()[i] = carry;
+            carry = op(carry, sum);
+        }
+
+        struct scan_body {
+            const T*    src;
+            T*          dst;
+            T*          offsets;
+            OP&         op;
+            void operator()(std::size_t begin, std::size_t end, std::size_t idx) {
+                T acc = offsets[idx];
+                for (std::size_t i = begin; i < end; ++i) {
+                    acc = op(acc, src[i]);
+                    dst[i] = acc;
+                }
+            }
+        } pass2 = {src, dst, sums.data(), op};
+        internal::run_ranges(pool, len, grain, pass2);
+    }
+
+    /**
+     * Неустойчивая параллельная сортировка.
+     *
+     * Массив делится на отрезки (по умолчанию - по одному на поток), которые сортируются
+     * параллельно utils::sort, после чего попарно сливаются через буфер на len элементов.
+     * Каждое слияние делится на независимые куски бинарным поиском границ, поэтому
+     * последние уровни слияния также выполняются всеми потоками.
+     *
+     * @param allocator
+     *      Аллокатор буфера слияния.
+     *
+     * @param grain
+     *      Размер отрезка, сортируемого одним потоком. 0 - выбрать автоматически.
+     *
+     * @throws out_of_memory_error
+     *      Если не удалось выделить буфер.
+     *
+     * @see utils::sort
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    void sort(concurrency::thread_pool* pool, T* array, std::size_t len, tca::allocator* allocator = tca::get_default_allocator(), std::size_t grain = 0) {
+        internal::sort<T, T_COMPARATOR, false>(pool, array, len, allocator, grain);
+    }
+
+    /**
+     * Устойчивая параллельная сортировка: отрезки сортируются utils::stable_sort, слияние сохраняет порядок равных элементов.
+     *
+     * @see sort
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    void stable_sort(concurrency::thread_pool* pool, T* array, std::size_t len, tca::allocator* allocator = tca::get_default_allocator(), std::size_t grain = 0) {
+        internal::sort<T, T_COMPARATOR, true>(pool, array, len, allocator, grain);
+    }
+
+}//namespace parallel
+
+}//namespace jstd
+
+#endif//JSTD_CPP_LANG_CONCURRENCY_PARALLEL_H
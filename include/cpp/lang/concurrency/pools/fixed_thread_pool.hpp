@@ -3,7 +3,7 @@
 
 #include <cpp/lang/concurrency/pools/thread_pool.hpp>
 #include <cpp/lang/concurrency/thread.hpp>
-#include <cpp/lang/utils/linked_list.hpp>
+#include <cpp/lang/utils/array_deque.hpp>
 #include <cpp/lang/array.hpp>
 
 namespace jstd
@@ -41,7 +41,7 @@ class fixed_thread_pool : public thread_pool {
     };
 
     array<worker>           m_threads;
-    linked_list<task*>      m_queue;
+    array_deque<task*>      m_queue;
     mutex                   m_queue_locker;
     mutex                   m_tp_mutex;
     bool                    m_terminated;
@@ -80,6 +80,11 @@ public:
     // 
     // 
     void force_shutdown() override;
+
+    // 
+    // 
+    // 
+    std::size_t get_count_threads() const override;
 };
 
 }
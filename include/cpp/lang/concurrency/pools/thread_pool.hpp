@@ -246,6 +246,19 @@ public:
      */
     virtual task* get_task() = 0;
 
+    /**
+     * Возвращает количество рабочих потоков пула.
+     *
+     * Используется для выбора степени параллелизма (например, в jstd::parallel).
+     * Базовая реализация возвращает 1: количество потоков неизвестно.
+     *
+     * @return 
+     *      Количество потоков, одновременно исполняющих задачи.
+     */
+    virtual std::size_t get_count_threads() const {
+        return 1;
+    }
+
     /**
      * Виртуальный деструктор.
      *
@@ -6,6 +6,10 @@
 #include <cpp/lang/math/math.hpp>
 #include <cpp/lang/utils/traits.hpp>
 #include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <limits>
+#include <type_traits>
 
 namespace jstd 
 {
@@ -249,6 +253,59 @@ public:
         return ch == (CHAR_T) '-';
     }
 
+    /**
+     * Максимальная длина записи format_int()/format_uint() (20 цифр или знак и 19 цифр).
+     */
+    static const std::size_t MAX_INT_CHARS   = 20;
+
+    /**
+     * Максимальная длина записи format_double()/format_float(), например "-0.000001234567890123456".
+     */
+    static const std::size_t MAX_FLOAT_CHARS = 25;
+
+    /**
+     * Состояние разбора from_chars().
+     */
+    enum struct parse_status {
+        /**
+         * Число разобрано.
+         */
+        OK,
+
+        /**
+         * В начале нет числа. ptr указывает на начало.
+         */
+        INVALID,
+
+        /**
+         * Число не умещается в тип. ptr указывает за последнюю цифру.
+         */
+        OUT_OF_RANGE
+    };
+
+    /**
+     * Результат from_chars().
+     */
+    template<typename CHAR_T>
+    struct parse_result {
+        /**
+         * Первый неразобранный символ.
+         */
+        const CHAR_T* ptr;
+
+        /**
+         *
+         */
+        parse_status status;
+
+        /**
+         *
+         */
+        bool ok() const {
+            return status == parse_status::OK;
+        }
+    };
+
 namespace internal
 {
     /**
@@ -260,95 +317,432 @@ namespace internal
         while (*s++) ++len;
         return len;
     }
-}
-    template<typename INT_T, typename STR_T>
-    INT_T parse_int(const STR_T* s, std::size_t len = ~(std::size_t) 0) {
-        if (len == ~(std::size_t) 0)
-        {
-            len = internal::str_len(s);
-        }
-        
-        INT_T result     = 0;
-        INT_T digit      = 1;
-        bool is_negative = false;
 
-        for (std::size_t i = len; i > 0;)
-        {
-            --i;
-            if (!is_digit10(s[i]))
-            {
-                if (i == 0 && is_sign(s[i]))
-                {
-                    is_negative = true;
-                    continue;
-                }
-                throw_except<number_format_exception>("Invalid integer string");
-            }
-            result += (INT_T) ((s[i] - 48) * digit);
-            digit *= 10;
-        }
+    /**
+     * Пары десятичных цифр "00".."99": запись числа идёт по две цифры за деление.
+     */
+    extern const char DIGIT_PAIRS[200];
 
-        return is_negative ? -result : result;
+    /**
+     * 10^i для i = 0..19.
+     */
+    extern const std::uint64_t POW10_U64[20];
+
+    /**
+     * Количество десятичных цифр v (для 0 - одна).
+     * Оценка по номеру старшего бита (log10(2) ~ 1233 / 4096) уточняется одним сравнением.
+     */
+    inline std::size_t count_digits(std::uint64_t v) {
+        const std::size_t t = ((simd::internal::bsr64(v | 1) + 1) * 1233) >> 12;
+        return t + ((v | 1) >= POW10_U64[t] ? 1 : 0);
     }
 
-    template<typename FLOAT_T, typename STR_T>
-    FLOAT_T parse_float(const STR_T* s, std::size_t len = ~(std::size_t) 0) {
-        if (len == ~(std::size_t) 0)
-        {
-            len = internal::str_len(s);
+    /**
+     * Значение цифры в системах счисления до 36 или 36, если ch не цифра.
+     */
+    template<typename CHAR_T>
+    unsigned digit_value(CHAR_T ch) {
+        if (ch >= (CHAR_T) '0' && ch <= (CHAR_T) '9') return (unsigned) (ch - (CHAR_T) '0');
+        if (ch >= (CHAR_T) 'a' && ch <= (CHAR_T) 'z') return (unsigned) (ch - (CHAR_T) 'a') + 10;
+        if (ch >= (CHAR_T) 'A' && ch <= (CHAR_T) 'Z') return (unsigned) (ch - (CHAR_T) 'A') + 10;
+        return 36;
+    }
+
+    /**
+     * Сдвигает p за слово word (строчные ASCII-буквы) без учёта регистра, если оно там есть.
+     */
+    template<typename CHAR_T>
+    bool match_word(const CHAR_T*& p, const CHAR_T* last, const char* word) {
+        const CHAR_T* s = p;
+        for (; *word != 0; ++word, ++s) {
+            if (s == last || (*s != (CHAR_T) *word && *s != (CHAR_T) (*word - 'a' + 'A')))
+                return false;
         }
+        p = s;
+        return true;
+    }
+
+    /**
+     * Сколько значащих цифр учитывает медленный путь разбора. Остальные заменяются одной цифрой 1,
+     * если среди них есть ненулевые: 768 цифр хватает, чтобы середина между соседними double
+     * записывалась точно, поэтому такая замена не меняет округления.
+     */
+    static const std::size_t SLOW_PATH_DIGITS = 768;
 
-        static const STR_T DOT       = 46;
-        static const STR_T START_NUM = 48;
+    /**
+     * Ближайшее к w * 10^q значение. Если truncated, за w отброшены ненулевые цифры.
+     *
+     * @return
+     *      false, если быстрого приближения недостаточно и нужен медленный путь.
+     */
+    bool decimal_to_binary(std::uint64_t w, long long q, bool truncated, double& value);
 
-        bool is_negative      = false;
-        FLOAT_T result        = 0;
-        std::size_t dot_index = len;
+    /**
+     * @see decimal_to_binary(std::uint64_t, long long, bool, double&)
+     */
+    bool decimal_to_binary(std::uint64_t w, long long q, bool truncated, float& value);
 
-        for (std::size_t i = 0; i < len; ++i)
-        {
-            if (s[i] == DOT)
-            {
-                dot_index = i;
-                break;
+    /**
+     * Медленный путь: ближайшее к digits * 10^q значение, где digits - count ASCII-цифр.
+     */
+    void decimal_to_binary(const char* digits, std::size_t count, long long q, double& value);
+
+    /**
+     * @see decimal_to_binary(const char*, std::size_t, long long, double&)
+     */
+    void decimal_to_binary(const char* digits, std::size_t count, long long q, float& value);
+
+    /**
+     * Собирает значащие цифры целой и дробной частей для медленного пути.
+     */
+    template<typename FLOAT_T, typename CHAR_T>
+    void parse_float_slow(const CHAR_T* int_first, const CHAR_T* int_last, const CHAR_T* frac_first, const CHAR_T* frac_last, long long exp_number, FLOAT_T& value) {
+        char digits[SLOW_PATH_DIGITS + 1];
+        std::size_t count   = 0;
+        long long q         = exp_number;
+        bool sticky         = false;
+        for (const CHAR_T* p = int_first; p != int_last; ++p) {
+            if (count == 0 && *p == (CHAR_T) '0')
+                continue;
+            if (count < SLOW_PATH_DIGITS) {
+                digits[count++] = (char) *p;
+            } else {
+                ++q;
+                sticky |= *p != (CHAR_T) '0';
+            }
+        }
+        for (const CHAR_T* p = frac_first; p != frac_last; ++p) {
+            if (count < SLOW_PATH_DIGITS) {
+                if (count != 0 || *p != (CHAR_T) '0')
+                    digits[count++] = (char) *p;
+                --q;
+            } else {
+                sticky |= *p != (CHAR_T) '0';
             }
         }
+        if (sticky) {
+            digits[count++] = '1';
+            --q;
+        }
+        if (count == 0) {
+            value = 0;
+            return;
+        }
+        decimal_to_binary(digits, count, q, value);
+    }
 
-        {//parse ceil part
-            FLOAT_T digit = 1;
-            for (std::size_t i = dot_index; i > 0; )
-            {
-                --i;
-                if (!is_digit10(s[i]))
-                {
-                    if (i == 0 && is_sign(s[i]))
-                    {
-                        is_negative = true;
-                        continue;
-                    }
-                    throw_except<number_format_exception>("Invalid floating string");
+    /**
+     * @see from_chars(const CHAR_T*, const CHAR_T*, double&)
+     */
+    template<typename FLOAT_T, typename CHAR_T>
+    parse_result<CHAR_T> parse_floating(const CHAR_T* first, const CHAR_T* last, FLOAT_T& value) {
+        const CHAR_T* p     = first;
+        const bool negative = p != last && is_sign(*p);
+        if (negative)
+            ++p;
+
+        if (p != last && !is_digit10(*p) && *p != (CHAR_T) '.') {
+            if (match_word(p, last, "inf")) {
+                match_word(p, last, "inity");
+                value = negative ? -std::numeric_limits<FLOAT_T>::infinity() : std::numeric_limits<FLOAT_T>::infinity();
+                return parse_result<CHAR_T>{p, parse_status::OK};
+            }
+            if (match_word(p, last, "nan")) {
+                value = negative ? -std::numeric_limits<FLOAT_T>::quiet_NaN() : std::numeric_limits<FLOAT_T>::quiet_NaN();
+                return parse_result<CHAR_T>{p, parse_status::OK};
+            }
+            return parse_result<CHAR_T>{first, parse_status::INVALID};
+        }
+
+        // Первые 19 цифр точно умещаются в w; при большем числе цифр w переполняется и пересчитывается ниже.
+        std::uint64_t w = 0;
+        const CHAR_T* int_first = p;
+        while (p != last && is_digit10(*p))
+            w = w * 10 + (unsigned) (*p++ - (CHAR_T) '0');
+        const CHAR_T* int_last   = p;
+        const CHAR_T* frac_first = p;
+        const CHAR_T* frac_last  = p;
+        if (p != last && *p == (CHAR_T) '.') {
+            frac_first = ++p;
+            while (p != last && is_digit10(*p))
+                w = w * 10 + (unsigned) (*p++ - (CHAR_T) '0');
+            frac_last = p;
+        }
+        const std::size_t digit_count = (std::size_t) (int_last - int_first) + (std::size_t) (frac_last - frac_first);
+        if (digit_count == 0)
+            return parse_result<CHAR_T>{first, parse_status::INVALID};
+
+        // Порядок без цифр ("1e", "1e+") не считается частью числа, как в strtod().
+        long long exp_number = 0;
+        if (p != last && (*p == (CHAR_T) 'e' || *p == (CHAR_T) 'E')) {
+            const CHAR_T* e = p + 1;
+            bool exp_negative = false;
+            if (e != last && (*e == (CHAR_T) '-' || *e == (CHAR_T) '+'))
+                exp_negative = *e++ == (CHAR_T) '-';
+            if (e != last && is_digit10(*e)) {
+                for (; e != last && is_digit10(*e); ++e) {
+                    if (exp_number < 0x10000000)
+                        exp_number = exp_number * 10 + (*e - (CHAR_T) '0');
                 }
-                result += (s[i] - START_NUM) * digit;
-                digit  *= 10;
+                if (exp_negative)
+                    exp_number = -exp_number;
+                p = e;
             }
         }
 
-        {//parse fract part
-            if (dot_index < len)
-            {
-                FLOAT_T digit = (FLOAT_T) 0.1;
-                for (std::size_t i = dot_index + 1; i < len; ++i)
-                {
-                    if (!is_digit10(s[i]))
-                        throw_except<number_format_exception>("Invalid floating string");
-                        
-                    result += (s[i] - START_NUM) * digit;
-                    digit  *= (FLOAT_T) 0.1;
+        long long q    = exp_number - (long long) (frac_last - frac_first);
+        bool truncated = false;
+        if (digit_count > 19) {
+            std::size_t leading_zeros = 0;
+            const CHAR_T* s = int_first;
+            for (; s != int_last && *s == (CHAR_T) '0'; ++s)
+                ++leading_zeros;
+            if (s == int_last) {
+                for (s = frac_first; s != frac_last && *s == (CHAR_T) '0'; ++s)
+                    ++leading_zeros;
+            }
+            if (digit_count - leading_zeros > 19) {
+                // Оставляем первые 19 значащих цифр, значение лежит между w и w + 1.
+                const std::uint64_t MIN_19_DIGITS = 1000000000000000000ull;
+                truncated = true;
+                w = 0;
+                for (s = int_first; w < MIN_19_DIGITS && s != int_last; ++s)
+                    w = w * 10 + (unsigned) (*s - (CHAR_T) '0');
+                if (w >= MIN_19_DIGITS) {
+                    q = exp_number + (long long) (int_last - s);
+                } else {
+                    for (s = frac_first; w < MIN_19_DIGITS && s != frac_last; ++s)
+                        w = w * 10 + (unsigned) (*s - (CHAR_T) '0');
+                    q = exp_number - (long long) (s - frac_first);
                 }
             }
         }
 
-        return is_negative ? -result : result;
+        if (!decimal_to_binary(w, q, truncated, value))
+            parse_float_slow(int_first, int_last, frac_first, frac_last, exp_number, value);
+        if (negative)
+            value = -value;
+
+        const bool overflow  = value == std::numeric_limits<FLOAT_T>::infinity() || value == -std::numeric_limits<FLOAT_T>::infinity();
+        const bool underflow = value == 0 && w != 0;
+        return parse_result<CHAR_T>{p, overflow || underflow ? parse_status::OUT_OF_RANGE : parse_status::OK};
+    }
+}
+
+    /**
+     * Записывает десятичную запись v в buf без завершающего нуля.
+     * Цифры пишутся с конца парами из таблицы, так что на каждые две цифры приходится одно деление на 100.
+     *
+     * @param buf
+     *      Буфер не меньше MAX_INT_CHARS символов.
+     *
+     * @return
+     *      Количество записанных символов.
+     */
+    template<typename CHAR_T>
+    std::size_t format_uint(CHAR_T* buf, unsigned long long v) {
+        const std::size_t n = internal::count_digits(v);
+        CHAR_T* p = buf + n;
+        while (v >= 100) {
+            const unsigned r = (unsigned) (v % 100) * 2;
+            v /= 100;
+            *--p = (CHAR_T) internal::DIGIT_PAIRS[r + 1];
+            *--p = (CHAR_T) internal::DIGIT_PAIRS[r];
+        }
+        if (v >= 10) {
+            const unsigned r = (unsigned) v * 2;
+            *--p = (CHAR_T) internal::DIGIT_PAIRS[r + 1];
+            *--p = (CHAR_T) internal::DIGIT_PAIRS[r];
+        } else {
+            *--p = (CHAR_T) ('0' + v);
+        }
+        return n;
+    }
+
+    /**
+     * @see format_uint(CHAR_T*, unsigned long long)
+     */
+    template<typename CHAR_T>
+    std::size_t format_int(CHAR_T* buf, long long v) {
+        if (v < 0) {
+            *buf = (CHAR_T) '-';
+            // Отрицание в беззнаковом типе корректно и для минимального значения.
+            return 1 + format_uint(buf + 1, 0ull - (unsigned long long) v);
+        }
+        return format_uint(buf, (unsigned long long) v);
+    }
+
+    /**
+     * Записывает кратчайшую запись v, которая читается обратно (from_chars(), strtod()) в то же значение,
+     * без завершающего нуля. Цифры вычисляются алгоритмом Ryu без обращения к printf.
+     *
+     * Формат как у Number.prototype.toString() в ECMAScript: "0.1", "100", "1.5e-7", "1e+21";
+     * "nan", "inf", "-inf" для особых значений.
+     *
+     * @param buf
+     *      Буфер не меньше MAX_FLOAT_CHARS символов.
+     *
+     * @return
+     *      Количество записанных символов.
+     */
+    std::size_t format_double(char* buf, double v);
+
+    /**
+     * @see format_double(char*, double)
+     *
+     * Кратчайшая запись для float, например 0.1f записывается как "0.1".
+     */
+    std::size_t format_float(char* buf, float v);
+
+    /**
+     * @see format_double(char*, double)
+     */
+    template<typename CHAR_T>
+    std::size_t format_double(CHAR_T* buf, double v) {
+        char tmp[MAX_FLOAT_CHARS];
+        const std::size_t n = format_double(tmp, v);
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = (CHAR_T) tmp[i];
+        return n;
+    }
+
+    /**
+     * @see format_float(char*, float)
+     */
+    template<typename CHAR_T>
+    std::size_t format_float(CHAR_T* buf, float v) {
+        char tmp[MAX_FLOAT_CHARS];
+        const std::size_t n = format_float(tmp, v);
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = (CHAR_T) tmp[i];
+        return n;
+    }
+
+    /**
+     * Разбирает целое число в начале [first, last) без исключений и без выделения памяти.
+     *
+     * Допускается только знак '-' (для знаковых типов), пробелы и префиксы "0x" не пропускаются.
+     * При OUT_OF_RANGE value не изменяется, а ptr указывает за последнюю цифру.
+     *
+     * @param radix
+     *      Основание от 2 до 36, цифры больше 9 - латинские буквы любого регистра.
+     *
+     * @throws illegal_argument_exception
+     *      Если radix вне диапазона (только в отладочной сборке).
+     */
+    template<typename INT_T, typename CHAR_T>
+    parse_result<CHAR_T> from_chars(const CHAR_T* first, const CHAR_T* last, INT_T& value, unsigned radix = 10) {
+        static_assert(std::is_integral<INT_T>::value, "INT_T must be integral");
+        JSTD_DEBUG_CODE(
+            if (radix < 2 || radix > 36)
+                throw_except<illegal_argument_exception>("radix must be in [2, 36], got %u", radix);
+        );
+        typedef typename std::make_unsigned<INT_T>::type UINT_T;
+
+        const CHAR_T* p     = first;
+        const bool negative = std::is_signed<INT_T>::value && p != last && is_sign(*p);
+        if (negative)
+            ++p;
+
+        // Модуль минимального значения на единицу больше максимального.
+        const UINT_T limit  = (UINT_T) ((UINT_T) std::numeric_limits<INT_T>::max() + (negative ? 1 : 0));
+        const UINT_T cutoff = (UINT_T) (limit / radix);
+        const unsigned cutlim = (unsigned) (limit % radix);
+
+        const CHAR_T* digits = p;
+        UINT_T acc    = 0;
+        bool overflow = false;
+        for (; p != last; ++p) {
+            const unsigned d = internal::digit_value(*p);
+            if (d >= radix)
+                break;
+            if (acc > cutoff || (acc == cutoff && d > cutlim))
+                overflow = true;
+            else
+                acc = (UINT_T) (acc * radix + d);
+        }
+        if (p == digits)
+            return parse_result<CHAR_T>{first, parse_status::INVALID};
+        if (overflow)
+            return parse_result<CHAR_T>{p, parse_status::OUT_OF_RANGE};
+        value = negative ? (INT_T) (0 - acc) : (INT_T) acc;
+        return parse_result<CHAR_T>{p, parse_status::OK};
+    }
+
+    /**
+     * Разбирает число с плавающей точкой в начале [first, last) без исключений:
+     * [-]цифры[.цифры][(e|E)[+|-]цифры], а также "inf", "infinity" и "nan" без учёта регистра.
+     * Точка или цифры до/после неё могут отсутствовать, но хотя бы одна цифра нужна.
+     *
+     * Результат всегда округлён к ближайшему. До 19 значащих цифр значение получается
+     * точным умножением (порядок до 22) или алгоритмом Eisel-Lemire; редкие неоднозначные случаи
+     * и более длинные записи, где отброшенные цифры влияют на округление, досчитываются через strtod().
+     *
+     * При OUT_OF_RANGE в value записывается бесконечность (переполнение) или ноль (потеря значимости) со знаком.
+     */
+    template<typename CHAR_T>
+    parse_result<CHAR_T> from_chars(const CHAR_T* first, const CHAR_T* last, double& value) {
+        return internal::parse_floating(first, last, value);
+    }
+
+    /**
+     * @see from_chars(const CHAR_T*, const CHAR_T*, double&)
+     */
+    template<typename CHAR_T>
+    parse_result<CHAR_T> from_chars(const CHAR_T* first, const CHAR_T* last, float& value) {
+        return internal::parse_floating(first, last, value);
+    }
+
+    /**
+     * Разбирает целое число, занимающее всю строку.
+     *
+     * @param len
+     *      Длина строки или ~0, если строка оканчивается нулём.
+     *
+     * @throws number_format_exception
+     *      Если строка не является числом или число не умещается в INT_T.
+     *
+     * @see from_chars(const CHAR_T*, const CHAR_T*, INT_T&, unsigned)
+     */
+    template<typename INT_T, typename STR_T>
+    INT_T parse_int(const STR_T* s, std::size_t len = ~(std::size_t) 0) {
+        if (len == ~(std::size_t) 0)
+        {
+            len = internal::str_len(s);
+        }
+        INT_T value = 0;
+        const parse_result<STR_T> r = from_chars(s, s + len, value);
+        if (r.status == parse_status::OUT_OF_RANGE)
+            throw_except<number_format_exception>("Integer out of range");
+        if (r.status != parse_status::OK || r.ptr != s + len)
+            throw_except<number_format_exception>("Invalid integer string");
+        return value;
+    }
+
+    /**
+     * Разбирает число с плавающей точкой, занимающее всю строку.
+     *
+     * @param len
+     *      Длина строки или ~0, если строка оканчивается нулём.
+     *
+     * @throws number_format_exception
+     *      Если строка не является числом или число вне диапазона FLOAT_T.
+     *
+     * @see from_chars(const CHAR_T*, const CHAR_T*, double&)
+     */
+    template<typename FLOAT_T, typename STR_T>
+    FLOAT_T parse_float(const STR_T* s, std::size_t len = ~(std::size_t) 0) {
+        if (len == ~(std::size_t) 0)
+        {
+            len = internal::str_len(s);
+        }
+        FLOAT_T value = 0;
+        const parse_result<STR_T> r = from_chars(s, s + len, value);
+        if (r.status == parse_status::OUT_OF_RANGE)
+            throw_except<number_format_exception>("Floating value out of range");
+        if (r.status != parse_status::OK || r.ptr != s + len)
+            throw_except<number_format_exception>("Invalid floating string");
+        return value;
     }
 
 }//namespace num
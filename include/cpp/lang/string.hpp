@@ -6,6 +6,7 @@
 #include <allocators/allocator.hpp>
 #include <cpp/lang/exceptions.hpp>
 #include <cpp/lang/math.hpp>
+#include <cpp/lang/numbers.hpp>
 #include <utility>
 #include <cstring>
 #include <cassert>
@@ -15,8 +16,13 @@
 namespace jstd
 {
 
+template<typename TCHAR>
+class tstring_builder;
+
 template<typename TCHAR>
 class tstring {
+    friend class tstring_builder<TCHAR>;
+
     /**
      * 
      */
@@ -54,13 +60,17 @@ class tstring {
      */
     void ensure_cap(std::size_t new_size);
 
+    /**
+     * Создаёт строку, забирая буфер buf вместимостью buf_cap символов, выделенный через allocator.
+     * Буфер должен содержать len символов и место под завершающий ноль.
+     */
+    static tstring<TCHAR> adopt(TCHAR* buf, std::size_t len, std::size_t buf_cap, tca::allocator* allocator);
+
     /**
      * 
      */
     static bool match(const TCHAR* a, const TCHAR* b, std::size_t blen) {
-        for (std::size_t i = 0; i < blen; ++i)
-            if (a[i] != b[i]) return false;
-        return true;
+        return objects::equals(a, b, blen);
     }
 
     /**
@@ -452,6 +462,28 @@ public:
         cap  = new_cap;
     }
     
+    template<typename TCHAR>
+    tstring<TCHAR> tstring<TCHAR>::adopt(TCHAR* buf, std::size_t len, std::size_t buf_cap, tca::allocator* allocator) {
+        assert(len < buf_cap);
+        tstring<TCHAR> str(allocator);
+        if (buf_cap <= INLINE_BUFFER_SIZE)
+        {
+            //Вместимость не больше встроенного буфера означает встроенную строку, поэтому символы копируются.
+            std::memcpy(str.inline_data, buf, len * sizeof(TCHAR));
+            str.inline_data[len] = 0;
+            str.size = len;
+            allocator->deallocate(buf);
+        }
+        else
+        {
+            buf[len]    = 0;
+            str.data    = buf;
+            str.cap     = buf_cap;
+            str.size    = len;
+        }
+        return str;
+    }
+
     template<typename TCHAR>
     tstring<TCHAR>::~tstring() {
         if (!is_inline_string() && data)
@@ -515,8 +547,9 @@ public:
         
         len = normalize_length(s, len);
 
+        // Вместимость растёт геометрически, иначе серия дописываний копирует строку на каждом шаге.
         if (rem() <= len)
-            ensure_cap(size + len);
+            ensure_cap(math::max(size + len, cap + (cap >> 1)));
         
         TCHAR* str = cstr();
         
@@ -558,25 +591,11 @@ public:
         )
         
         len = normalize_length(s, len);
-        if (len == 0 || len > (length() - from_index)) return npos();
-
-        for (std::size_t i = from_index; i <= length() - len; ++i)
-        {
-            bool match = true;
-            for (std::size_t j = 0; j < len; ++j)
-            {
-                assert(j < len);
-                assert(i + j < size);
-                if (cstr()[i + j] != s[j])
-                {
-                    match = false;
-                    break;
-                }
-            }   
-            if (match) return i;
-        }
+        if (len == 0 || from_index > length() || len > (length() - from_index)) return npos();
 
-        return npos();
+        const std::size_t rest  = length() - from_index;
+        const std::size_t i     = simd::find_sequence(cstr() + from_index, rest, s, len);
+        return i == rest ? npos() : from_index + i;
     }
     
     template<typename TCHAR>
@@ -584,24 +603,9 @@ public:
         len = normalize_length(s, len);
     
         if (len == 0 || len > length()) return npos();
-        
-        for (std::size_t i = length() - len + 1; i > 0;)
-        {
-            --i;
-            bool match = true;
-            for (std::size_t j = 0; j < len; ++j)
-            {
-                if (cstr()[i + j] != s[j])
-                {
-                    match = false;
-                    break;
-                }
-            }
-            
-            if (match) return i;
-        }
-        
-        return npos();
+
+        const std::size_t i = simd::find_last_sequence(cstr(), length(), s, len);
+        return i == length() ? npos() : i;
     }
 
     template<typename TCHAR>
@@ -641,7 +645,7 @@ public:
 
     template<typename TCHAR>
     bool tstring<TCHAR>::contains(const TCHAR* s, std::size_t len) const {
-        return index_of(s, len) != npos();
+        return !is_empty() && index_of(s, 0, len) != npos();
     }
 
     template<typename TCHAR>
@@ -689,21 +693,58 @@ public:
         if (matcher_len == 0 || matcher_len > length())
             return *this;
 
-        for (std::size_t i = 0; i <= length() - matcher_len; )
+        //Первый проход считает вхождения, второй собирает результат без сдвигов хвоста на каждое вхождение.
+        const TCHAR* src    = cstr();
+        std::size_t count   = 0;
+        for (std::size_t i = 0; ; )
         {
-            bool matched = match(cstr() + i, matcher, matcher_len);
-            if (matched)
-            {
-                remove(i, i + matcher_len);
-                append(i, replacement, replacement_len);
-                i += replacement_len;
-            }
-            else
-            {
-                ++i;
-            }
+            const std::size_t at = simd::find_sequence(src + i, size - i, matcher, matcher_len);
+            if (at == size - i)
+                break;
+            ++count;
+            i += at + matcher_len;
+        }
+        if (count == 0)
+            return *this;
+
+        const std::size_t new_size = size - count * matcher_len + count * replacement_len;
+        tstring<TCHAR> out(allocator);
+        TCHAR* dst = cstr();
+        if (replacement_len > matcher_len)
+        {
+            //Результат длиннее: собираем в новый буфер.
+            out.reserve(new_size);
+            dst = out.cstr();
+        }
+
+        //При сжатии запись идёт в тот же буфер и никогда не обгоняет чтение.
+        std::size_t w = 0;
+        for (std::size_t i = 0; ; )
+        {
+            const std::size_t at = simd::find_sequence(src + i, size - i, matcher, matcher_len);
+            std::memmove(dst + w, src + i, at * sizeof(TCHAR));
+            w += at;
+            i += at;
+            if (i == size)
+                break;
+            std::memcpy(dst + w, replacement, replacement_len * sizeof(TCHAR));
+            w += replacement_len;
+            i += matcher_len;
+            if (i == size)
+                break;
         }
+        assert(w == new_size);
+        dst[new_size] = 0;
 
+        if (replacement_len > matcher_len)
+        {
+            out.size = new_size;
+            *this = std::move(out);
+        }
+        else
+        {
+            size = new_size;
+        }
         return *this;
     }
 
@@ -825,6 +866,50 @@ namespace internal
             str.append(buf, static_cast<std::size_t>(len));
         return tstring<wchar_t>( std::move(str) );
     }
+
+    /**
+     * Десятичная запись целого без printf (num::format_int()).
+     */
+    template<typename TCHAR>
+    tstring<TCHAR> int_to_string0(long long e, tca::allocator* allocator) {
+        tstring<TCHAR> str(allocator);
+        TCHAR buf[num::MAX_INT_CHARS];
+        str.append(buf, num::format_int(buf, e));
+        return str;
+    }
+
+    /**
+     * @see int_to_string0
+     */
+    template<typename TCHAR>
+    tstring<TCHAR> uint_to_string0(unsigned long long e, tca::allocator* allocator) {
+        tstring<TCHAR> str(allocator);
+        TCHAR buf[num::MAX_INT_CHARS];
+        str.append(buf, num::format_uint(buf, e));
+        return str;
+    }
+
+    /**
+     * Кратчайшая запись, читаемая обратно в то же значение (num::format_double()).
+     */
+    template<typename TCHAR>
+    tstring<TCHAR> double_to_string0(double e, tca::allocator* allocator) {
+        tstring<TCHAR> str(allocator);
+        TCHAR buf[num::MAX_FLOAT_CHARS];
+        str.append(buf, num::format_double(buf, e));
+        return str;
+    }
+
+    /**
+     * @see double_to_string0
+     */
+    template<typename TCHAR>
+    tstring<TCHAR> float_to_string0(float e, tca::allocator* allocator) {
+        tstring<TCHAR> str(allocator);
+        TCHAR buf[num::MAX_FLOAT_CHARS];
+        str.append(buf, num::format_float(buf, e));
+        return str;
+    }
 }
 
     template<typename E>
@@ -849,52 +934,52 @@ namespace internal
 
     template<>
     inline tstring<char> to_string<int>(const int& e, tca::allocator* allocator) {
-        return internal::to_string0<int>(e, "%i", allocator);
+        return internal::int_to_string0<char>(e, allocator);
     }
     
     template<>
     inline tstring<char> to_string<unsigned int>(const unsigned int& e, tca::allocator* allocator) {
-        return internal::to_string0<unsigned int>(e, "%u", allocator);
+        return internal::uint_to_string0<char>(e, allocator);
     }
     
     template<>
     inline tstring<char> to_string<short>(const short& e, tca::allocator* allocator) {
-        return internal::to_string0<int>(e, "%i", allocator);
+        return internal::int_to_string0<char>(e, allocator);
     }
     
     template<>
     inline tstring<char> to_string<unsigned short>(const unsigned short& e, tca::allocator* allocator) {
-        return internal::to_string0<unsigned int>(e, "%u", allocator);
+        return internal::uint_to_string0<char>(e, allocator);
     }
 
     template<>
     inline tstring<char> to_string<long>(const long& e, tca::allocator* allocator) {
-        return internal::to_string0<long>(e, "%li", allocator);
+        return internal::int_to_string0<char>(e, allocator);
     }
     
     template<>
     inline tstring<char> to_string<unsigned long>(const unsigned long& e, tca::allocator* allocator) {
-        return internal::to_string0<unsigned long>(e, "%lu", allocator);
+        return internal::uint_to_string0<char>(e, allocator);
     }
 
     template<>
     inline tstring<char> to_string<long long>(const long long& e, tca::allocator* allocator) {
-        return internal::to_string0<long long>(e, "%lli", allocator);
+        return internal::int_to_string0<char>(e, allocator);
     }
     
     template<>
     inline tstring<char> to_string<unsigned long long>(const unsigned long long& e, tca::allocator* allocator) {
-        return internal::to_string0<unsigned long long>(e, "%llu", allocator);
+        return internal::uint_to_string0<char>(e, allocator);
     }
 
     template<>
     inline tstring<char> to_string<float>(const float& e, tca::allocator* allocator) {
-        return internal::to_string0<float>(e, "%g", allocator);
+        return internal::float_to_string0<char>(e, allocator);
     }
     
     template<>
     inline tstring<char> to_string<double>(const double& e, tca::allocator* allocator) {
-        return internal::to_string0<double>(e, "%g", allocator);
+        return internal::double_to_string0<char>(e, allocator);
     }
     
     template<typename T>
@@ -934,52 +1019,52 @@ namespace internal
 
     template<>
     inline tstring<wchar_t> to_wstring<int>(const int& e, tca::allocator* allocator) {
-        return internal::to_wstring0<int>(e, L"%i", allocator);
+        return internal::int_to_string0<wchar_t>(e, allocator);
     }
     
     template<>
     inline tstring<wchar_t> to_wstring<unsigned int>(const unsigned int& e, tca::allocator* allocator) {
-        return internal::to_wstring0<unsigned int>(e, L"%u", allocator);
+        return internal::uint_to_string0<wchar_t>(e, allocator);
     }
     
     template<>
     inline tstring<wchar_t> to_wstring<short>(const short& e, tca::allocator* allocator) {
-        return internal::to_wstring0<int>(e, L"%i", allocator);
+        return internal::int_to_string0<wchar_t>(e, allocator);
     }
     
     template<>
     inline tstring<wchar_t> to_wstring<unsigned short>(const unsigned short& e, tca::allocator* allocator) {
-        return internal::to_wstring0<unsigned int>(e, L"%u", allocator);
+        return internal::uint_to_string0<wchar_t>(e, allocator);
     }
 
     template<>
     inline tstring<wchar_t> to_wstring<long>(const long& e, tca::allocator* allocator) {
-        return internal::to_wstring0<long>(e, L"%li", allocator);
+        return internal::int_to_string0<wchar_t>(e, allocator);
     }
     
     template<>
     inline tstring<wchar_t> to_wstring<unsigned long>(const unsigned long& e, tca::allocator* allocator) {
-        return internal::to_wstring0<unsigned long>(e, L"%lu", allocator);
+        return internal::uint_to_string0<wchar_t>(e, allocator);
     }
 
     template<>
     inline tstring<wchar_t> to_wstring<long long>(const long long& e, tca::allocator* allocator) {
-        return internal::to_wstring0<long long>(e, L"%lli", allocator);
+        return internal::int_to_string0<wchar_t>(e, allocator);
     }
     
     template<>
     inline tstring<wchar_t> to_wstring<unsigned long long>(const unsigned long long& e, tca::allocator* allocator) {
-        return internal::to_wstring0<unsigned long long>(e, L"%llu", allocator);
+        return internal::uint_to_string0<wchar_t>(e, allocator);
     }
 
     template<>
     inline tstring<wchar_t> to_wstring<float>(const float& e, tca::allocator* allocator) {
-        return internal::to_wstring0<float>(e, L"%g", allocator);
+        return internal::float_to_string0<wchar_t>(e, allocator);
     }
     
     template<>
     inline tstring<wchar_t> to_wstring<double>(const double& e, tca::allocator* allocator) {
-        return internal::to_wstring0<double>(e, L"%g", allocator);
+        return internal::double_to_string0<wchar_t>(e, allocator);
     }
     
     template<typename T>
@@ -1005,18 +1090,36 @@ using u32string = tstring<unsigned long>;
 using wstring   = tstring<wchar_t>;
 using string    = u8string;
 
+template<typename TCHAR>
+class tstring_view;
+
+/**
+ * Принимает и tstring_view (cpp/lang/string_view.hpp) с тем же хеш-кодом,
+ * что позволяет искать в hash_map<tstring<T>, V>::find() без создания строки.
+ */
 template<typename T>
 struct hash_for<tstring<T>> {
     std::size_t operator() (const tstring<T>& s) const {
         return s.hashcode();
     }
+
+    std::size_t operator() (const tstring_view<T>& s) const {
+        return s.hashcode();
+    }
 };
 
+/**
+ * @see hash_for<tstring<T>>
+ */
 template<typename T>
 struct equal_to<tstring<T>> {
     bool operator() (const tstring<T>& a, const tstring<T>& b) const {
         return a.equals(b);
     }
+
+    bool operator() (const tstring<T>& a, const tstring_view<T>& b) const {
+        return a.length() == b.length() && objects::equals(a.cstr(), b.data(), a.length());
+    }
 };
 
 template<typename T>
@@ -1026,6 +1129,15 @@ struct compare_to<tstring<T>> {
     }
 };
 
+/**
+ * Строка хранит либо указатель на буфер, либо символы внутри себя (признак - вместимость, а не адрес),
+ * поэтому переносится побайтово.
+ */
+template<typename TCHAR>
+struct is_trivially_relocatable<tstring<TCHAR>> {
+    static const bool value = true;
+};
+
 }//namespace jstd
 namespace tc = jstd;
 
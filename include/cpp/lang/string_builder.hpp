@@ -0,0 +1,641 @@
+#ifndef JSTD_CPP_LANG_STRING_BUILDER_H
+#define JSTD_CPP_LANG_STRING_BUILDER_H
+
+#include <cpp/lang/string.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/math.hpp>
+#include <cpp/lang/numbers.hpp>
+#include <allocators/allocator.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cstring>
+#include <cstdio>
+
+namespace jstd
+{
+
+/**
+ * Способ хранения символов в tstring_builder.
+ */
+enum struct builder_mode {
+    CONTIGUOUS, /* Один буфер, вместимость растёт вдвое. to_string() отдаёт буфер строке без копирования.          */
+    CHUNKED     /* Цепочка блоков, уже записанные символы не копируются при росте. to_string() копирует их один раз. */
+};
+
+/**
+ * Построитель строк для серии дописываний.
+ *
+ * В режиме CONTIGUOUS символы лежат в одном буфере, вместимость которого при нехватке растёт вдвое,
+ * поэтому N дописываний стоят O(N) амортизированно. to_string() передаёт буфер строке без копирования.
+ *
+ * В режиме CHUNKED при нехватке места добавляется новый блок (каждый следующий вдвое больше, до MAX_CHUNK),
+ * а записанные символы остаются на месте. Это выгодно для очень больших ответов, которые удобнее отдавать
+ * по блокам через for_each_chunk(), не собирая в одну строку.
+ *
+ * Методы append_int(), append_uint(), append_float() и append_bool() форматируют значение прямо в буфер,
+ * без промежуточной строки.
+ *
+ * @tparam TCHAR
+ *      Тип символа.
+ */
+template<typename TCHAR>
+class tstring_builder {
+    tstring_builder(const tstring_builder<TCHAR>&)                          = delete;
+    tstring_builder<TCHAR>& operator= (const tstring_builder<TCHAR>&)       = delete;
+
+    /**
+     * Блок режима CHUNKED. Символы лежат сразу за заголовком.
+     */
+    struct chunk {
+        chunk*      next;
+        std::size_t cap;
+        std::size_t len;
+
+        TCHAR* data() {
+            return reinterpret_cast<TCHAR*>(this + 1);
+        }
+
+        const TCHAR* data() const {
+            return reinterpret_cast<const TCHAR*>(this + 1);
+        }
+    };
+
+    /**
+     * Вместимость первого буфера (блока) по умолчанию.
+     */
+    static const std::size_t MIN_CAPACITY = 32;
+
+    /**
+     * Максимальная вместимость, до которой удваиваются блоки режима CHUNKED.
+     */
+    static const std::size_t MAX_CHUNK = 1024 * 1024;
+
+    /**
+     *
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     *
+     */
+    builder_mode m_mode;
+
+    /**
+     * Буфер режима CONTIGUOUS.
+     */
+    TCHAR* m_data;
+
+    /**
+     * В режиме CONTIGUOUS - вместимость m_data с местом под завершающий ноль,
+     * в режиме CHUNKED - вместимость первого блока.
+     */
+    std::size_t m_cap;
+
+    /**
+     * Блоки режима CHUNKED.
+     */
+    chunk* m_head;
+    chunk* m_tail;
+
+    /**
+     *
+     */
+    std::size_t m_length;
+
+    /**
+     * Расширяет буфер режима CONTIGUOUS минимум до min_cap символов.
+     */
+    void grow(std::size_t min_cap);
+
+    /**
+     * Добавляет в конец блок режима CHUNKED, вмещающий не менее n символов.
+     */
+    void add_chunk(std::size_t n);
+
+    /**
+     * Возвращает место под n символов подряд в конце построителя. Длина не меняется до commit().
+     */
+    TCHAR* claim(std::size_t n);
+
+    /**
+     * Принимает n символов, записанных в место, полученное через claim().
+     */
+    void commit(std::size_t n) {
+        m_length += n;
+        if (m_mode == builder_mode::CHUNKED)
+            m_tail->len += n;
+    }
+
+    /**
+     * Освобождает всю память.
+     */
+    void release();
+
+    /**
+     *
+     */
+    static std::size_t str_len(const TCHAR* s) {
+        return tstring<TCHAR>::str_len(s);
+    }
+
+public:
+    /**
+     *
+     */
+    explicit tstring_builder(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * @param init_capacity
+     *      Начальная вместимость буфера (CONTIGUOUS, выделяется сразу)
+     *      или первого блока (CHUNKED, выделяется при первом дописывании).
+     */
+    explicit tstring_builder(std::size_t init_capacity, builder_mode mode = builder_mode::CONTIGUOUS, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    tstring_builder(tstring_builder<TCHAR>&& b);
+
+    /**
+     *
+     */
+    tstring_builder<TCHAR>& operator= (tstring_builder<TCHAR>&& b);
+
+    /**
+     *
+     */
+    ~tstring_builder();
+
+    /**
+     * Дописывает len символов строки s.
+     */
+    tstring_builder<TCHAR>& append(const TCHAR* s, std::size_t len);
+
+    /**
+     * Дописывает строку s, оканчивающуюся нулём.
+     */
+    tstring_builder<TCHAR>& append(const TCHAR* s) {
+        return append(s, str_len(s));
+    }
+
+    /**
+     *
+     */
+    tstring_builder<TCHAR>& append(const tstring<TCHAR>& s) {
+        return append(s.cstr(), s.length());
+    }
+
+    /**
+     *
+     */
+    tstring_builder<TCHAR>& append(TCHAR ch) {
+        *claim(1) = ch;
+        commit(1);
+        return *this;
+    }
+
+    /**
+     * Дописывает count символов ch.
+     */
+    tstring_builder<TCHAR>& append_repeat(TCHAR ch, std::size_t count);
+
+    /**
+     * Дописывает десятичную запись числа.
+     */
+    tstring_builder<TCHAR>& append_int(long long v);
+
+    /**
+     * Дописывает запись числа в системе счисления radix (от 2 до 36, цифры больше 9 - строчные латинские буквы).
+     *
+     * @throws illegal_argument_exception
+     *      Если radix вне диапазона (только в отладочной сборке).
+     */
+    tstring_builder<TCHAR>& append_uint(unsigned long long v, unsigned radix = 10);
+
+    /**
+     * Дописывает кратчайшую запись числа, которая читается обратно в то же значение.
+     *
+     * @see num::format_double(char*, double)
+     */
+    tstring_builder<TCHAR>& append_float(double v);
+
+    /**
+     * @see num::format_float(char*, float)
+     */
+    tstring_builder<TCHAR>& append_float(float v);
+
+    /**
+     * Дописывает число в формате %g с precision значащими цифрами.
+     *
+     * @throws illegal_argument_exception
+     *      Если precision вне диапазона [0, 40] (только в отладочной сборке).
+     */
+    tstring_builder<TCHAR>& append_float(double v, int precision);
+
+    /**
+     * Дописывает "true" или "false".
+     */
+    tstring_builder<TCHAR>& append_bool(bool v);
+
+    /**
+     *
+     */
+    tstring_builder<TCHAR>& operator<< (const TCHAR* s) {
+        return append(s);
+    }
+
+    /**
+     *
+     */
+    tstring_builder<TCHAR>& operator<< (const tstring<TCHAR>& s) {
+        return append(s);
+    }
+
+    /**
+     *
+     */
+    tstring_builder<TCHAR>& operator<< (TCHAR ch) {
+        return append(ch);
+    }
+
+    /**
+     * Выделяет память так, чтобы дописывания до общей длины n не выделяли её снова.
+     * В режиме CHUNKED место резервируется в последнем блоке.
+     */
+    tstring_builder<TCHAR>& reserve(std::size_t n);
+
+    /**
+     * Сбрасывает длину. Буфер (первый блок) сохраняется для повторного использования.
+     */
+    void clear();
+
+    /**
+     * Возвращает построенную строку. Построитель становится пустым.
+     *
+     * В режиме CONTIGUOUS строка получает буфер построителя без копирования
+     * (короткие строки копируются во встроенный буфер tstring).
+     */
+    tstring<TCHAR> to_string();
+
+    /**
+     * Копирует содержимое в новую строку, не изменяя построитель.
+     */
+    tstring<TCHAR> copy_string(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Вызывает f(const TCHAR* data, std::size_t len) для каждого непустого фрагмента по порядку.
+     * В режиме CONTIGUOUS фрагмент один.
+     */
+    template<typename FUNC>
+    void for_each_chunk(FUNC f) const;
+
+    /**
+     *
+     */
+    std::size_t length() const {
+        return m_length;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_length == 0;
+    }
+
+    /**
+     *
+     */
+    builder_mode mode() const {
+        return m_mode;
+    }
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const {
+        return m_allocator;
+    }
+};
+
+    template<typename TCHAR>
+    /*static*/ const std::size_t tstring_builder<TCHAR>::MIN_CAPACITY;
+
+    template<typename TCHAR>
+    /*static*/ const std::size_t tstring_builder<TCHAR>::MAX_CHUNK;
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>::tstring_builder(tca::allocator* allocator) : tstring_builder<TCHAR>(0, builder_mode::CONTIGUOUS, allocator) {
+
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>::tstring_builder(std::size_t init_capacity, builder_mode mode, tca::allocator* allocator) :
+        m_allocator(allocator),
+        m_mode(mode),
+        m_data(nullptr),
+        m_cap(mode == builder_mode::CHUNKED ? math::max(init_capacity, MIN_CAPACITY) : 0),
+        m_head(nullptr),
+        m_tail(nullptr),
+        m_length(0) {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator is null");
+        );
+        if (mode == builder_mode::CONTIGUOUS && init_capacity > 0)
+            grow(init_capacity + 1);
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>::tstring_builder(tstring_builder<TCHAR>&& b) :
+        m_allocator(b.m_allocator),
+        m_mode(b.m_mode),
+        m_data(b.m_data),
+        m_cap(b.m_cap),
+        m_head(b.m_head),
+        m_tail(b.m_tail),
+        m_length(b.m_length) {
+        b.m_data    = nullptr;
+        b.m_cap     = b.m_mode == builder_mode::CHUNKED ? m_cap : 0;
+        b.m_head    = nullptr;
+        b.m_tail    = nullptr;
+        b.m_length  = 0;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::operator= (tstring_builder<TCHAR>&& b) {
+        if (&b != this) {
+            std::swap(m_allocator,  b.m_allocator);
+            std::swap(m_mode,       b.m_mode);
+            std::swap(m_data,       b.m_data);
+            std::swap(m_cap,        b.m_cap);
+            std::swap(m_head,       b.m_head);
+            std::swap(m_tail,       b.m_tail);
+            std::swap(m_length,     b.m_length);
+        }
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>::~tstring_builder() {
+        release();
+    }
+
+    template<typename TCHAR>
+    void tstring_builder<TCHAR>::release() {
+        if (m_data != nullptr) {
+            m_allocator->deallocate(m_data);
+            m_data  = nullptr;
+            m_cap   = 0;
+        }
+        chunk* c = m_head;
+        while (c != nullptr) {
+            chunk* next = c->next;
+            m_allocator->deallocate(c, sizeof(chunk) + c->cap * sizeof(TCHAR));
+            c = next;
+        }
+        m_head      = nullptr;
+        m_tail      = nullptr;
+        m_length    = 0;
+    }
+
+    template<typename TCHAR>
+    void tstring_builder<TCHAR>::grow(std::size_t min_cap) {
+        const std::size_t new_cap = math::max(min_cap, math::max(m_cap * 2, MIN_CAPACITY));
+        TCHAR* new_data = static_cast<TCHAR*>(m_allocator->allocate_align(new_cap * sizeof(TCHAR), alignof(TCHAR)));
+        if (new_data == nullptr)
+            throw_except<out_of_memory_error>("Out of memory");
+        if (m_data != nullptr) {
+            std::memcpy(new_data, m_data, m_length * sizeof(TCHAR));
+            m_allocator->deallocate(m_data);
+        }
+        m_data  = new_data;
+        m_cap   = new_cap;
+    }
+
+    template<typename TCHAR>
+    void tstring_builder<TCHAR>::add_chunk(std::size_t n) {
+        const std::size_t next_cap = m_tail != nullptr ? math::max(m_cap, math::min(m_tail->cap * 2, MAX_CHUNK)) : m_cap;
+        const std::size_t cap = math::max(n, next_cap);
+        chunk* c = static_cast<chunk*>(m_allocator->allocate_align(sizeof(chunk) + cap * sizeof(TCHAR), alignof(chunk)));
+        if (c == nullptr)
+            throw_except<out_of_memory_error>("Out of memory");
+        c->next = nullptr;
+        c->cap  = cap;
+        c->len  = 0;
+        if (m_tail != nullptr)
+            m_tail->next = c;
+        else
+            m_head = c;
+        m_tail = c;
+    }
+
+    template<typename TCHAR>
+    TCHAR* tstring_builder<TCHAR>::claim(std::size_t n) {
+        if (m_mode == builder_mode::CONTIGUOUS) {
+            // Одно место всегда остаётся под завершающий ноль для to_string().
+            if (m_cap - m_length <= n)
+                grow(m_length + n + 1);
+            return m_data + m_length;
+        }
+        if (m_tail == nullptr || m_tail->cap - m_tail->len < n)
+            add_chunk(n);
+        return m_tail->data() + m_tail->len;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append(const TCHAR* s, std::size_t len) {
+        JSTD_DEBUG_CODE(
+            if (s == nullptr && len != 0)
+                throw_except<null_pointer_exception>("s is null");
+        );
+        if (m_mode == builder_mode::CONTIGUOUS) {
+            std::memcpy(claim(len), s, len * sizeof(TCHAR));
+            commit(len);
+            return *this;
+        }
+        // Заполняем остаток последнего блока, остальное - в новый блок.
+        if (m_tail != nullptr) {
+            const std::size_t part = math::min(len, m_tail->cap - m_tail->len);
+            std::memcpy(m_tail->data() + m_tail->len, s, part * sizeof(TCHAR));
+            commit(part);
+            s   += part;
+            len -= part;
+        }
+        if (len > 0) {
+            add_chunk(len);
+            std::memcpy(m_tail->data(), s, len * sizeof(TCHAR));
+            commit(len);
+        }
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_repeat(TCHAR ch, std::size_t count) {
+        while (count > 0) {
+            const std::size_t part = m_mode == builder_mode::CHUNKED && m_tail != nullptr && m_tail->len < m_tail->cap ?
+                                        math::min(count, m_tail->cap - m_tail->len) : count;
+            TCHAR* dst = claim(part);
+            for (std::size_t i = 0; i < part; ++i)
+                dst[i] = ch;
+            commit(part);
+            count -= part;
+        }
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_uint(unsigned long long v, unsigned radix) {
+        JSTD_DEBUG_CODE(
+            if (radix < 2 || radix > 36)
+                throw_except<illegal_argument_exception>("radix must be in [2, 36], got %u", radix);
+        );
+        if (radix == 10) {
+            TCHAR* dst = claim(num::MAX_INT_CHARS);
+            commit(num::format_uint(dst, v));
+            return *this;
+        }
+        std::size_t digits = 1;
+        for (unsigned long long t = v / radix; t != 0; t /= radix)
+            ++digits;
+        TCHAR* dst = claim(digits);
+        for (std::size_t i = digits; i > 0;) {
+            const unsigned d = (unsigned) (v % radix);
+            dst[--i] = (TCHAR) (d < 10 ? '0' + d : 'a' + (d - 10));
+            v /= radix;
+        }
+        commit(digits);
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_int(long long v) {
+        TCHAR* dst = claim(num::MAX_INT_CHARS);
+        commit(num::format_int(dst, v));
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_float(double v) {
+        TCHAR* dst = claim(num::MAX_FLOAT_CHARS);
+        commit(num::format_double(dst, v));
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_float(float v) {
+        TCHAR* dst = claim(num::MAX_FLOAT_CHARS);
+        commit(num::format_float(dst, v));
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_float(double v, int precision) {
+        JSTD_DEBUG_CODE(
+            if (precision < 0 || precision > 40)
+                throw_except<illegal_argument_exception>("precision must be in [0, 40], got %i", precision);
+        );
+        char buf[64];
+        const int n = std::snprintf(buf, sizeof(buf), "%.*g", precision, v);
+        if (n <= 0)
+            return *this;
+        const std::size_t len = math::min((std::size_t) n, sizeof(buf) - 1);
+        TCHAR* dst = claim(len);
+        for (std::size_t i = 0; i < len; ++i)
+            dst[i] = (TCHAR) buf[i];
+        commit(len);
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::append_bool(bool v) {
+        const char* s = v ? "true" : "false";
+        const std::size_t len = v ? 4 : 5;
+        TCHAR* dst = claim(len);
+        for (std::size_t i = 0; i < len; ++i)
+            dst[i] = (TCHAR) s[i];
+        commit(len);
+        return *this;
+    }
+
+    template<typename TCHAR>
+    tstring_builder<TCHAR>& tstring_builder<TCHAR>::reserve(std::size_t n) {
+        if (m_mode == builder_mode::CONTIGUOUS) {
+            if (n >= m_cap)
+                grow(n + 1);
+        } else if (n > m_length) {
+            claim(n - m_length);
+        }
+        return *this;
+    }
+
+    template<typename TCHAR>
+    void tstring_builder<TCHAR>::clear() {
+        m_length = 0;
+        if (m_head == nullptr)
+            return;
+        chunk* c = m_head->next;
+        while (c != nullptr) {
+            chunk* next = c->next;
+            m_allocator->deallocate(c, sizeof(chunk) + c->cap * sizeof(TCHAR));
+            c = next;
+        }
+        m_head->next    = nullptr;
+        m_head->len     = 0;
+        m_tail          = m_head;
+    }
+
+    template<typename TCHAR>
+    tstring<TCHAR> tstring_builder<TCHAR>::to_string() {
+        if (m_mode == builder_mode::CONTIGUOUS) {
+            if (m_data == nullptr)
+                return tstring<TCHAR>(m_allocator);
+            TCHAR* data = m_data;
+            const std::size_t len = m_length;
+            const std::size_t cap = m_cap;
+            m_data      = nullptr;
+            m_cap       = 0;
+            m_length    = 0;
+            return tstring<TCHAR>::adopt(data, len, cap, m_allocator);
+        }
+        tstring<TCHAR> str = copy_string(m_allocator);
+        release();
+        return str;
+    }
+
+    template<typename TCHAR>
+    tstring<TCHAR> tstring_builder<TCHAR>::copy_string(tca::allocator* allocator) const {
+        if (allocator == nullptr)
+            allocator = m_allocator;
+        if (m_length == 0)
+            return tstring<TCHAR>(allocator);
+        const std::size_t cap = m_length + 1;
+        TCHAR* buf = static_cast<TCHAR*>(allocator->allocate_align(cap * sizeof(TCHAR), alignof(TCHAR)));
+        if (buf == nullptr)
+            throw_except<out_of_memory_error>("Out of memory");
+        TCHAR* dst = buf;
+        for_each_chunk([&dst](const TCHAR* data, std::size_t len) {
+            std::memcpy(dst, data, len * sizeof(TCHAR));
+            dst += len;
+        });
+        return tstring<TCHAR>::adopt(buf, m_length, cap, allocator);
+    }
+
+    template<typename TCHAR>
+    template<typename FUNC>
+    void tstring_builder<TCHAR>::for_each_chunk(FUNC f) const {
+        if (m_mode == builder_mode::CONTIGUOUS) {
+            if (m_length > 0)
+                f(static_cast<const TCHAR*>(m_data), m_length);
+            return;
+        }
+        for (const chunk* c = m_head; c != nullptr; c = c->next)
+            if (c->len > 0)
+                f(c->data(), c->len);
+    }
+
+using string_builder    = tstring_builder<char>;
+using wstring_builder   = tstring_builder<wchar_t>;
+
+}
+
+#endif//JSTD_CPP_LANG_STRING_BUILDER_H
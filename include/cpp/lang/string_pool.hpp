@@ -14,6 +14,7 @@ namespace jstd
  * Класс, реализующий строковой пул константных строк в однобайтовом формате UTF-8 и ASCII.
  * 
  * @see jstd::concurrency_string_pool
+ * @see jstd::symbol_table
  */
 class string_const_pool {
     /**
@@ -42,12 +43,8 @@ public:
      * Возвращает указатель на tc::string из пула.
      * Если строки в пуле нет, создаёт её и добавляет в пул.
      * 
-     * @warning
-     *      Строка обязана быть литералом, либо освобождаться строго после вызова деструктора этого пула!
-     *      Объект работает напрямую с этим указателем!
-     * 
      * @param str
-     *      Константная си-строка.
+     *      Константная си-строка. Пул хранит собственную копию, поэтому буфер можно освободить после вызова.
      * 
      * @return 
      *      Строка идентичная переданной строке, но ввиде объекта jstd::string
@@ -95,8 +92,11 @@ public:
 /**
  * 
  * Класс, реализующий многопоточный строковой пул константных строк в однобайтовом формате UTF-8 и ASCII.
+ * Все операции выполняются под одной блокировкой.
+ * Если строки не нужно удалять по одной, symbol_table быстрее: поиск в нём не блокирует.
  * 
  * @see jstd::string_const_pool
+ * @see jstd::symbol_table
  */
 class concurrency_string_const_pool {
     /**
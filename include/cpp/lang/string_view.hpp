@@ -0,0 +1,412 @@
+#ifndef JSTD_CPP_LANG_STRING_VIEW_H
+#define JSTD_CPP_LANG_STRING_VIEW_H
+
+#include <cpp/lang/string.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/objects.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cpp/lang/utils/hash.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+
+namespace jstd
+{
+
+/**
+ * Невладеющее представление непрерывного участка символов.
+ *
+ * Не копирует символы и не выделяет память: срезы, поиск, разбиение и обрезка пробелов
+ * возвращают новые представления того же буфера. Буфер должен жить дольше представления.
+ * Символы не обязаны оканчиваться нулём.
+ *
+ * hashcode() совпадает с tstring::hashcode() для тех же символов, а hash_for/equal_to
+ * для tstring принимают tstring_view, поэтому hash_map<string, V>::find() ищет по представлению
+ * без создания временной строки.
+ *
+ * @tparam TCHAR
+ *      Тип символа.
+ */
+template<typename TCHAR>
+class tstring_view {
+    /**
+     *
+     */
+    const TCHAR* m_data;
+
+    /**
+     *
+     */
+    std::size_t m_length;
+
+    /**
+     *
+     */
+    static bool is_space(TCHAR ch) {
+        return ch <= (TCHAR) 0x20;
+    }
+
+    /**
+     * Буфер пустого представления, чтобы m_data никогда не был nullptr.
+     */
+    static const TCHAR* empty_data() {
+        static const TCHAR EMPTY[1] = {0};
+        return EMPTY;
+    }
+
+public:
+    /**
+     *
+     */
+    static std::size_t npos() {
+        return ~(std::size_t) 0;
+    }
+
+    /**
+     * Пустое представление.
+     */
+    tstring_view() : m_data(empty_data()), m_length(0) {
+
+    }
+
+    /**
+     * Представление строки, оканчивающейся нулём.
+     */
+    tstring_view(const TCHAR* s) : m_data(s != nullptr ? s : empty_data()), m_length(s != nullptr ? tstring<TCHAR>::str_len(s) : 0) {
+
+    }
+
+    /**
+     *
+     */
+    tstring_view(const TCHAR* s, std::size_t len) : m_data(s != nullptr ? s : empty_data()), m_length(len) {
+        JSTD_DEBUG_CODE(
+            if (s == nullptr && len != 0)
+                throw_except<null_pointer_exception>("s is null");
+        );
+    }
+
+    /**
+     * Представление всей строки s. Действительно, пока s не изменена и не разрушена.
+     */
+    tstring_view(const tstring<TCHAR>& s) : m_data(s.cstr()), m_length(s.length()) {
+
+    }
+
+    /**
+     *
+     */
+    const TCHAR* data() const {
+        return m_data;
+    }
+
+    /**
+     *
+     */
+    std::size_t length() const {
+        return m_length;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_length == 0;
+    }
+
+    /**
+     *
+     */
+    const TCHAR& operator[] (std::size_t idx) const {
+        check_index(idx, m_length);
+        return m_data[idx];
+    }
+
+    /**
+     *
+     */
+    TCHAR char_at(std::size_t idx) const {
+        check_index(idx, m_length);
+        return m_data[idx];
+    }
+
+    /**
+     *
+     */
+    const TCHAR* begin() const {
+        return m_data;
+    }
+
+    /**
+     *
+     */
+    const TCHAR* end() const {
+        return m_data + m_length;
+    }
+
+    /**
+     * Участок [start, end).
+     */
+    tstring_view<TCHAR> sub_view(std::size_t start, std::size_t end) const {
+        JSTD_DEBUG_CODE(
+            if (end < start)        throw_except<illegal_argument_exception>("'start' can't less 'end' where [start: %zu, end: %zu]", start, end);
+            if (end > m_length)     throw_except<illegal_argument_exception>("'end' must be less or equal 'length' where [start: %zu, length: %zu]", start, m_length);
+        );
+        return tstring_view<TCHAR>(m_data + start, end - start);
+    }
+
+    /**
+     * Участок от start до конца.
+     */
+    tstring_view<TCHAR> sub_view(std::size_t start) const {
+        return sub_view(start, m_length);
+    }
+
+    /**
+     * Индекс первого символа ch, начиная с from_index, или npos().
+     */
+    std::size_t index_of(TCHAR ch, std::size_t from_index = 0) const;
+
+    /**
+     * Индекс первого вхождения s, начиная с from_index, или npos().
+     */
+    std::size_t index_of(const tstring_view<TCHAR>& s, std::size_t from_index = 0) const;
+
+    /**
+     * Индекс последнего символа ch или npos().
+     */
+    std::size_t last_index_of(TCHAR ch) const;
+
+    /**
+     * Индекс последнего вхождения s или npos().
+     */
+    std::size_t last_index_of(const tstring_view<TCHAR>& s) const;
+
+    /**
+     *
+     */
+    bool contains(const tstring_view<TCHAR>& s) const {
+        return index_of(s) != npos();
+    }
+
+    /**
+     *
+     */
+    bool starts_with(const tstring_view<TCHAR>& s) const {
+        return s.m_length <= m_length && simd::equals(m_data, s.m_data, s.m_length);
+    }
+
+    /**
+     *
+     */
+    bool ends_with(const tstring_view<TCHAR>& s) const {
+        return s.m_length <= m_length && simd::equals(m_data + (m_length - s.m_length), s.m_data, s.m_length);
+    }
+
+    /**
+     * Представление без пробельных символов (<= 0x20) в начале и в конце.
+     */
+    tstring_view<TCHAR> trim() const;
+
+    /**
+     * Вызывает f(tstring_view<TCHAR>) для каждого участка между разделителями delim, включая пустые.
+     * Для пустого представления f вызывается один раз с пустым участком.
+     */
+    template<typename FUNC>
+    void split(TCHAR delim, FUNC f) const;
+
+    /**
+     * @see split(TCHAR, FUNC)
+     *
+     * @param delim
+     *      Непустая последовательность-разделитель.
+     */
+    template<typename FUNC>
+    void split(const tstring_view<TCHAR>& delim, FUNC f) const;
+
+    /**
+     * Делит представление по первому символу delim: head - участок до него, остаток - после.
+     * Удобно для пошагового разбора без обратного вызова.
+     *
+     * @return
+     *      false, если delim не найден: head - всё представление, остаток пуст.
+     */
+    bool split_first(TCHAR delim, tstring_view<TCHAR>& head, tstring_view<TCHAR>& rest) const;
+
+    /**
+     * Хеш-код, совпадающий с tstring::hashcode() для тех же символов.
+     */
+    std::size_t hashcode() const {
+        return objects::hashcode(m_data, m_length);
+    }
+
+    /**
+     *
+     */
+    bool equals(const tstring_view<TCHAR>& s) const {
+        return m_length == s.m_length && simd::equals(m_data, s.m_data, m_length);
+    }
+
+    /**
+     *
+     */
+    bool operator== (const tstring_view<TCHAR>& s) const {
+        return equals(s);
+    }
+
+    /**
+     *
+     */
+    bool operator!= (const tstring_view<TCHAR>& s) const {
+        return !equals(s);
+    }
+
+    /**
+     * Лексикографическое сравнение.
+     */
+    int compare_to(const tstring_view<TCHAR>& s) const;
+
+    /**
+     * Копирует символы в новую строку.
+     */
+    tstring<TCHAR> to_string(tca::allocator* allocator = tca::get_default_allocator()) const {
+        tstring<TCHAR> str(allocator);
+        str.reserve(m_length);
+        if (m_length != 0)
+            str.append(m_data, m_length);
+        return str;
+    }
+};
+
+    template<typename TCHAR>
+    std::size_t tstring_view<TCHAR>::index_of(TCHAR ch, std::size_t from_index) const {
+        if (from_index >= m_length)
+            return npos();
+        const std::size_t i = simd::find(m_data + from_index, m_length - from_index, ch);
+        return i == m_length - from_index ? npos() : from_index + i;
+    }
+
+    template<typename TCHAR>
+    std::size_t tstring_view<TCHAR>::index_of(const tstring_view<TCHAR>& s, std::size_t from_index) const {
+        if (s.m_length == 0 || from_index > m_length || s.m_length > m_length - from_index)
+            return npos();
+        const std::size_t rest  = m_length - from_index;
+        const std::size_t i     = simd::find_sequence(m_data + from_index, rest, s.m_data, s.m_length);
+        return i == rest ? npos() : from_index + i;
+    }
+
+    template<typename TCHAR>
+    std::size_t tstring_view<TCHAR>::last_index_of(TCHAR ch) const {
+        const std::size_t i = simd::find_last(m_data, m_length, ch);
+        return i == m_length ? npos() : i;
+    }
+
+    template<typename TCHAR>
+    std::size_t tstring_view<TCHAR>::last_index_of(const tstring_view<TCHAR>& s) const {
+        if (s.m_length == 0 || s.m_length > m_length)
+            return npos();
+        const std::size_t i = simd::find_last_sequence(m_data, m_length, s.m_data, s.m_length);
+        return i == m_length ? npos() : i;
+    }
+
+    template<typename TCHAR>
+    tstring_view<TCHAR> tstring_view<TCHAR>::trim() const {
+        std::size_t start = 0;
+        std::size_t end   = m_length;
+        while (start < end && is_space(m_data[start]))
+            ++start;
+        while (end > start && is_space(m_data[end - 1]))
+            --end;
+        return tstring_view<TCHAR>(m_data + start, end - start);
+    }
+
+    template<typename TCHAR>
+    template<typename FUNC>
+    void tstring_view<TCHAR>::split(TCHAR delim, FUNC f) const {
+        std::size_t start = 0;
+        for (;;) {
+            const std::size_t i = simd::find(m_data + start, m_length - start, delim);
+            f(tstring_view<TCHAR>(m_data + start, i));
+            if (i == m_length - start)
+                return;
+            start += i + 1;
+        }
+    }
+
+    template<typename TCHAR>
+    template<typename FUNC>
+    void tstring_view<TCHAR>::split(const tstring_view<TCHAR>& delim, FUNC f) const {
+        JSTD_DEBUG_CODE(
+            if (delim.is_empty())
+                throw_except<illegal_argument_exception>("delim is empty");
+        );
+        std::size_t start = 0;
+        for (;;) {
+            const std::size_t rest = m_length - start;
+            const std::size_t i = simd::find_sequence(m_data + start, rest, delim.m_data, delim.m_length);
+            if (i == rest) {
+                f(tstring_view<TCHAR>(m_data + start, rest));
+                return;
+            }
+            f(tstring_view<TCHAR>(m_data + start, i));
+            start += i + delim.m_length;
+        }
+    }
+
+    template<typename TCHAR>
+    bool tstring_view<TCHAR>::split_first(TCHAR delim, tstring_view<TCHAR>& head, tstring_view<TCHAR>& rest) const {
+        const std::size_t i = simd::find(m_data, m_length, delim);
+        if (i == m_length) {
+            head = *this;
+            rest = tstring_view<TCHAR>(m_data + m_length, 0);
+            return false;
+        }
+        // Через временные: head или rest может быть этим же объектом.
+        const tstring_view<TCHAR> h(m_data, i);
+        const tstring_view<TCHAR> r(m_data + i + 1, m_length - i - 1);
+        head = h;
+        rest = r;
+        return true;
+    }
+
+    template<typename TCHAR>
+    int tstring_view<TCHAR>::compare_to(const tstring_view<TCHAR>& s) const {
+        const std::size_t len = m_length < s.m_length ? m_length : s.m_length;
+        for (std::size_t i = 0; i < len; ++i) {
+            if (m_data[i] < s.m_data[i]) return -1;
+            if (m_data[i] > s.m_data[i]) return  1;
+        }
+        if (m_length < s.m_length) return -1;
+        if (m_length > s.m_length) return  1;
+        return 0;
+    }
+
+using u8string_view     = tstring_view<char>;
+using u16string_view    = tstring_view<unsigned short>;
+using u32string_view    = tstring_view<unsigned long>;
+using wstring_view      = tstring_view<wchar_t>;
+using string_view       = u8string_view;
+
+template<typename T>
+struct hash_for<tstring_view<T>> {
+    std::size_t operator() (const tstring_view<T>& s) const {
+        return s.hashcode();
+    }
+};
+
+template<typename T>
+struct equal_to<tstring_view<T>> {
+    bool operator() (const tstring_view<T>& a, const tstring_view<T>& b) const {
+        return a.equals(b);
+    }
+};
+
+template<typename T>
+struct compare_to<tstring_view<T>> {
+    int operator() (const tstring_view<T>& a, const tstring_view<T>& b) const {
+        return a.compare_to(b);
+    }
+};
+
+}
+
+#endif//JSTD_CPP_LANG_STRING_VIEW_H
@@ -0,0 +1,206 @@
+#ifndef JSTD_CPP_LANG_SYMBOL_TABLE_H
+#define JSTD_CPP_LANG_SYMBOL_TABLE_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/concurrency/mutex.hpp>
+#include <atomic>
+#include <cstdint>
+
+namespace jstd
+{
+
+/**
+ * Идентификатор интернированной строки.
+ * Две строки одной таблицы равны тогда и только тогда, когда равны их идентификаторы.
+ */
+typedef std::uint32_t symbol;
+
+/**
+ * Многопоточная таблица интернирования строк.
+ *
+ * Каждой уникальной строке выдаётся 32-битный идентификатор: идентификаторы плотные и идут подряд с нуля,
+ * поэтому их удобно использовать как индексы во внешних массивах. Строки не удаляются до разрушения таблицы.
+ *
+ * Таблица разбита на SHARDS частей по старшим битам хеш-кода. Поиск не берёт блокировок:
+ * каждая часть - таблица с открытой адресацией, ячейки которой публикуются атомарной записью.
+ * Добавление новой строки блокирует только её часть. При расширении части старая таблица ячеек
+ * не освобождается до разрушения всей таблицы, так как её могут читать другие потоки;
+ * суммарно это не больше памяти текущих таблиц.
+ *
+ * Байты строк хранятся подряд в дописываемых блоках памяти (свой блок у каждой части),
+ * вместе с кэшированными хеш-кодом и длиной, и оканчиваются нулём.
+ * Указатели, возвращаемые name(), действительны до разрушения таблицы.
+ *
+ * Аллокатор должен допускать одновременные вызовы из разных потоков.
+ *
+ * @see string_const_pool
+ */
+class symbol_table {
+    symbol_table(const symbol_table&)               = delete;
+    symbol_table& operator= (const symbol_table&)   = delete;
+
+public:
+    /**
+     * Значение "строка не найдена".
+     */
+    static const symbol null_symbol = ~((symbol) 0);
+
+    /**
+     * Количество частей таблицы (степень двойки).
+     */
+    static const std::size_t SHARDS = 64;
+
+private:
+    struct record;
+    struct table;
+    struct arena_block;
+    struct shard;
+
+    /**
+     * Количество идентификаторов в первом сегменте каталога. Каждый следующий сегмент вдвое больше.
+     */
+    static const std::size_t FIRST_SEGMENT = 1024;
+
+    /**
+     * Количество сегментов, покрывающее все 32-битные идентификаторы.
+     */
+    static const std::size_t SEGMENTS = 23;
+
+    /**
+     *
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     * Части таблицы.
+     */
+    shard* m_shards;
+
+    /**
+     * Каталог: идентификатор -> запись строки. Сегменты выделяются при первом обращении.
+     */
+    std::atomic<std::atomic<const record*>*> m_segments[SEGMENTS];
+
+    /**
+     * Следующий свободный идентификатор.
+     */
+    std::atomic<std::uint32_t> m_next_id;
+
+    /**
+     * Ячейка каталога для идентификатора. Отсутствующий сегмент создаётся.
+     */
+    std::atomic<const record*>* slot_of(symbol id);
+
+    /**
+     * Запись строки по идентификатору или nullptr.
+     */
+    const record* record_of(symbol id) const;
+
+    /**
+     * Ищет строку в таблице ячеек части.
+     */
+    symbol probe(const table* t, std::uint64_t hash, const char* str, std::size_t len) const;
+
+    /**
+     * Выделяет таблицу ячеек на capacity ячеек.
+     */
+    table* new_table(std::size_t capacity);
+
+    /**
+     * Переносит ячейки части в таблицу вдвое большего размера.
+     */
+    void grow(shard& sh);
+
+    /**
+     * Копирует строку в блок памяти части.
+     */
+    record* append(shard& sh, std::uint64_t hash, const char* str, std::size_t len);
+
+    /**
+     *
+     */
+    static std::uint64_t hash_of(const char* str, std::size_t len);
+
+public:
+    /**
+     * @param allocator
+     *      Распределитель памяти для строк и таблиц.
+     */
+    symbol_table(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    ~symbol_table();
+
+    /**
+     * Возвращает идентификатор строки, добавляя её в таблицу, если её там нет.
+     *
+     * @param str
+     *      Строка длиной len байт. Может не оканчиваться нулём.
+     *
+     * @throws illegal_state_exception
+     *      Если исчерпаны 32-битные идентификаторы.
+     */
+    symbol intern(const char* str, std::size_t len);
+
+    /**
+     * @see intern(const char*, std::size_t)
+     */
+    symbol intern(const char* str);
+
+    /**
+     * Возвращает идентификатор строки без добавления. Не берёт блокировок.
+     *
+     * @return
+     *      Идентификатор или null_symbol.
+     */
+    symbol find(const char* str, std::size_t len) const;
+
+    /**
+     * @see find(const char*, std::size_t)
+     */
+    symbol find(const char* str) const;
+
+    /**
+     *
+     */
+    bool contains(const char* str, std::size_t len) const {
+        return find(str, len) != null_symbol;
+    }
+
+    /**
+     * Возвращает интернированную строку, оканчивающуюся нулём.
+     *
+     * @throws no_such_element_exception
+     *      Если идентификатор не выдан этой таблицей.
+     */
+    const char* name(symbol id) const;
+
+    /**
+     * Длина интернированной строки в байтах.
+     *
+     * @throws no_such_element_exception
+     *      Если идентификатор не выдан этой таблицей.
+     */
+    std::size_t length(symbol id) const;
+
+    /**
+     * Кэшированный хеш-код интернированной строки.
+     *
+     * @throws no_such_element_exception
+     *      Если идентификатор не выдан этой таблицей.
+     */
+    std::uint64_t hash(symbol id) const;
+
+    /**
+     * Количество интернированных строк.
+     */
+    std::size_t size() const {
+        return m_next_id.load(std::memory_order_acquire);
+    }
+};
+
+}
+
+#endif//JSTD_CPP_LANG_SYMBOL_TABLE_H
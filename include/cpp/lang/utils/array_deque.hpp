@@ -0,0 +1,723 @@
+#ifndef JSTD_CPP_LANG_UTILS_ARRAY_DEQUE_H
+#define JSTD_CPP_LANG_UTILS_ARRAY_DEQUE_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/objects.hpp>
+#include <cpp/lang/utils/arrays.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <initializer_list>
+#include <cassert>
+#include <new>
+
+namespace jstd
+{
+
+/**
+ * Двусторонняя очередь на кольцевом буфере.
+ *
+ * Вместимость всегда является степенью двойки, поэтому индекс в буфере вычисляется маской.
+ * Добавление и удаление с обоих концов выполняются за O(1) без выделения памяти на каждый элемент
+ * (в отличие от linked_list). Элементы хранятся в не более чем двух непрерывных участках буфера,
+ * доступных через head_segment() и tail_segment() для пакетного копирования.
+ *
+ * Методы add_first/add_last/remove_first/remove_last/push/pop совпадают по поведению с linked_list.
+ *
+ * @tparam E
+ *      Тип элементов.
+ */
+template<typename E>
+class array_deque {
+    /**
+     * Начальная вместимость при первом добавлении.
+     */
+    static const std::size_t DEFAULT_CAPACITY = 8;
+
+    /**
+     *
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     *
+     */
+    E* m_data;
+
+    /**
+     * Вместимость буфера (0 или степень двойки).
+     */
+    std::size_t m_capacity;
+
+    /**
+     * Индекс первого элемента в буфере.
+     */
+    std::size_t m_head;
+
+    /**
+     *
+     */
+    std::size_t m_size;
+
+    /**
+     * Индекс в буфере для логической позиции idx.
+     */
+    std::size_t slot(std::size_t idx) const {
+        return (m_head + idx) & (m_capacity - 1);
+    }
+
+    /**
+     * Переносит элементы в новый буфер вместимостью new_capacity (степень двойки), начиная с нулевого индекса.
+     */
+    void realloc(std::size_t new_capacity);
+
+    /**
+     *
+     */
+    void ensure_capacity(std::size_t min_capacity);
+
+    /**
+     *
+     */
+    void cleanup();
+
+public:
+    /**
+     *
+     */
+    static const std::size_t null_val = ~((std::size_t) 0);
+
+    /**
+     *
+     */
+    array_deque(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт очередь, способную вместить init_capacity элементов без перераспределения.
+     */
+    explicit array_deque(std::size_t init_capacity, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    array_deque(const std::initializer_list<E>& init_list, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    array_deque(const array_deque<E>& deque);
+
+    /**
+     *
+     */
+    array_deque(array_deque<E>&& deque);
+
+    /**
+     *
+     */
+    array_deque<E>& operator= (const array_deque<E>& deque);
+
+    /**
+     *
+     */
+    array_deque<E>& operator= (array_deque<E>&& deque);
+
+    /**
+     *
+     */
+    ~array_deque();
+
+    /**
+     * Создаёт копию очереди. Если аллокатор не указан, используется аллокатор текущей очереди.
+     */
+    array_deque<E> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Добавляет элемент в конец очереди.
+     */
+    template<typename _E>
+    void add(_E&& e);
+
+    /**
+     * Добавляет элемент в начало очереди.
+     */
+    template<typename _E>
+    void add_first(_E&& e);
+
+    /**
+     * Добавляет элемент в конец очереди.
+     */
+    template<typename _E>
+    void add_last(_E&& e);
+
+    /**
+     * Копирует n элементов в конец очереди. Буфер расширяется не более одного раза.
+     */
+    void add_all(const E* src, std::size_t n);
+
+    /**
+     * Удаляет первый элемент.
+     *
+     * @param ret
+     *      (Необязательно) указатель, куда будет перемещено удалённое значение.
+     *
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    void remove_first(E* ret = nullptr);
+
+    /**
+     * Удаляет последний элемент.
+     *
+     * @param ret
+     *      (Необязательно) указатель, куда будет перемещено удалённое значение.
+     *
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    void remove_last(E* ret = nullptr);
+
+    /**
+     * Перемещает до max первых элементов в массив dst и удаляет их из очереди.
+     *
+     * @return
+     *      Количество перемещённых элементов.
+     */
+    std::size_t drain_first(E* dst, std::size_t max);
+
+    /**
+     * Добавляет элемент в конец (аналог push_back).
+     */
+    template<typename _E>
+    void push(_E&& e);
+
+    /**
+     * Удаляет последний элемент (аналог pop_back).
+     */
+    void pop(E* ret = nullptr);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    E& first();
+
+    /**
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    const E& first() const;
+
+    /**
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    E& last();
+
+    /**
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    const E& last() const;
+
+    /**
+     * Возвращает элемент по логическому индексу (0 - первый элемент).
+     *
+     * @throws index_out_of_bound_exception
+     *      Если индекс не допустим.
+     */
+    E& at(std::size_t idx);
+
+    /**
+     * @see at
+     */
+    const E& at(std::size_t idx) const;
+
+    /**
+     * Первый непрерывный участок элементов, начиная с первого элемента очереди.
+     *
+     * @param len
+     *      Сюда записывается количество элементов участка.
+     */
+    E* head_segment(std::size_t* len);
+
+    /**
+     * @see head_segment
+     */
+    const E* head_segment(std::size_t* len) const;
+
+    /**
+     * Второй непрерывный участок (элементы, перенесённые в начало буфера), или nullptr, если его нет.
+     *
+     * @param len
+     *      Сюда записывается количество элементов участка.
+     */
+    E* tail_segment(std::size_t* len);
+
+    /**
+     * @see tail_segment
+     */
+    const E* tail_segment(std::size_t* len) const;
+
+    /**
+     * Гарантирует, что очередь может вместить не менее {@code new_capacity} элементов без перераспределения.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * Удаляет все элементы, но не освобождает память.
+     */
+    void clear();
+
+    /**
+     *
+     */
+    std::size_t size() const;
+
+    /**
+     *
+     */
+    std::size_t capacity() const;
+
+    /**
+     *
+     */
+    bool is_empty() const;
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const;
+
+    /**
+     * Проверяет наличие элемента, используя jstd::equal_to<E>.
+     */
+    bool contains(const E& e) const {
+        return index_of(e) != null_val;
+    }
+
+    /**
+     * Возвращает логический индекс первого вхождения элемента или array_deque<E>::null_val.
+     */
+    std::size_t index_of(const E& e) const;
+
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 80;
+
+    /**
+     *
+     */
+    int to_string(char buf[], std::size_t bufsize) const;
+
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    class iterator {
+        DATA_TYPE*  m_data;
+        std::size_t m_mask;
+        std::size_t m_head;
+        std::size_t m_offset;
+    public:
+        iterator(DATA_TYPE* data, std::size_t mask, std::size_t head, std::size_t offset);
+        VALUE_TYPE& operator*() const;
+        iterator<DATA_TYPE, VALUE_TYPE>& operator++();
+        iterator<DATA_TYPE, VALUE_TYPE> operator++(int);
+        bool operator!=(const iterator<DATA_TYPE, VALUE_TYPE>& it) const;
+    };
+
+    iterator<const E, const E> begin() const {
+        return iterator<const E, const E>(m_data, m_capacity - 1, m_head, 0);
+    }
+
+    iterator<const E, const E> end() const {
+        return iterator<const E, const E>(m_data, m_capacity - 1, m_head, m_size);
+    }
+
+    iterator<E, E> begin() {
+        return iterator<E, E>(m_data, m_capacity - 1, m_head, 0);
+    }
+
+    iterator<E, E> end() {
+        return iterator<E, E>(m_data, m_capacity - 1, m_head, m_size);
+    }
+};
+
+    template<typename E>
+    array_deque<E>::array_deque(tca::allocator* allocator) :
+    m_allocator(allocator),
+    m_data(nullptr),
+    m_capacity(0),
+    m_head(0),
+    m_size(0) {
+
+    }
+
+    template<typename E>
+    array_deque<E>::array_deque(std::size_t init_capacity, tca::allocator* allocator) : array_deque<E>(allocator) {
+        reserve(init_capacity);
+    }
+
+    template<typename E>
+    array_deque<E>::array_deque(const std::initializer_list<E>& init_list, tca::allocator* allocator) : array_deque<E>(allocator) {
+        reserve(init_list.size());
+        for (const E& e : init_list)
+            add_last(e);
+    }
+
+    template<typename E>
+    array_deque<E>::array_deque(const array_deque<E>& deque) : array_deque<E>(deque.m_allocator) {
+        reserve(deque.m_size);
+        for (std::size_t i = 0; i < deque.m_size; ++i)
+            add_last(deque.m_data[deque.slot(i)]);
+    }
+
+    template<typename E>
+    array_deque<E>::array_deque(array_deque<E>&& deque) :
+    m_allocator(deque.m_allocator),
+    m_data(deque.m_data),
+    m_capacity(deque.m_capacity),
+    m_head(deque.m_head),
+    m_size(deque.m_size) {
+        deque.m_data     = nullptr;
+        deque.m_capacity = 0;
+        deque.m_head     = 0;
+        deque.m_size     = 0;
+    }
+
+    template<typename E>
+    array_deque<E>& array_deque<E>::operator= (const array_deque<E>& deque) {
+        if (&deque != this) {
+            array_deque<E> tmp = deque.clone(m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename E>
+    array_deque<E>& array_deque<E>::operator= (array_deque<E>&& deque) {
+        if (&deque != this) {
+            cleanup();
+            m_allocator = deque.m_allocator;
+            m_data      = deque.m_data;
+            m_capacity  = deque.m_capacity;
+            m_head      = deque.m_head;
+            m_size      = deque.m_size;
+            deque.m_data     = nullptr;
+            deque.m_capacity = 0;
+            deque.m_head     = 0;
+            deque.m_size     = 0;
+        }
+        return *this;
+    }
+
+    template<typename E>
+    array_deque<E>::~array_deque() {
+        cleanup();
+    }
+
+    template<typename E>
+    array_deque<E> array_deque<E>::clone(tca::allocator* allocator) const {
+        if (allocator == nullptr)
+            allocator = m_allocator;
+        array_deque<E> result(allocator);
+        result.reserve(m_size);
+        for (std::size_t i = 0; i < m_size; ++i)
+            result.add_last(m_data[slot(i)]);
+        return result;
+    }
+
+    template<typename E>
+    void array_deque<E>::realloc(std::size_t new_capacity) {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator is null");
+        )
+        assert(new_capacity >= m_size && (new_capacity & (new_capacity - 1)) == 0);
+
+        E* new_data = reinterpret_cast<E*>(m_allocator->allocate_align(sizeof(E) * new_capacity, alignof(E)));
+        if (new_data == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+
+        const std::size_t first = m_size < m_capacity - m_head ? m_size : m_capacity - m_head;
+        relocate(new_data, m_data + m_head, first);
+        relocate(new_data + first, m_data, m_size - first);
+
+        if (m_data != nullptr)
+            m_allocator->deallocate(m_data, sizeof(E) * m_capacity);
+        m_data      = new_data;
+        m_capacity  = new_capacity;
+        m_head      = 0;
+    }
+
+    template<typename E>
+    void array_deque<E>::ensure_capacity(std::size_t min_capacity) {
+        if (min_capacity <= m_capacity)
+            return;
+        std::size_t new_capacity = m_capacity > 0 ? m_capacity : DEFAULT_CAPACITY;
+        while (new_capacity < min_capacity)
+            new_capacity <<= 1;
+        realloc(new_capacity);
+    }
+
+    template<typename E>
+    void array_deque<E>::reserve(std::size_t new_capacity) {
+        if (new_capacity > m_capacity) {
+            std::size_t cap = 1;
+            while (cap < new_capacity)
+                cap <<= 1;
+            realloc(cap);
+        }
+    }
+
+    template<typename E>
+    void array_deque<E>::cleanup() {
+        clear();
+        if (m_data != nullptr && m_allocator != nullptr)
+            m_allocator->deallocate(m_data, sizeof(E) * m_capacity);
+        m_data      = nullptr;
+        m_capacity  = 0;
+        m_head      = 0;
+    }
+
+    template<typename E>
+    template<typename _E>
+    void array_deque<E>::add(_E&& e) {
+        add_last(std::forward<_E>(e));
+    }
+
+    template<typename E>
+    template<typename _E>
+    void array_deque<E>::add_last(_E&& e) {
+        ensure_capacity(m_size + 1);
+        new (m_data + slot(m_size)) E(std::forward<_E>(e));
+        ++m_size;
+    }
+
+    template<typename E>
+    template<typename _E>
+    void array_deque<E>::add_first(_E&& e) {
+        ensure_capacity(m_size + 1);
+        const std::size_t h = (m_head - 1) & (m_capacity - 1);
+        new (m_data + h) E(std::forward<_E>(e));
+        m_head = h;
+        ++m_size;
+    }
+
+    template<typename E>
+    void array_deque<E>::add_all(const E* src, std::size_t n) {
+        ensure_capacity(m_size + n);
+        for (std::size_t i = 0; i < n; ++i) {
+            new (m_data + slot(m_size)) E(src[i]);
+            ++m_size;
+        }
+    }
+
+    template<typename E>
+    void array_deque<E>::remove_first(E* ret) {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        E& e = m_data[m_head];
+        if (ret != nullptr)
+            *ret = std::move(e);
+        e.~E();
+        m_head = (m_head + 1) & (m_capacity - 1);
+        --m_size;
+    }
+
+    template<typename E>
+    void array_deque<E>::remove_last(E* ret) {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        E& e = m_data[slot(m_size - 1)];
+        if (ret != nullptr)
+            *ret = std::move(e);
+        e.~E();
+        --m_size;
+    }
+
+    template<typename E>
+    std::size_t array_deque<E>::drain_first(E* dst, std::size_t max) {
+        const std::size_t n = max < m_size ? max : m_size;
+        for (std::size_t i = 0; i < n; ++i) {
+            E& e = m_data[slot(i)];
+            dst[i] = std::move(e);
+            e.~E();
+        }
+        if (n != 0)
+            m_head = slot(n);
+        m_size -= n;
+        return n;
+    }
+
+    template<typename E>
+    template<typename _E>
+    void array_deque<E>::push(_E&& e) {
+        add_last(std::forward<_E>(e));
+    }
+
+    template<typename E>
+    void array_deque<E>::pop(E* ret) {
+        remove_last(ret);
+    }
+
+    template<typename E>
+    E& array_deque<E>::first() {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        return m_data[m_head];
+    }
+
+    template<typename E>
+    const E& array_deque<E>::first() const {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        return m_data[m_head];
+    }
+
+    template<typename E>
+    E& array_deque<E>::last() {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        return m_data[slot(m_size - 1)];
+    }
+
+    template<typename E>
+    const E& array_deque<E>::last() const {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        return m_data[slot(m_size - 1)];
+    }
+
+    template<typename E>
+    E& array_deque<E>::at(std::size_t idx) {
+        check_index(idx, m_size);
+        return m_data[slot(idx)];
+    }
+
+    template<typename E>
+    const E& array_deque<E>::at(std::size_t idx) const {
+        check_index(idx, m_size);
+        return m_data[slot(idx)];
+    }
+
+    template<typename E>
+    E* array_deque<E>::head_segment(std::size_t* len) {
+        const std::size_t to_end = m_capacity - m_head;
+        *len = m_size < to_end ? m_size : to_end;
+        return m_size != 0 ? m_data + m_head : nullptr;
+    }
+
+    template<typename E>
+    const E* array_deque<E>::head_segment(std::size_t* len) const {
+        return const_cast<array_deque<E>*>(this)->head_segment(len);
+    }
+
+    template<typename E>
+    E* array_deque<E>::tail_segment(std::size_t* len) {
+        const std::size_t to_end = m_capacity - m_head;
+        if (m_size <= to_end) {
+            *len = 0;
+            return nullptr;
+        }
+        *len = m_size - to_end;
+        return m_data;
+    }
+
+    template<typename E>
+    const E* array_deque<E>::tail_segment(std::size_t* len) const {
+        return const_cast<array_deque<E>*>(this)->tail_segment(len);
+    }
+
+    template<typename E>
+    void array_deque<E>::clear() {
+        for (std::size_t i = 0; i < m_size; ++i)
+            m_data[slot(i)].~E();
+        m_head = 0;
+        m_size = 0;
+    }
+
+    template<typename E>
+    std::size_t array_deque<E>::size() const {
+        return m_size;
+    }
+
+    template<typename E>
+    std::size_t array_deque<E>::capacity() const {
+        return m_capacity;
+    }
+
+    template<typename E>
+    bool array_deque<E>::is_empty() const {
+        return m_size == 0;
+    }
+
+    template<typename E>
+    tca::allocator* array_deque<E>::get_allocator() const {
+        return m_allocator;
+    }
+
+    template<typename E>
+    std::size_t array_deque<E>::index_of(const E& e) const {
+        //поиск по двум непрерывным сегментам кольцевого буфера
+        std::size_t head_len;
+        const E* head = head_segment(&head_len);
+        std::size_t idx = objects::index_of(head, head_len, e);
+        if (idx != head_len)
+            return idx;
+        std::size_t tail_len;
+        const E* tail = tail_segment(&tail_len);
+        idx = objects::index_of(tail, tail_len, e);
+        return idx != tail_len ? head_len + idx : null_val;
+    }
+
+    template<typename E>
+    int array_deque<E>::to_string(char buf[], std::size_t bufsize) const {
+        return std::snprintf(buf, bufsize, "[data=0x%llx, capacity=%lli, head=%lli, size=%lli]", (long long) m_data, (long long) m_capacity, (long long) m_head, (long long) m_size);
+    }
+
+    /**
+     * ==========================================================================================================================================
+     */
+    template<typename E>
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    array_deque<E>::iterator<DATA_TYPE, VALUE_TYPE>::iterator(DATA_TYPE* data, std::size_t mask, std::size_t head, std::size_t offset) :
+    m_data(data),
+    m_mask(mask),
+    m_head(head),
+    m_offset(offset) {
+
+    }
+
+    template<typename E>
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    VALUE_TYPE& array_deque<E>::iterator<DATA_TYPE, VALUE_TYPE>::operator*() const {
+        return m_data[(m_head + m_offset) & m_mask];
+    }
+
+    template<typename E>
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    typename array_deque<E>:: template iterator<DATA_TYPE, VALUE_TYPE>& array_deque<E>::iterator<DATA_TYPE, VALUE_TYPE>::operator++() {
+        ++m_offset;
+        return *this;
+    }
+
+    template<typename E>
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    typename array_deque<E>:: template iterator<DATA_TYPE, VALUE_TYPE> array_deque<E>::iterator<DATA_TYPE, VALUE_TYPE>::operator++(int) {
+        iterator<DATA_TYPE, VALUE_TYPE> it = *this;
+        ++m_offset;
+        return it;
+    }
+
+    template<typename E>
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    bool array_deque<E>::iterator<DATA_TYPE, VALUE_TYPE>::operator!=(const iterator<DATA_TYPE, VALUE_TYPE>& it) const {
+        return m_offset != it.m_offset;
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_ARRAY_DEQUE_H
@@ -6,6 +6,8 @@
 #include <cpp/lang/utils/hash.hpp>
 #include <cpp/lang/utils/comparator.hpp>
 #include <cpp/lang/utils/objects.hpp>
+#include <cpp/lang/utils/arrays.hpp>
+#include <cpp/lang/utils/sort.hpp>
 #include <cstdint>
 #include <utility>
 #include <initializer_list>
@@ -314,6 +316,16 @@ public:
      */
     std::size_t size() const;
 
+    /**
+     * Возвращает количество элементов, которое список вмещает без перераспределения.
+     */
+    std::size_t capacity() const;
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const;
+
     /**
      * Гарантирует, что список может вместить не менее {@code new_capacity} элементов без перераспределения.
      *
@@ -393,6 +405,29 @@ public:
     template<typename COMPARATOR_T = compare_to<E>>
     void intersect_sort();
 
+    /**
+     * Сортирует элементы списка (pattern-defeating quicksort, O(n log n) в худшем случае).
+     * Порядок равных элементов не сохраняется.
+     *
+     * @tparam COMPARATOR_T 
+     *      Тип компаратора, реализующего оператор {@code ()(const E&, const E&)}.
+     *
+     * @see utils::sort
+     */
+    template<typename COMPARATOR_T = compare_to<E>>
+    void sort();
+
+    /**
+     * Устойчиво сортирует элементы списка (сортировка слиянием).
+     *
+     * @param allocator
+     *      Аллокатор временного буфера. Если nullptr - используется аллокатор списка.
+     *
+     * @see utils::stable_sort
+     */
+    template<typename COMPARATOR_T = compare_to<E>>
+    void stable_sort(tca::allocator* allocator = nullptr);
+
     /**
      * Выполняет бинарный поиск заданного элемента в отсортированном списке.
      *
@@ -547,7 +582,7 @@ public:
                 return array_list<E>();
             allocator = m_allocator;
         }
-        array_list<E> list(allocator, m_size);
+        array_list<E> list(m_size, allocator);
         
         for (std::size_t i = 0; i < m_size; ++i) 
             list.add(m_data[i]);
@@ -600,6 +635,18 @@ public:
         }
     }
 
+    template<typename E>
+    template<typename COMPARATOR_T>
+    void array_list<E>::sort() {
+        utils::sort<E, COMPARATOR_T>(m_data, m_size);
+    }
+
+    template<typename E>
+    template<typename COMPARATOR_T>
+    void array_list<E>::stable_sort(tca::allocator* allocator) {
+        utils::stable_sort<E, COMPARATOR_T>(m_data, m_size, allocator != nullptr ? allocator : m_allocator);
+    }
+
     template<typename E>
     template<typename _E>
     bool array_list<E>::set(std::size_t idx, _E&& e, E* ret_old_value) {
@@ -612,7 +659,9 @@ public:
 
     template<typename E>
     void array_list<E>::grow() {
-        const std::size_t new_capacity = m_capacity > 0 ? m_capacity + (m_capacity >> 1) : DEFAULT_CAPACITY;
+        //При вместимости 1 прирост m_capacity >> 1 равен нулю, поэтому растём хотя бы на один элемент
+        const std::size_t step          = m_capacity >> 1;
+        const std::size_t new_capacity  = m_capacity > 0 ? m_capacity + (step > 0 ? step : 1) : DEFAULT_CAPACITY;
         reserve(new_capacity);
     }
 
@@ -621,6 +670,16 @@ public:
         return m_size;
     }
 
+    template<typename E>
+    std::size_t array_list<E>::capacity() const {
+        return m_capacity;
+    }
+
+    template<typename E>
+    tca::allocator* array_list<E>::get_allocator() const {
+        return m_allocator;
+    }
+
     template<typename E>
     E& array_list<E>::at(std::size_t idx) const {
         check_index(idx, m_size);
@@ -635,20 +694,14 @@ public:
 
     template<typename E>
     std::size_t array_list<E>::last_index_of(const E& e) const {
-        equal_to<E> equals;
-        for (std::size_t i = m_size; i > 0; --i)
-            if (equals(e, m_data[i - 1]))
-                return i - 1;
-        return array_list<E>::null_val;
+        const std::size_t idx = objects::last_index_of(m_data, m_size, e);
+        return idx != m_size ? idx : array_list<E>::null_val;
     }
 
     template<typename E>
     std::size_t array_list<E>::index_of(const E& e) const {
-        equal_to<E> equals;
-        for (std::size_t i = 0; i < m_size; ++i)
-            if (equals(e, m_data[i]))
-                return i;
-        return array_list<E>::null_val;
+        const std::size_t idx = objects::index_of(m_data, m_size, e);
+        return idx != m_size ? idx : array_list<E>::null_val;
     }
     
     template<typename E>
@@ -667,9 +720,7 @@ public:
             *ret = std::move(m_data[idx]);
 
         m_data[idx].~E();
-
-        for (std::size_t i = idx; i < m_size - 1; ++i)
-            new(m_data + i) E(std::move(m_data[i + 1]));
+        relocate(m_data + idx, m_data + idx + 1, m_size - idx - 1);
 
         --m_size;
         
@@ -710,10 +761,13 @@ public:
         if (m_size + 1 > m_capacity) 
             grow();
         
-        for (std::size_t i = m_size; i > idx; --i)
-            new(m_data + i) E(std::move(m_data[i - 1]));
-        
-        new(m_data + idx) E(std::forward<_E>(e));
+        relocate(m_data + idx + 1, m_data + idx, m_size - idx);
+        try {
+            new(m_data + idx) E(std::forward<_E>(e));
+        } catch (...) {
+            relocate(m_data + idx, m_data + idx + 1, m_size - idx);
+            throw;
+        }
         
         ++m_size;
     }
@@ -742,15 +796,11 @@ public:
             throw_except<out_of_memory_error>("Out of memory!");
         
         if (m_data != nullptr) {
-            if (new_capacity >= m_size) {
-                for (std::size_t i = 0; i < m_size; ++i)
-                    new(new_data + i) E(std::move(m_data[i]));
-            } else {
-                for (std::size_t i = 0; i < new_capacity; ++i)
-                    new(new_data + i) E(std::move(m_data[i]));
+            if (new_capacity < m_size) {
                 call_destructors(new_capacity, m_size);
                 m_size = new_capacity;
             }
+            relocate(new_data, m_data, m_size);
         }
     
         m_allocator->deallocate(m_data);
@@ -900,5 +950,13 @@ public:
     bool array_list<E>::iterator<DATA_TYPE, VALUE_TYPE>::operator!=(const iterator<DATA_TYPE, VALUE_TYPE>& it) const {
         return m_offset != it.m_offset;
     }
+
+    /**
+     * array_list не хранит указателей на себя, поэтому переносится побайтово.
+     */
+    template<typename E>
+    struct is_trivially_relocatable<array_list<E>> {
+        static const bool value = true;
+    };
 }
 #endif//JSTD_CPP_LANG_UTILS_ARRAY_LIST_H
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <cstring>
 #include <initializer_list>
 #include <cstdint>
+#include <new>
+#include <cpp/lang/utils/traits.hpp>
 
 #ifndef NDEBUG
     #include <cpp/lang/exceptions.hpp>
@@ -154,6 +156,53 @@ namespace jstd {
         }
     }
 
+    /**
+     * Переносит length объектов из src в неинициализированную память dst.
+     * После вызова объекты в src считаются разрушенными, а память под ними - неинициализированной.
+     *
+     * Диапазоны могут перекрываться, поэтому функция подходит и для сдвига элементов внутри одного массива.
+     * Для типов с is_trivially_relocatable весь диапазон переносится одним std::memmove,
+     * для остальных - конструктором перемещения и деструктором каждого объекта.
+     *
+     * @tparam T
+     *      Тип переносимых объектов. Конструктор перемещения не должен бросать исключений.
+     *
+     * @param dst
+     *      Неинициализированная память под length объектов.
+     *
+     * @param src
+     *      Переносимые объекты.
+     *
+     * @param length
+     *      Количество объектов.
+     */
+    template<typename T>
+    void relocate(T* dst, T* src, std::size_t length) {
+        if (length == 0 || dst == src)
+            return;
+        JSTD_DEBUG_CODE(
+            if (dst == nullptr)
+                throw_except<null_pointer_exception>("dst is null");
+            if (src == nullptr)
+                throw_except<null_pointer_exception>("src is null");
+        );
+        if (is_trivially_relocatable<T>::value) {
+            std::memmove((void*) dst, (const void*) src, sizeof(T) * length);
+            return;
+        }
+        if (dst < src) {
+            for (std::size_t i = 0; i < length; ++i) {
+                new (dst + i) T(std::move(src[i]));
+                src[i].~T();
+            }
+        } else {
+            for (std::size_t i = length; i > 0; --i) {
+                new (dst + i - 1) T(std::move(src[i - 1]));
+                src[i - 1].~T();
+            }
+        }
+    }
+
     template<typename T, typename E>
     void placement_copy(T* array, const std::initializer_list<E>& init_list) {
         JSTD_DEBUG_CODE(
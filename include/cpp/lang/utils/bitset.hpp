@@ -0,0 +1,1149 @@
+#ifndef JSTD_CPP_LANG_UTILS_BITSET_H
+#define JSTD_CPP_LANG_UTILS_BITSET_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/objects.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <iterator>
+
+namespace jstd
+{
+
+namespace internal
+{
+/**
+ * Операции над массивами 64-битных слов, общие для bitset и dynamic_bitset.
+ *
+ * Все функции рассчитывают на то, что неиспользуемые старшие биты последнего слова равны нулю.
+ * Подсчёт битов использует __builtin_popcountll, который превращается в инструкцию popcnt при сборке с -mpopcnt (или -march с её поддержкой).
+ */
+namespace bits
+{
+    typedef std::uint64_t word_t;
+
+    /**
+     * Количество бит в слове.
+     */
+    static const std::size_t WORD_BITS = 64;
+
+    /**
+     * Возвращаемое значение, если бит не найден.
+     */
+    static const std::size_t NONE = ~((std::size_t) 0);
+
+    /**
+     * Количество слов для хранения nbits бит.
+     */
+    inline std::size_t words_for(std::size_t nbits) {
+        return (nbits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    /**
+     * Маска используемых бит последнего слова.
+     */
+    inline word_t tail_mask(std::size_t nbits) {
+        std::size_t r = nbits % WORD_BITS;
+        return r == 0 ? ~word_t(0) : (word_t(1) << r) - 1;
+    }
+
+    inline word_t bit_mask(std::size_t idx) {
+        return word_t(1) << (idx % WORD_BITS);
+    }
+
+#if defined(JSTD_SIMD_AVX2)
+    typedef __m256i vec_t;
+
+    inline vec_t vload(const word_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    inline void vstore(word_t* p, vec_t v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+
+    inline bool vis_zero(vec_t v) {
+        return _mm256_testz_si256(v, v) != 0;
+    }
+#elif defined(JSTD_SIMD_SSE2)
+    typedef __m128i vec_t;
+
+    inline vec_t vload(const word_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    inline void vstore(word_t* p, vec_t v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+
+    inline bool vis_zero(vec_t v) {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF;
+    }
+#endif
+
+#if defined(JSTD_SIMD_SSE2)
+    /**
+     * Количество слов в векторном регистре.
+     */
+    static const std::size_t VEC_WORDS = sizeof(vec_t) / sizeof(word_t);
+#endif
+
+    enum op_kind {
+        OP_AND,
+        OP_OR,
+        OP_XOR,
+        OP_ANDNOT
+    };
+
+    /**
+     * Побитовая операция над словами и векторными регистрами.
+     * OP_ANDNOT вычисляет a & ~b.
+     */
+    template<op_kind OP>
+    struct word_op;
+
+    template<>
+    struct word_op<OP_AND> {
+        static word_t apply(word_t a, word_t b) { return a & b; }
+#if defined(JSTD_SIMD_AVX2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm256_and_si256(a, b); }
+#elif defined(JSTD_SIMD_SSE2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm_and_si128(a, b); }
+#endif
+    };
+
+    template<>
+    struct word_op<OP_OR> {
+        static word_t apply(word_t a, word_t b) { return a | b; }
+#if defined(JSTD_SIMD_AVX2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm256_or_si256(a, b); }
+#elif defined(JSTD_SIMD_SSE2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm_or_si128(a, b); }
+#endif
+    };
+
+    template<>
+    struct word_op<OP_XOR> {
+        static word_t apply(word_t a, word_t b) { return a ^ b; }
+#if defined(JSTD_SIMD_AVX2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm256_xor_si256(a, b); }
+#elif defined(JSTD_SIMD_SSE2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm_xor_si128(a, b); }
+#endif
+    };
+
+    template<>
+    struct word_op<OP_ANDNOT> {
+        static word_t apply(word_t a, word_t b) { return a & ~b; }
+#if defined(JSTD_SIMD_AVX2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm256_andnot_si256(b, a); }
+#elif defined(JSTD_SIMD_SSE2)
+        static vec_t apply(vec_t a, vec_t b) { return _mm_andnot_si128(b, a); }
+#endif
+    };
+
+    /**
+     * dst[i] = a[i] OP b[i]. dst может совпадать с a или b.
+     */
+    template<op_kind OP>
+    void apply(word_t* dst, const word_t* a, const word_t* b, std::size_t n) {
+        std::size_t i = 0;
+#if defined(JSTD_SIMD_SSE2)
+        for (; i + VEC_WORDS <= n; i += VEC_WORDS)
+            vstore(dst + i, word_op<OP>::apply(vload(a + i), vload(b + i)));
+#endif
+        for (; i < n; ++i)
+            dst[i] = word_op<OP>::apply(a[i], b[i]);
+    }
+
+    /**
+     * Возвращает true, если хотя бы одно слово a[i] OP b[i] не равно нулю.
+     */
+    template<op_kind OP>
+    bool any(const word_t* a, const word_t* b, std::size_t n) {
+        std::size_t i = 0;
+#if defined(JSTD_SIMD_SSE2)
+        for (; i + VEC_WORDS <= n; i += VEC_WORDS) {
+            if (!vis_zero(word_op<OP>::apply(vload(a + i), vload(b + i))))
+                return true;
+        }
+#endif
+        for (; i < n; ++i) {
+            if (word_op<OP>::apply(a[i], b[i]) != 0)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Количество установленных бит в a[i] OP b[i].
+     */
+    template<op_kind OP>
+    std::size_t count(const word_t* a, const word_t* b, std::size_t n) {
+        std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            c0 += simd::internal::popcount64(word_op<OP>::apply(a[i + 0], b[i + 0]));
+            c1 += simd::internal::popcount64(word_op<OP>::apply(a[i + 1], b[i + 1]));
+            c2 += simd::internal::popcount64(word_op<OP>::apply(a[i + 2], b[i + 2]));
+            c3 += simd::internal::popcount64(word_op<OP>::apply(a[i + 3], b[i + 3]));
+        }
+        for (; i < n; ++i)
+            c0 += simd::internal::popcount64(word_op<OP>::apply(a[i], b[i]));
+        return c0 + c1 + c2 + c3;
+    }
+
+    /**
+     * Количество установленных бит.
+     */
+    inline std::size_t count(const word_t* w, std::size_t n) {
+        std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            c0 += simd::internal::popcount64(w[i + 0]);
+            c1 += simd::internal::popcount64(w[i + 1]);
+            c2 += simd::internal::popcount64(w[i + 2]);
+            c3 += simd::internal::popcount64(w[i + 3]);
+        }
+        for (; i < n; ++i)
+            c0 += simd::internal::popcount64(w[i]);
+        return c0 + c1 + c2 + c3;
+    }
+
+    /**
+     * Возвращает true, если хотя бы один бит установлен.
+     */
+    inline bool any(const word_t* w, std::size_t n) {
+        std::size_t i = 0;
+#if defined(JSTD_SIMD_SSE2)
+        for (; i + VEC_WORDS <= n; i += VEC_WORDS) {
+            if (!vis_zero(vload(w + i)))
+                return true;
+        }
+#endif
+        for (; i < n; ++i) {
+            if (w[i] != 0)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Индекс первого установленного бита, не меньшего from, или NONE.
+     */
+    inline std::size_t find_next(const word_t* w, std::size_t n, std::size_t from) {
+        std::size_t i = from / WORD_BITS;
+        if (i >= n)
+            return NONE;
+        word_t x = w[i] & (~word_t(0) << (from % WORD_BITS));
+        while (x == 0) {
+            if (++i == n)
+                return NONE;
+            x = w[i];
+        }
+        return i * WORD_BITS + simd::internal::ctz64(x);
+    }
+
+    /**
+     * Индекс первого сброшенного бита из [from, nbits), или NONE.
+     */
+    inline std::size_t find_next_clear(const word_t* w, std::size_t nbits, std::size_t from) {
+        if (from >= nbits)
+            return NONE;
+        std::size_t n = words_for(nbits);
+        std::size_t i = from / WORD_BITS;
+        word_t x = ~w[i] & (~word_t(0) << (from % WORD_BITS));
+        while (x == 0) {
+            if (++i == n)
+                return NONE;
+            x = ~w[i];
+        }
+        std::size_t r = i * WORD_BITS + simd::internal::ctz64(x);
+        return r < nbits ? r : NONE;
+    }
+
+    /**
+     * Индекс последнего установленного бита, не большего from, или NONE. from < n * WORD_BITS.
+     */
+    inline std::size_t find_prev(const word_t* w, std::size_t from) {
+        std::size_t i = from / WORD_BITS;
+        word_t x = w[i] & (~word_t(0) >> (WORD_BITS - 1 - from % WORD_BITS));
+        while (x == 0) {
+            if (i == 0)
+                return NONE;
+            x = w[--i];
+        }
+        return i * WORD_BITS + simd::internal::bsr64(x);
+    }
+
+    /**
+     * Устанавливает или сбрасывает биты в диапазоне [from, to).
+     */
+    inline void fill_range(word_t* w, std::size_t from, std::size_t to, bool value) {
+        if (from >= to)
+            return;
+        std::size_t first = from / WORD_BITS;
+        std::size_t last  = (to - 1) / WORD_BITS;
+        word_t first_mask = ~word_t(0) << (from % WORD_BITS);
+        word_t last_mask  = ~word_t(0) >> (WORD_BITS - 1 - (to - 1) % WORD_BITS);
+        if (first == last)
+            first_mask &= last_mask;
+        if (value)
+            w[first] |= first_mask;
+        else
+            w[first] &= ~first_mask;
+        if (first == last)
+            return;
+        if (last > first + 1)
+            std::memset(w + first + 1, value ? 0xFF : 0, (last - first - 1) * sizeof(word_t));
+        if (value)
+            w[last] |= last_mask;
+        else
+            w[last] &= ~last_mask;
+    }
+
+    /**
+     * Инвертирует биты [0, nbits).
+     */
+    inline void flip_all(word_t* w, std::size_t nbits) {
+        std::size_t n = words_for(nbits);
+        for (std::size_t i = 0; i < n; ++i)
+            w[i] = ~w[i];
+        if (n != 0)
+            w[n - 1] &= tail_mask(nbits);
+    }
+
+    /**
+     * Вызывает func(idx) для каждого установленного бита в порядке возрастания.
+     */
+    template<typename FUNC>
+    void for_each_set(const word_t* w, std::size_t n, FUNC& func) {
+        for (std::size_t i = 0; i < n; ++i) {
+            word_t x = w[i];
+            while (x != 0) {
+                func(i * WORD_BITS + simd::internal::ctz64(x));
+                x &= x - 1;
+            }
+        }
+    }
+
+    /**
+     * Строковое представление в виде "[size=N, count=C]".
+     */
+    inline int to_string(const word_t* w, std::size_t nbits, char buf[], std::size_t bufsize) {
+        return std::snprintf(buf, bufsize, "[size=%lli, count=%lli]", (long long) nbits, (long long) count(w, words_for(nbits)));
+    }
+
+    /**
+     * Итератор по индексам установленных бит.
+     */
+    class set_bit_iterator {
+        const word_t* m_words;
+        std::size_t m_count;
+        std::size_t m_idx;
+        word_t m_cur;
+
+        void skip() {
+            while (m_cur == 0 && ++m_idx < m_count)
+                m_cur = m_words[m_idx];
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::size_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::size_t* pointer;
+        typedef std::size_t reference;
+
+        set_bit_iterator(const word_t* words, std::size_t count, std::size_t idx) :
+        m_words(words),
+        m_count(count),
+        m_idx(idx),
+        m_cur(idx < count ? words[idx] : 0) {
+            if (m_idx < m_count)
+                skip();
+        }
+
+        std::size_t operator*() const {
+            return m_idx * WORD_BITS + simd::internal::ctz64(m_cur);
+        }
+
+        set_bit_iterator& operator++() {
+            m_cur &= m_cur - 1;
+            skip();
+            return *this;
+        }
+
+        set_bit_iterator operator++(int) {
+            set_bit_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const set_bit_iterator& it) const {
+            return m_idx == it.m_idx && m_cur == it.m_cur;
+        }
+
+        bool operator!=(const set_bit_iterator& it) const {
+            return !(*this == it);
+        }
+    };
+}
+}
+
+/**
+ * Битовое множество фиксированного размера N, хранящееся внутри объекта.
+ *
+ * Биты упакованы в 64-битные слова. Операции над множествами (&=, |=, ^=, and_not) выполняются
+ * векторными инструкциями, подсчёт бит - инструкцией popcnt, поиск - через ctz/bsr по словам.
+ * Итерация (begin/end, for_each_set) перебирает индексы установленных бит.
+ *
+ * Проверка индексов выполняется только в отладочной сборке.
+ *
+ * @tparam N
+ *      Количество бит.
+ */
+template<std::size_t N>
+class bitset {
+    static_assert(N > 0, "Bitset size must be > 0");
+
+public:
+    typedef internal::bits::word_t word_t;
+
+    /**
+     * Итератор по индексам установленных бит.
+     */
+    typedef internal::bits::set_bit_iterator iterator;
+
+    /**
+     *
+     */
+    static const std::size_t null_val = internal::bits::NONE;
+
+    /**
+     * Количество слов в массиве бит.
+     */
+    static const std::size_t WORDS = (N + internal::bits::WORD_BITS - 1) / internal::bits::WORD_BITS;
+
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 64;
+
+private:
+    /**
+     * Слова с битами. Неиспользуемые биты последнего слова всегда равны нулю.
+     */
+    word_t m_words[WORDS];
+
+public:
+    /**
+     * Создаёт множество со всеми сброшенными битами.
+     */
+    bitset();
+
+    /**
+     * Возвращает значение бита idx.
+     */
+    bool get(std::size_t idx) const {
+        check_index(idx, N);
+        return (m_words[idx / internal::bits::WORD_BITS] & internal::bits::bit_mask(idx)) != 0;
+    }
+
+    /**
+     * Устанавливает бит idx.
+     */
+    void set(std::size_t idx) {
+        check_index(idx, N);
+        m_words[idx / internal::bits::WORD_BITS] |= internal::bits::bit_mask(idx);
+    }
+
+    /**
+     * Устанавливает бит idx в значение value.
+     */
+    void set(std::size_t idx, bool value) {
+        if (value)
+            set(idx);
+        else
+            reset(idx);
+    }
+
+    /**
+     * Сбрасывает бит idx.
+     */
+    void reset(std::size_t idx) {
+        check_index(idx, N);
+        m_words[idx / internal::bits::WORD_BITS] &= ~internal::bits::bit_mask(idx);
+    }
+
+    /**
+     * Инвертирует бит idx.
+     */
+    void flip(std::size_t idx) {
+        check_index(idx, N);
+        m_words[idx / internal::bits::WORD_BITS] ^= internal::bits::bit_mask(idx);
+    }
+
+    /**
+     * Устанавливает биты в диапазоне [from, to) в значение value.
+     *
+     * @throws index_out_of_bound_exception
+     *      Если from > to или to > N.
+     */
+    void set_range(std::size_t from, std::size_t to, bool value = true);
+
+    /**
+     * Устанавливает все биты.
+     */
+    void set_all();
+
+    /**
+     * Сбрасывает все биты.
+     */
+    void reset_all();
+
+    /**
+     * Инвертирует все биты.
+     */
+    void flip_all();
+
+    /**
+     * Количество бит в множестве.
+     */
+    std::size_t size() const {
+        return N;
+    }
+
+    /**
+     * Количество установленных бит.
+     */
+    std::size_t count() const;
+
+    /**
+     * Возвращает true, если хотя бы один бит установлен.
+     */
+    bool any() const;
+
+    /**
+     * Возвращает true, если ни один бит не установлен.
+     */
+    bool none() const {
+        return !any();
+    }
+
+    /**
+     * Возвращает true, если установлены все биты.
+     */
+    bool all() const;
+
+    /**
+     * Индекс первого установленного бита или null_val.
+     */
+    std::size_t find_first() const {
+        return internal::bits::find_next(m_words, WORDS, 0);
+    }
+
+    /**
+     * Индекс первого установленного бита, не меньшего from, или null_val.
+     */
+    std::size_t find_next(std::size_t from) const;
+
+    /**
+     * Индекс последнего установленного бита или null_val.
+     */
+    std::size_t find_last() const {
+        return internal::bits::find_prev(m_words, N - 1);
+    }
+
+    /**
+     * Индекс последнего установленного бита, не большего from, или null_val.
+     */
+    std::size_t find_prev(std::size_t from) const;
+
+    /**
+     * Индекс первого сброшенного бита, не меньшего from, или null_val.
+     */
+    std::size_t find_next_clear(std::size_t from = 0) const {
+        return internal::bits::find_next_clear(m_words, N, from);
+    }
+
+    /**
+     * Пересечение с other.
+     */
+    bitset<N>& operator&=(const bitset<N>& other);
+
+    /**
+     * Объединение с other.
+     */
+    bitset<N>& operator|=(const bitset<N>& other);
+
+    /**
+     * Симметрическая разность с other.
+     */
+    bitset<N>& operator^=(const bitset<N>& other);
+
+    /**
+     * Разность: сбрасывает биты, установленные в other.
+     */
+    bitset<N>& and_not(const bitset<N>& other);
+
+    /**
+     * Количество бит, установленных в обоих множествах. Пересечение не материализуется.
+     */
+    std::size_t and_count(const bitset<N>& other) const;
+
+    /**
+     * Возвращает true, если множества пересекаются.
+     */
+    bool intersects(const bitset<N>& other) const;
+
+    /**
+     * Возвращает true, если все установленные биты этого множества установлены и в other.
+     */
+    bool is_subset_of(const bitset<N>& other) const;
+
+    /**
+     * Вызывает func(idx) для каждого установленного бита в порядке возрастания.
+     */
+    template<typename FUNC>
+    void for_each_set(FUNC func) const {
+        internal::bits::for_each_set(m_words, WORDS, func);
+    }
+
+    /**
+     *
+     */
+    bool equals(const bitset<N>& other) const;
+
+    /**
+     *
+     */
+    std::size_t hashcode() const;
+
+    /**
+     * Записывает строковое представление множества в буфер.
+     */
+    int to_string(char buf[], std::size_t bufsize) const;
+
+    /**
+     * Возвращает указатель на слова с битами.
+     */
+    word_t* data() {
+        return m_words;
+    }
+
+    /**
+     * Возвращает указатель на слова с битами. (Константная версия)
+     */
+    const word_t* data() const {
+        return m_words;
+    }
+
+    /**
+     * Количество слов в массиве бит.
+     */
+    std::size_t word_count() const {
+        return WORDS;
+    }
+
+    iterator begin() const {
+        return iterator(m_words, WORDS, 0);
+    }
+
+    iterator end() const {
+        return iterator(m_words, WORDS, WORDS);
+    }
+};
+
+/**
+ * Битовое множество изменяемого размера, хранящееся в памяти аллокатора.
+ *
+ * Поддерживает те же операции, что и bitset. Бинарные операции требуют, чтобы множества имели одинаковый размер.
+ * При изменении размера новые биты получают заданное значение.
+ *
+ * Проверка индексов в get/set/reset/flip выполняется только в отладочной сборке.
+ */
+class dynamic_bitset {
+public:
+    typedef internal::bits::word_t word_t;
+
+    /**
+     * Итератор по индексам установленных бит.
+     */
+    typedef internal::bits::set_bit_iterator iterator;
+
+    /**
+     *
+     */
+    static const std::size_t null_val = internal::bits::NONE;
+
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 64;
+
+private:
+    /**
+     * Указатель на пользовательский аллокатор памяти.
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     * Слова с битами. Неиспользуемые биты последнего слова всегда равны нулю.
+     */
+    word_t* m_words;
+
+    /**
+     * Количество бит.
+     */
+    std::size_t m_size;
+
+    /**
+     * Вместимость в словах.
+     */
+    std::size_t m_capacity;
+
+    /**
+     * Освобождает память и обнуляет размер.
+     */
+    void cleanup();
+
+    /**
+     * Количество используемых слов.
+     */
+    std::size_t words() const {
+        return internal::bits::words_for(m_size);
+    }
+
+    /**
+     * Проверяет, что множества имеют одинаковый размер.
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры различаются.
+     */
+    void check_same_size(const dynamic_bitset& other) const;
+
+public:
+    /**
+     * Создаёт пустое множество.
+     */
+    dynamic_bitset(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт множество из size сброшенных бит.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    explicit dynamic_bitset(std::size_t size, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    dynamic_bitset(const dynamic_bitset& other);
+
+    /**
+     *
+     */
+    dynamic_bitset(dynamic_bitset&& other);
+
+    /**
+     *
+     */
+    dynamic_bitset& operator=(const dynamic_bitset& other);
+
+    /**
+     *
+     */
+    dynamic_bitset& operator=(dynamic_bitset&& other);
+
+    /**
+     * Создаёт копию множества.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего множества.
+     */
+    dynamic_bitset clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     *
+     */
+    ~dynamic_bitset();
+
+    /**
+     * @see bitset::get
+     */
+    bool get(std::size_t idx) const {
+        check_index(idx, m_size);
+        return (m_words[idx / internal::bits::WORD_BITS] & internal::bits::bit_mask(idx)) != 0;
+    }
+
+    /**
+     * @see bitset::set
+     */
+    void set(std::size_t idx) {
+        check_index(idx, m_size);
+        m_words[idx / internal::bits::WORD_BITS] |= internal::bits::bit_mask(idx);
+    }
+
+    /**
+     * @see bitset::set
+     */
+    void set(std::size_t idx, bool value) {
+        if (value)
+            set(idx);
+        else
+            reset(idx);
+    }
+
+    /**
+     * @see bitset::reset
+     */
+    void reset(std::size_t idx) {
+        check_index(idx, m_size);
+        m_words[idx / internal::bits::WORD_BITS] &= ~internal::bits::bit_mask(idx);
+    }
+
+    /**
+     * @see bitset::flip
+     */
+    void flip(std::size_t idx) {
+        check_index(idx, m_size);
+        m_words[idx / internal::bits::WORD_BITS] ^= internal::bits::bit_mask(idx);
+    }
+
+    /**
+     * @see bitset::set_range
+     */
+    void set_range(std::size_t from, std::size_t to, bool value = true);
+
+    /**
+     * @see bitset::set_all
+     */
+    void set_all();
+
+    /**
+     * @see bitset::reset_all
+     */
+    void reset_all();
+
+    /**
+     * @see bitset::flip_all
+     */
+    void flip_all();
+
+    /**
+     * Изменяет количество бит. Новые биты получают значение value.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    void resize(std::size_t new_size, bool value = false);
+
+    /**
+     * Гарантирует, что множество может вырасти до {@code new_capacity} бит без перераспределения.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * Количество бит в множестве.
+     */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+     * Количество бит, которое множество вмещает без перераспределения.
+     */
+    std::size_t capacity() const {
+        return m_capacity * internal::bits::WORD_BITS;
+    }
+
+    /**
+     * Возвращает true, если размер множества равен нулю.
+     */
+    bool is_empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     * @see bitset::count
+     */
+    std::size_t count() const;
+
+    /**
+     * @see bitset::any
+     */
+    bool any() const;
+
+    /**
+     * @see bitset::none
+     */
+    bool none() const {
+        return !any();
+    }
+
+    /**
+     * @see bitset::all
+     */
+    bool all() const;
+
+    /**
+     * @see bitset::find_first
+     */
+    std::size_t find_first() const {
+        return internal::bits::find_next(m_words, words(), 0);
+    }
+
+    /**
+     * @see bitset::find_next
+     */
+    std::size_t find_next(std::size_t from) const;
+
+    /**
+     * @see bitset::find_last
+     */
+    std::size_t find_last() const;
+
+    /**
+     * @see bitset::find_prev
+     */
+    std::size_t find_prev(std::size_t from) const;
+
+    /**
+     * @see bitset::find_next_clear
+     */
+    std::size_t find_next_clear(std::size_t from = 0) const {
+        return internal::bits::find_next_clear(m_words, m_size, from);
+    }
+
+    /**
+     * @see bitset::operator&=
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    dynamic_bitset& operator&=(const dynamic_bitset& other);
+
+    /**
+     * @see bitset::operator|=
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    dynamic_bitset& operator|=(const dynamic_bitset& other);
+
+    /**
+     * @see bitset::operator^=
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    dynamic_bitset& operator^=(const dynamic_bitset& other);
+
+    /**
+     * @see bitset::and_not
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    dynamic_bitset& and_not(const dynamic_bitset& other);
+
+    /**
+     * @see bitset::and_count
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    std::size_t and_count(const dynamic_bitset& other) const;
+
+    /**
+     * @see bitset::intersects
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    bool intersects(const dynamic_bitset& other) const;
+
+    /**
+     * @see bitset::is_subset_of
+     *
+     * @throws illegal_argument_exception
+     *      Если размеры множеств различаются.
+     */
+    bool is_subset_of(const dynamic_bitset& other) const;
+
+    /**
+     * @see bitset::for_each_set
+     */
+    template<typename FUNC>
+    void for_each_set(FUNC func) const {
+        internal::bits::for_each_set(m_words, words(), func);
+    }
+
+    /**
+     * Множества равны, если равны их размеры и значения всех бит.
+     */
+    bool equals(const dynamic_bitset& other) const;
+
+    /**
+     *
+     */
+    std::size_t hashcode() const;
+
+    /**
+     * @see bitset::to_string
+     */
+    int to_string(char buf[], std::size_t bufsize) const;
+
+    /**
+     * @see bitset::data
+     */
+    word_t* data() {
+        return m_words;
+    }
+
+    /**
+     * @see bitset::data
+     */
+    const word_t* data() const {
+        return m_words;
+    }
+
+    /**
+     * @see bitset::word_count
+     */
+    std::size_t word_count() const {
+        return words();
+    }
+
+    iterator begin() const {
+        return iterator(m_words, words(), 0);
+    }
+
+    iterator end() const {
+        std::size_t n = words();
+        return iterator(m_words, n, n);
+    }
+};
+
+    template<std::size_t N>
+    bitset<N>::bitset() {
+        reset_all();
+    }
+
+    template<std::size_t N>
+    void bitset<N>::set_range(std::size_t from, std::size_t to, bool value) {
+        if (from > to || to > N)
+            throw_except<index_out_of_bound_exception>("Range [%zu, %zu) out of bound for length %zu!", from, to, N);
+        internal::bits::fill_range(m_words, from, to, value);
+    }
+
+    template<std::size_t N>
+    void bitset<N>::set_all() {
+        std::memset(m_words, 0xFF, sizeof(m_words));
+        m_words[WORDS - 1] &= internal::bits::tail_mask(N);
+    }
+
+    template<std::size_t N>
+    void bitset<N>::reset_all() {
+        std::memset(m_words, 0, sizeof(m_words));
+    }
+
+    template<std::size_t N>
+    void bitset<N>::flip_all() {
+        internal::bits::flip_all(m_words, N);
+    }
+
+    template<std::size_t N>
+    std::size_t bitset<N>::count() const {
+        return internal::bits::count(m_words, WORDS);
+    }
+
+    template<std::size_t N>
+    bool bitset<N>::any() const {
+        return internal::bits::any(m_words, WORDS);
+    }
+
+    template<std::size_t N>
+    bool bitset<N>::all() const {
+        return internal::bits::find_next_clear(m_words, N, 0) == null_val;
+    }
+
+    template<std::size_t N>
+    std::size_t bitset<N>::find_next(std::size_t from) const {
+        if (from >= N)
+            return null_val;
+        return internal::bits::find_next(m_words, WORDS, from);
+    }
+
+    template<std::size_t N>
+    std::size_t bitset<N>::find_prev(std::size_t from) const {
+        if (from >= N)
+            from = N - 1;
+        return internal::bits::find_prev(m_words, from);
+    }
+
+    template<std::size_t N>
+    bitset<N>& bitset<N>::operator&=(const bitset<N>& other) {
+        internal::bits::apply<internal::bits::OP_AND>(m_words, m_words, other.m_words, WORDS);
+        return *this;
+    }
+
+    template<std::size_t N>
+    bitset<N>& bitset<N>::operator|=(const bitset<N>& other) {
+        internal::bits::apply<internal::bits::OP_OR>(m_words, m_words, other.m_words, WORDS);
+        return *this;
+    }
+
+    template<std::size_t N>
+    bitset<N>& bitset<N>::operator^=(const bitset<N>& other) {
+        internal::bits::apply<internal::bits::OP_XOR>(m_words, m_words, other.m_words, WORDS);
+        return *this;
+    }
+
+    template<std::size_t N>
+    bitset<N>& bitset<N>::and_not(const bitset<N>& other) {
+        internal::bits::apply<internal::bits::OP_ANDNOT>(m_words, m_words, other.m_words, WORDS);
+        return *this;
+    }
+
+    template<std::size_t N>
+    std::size_t bitset<N>::and_count(const bitset<N>& other) const {
+        return internal::bits::count<internal::bits::OP_AND>(m_words, other.m_words, WORDS);
+    }
+
+    template<std::size_t N>
+    bool bitset<N>::intersects(const bitset<N>& other) const {
+        return internal::bits::any<internal::bits::OP_AND>(m_words, other.m_words, WORDS);
+    }
+
+    template<std::size_t N>
+    bool bitset<N>::is_subset_of(const bitset<N>& other) const {
+        return !internal::bits::any<internal::bits::OP_ANDNOT>(m_words, other.m_words, WORDS);
+    }
+
+    template<std::size_t N>
+    bool bitset<N>::equals(const bitset<N>& other) const {
+        return std::memcmp(m_words, other.m_words, sizeof(m_words)) == 0;
+    }
+
+    template<std::size_t N>
+    std::size_t bitset<N>::hashcode() const {
+        return objects::hashcode(m_words, WORDS);
+    }
+
+    template<std::size_t N>
+    int bitset<N>::to_string(char buf[], std::size_t bufsize) const {
+        return internal::bits::to_string(m_words, N, buf, bufsize);
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_BITSET_H
@@ -0,0 +1,523 @@
+#ifndef JSTD_CPP_LANG_UTILS_BLOOM_FILTER_H
+#define JSTD_CPP_LANG_UTILS_BLOOM_FILTER_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/io/bytebuffer.hpp>
+#include <cpp/lang/utils/hash.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+namespace jstd
+{
+
+namespace internal
+{
+/**
+ * Блок фильтра Блума - 512 бит (одна кэш-линия) из 8 слов по 64 бита.
+ * Ключ устанавливает ровно по одному биту в каждом слове блока, номер бита в слове i равен (h * SALT[i]) >> 26.
+ */
+namespace bloom
+{
+    static const std::size_t BLOCK_WORDS = 8;
+    static const std::size_t BLOCK_BYTES = BLOCK_WORDS * sizeof(std::uint64_t);
+
+    /**
+     * Количество ключей, для которых блоки вычисляются и предзагружаются заранее в пакетных операциях.
+     */
+    static const std::size_t BATCH = 16;
+
+    static const std::uint32_t SALT[BLOCK_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+    };
+
+    /**
+     * Сигнатура сериализованного фильтра ("JBF1").
+     */
+    static const std::uint32_t MAGIC = 0x3146424AU;
+
+#if defined(JSTD_SIMD_AVX2)
+    /**
+     * Маски для слов 0..3 и 4..7 блока.
+     */
+    inline void make_mask(std::uint32_t h, __m256i& lo, __m256i& hi) {
+        const __m256i salt = _mm256_setr_epi32((int) SALT[0], (int) SALT[1], (int) SALT[2], (int) SALT[3],
+                                               (int) SALT[4], (int) SALT[5], (int) SALT[6], (int) SALT[7]);
+        __m256i idx  = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int) h), salt), 26);
+        __m256i ones = _mm256_set1_epi64x(1);
+        lo = _mm256_sllv_epi64(ones, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(idx)));
+        hi = _mm256_sllv_epi64(ones, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(idx, 1)));
+    }
+#endif
+
+    /**
+     * Устанавливает биты ключа с хэшем h в блоке. Блок выровнен на BLOCK_BYTES.
+     */
+    inline void insert(std::uint64_t* block, std::uint32_t h) {
+#if defined(JSTD_SIMD_AVX2)
+        __m256i lo, hi;
+        make_mask(h, lo, hi);
+        __m256i* p = reinterpret_cast<__m256i*>(block);
+        _mm256_store_si256(p,     _mm256_or_si256(_mm256_load_si256(p),     lo));
+        _mm256_store_si256(p + 1, _mm256_or_si256(_mm256_load_si256(p + 1), hi));
+#else
+        for (std::size_t i = 0; i < BLOCK_WORDS; ++i)
+            block[i] |= std::uint64_t(1) << ((h * SALT[i]) >> 26);
+#endif
+    }
+
+    /**
+     * Проверяет, установлены ли все биты ключа с хэшем h в блоке.
+     */
+    inline bool contains(const std::uint64_t* block, std::uint32_t h) {
+#if defined(JSTD_SIMD_AVX2)
+        __m256i lo, hi;
+        make_mask(h, lo, hi);
+        const __m256i* p = reinterpret_cast<const __m256i*>(block);
+        return _mm256_testc_si256(_mm256_load_si256(p), lo) & _mm256_testc_si256(_mm256_load_si256(p + 1), hi);
+#else
+        std::uint64_t miss = 0;
+        for (std::size_t i = 0; i < BLOCK_WORDS; ++i)
+            miss |= ~block[i] & (std::uint64_t(1) << ((h * SALT[i]) >> 26));
+        return miss == 0;
+#endif
+    }
+
+    inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void) p;
+#endif
+    }
+}
+}
+
+/**
+ * Блочный фильтр Блума.
+ *
+ * Вероятностное множество без ложноотрицательных ответов: might_contain возвращает false только для ключей,
+ * которые никогда не добавлялись. Каждый ключ затрагивает один блок размером с кэш-линию,
+ * поэтому добавление и проверка стоят одного промаха кэша. При сборке с AVX2 маска блока
+ * строится и проверяется векторными инструкциями.
+ *
+ * Хэш-код ключа берётся из HASH и перемешивается mix_hash, так что подходит и hash_for примитивных типов.
+ * Старшие 32 бита выбирают блок, младшие - биты внутри блока.
+ *
+ * @tparam T
+ *      Тип ключей.
+ *
+ * @tparam HASH
+ *      Функтор хэш-кода.
+ */
+template<typename T, typename HASH = hash_for<T>>
+class bloom_filter {
+    /**
+     * Указатель на пользовательский аллокатор памяти.
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     * Блоки фильтра, выровненные на размер блока.
+     */
+    std::uint64_t* m_words;
+
+    /**
+     * Количество блоков.
+     */
+    std::size_t m_blocks;
+
+    /**
+     * Функтор хэш-кода.
+     */
+    HASH m_hash;
+
+    /**
+     * Создаёт фильтр из blocks пустых блоков.
+     */
+    bloom_filter(std::size_t blocks, tca::allocator* allocator, const HASH& hash, int);
+
+    /**
+     * Выделяет память под blocks блоков и обнуляет её.
+     */
+    void init(std::size_t blocks);
+
+    /**
+     * Освобождает память.
+     */
+    void cleanup();
+
+    std::uint64_t hash_of(const T& key) const {
+        return mix_hash((std::uint64_t) m_hash(key));
+    }
+
+    /**
+     * Проверяет, что у фильтра есть блоки (фильтр не перемещён).
+     *
+     * @throws illegal_state_exception
+     *      В отладочной сборке, если блоков нет.
+     */
+    bool check_blocks() const {
+        JSTD_DEBUG_CODE(
+            if (m_blocks == 0)
+                throw_except<illegal_state_exception>("bloom_filter has no blocks (moved-from)");
+        );
+        return m_blocks != 0;
+    }
+
+    std::uint64_t* block_of(std::uint64_t h) const {
+        return m_words + (((h >> 32) * (std::uint64_t) m_blocks) >> 32) * internal::bloom::BLOCK_WORDS;
+    }
+
+public:
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 64;
+
+    /**
+     * Количество блоков, при котором фильтр из expected_count ключей даёт примерно fpp ложноположительных ответов.
+     *
+     * @throws illegal_argument_exception
+     *      Если fpp не лежит в интервале (0, 1).
+     */
+    static std::size_t optimal_blocks(std::size_t expected_count, double fpp);
+
+    /**
+     * Создаёт фильтр, рассчитанный на expected_count ключей с долей ложноположительных ответов около fpp.
+     *
+     * @throws illegal_argument_exception
+     *      Если fpp не лежит в интервале (0, 1).
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    explicit bloom_filter(std::size_t expected_count, double fpp = 0.01, tca::allocator* allocator = tca::get_default_allocator(), const HASH& hash = HASH());
+
+    /**
+     *
+     */
+    bloom_filter(const bloom_filter<T, HASH>& filter);
+
+    /**
+     *
+     */
+    bloom_filter(bloom_filter<T, HASH>&& filter);
+
+    /**
+     *
+     */
+    bloom_filter<T, HASH>& operator=(const bloom_filter<T, HASH>& filter);
+
+    /**
+     *
+     */
+    bloom_filter<T, HASH>& operator=(bloom_filter<T, HASH>&& filter);
+
+    /**
+     * Создаёт копию фильтра.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего фильтра.
+     */
+    bloom_filter<T, HASH> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     *
+     */
+    ~bloom_filter();
+
+    /**
+     * Добавляет ключ в фильтр.
+     *
+     * @throws illegal_state_exception
+     *      В отладочной сборке, если фильтр перемещён. В обычной сборке ключ не добавляется.
+     */
+    void add(const T& key) {
+        if (!check_blocks())
+            return;
+        std::uint64_t h = hash_of(key);
+        internal::bloom::insert(block_of(h), (std::uint32_t) h);
+    }
+
+    /**
+     * Добавляет len ключей. Блоки очередной пачки ключей предзагружаются до записи,
+     * поэтому промахи кэша перекрываются.
+     */
+    void add_all(const T* keys, std::size_t len);
+
+    /**
+     * Возвращает false, если ключ точно не добавлялся, и true, если ключ, возможно, добавлялся.
+     * Перемещённый фильтр не содержит ключей.
+     */
+    bool might_contain(const T& key) const {
+        if (m_blocks == 0)
+            return false;
+        std::uint64_t h = hash_of(key);
+        return internal::bloom::contains(block_of(h), (std::uint32_t) h);
+    }
+
+    /**
+     * Проверяет len ключей, записывая результаты might_contain в result.
+     *
+     * @return
+     *      Количество ключей, которые, возможно, есть в фильтре.
+     */
+    std::size_t might_contain_all(const T* keys, std::size_t len, bool* result) const;
+
+    /**
+     * Объединяет фильтр с other: результат отвечает true для ключей из любого из двух фильтров.
+     *
+     * @throws illegal_argument_exception
+     *      Если у фильтров разное количество блоков.
+     */
+    void merge(const bloom_filter<T, HASH>& other);
+
+    /**
+     * Удаляет все ключи.
+     */
+    void clear();
+
+    /**
+     * Количество блоков.
+     */
+    std::size_t block_count() const {
+        return m_blocks;
+    }
+
+    /**
+     * Размер битового массива в байтах.
+     */
+    std::size_t size_in_bytes() const {
+        return m_blocks * internal::bloom::BLOCK_BYTES;
+    }
+
+    /**
+     * Количество байт, которое запишет write.
+     */
+    std::size_t serialized_size() const {
+        return sizeof(std::uint32_t) + sizeof(std::uint64_t) + size_in_bytes();
+    }
+
+    /**
+     * Записывает фильтр в буфер, начиная с текущей позиции, в порядке байт буфера.
+     *
+     * @throws index_out_of_bound_exception
+     *      Если в буфере меньше serialized_size() байт.
+     */
+    void write(byte_buffer& buf) const;
+
+    /**
+     * Читает фильтр, записанный write, начиная с текущей позиции буфера.
+     *
+     * @throws invalid_data_format_exception
+     *      Если данные не являются сериализованным фильтром Блума.
+     */
+    static bloom_filter<T, HASH> read(byte_buffer& buf, tca::allocator* allocator = tca::get_default_allocator(), const HASH& hash = HASH());
+
+    /**
+     * Записывает строковое представление фильтра в буфер.
+     */
+    int to_string(char buf[], std::size_t bufsize) const;
+};
+
+    template<typename T, typename HASH>
+    std::size_t bloom_filter<T, HASH>::optimal_blocks(std::size_t expected_count, double fpp) {
+        if (!(fpp > 0.0 && fpp < 1.0))
+            throw_except<illegal_argument_exception>("fpp must be in (0, 1)");
+        // Оптимум классического фильтра -ln(p) / ln(2)^2 бит на ключ, плюс 20% на неравномерную загрузку блоков.
+        const double bits_per_key = -std::log(fpp) / (0.6931471805599453 * 0.6931471805599453) * 1.2;
+        const double bits = bits_per_key * (double) (expected_count > 0 ? expected_count : 1);
+        const double blocks = std::ceil(bits / (double) (internal::bloom::BLOCK_BYTES * 8));
+        return blocks < 1.0 ? 1 : (std::size_t) blocks;
+    }
+
+    template<typename T, typename HASH>
+    void bloom_filter<T, HASH>::init(std::size_t blocks) {
+        JSTD_DEBUG_CODE(
+            check_non_null(m_allocator);
+        );
+        void* words = m_allocator->allocate_align(blocks * internal::bloom::BLOCK_BYTES, internal::bloom::BLOCK_BYTES);
+        if (words == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        std::memset(words, 0, blocks * internal::bloom::BLOCK_BYTES);
+        m_words  = static_cast<std::uint64_t*>(words);
+        m_blocks = blocks;
+    }
+
+    template<typename T, typename HASH>
+    void bloom_filter<T, HASH>::cleanup() {
+        if (m_allocator != nullptr && m_words != nullptr)
+            m_allocator->deallocate(m_words);
+        m_words  = nullptr;
+        m_blocks = 0;
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>::bloom_filter(std::size_t expected_count, double fpp, tca::allocator* allocator, const HASH& hash) :
+    m_allocator(allocator),
+    m_words(nullptr),
+    m_blocks(0),
+    m_hash(hash) {
+        init(optimal_blocks(expected_count, fpp));
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>::bloom_filter(std::size_t blocks, tca::allocator* allocator, const HASH& hash, int) :
+    m_allocator(allocator),
+    m_words(nullptr),
+    m_blocks(0),
+    m_hash(hash) {
+        init(blocks);
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>::bloom_filter(const bloom_filter<T, HASH>& filter) :
+    m_allocator(filter.m_allocator),
+    m_words(nullptr),
+    m_blocks(0),
+    m_hash(filter.m_hash) {
+        if (filter.m_words != nullptr) {
+            init(filter.m_blocks);
+            std::memcpy(m_words, filter.m_words, size_in_bytes());
+        }
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>::bloom_filter(bloom_filter<T, HASH>&& filter) :
+    m_allocator(filter.m_allocator),
+    m_words(filter.m_words),
+    m_blocks(filter.m_blocks),
+    m_hash(std::move(filter.m_hash)) {
+        filter.m_words  = nullptr;
+        filter.m_blocks = 0;
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>& bloom_filter<T, HASH>::operator=(const bloom_filter<T, HASH>& filter) {
+        if (&filter != this) {
+            bloom_filter<T, HASH> tmp = filter.clone(m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>& bloom_filter<T, HASH>::operator=(bloom_filter<T, HASH>&& filter) {
+        if (&filter != this) {
+            cleanup();
+            m_allocator = filter.m_allocator;
+            m_words     = filter.m_words;
+            m_blocks    = filter.m_blocks;
+            m_hash      = std::move(filter.m_hash);
+            filter.m_words  = nullptr;
+            filter.m_blocks = 0;
+        }
+        return *this;
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH> bloom_filter<T, HASH>::clone(tca::allocator* allocator) const {
+        if (allocator == nullptr)
+            allocator = m_allocator;
+        bloom_filter<T, HASH> copy(m_blocks, allocator, m_hash, 0);
+        std::memcpy(copy.m_words, m_words, size_in_bytes());
+        return copy;
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH>::~bloom_filter() {
+        cleanup();
+    }
+
+    template<typename T, typename HASH>
+    void bloom_filter<T, HASH>::add_all(const T* keys, std::size_t len) {
+        if (!check_blocks())
+            return;
+        std::uint64_t hashes[internal::bloom::BATCH];
+        for (std::size_t start = 0; start < len; start += internal::bloom::BATCH) {
+            const std::size_t n = len - start < internal::bloom::BATCH ? len - start : internal::bloom::BATCH;
+            for (std::size_t i = 0; i < n; ++i) {
+                hashes[i] = hash_of(keys[start + i]);
+                internal::bloom::prefetch(block_of(hashes[i]));
+            }
+            for (std::size_t i = 0; i < n; ++i)
+                internal::bloom::insert(block_of(hashes[i]), (std::uint32_t) hashes[i]);
+        }
+    }
+
+    template<typename T, typename HASH>
+    std::size_t bloom_filter<T, HASH>::might_contain_all(const T* keys, std::size_t len, bool* result) const {
+        if (m_blocks == 0) {
+            for (std::size_t i = 0; i < len; ++i)
+                result[i] = false;
+            return 0;
+        }
+        std::uint64_t hashes[internal::bloom::BATCH];
+        std::size_t found = 0;
+        for (std::size_t start = 0; start < len; start += internal::bloom::BATCH) {
+            const std::size_t n = len - start < internal::bloom::BATCH ? len - start : internal::bloom::BATCH;
+            for (std::size_t i = 0; i < n; ++i) {
+                hashes[i] = hash_of(keys[start + i]);
+                internal::bloom::prefetch(block_of(hashes[i]));
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                bool hit = internal::bloom::contains(block_of(hashes[i]), (std::uint32_t) hashes[i]);
+                result[start + i] = hit;
+                found += hit;
+            }
+        }
+        return found;
+    }
+
+    template<typename T, typename HASH>
+    void bloom_filter<T, HASH>::merge(const bloom_filter<T, HASH>& other) {
+        if (other.m_blocks != m_blocks)
+            throw_except<illegal_argument_exception>("Bloom filters have different sizes: %zu and %zu blocks!", m_blocks, other.m_blocks);
+        const std::size_t n = m_blocks * internal::bloom::BLOCK_WORDS;
+        for (std::size_t i = 0; i < n; ++i)
+            m_words[i] |= other.m_words[i];
+    }
+
+    template<typename T, typename HASH>
+    void bloom_filter<T, HASH>::clear() {
+        if (m_words != nullptr)
+            std::memset(m_words, 0, size_in_bytes());
+    }
+
+    template<typename T, typename HASH>
+    void bloom_filter<T, HASH>::write(byte_buffer& buf) const {
+        if (buf.remaining() < serialized_size())
+            throw_except<index_out_of_bound_exception>("Remaining %zu < %zu", buf.remaining(), serialized_size());
+        buf.put<std::uint32_t>(internal::bloom::MAGIC);
+        buf.put<std::uint64_t>((std::uint64_t) m_blocks);
+        buf.puts<std::uint64_t>(m_words, m_blocks * internal::bloom::BLOCK_WORDS);
+    }
+
+    template<typename T, typename HASH>
+    bloom_filter<T, HASH> bloom_filter<T, HASH>::read(byte_buffer& buf, tca::allocator* allocator, const HASH& hash) {
+        if (buf.remaining() < sizeof(std::uint32_t) + sizeof(std::uint64_t))
+            throw_except<invalid_data_format_exception>("Truncated bloom filter data!");
+        if (buf.get<std::uint32_t>() != internal::bloom::MAGIC)
+            throw_except<invalid_data_format_exception>("Invalid bloom filter signature!");
+        const std::uint64_t blocks = buf.get<std::uint64_t>();
+        if (blocks == 0 || blocks > buf.remaining() / internal::bloom::BLOCK_BYTES)
+            throw_except<invalid_data_format_exception>("Invalid bloom filter size: %llu blocks!", (unsigned long long) blocks);
+
+        bloom_filter<T, HASH> filter((std::size_t) blocks, allocator, hash, 0);
+        buf.gets<std::uint64_t>(filter.m_words, filter.m_blocks * internal::bloom::BLOCK_WORDS);
+        return filter;
+    }
+
+    template<typename T, typename HASH>
+    int bloom_filter<T, HASH>::to_string(char buf[], std::size_t bufsize) const {
+        return std::snprintf(buf, bufsize, "[blocks=%lli, bytes=%lli]", (long long) m_blocks, (long long) size_in_bytes());
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_BLOOM_FILTER_H
@@ -0,0 +1,1530 @@
+#ifndef JSTD_CPP_LANG_UTILS_BTREE_MAP_H
+#define JSTD_CPP_LANG_UTILS_BTREE_MAP_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/arrays.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cpp/lang/utils/traits.hpp>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+#include <new>
+
+#include <cpp/lang/utils/simd.hpp>
+
+namespace jstd
+{
+
+namespace internal
+{
+
+/**
+ * Поиск позиции ключа внутри узла B+дерева через компаратор (бинарный поиск).
+ *
+ * lower_bound - количество ключей, строго меньших key.
+ * upper_bound - количество ключей, не больших key.
+ */
+template<typename K, typename COMPARATOR_T, bool PRIMITIVE>
+struct btree_search {
+    static std::size_t lower_bound(const K* keys, std::size_t n, const K& key, const COMPARATOR_T& cmp) {
+        std::size_t lo = 0;
+        std::size_t hi = n;
+        while (lo < hi) {
+            const std::size_t mid = (lo + hi) >> 1;
+            if (cmp(keys[mid], key) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    static std::size_t upper_bound(const K* keys, std::size_t n, const K& key, const COMPARATOR_T& cmp) {
+        std::size_t lo = 0;
+        std::size_t hi = n;
+        while (lo < hi) {
+            const std::size_t mid = (lo + hi) >> 1;
+            if (cmp(keys[mid], key) <= 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+};
+
+/**
+ * Подсчёт ключей, строго меньших key. Цикл без ветвлений, векторизуется компилятором.
+ */
+template<typename K>
+inline std::size_t btree_count_less(const K* keys, std::size_t n, const K& key) {
+    std::size_t r = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        r += keys[i] < key;
+    return r;
+}
+
+/**
+ * Подсчёт ключей, не больших key.
+ */
+template<typename K>
+inline std::size_t btree_count_less_equal(const K* keys, std::size_t n, const K& key) {
+    std::size_t r = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        r += !(key < keys[i]);
+    return r;
+}
+
+#if defined(JSTD_SIMD_SSE2)
+    /**
+     * Количество установленных бит в 4-битной маске _mm_movemask_ps.
+     */
+    inline std::size_t btree_mask_bits(int mask) {
+        return (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+    }
+
+    template<>
+    inline std::size_t btree_count_less<std::int32_t>(const std::int32_t* keys, std::size_t n, const std::int32_t& key) {
+        const __m128i k = _mm_set1_epi32(key);
+        std::size_t r = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            r += btree_mask_bits(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, k))));
+        }
+        for (; i < n; ++i)
+            r += keys[i] < key;
+        return r;
+    }
+
+    template<>
+    inline std::size_t btree_count_less_equal<std::int32_t>(const std::int32_t* keys, std::size_t n, const std::int32_t& key) {
+        const __m128i k = _mm_set1_epi32(key);
+        std::size_t r = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            r += 4 - btree_mask_bits(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, k))));
+        }
+        for (; i < n; ++i)
+            r += !(key < keys[i]);
+        return r;
+    }
+
+    template<>
+    inline std::size_t btree_count_less<float>(const float* keys, std::size_t n, const float& key) {
+        const __m128 k = _mm_set1_ps(key);
+        std::size_t r = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            r += btree_mask_bits(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(keys + i), k)));
+        for (; i < n; ++i)
+            r += keys[i] < key;
+        return r;
+    }
+
+    template<>
+    inline std::size_t btree_count_less_equal<float>(const float* keys, std::size_t n, const float& key) {
+        const __m128 k = _mm_set1_ps(key);
+        std::size_t r = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            r += 4 - btree_mask_bits(_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(keys + i), k)));
+        for (; i < n; ++i)
+            r += !(key < keys[i]);
+        return r;
+    }
+#endif
+
+/**
+ * Поиск для примитивных ключей со стандартным компаратором.
+ * Бинарный поиск сужает диапазон до нескольких десятков ключей,
+ * остаток обрабатывается линейным подсчётом (SSE2 для int32_t и float).
+ */
+template<typename K, typename COMPARATOR_T>
+struct btree_search<K, COMPARATOR_T, true> {
+    static const std::size_t LINEAR_THRESHOLD = 32;
+
+    static std::size_t lower_bound(const K* keys, std::size_t n, const K& key, const COMPARATOR_T&) {
+        std::size_t lo = 0;
+        std::size_t hi = n;
+        while (hi - lo > LINEAR_THRESHOLD) {
+            const std::size_t mid = (lo + hi) >> 1;
+            if (keys[mid] < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo + btree_count_less(keys + lo, hi - lo, key);
+    }
+
+    static std::size_t upper_bound(const K* keys, std::size_t n, const K& key, const COMPARATOR_T&) {
+        std::size_t lo = 0;
+        std::size_t hi = n;
+        while (hi - lo > LINEAR_THRESHOLD) {
+            const std::size_t mid = (lo + hi) >> 1;
+            if (!(key < keys[mid]))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo + btree_count_less_equal(keys + lo, hi - lo, key);
+    }
+};
+
+/**
+ * Источник записей для построения B+дерева из пары отсортированных массивов.
+ */
+template<typename K, typename V>
+struct btree_array_source {
+    const K* keys;
+    const V* values;
+    std::size_t index;
+
+    void key(void* dst) const {
+        new (dst) K(keys[index]);
+    }
+
+    void value(void* dst) const {
+        new (dst) V(values[index]);
+    }
+
+    void next() {
+        ++index;
+    }
+};
+
+/**
+ * Источник записей для построения B+дерева из связного списка листьев другого дерева.
+ */
+template<typename K, typename V, typename LEAF>
+struct btree_leaf_source {
+    LEAF* leaf;
+    std::size_t index;
+
+    void key(void* dst) const {
+        new (dst) K(leaf->keys()[index]);
+    }
+
+    void value(void* dst) const {
+        new (dst) V(leaf->values()[index]);
+    }
+
+    void next() {
+        if (++index >= leaf->count) {
+            leaf  = leaf->next;
+            index = 0;
+        }
+    }
+};
+
+}
+
+/**
+ * Упорядоченная карта на основе B+дерева.
+ *
+ * В отличие от tree_map (один ключ на узел, один промах кэша на уровень), узлы B+дерева
+ * широкие: их размер задаётся параметром {@code NODE_SIZE} (по умолчанию 256 байт - 4 линии кэша),
+ * ключи узла лежат в непрерывном массиве. Все значения хранятся в листьях, листья связаны в
+ * двусвязный список, поэтому обход и выборка диапазона идут последовательно по памяти.
+ *
+ * Для примитивных ключей со стандартным компаратором поиск внутри узла выполняется
+ * линейным подсчётом без ветвлений (SSE2 для int32_t и float).
+ *
+ * Итераторы становятся недействительными после любого изменения карты.
+ *
+ * @tparam K
+ *      Тип ключа.
+ *
+ * @tparam V
+ *      Тип значения.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор ключей, возвращающий int (<0, 0, >0).
+ *
+ * @tparam NODE_SIZE
+ *      Желаемый размер узла в байтах. Вместимость узла вычисляется из него, но не меньше 4.
+ */
+template<typename K, typename V, typename COMPARATOR_T = compare_to<K>, std::size_t NODE_SIZE = 256>
+class btree_map {
+public:
+    /**
+     * Максимальное количество записей в листе.
+     */
+    static const std::size_t LEAF_CAPACITY  = NODE_SIZE / (sizeof(K) + sizeof(V)) < 4 ? 4 : NODE_SIZE / (sizeof(K) + sizeof(V));
+
+    /**
+     * Максимальное количество ключей во внутреннем узле.
+     */
+    static const std::size_t INNER_CAPACITY = NODE_SIZE / (sizeof(K) + sizeof(void*)) < 4 ? 4 : NODE_SIZE / (sizeof(K) + sizeof(void*));
+
+private:
+    /**
+     *
+     */
+    static const std::size_t LEAF_MIN  = LEAF_CAPACITY  / 2;
+
+    /**
+     *
+     */
+    static const std::size_t INNER_MIN = INNER_CAPACITY / 2;
+
+    /**
+     *
+     */
+    typedef internal::btree_search<K, COMPARATOR_T, is_primitive<K>::value && is_same<COMPARATOR_T, compare_to<K>>::value> search_type;
+
+    /**
+     * Общий заголовок узлов.
+     */
+    struct node {
+        /**
+         *
+         */
+        bool leaf;
+
+        /**
+         * Количество ключей в узле.
+         */
+        std::size_t count;
+    };
+
+    /**
+     * Лист: ключи и значения в раздельных массивах, ссылки на соседние листья.
+     */
+    struct leaf_node : public node {
+        /**
+         *
+         */
+        leaf_node* prev;
+
+        /**
+         *
+         */
+        leaf_node* next;
+
+        /**
+         *
+         */
+        alignas(K) unsigned char key_data[sizeof(K) * LEAF_CAPACITY];
+
+        /**
+         *
+         */
+        alignas(V) unsigned char value_data[sizeof(V) * LEAF_CAPACITY];
+
+        /**
+         *
+         */
+        K* keys() {
+            return reinterpret_cast<K*>(key_data);
+        }
+
+        /**
+         *
+         */
+        V* values() {
+            return reinterpret_cast<V*>(value_data);
+        }
+    };
+
+    /**
+     * Внутренний узел: count ключей-разделителей и count + 1 потомков.
+     * Ключ keys[i] равен наименьшему ключу в поддереве children[i + 1].
+     */
+    struct inner_node : public node {
+        /**
+         *
+         */
+        alignas(K) unsigned char key_data[sizeof(K) * INNER_CAPACITY];
+
+        /**
+         *
+         */
+        node* children[INNER_CAPACITY + 1];
+
+        /**
+         *
+         */
+        K* keys() {
+            return reinterpret_cast<K*>(key_data);
+        }
+    };
+
+    /**
+     *
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     *
+     */
+    node* m_root;
+
+    /**
+     *
+     */
+    leaf_node* m_first;
+
+    /**
+     *
+     */
+    leaf_node* m_last;
+
+    /**
+     *
+     */
+    std::size_t m_size;
+
+    /**
+     *
+     */
+    COMPARATOR_T m_comparator;
+
+    /**
+     *
+     */
+    leaf_node* alloc_leaf();
+
+    /**
+     *
+     */
+    inner_node* alloc_inner();
+
+    /**
+     * Разрушает ключи (и значения) узла и освобождает его память. Потомки не затрагиваются.
+     */
+    void free_node(node* n);
+
+    /**
+     *
+     */
+    void free_subtree(node* n);
+
+    /**
+     * Возвращает лист, в котором должен находиться ключ, или nullptr, если карта пуста.
+     */
+    leaf_node* find_leaf(const K& key) const;
+
+    /**
+     * Вставка в поддерево.
+     *
+     * @param split_key
+     *      Неинициализированная память под ключ. При разделении узла туда помещается
+     *      разделитель для родителя.
+     *
+     * @return
+     *      Новый правый узел, если узел был разделён, иначе nullptr.
+     */
+    template<typename K_, typename V_>
+    node* insert0(node* n, K_&& key, V_&& value, bool& inserted, void* split_key);
+
+    /**
+     * Удаление из поддерева. Потомок, в котором записей стало меньше минимума,
+     * пополняется от соседа или сливается с ним.
+     */
+    bool remove0(node* n, const K& key, V* ret);
+
+    /**
+     *
+     */
+    void rebalance(inner_node* parent, std::size_t idx);
+
+    /**
+     * Сливает parent->children[idx + 1] в parent->children[idx].
+     */
+    void merge(inner_node* parent, std::size_t idx);
+
+    /**
+     * Строит дерево снизу вверх из n записей, выдаваемых источником в порядке возрастания ключей.
+     */
+    template<typename SOURCE>
+    void build(std::size_t n, SOURCE& source);
+
+    /**
+     *
+     */
+    static std::size_t min_count(const node* n) {
+        return n->leaf ? LEAF_MIN : INNER_MIN;
+    }
+
+    /**
+     * Сдвигает элементы [pos, count) на одну позицию вправо, освобождая a[pos].
+     */
+    template<typename T>
+    static void shift_right(T* a, std::size_t pos, std::size_t count) {
+        jstd::relocate(a + pos + 1, a + pos, count - pos);
+    }
+
+    /**
+     * Сдвигает элементы (pos, count) на одну позицию влево. Элемент a[pos] должен быть уже разрушен.
+     */
+    template<typename T>
+    static void shift_left(T* a, std::size_t pos, std::size_t count) {
+        if (pos + 1 < count)
+            jstd::relocate(a + pos, a + pos + 1, count - pos - 1);
+    }
+
+    /**
+     * Перемещает n элементов в неинициализированную память dst.
+     */
+    template<typename T>
+    static void relocate(T* dst, T* src, std::size_t n) {
+        jstd::relocate(dst, src, n);
+    }
+
+    /**
+     * Вставляет разделитель *sep и правого потомка child в позицию pos. *sep разрушается.
+     */
+    static void insert_separator(inner_node* in, std::size_t pos, K* sep, node* child);
+
+    /**
+     * Вставляет запись в лист, в котором есть свободное место.
+     */
+    template<typename K_, typename V_>
+    static void insert_into_leaf(leaf_node* l, std::size_t pos, K_&& key, V_&& value);
+
+public:
+    /**
+     * Представление записи карты, возвращаемое итератором.
+     */
+    template<typename TVALUE>
+    class entry {
+        /**
+         *
+         */
+        const K* m_key;
+
+        /**
+         *
+         */
+        TVALUE* m_value;
+
+    public:
+        /**
+         *
+         */
+        entry(const K* key, TVALUE* value) : m_key(key), m_value(value) {}
+
+        /**
+         *
+         */
+        const K& get_key() const {
+            return *m_key;
+        }
+
+        /**
+         *
+         */
+        TVALUE& get_value() const {
+            return *m_value;
+        }
+    };
+
+    /**
+     * Итератор по записям в порядке возрастания ключей, идущий по связному списку листьев.
+     */
+    template<typename TVALUE>
+    class iterator {
+        template<typename>
+        friend class iterator;
+
+        /**
+         *
+         */
+        leaf_node* m_leaf;
+
+        /**
+         *
+         */
+        std::size_t m_index;
+
+    public:
+        /**
+         *
+         */
+        iterator(leaf_node* leaf, std::size_t index);
+
+        /**
+         * Изменяемый итератор неявно приводится к константному, поэтому результат константных методов
+         * можно сравнивать с end() неконстантной карты.
+         */
+        iterator(const iterator<V>& it) : m_leaf(it.m_leaf), m_index(it.m_index) {}
+
+        /**
+         *
+         */
+        entry<TVALUE> operator* () const;
+
+        /**
+         *
+         */
+        template<typename TVALUE2>
+        bool operator!=(const iterator<TVALUE2>&) const;
+
+        /**
+         *
+         */
+        template<typename TVALUE2>
+        bool operator==(const iterator<TVALUE2>&) const;
+
+        /**
+         *
+         */
+        iterator<TVALUE>& operator++ ();
+
+        /**
+         *
+         */
+        iterator<TVALUE> operator++ (int);
+    };
+
+    /**
+     * Диапазон записей [from, to) для использования в range-based for.
+     */
+    class range {
+        /**
+         *
+         */
+        iterator<const V> m_begin;
+
+        /**
+         *
+         */
+        iterator<const V> m_end;
+
+    public:
+        /**
+         *
+         */
+        range(const iterator<const V>& b, const iterator<const V>& e) : m_begin(b), m_end(e) {}
+
+        /**
+         *
+         */
+        iterator<const V> begin() const {
+            return m_begin;
+        }
+
+        /**
+         *
+         */
+        iterator<const V> end() const {
+            return m_end;
+        }
+    };
+
+private:
+    /**
+     * Первая запись с ключом >= key (UPPER == false) или > key (UPPER == true).
+     */
+    template<bool UPPER>
+    iterator<V> bound(const K& key) const;
+
+public:
+    /**
+     *
+     */
+    btree_map(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    btree_map(const btree_map<K, V, COMPARATOR_T, NODE_SIZE>& map);
+
+    /**
+     *
+     */
+    btree_map(btree_map<K, V, COMPARATOR_T, NODE_SIZE>&& map);
+
+    /**
+     *
+     */
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>& operator= (const btree_map<K, V, COMPARATOR_T, NODE_SIZE>& map);
+
+    /**
+     *
+     */
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>& operator= (btree_map<K, V, COMPARATOR_T, NODE_SIZE>&& map);
+
+    /**
+     *
+     */
+    ~btree_map();
+
+    /**
+     * Помещает значение по ключу. Если ключ уже существует, значение заменяется.
+     *
+     * @return
+     *      true - если была добавлена новая запись, false - если значение заменено.
+     */
+    template<typename K_, typename V_>
+    bool put(K_&& key, V_&& value);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если значения по переданному ключу не существует.
+     */
+    V& get(const K& key);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если значения по переданному ключу не существует.
+     */
+    const V& get(const K& key) const;
+
+    /**
+     *
+     */
+    V& get_or_default(const K& key, V& value);
+
+    /**
+     *
+     */
+    const V& get_or_default(const K& key, const V& value) const;
+
+    /**
+     *
+     */
+    bool contains_key(const K& key) const;
+
+    /**
+     * Удаляет запись по ключу.
+     *
+     * @param ret
+     *      (Необязательно) указатель, куда будет перемещено удалённое значение.
+     *
+     * @return
+     *      true - если запись была удалена.
+     */
+    bool remove(const K& key, V* ret = nullptr);
+
+    /**
+     * Заменяет содержимое карты записями из отсортированных массивов.
+     * Дерево строится снизу вверх за O(n) с почти полностью заполненными узлами.
+     *
+     * @param keys
+     *      Ключи в строго возрастающем порядке.
+     *
+     * @param values
+     *      Значения, values[i] соответствует keys[i].
+     *
+     * @throws illegal_argument_exception
+     *      Если ключи не упорядочены строго по возрастанию.
+     */
+    void bulk_load(const K* keys, const V* values, std::size_t n);
+
+    /**
+     *
+     */
+    void clear();
+
+    /**
+     *
+     */
+    std::size_t size() const;
+
+    /**
+     *
+     */
+    bool is_empty() const;
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const;
+
+    /**
+     *
+     */
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Возвращает итератор на запись с ключом key или end().
+     */
+    iterator<V> find(const K& key);
+
+    /**
+     * Возвращает итератор на запись с ключом key или end().
+     */
+    iterator<const V> find(const K& key) const;
+
+    /**
+     * Возвращает итератор на первую запись с ключом >= key.
+     */
+    iterator<V> lower_bound(const K& key) {
+        return bound<false>(key);
+    }
+
+    /**
+     * Возвращает итератор на первую запись с ключом >= key.
+     */
+    iterator<const V> lower_bound(const K& key) const {
+        return bound<false>(key);
+    }
+
+    /**
+     * Возвращает итератор на первую запись с ключом > key.
+     */
+    iterator<V> upper_bound(const K& key) {
+        return bound<true>(key);
+    }
+
+    /**
+     * Возвращает итератор на первую запись с ключом > key.
+     */
+    iterator<const V> upper_bound(const K& key) const {
+        return bound<true>(key);
+    }
+
+    /**
+     * Возвращает диапазон записей с ключами из полуинтервала [from, to).
+     * Диапазон не копирует данные и становится недействительным после изменения карты.
+     */
+    range sub_map(const K& from, const K& to) const;
+
+    /**
+     *
+     */
+    iterator<V> begin() {
+        return iterator<V>(m_size != 0 ? m_first : nullptr, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<V> end() {
+        return iterator<V>(nullptr, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<const V> begin() const {
+        return iterator<const V>(m_size != 0 ? m_first : nullptr, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<const V> end() const {
+        return iterator<const V>(nullptr, 0);
+    }
+};
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename TVALUE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>::iterator<TVALUE>::iterator(leaf_node* leaf, std::size_t index) :
+        m_leaf(leaf),
+        m_index(index) {
+
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename TVALUE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>:: template entry<TVALUE> btree_map<K, V, COMPARATOR_T, NODE_SIZE>::iterator<TVALUE>::operator* () const {
+        assert(m_leaf != nullptr && m_index < m_leaf->count);
+        return entry<TVALUE>(m_leaf->keys() + m_index, m_leaf->values() + m_index);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename TVALUE>
+    template<typename TVALUE2>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::iterator<TVALUE>::operator!=(const iterator<TVALUE2>& it) const {
+        return m_leaf != it.m_leaf || m_index != it.m_index;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename TVALUE>
+    template<typename TVALUE2>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::iterator<TVALUE>::operator==(const iterator<TVALUE2>& it) const {
+        return !(*this != it);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename TVALUE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>:: template iterator<TVALUE>& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::iterator<TVALUE>::operator++ () {
+        assert(m_leaf != nullptr);
+        if (++m_index >= m_leaf->count) {
+            m_leaf  = m_leaf->next;
+            m_index = 0;
+        }
+        return *this;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename TVALUE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>:: template iterator<TVALUE> btree_map<K, V, COMPARATOR_T, NODE_SIZE>::iterator<TVALUE>::operator++ (int) {
+        iterator<TVALUE> tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>::btree_map(tca::allocator* allocator) :
+        m_allocator(allocator),
+        m_root(nullptr),
+        m_first(nullptr),
+        m_last(nullptr),
+        m_size(0),
+        m_comparator() {
+
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>::btree_map(const btree_map<K, V, COMPARATOR_T, NODE_SIZE>& map) :
+        btree_map(map.m_allocator) {
+        (*this) = map.clone();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>::btree_map(btree_map<K, V, COMPARATOR_T, NODE_SIZE>&& map) :
+        m_allocator(map.m_allocator),
+        m_root(map.m_root),
+        m_first(map.m_first),
+        m_last(map.m_last),
+        m_size(map.m_size),
+        m_comparator(std::move(map.m_comparator)) {
+        map.m_root  = nullptr;
+        map.m_first = nullptr;
+        map.m_last  = nullptr;
+        map.m_size  = 0;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::operator= (const btree_map<K, V, COMPARATOR_T, NODE_SIZE>& map) {
+        if (&map != this) {
+            btree_map<K, V, COMPARATOR_T, NODE_SIZE> tmp = map.clone(m_allocator);
+            (*this) = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::operator= (btree_map<K, V, COMPARATOR_T, NODE_SIZE>&& map) {
+        if (&map != this) {
+            clear();
+            m_allocator  = map.m_allocator;
+            m_root       = map.m_root;
+            m_first      = map.m_first;
+            m_last       = map.m_last;
+            m_size       = map.m_size;
+            m_comparator = std::move(map.m_comparator);
+            map.m_root  = nullptr;
+            map.m_first = nullptr;
+            map.m_last  = nullptr;
+            map.m_size  = 0;
+        }
+        return *this;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE>::~btree_map() {
+        clear();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>::leaf_node* btree_map<K, V, COMPARATOR_T, NODE_SIZE>::alloc_leaf() {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator must be != null");
+        );
+        void* mem = m_allocator->allocate_align(sizeof(leaf_node), alignof(leaf_node));
+        if (!mem)
+            throw_except<out_of_memory_error>("Out of memory!");
+        leaf_node* l = new (mem) leaf_node;
+        l->leaf  = true;
+        l->count = 0;
+        l->prev  = nullptr;
+        l->next  = nullptr;
+        return l;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>::inner_node* btree_map<K, V, COMPARATOR_T, NODE_SIZE>::alloc_inner() {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator must be != null");
+        );
+        void* mem = m_allocator->allocate_align(sizeof(inner_node), alignof(inner_node));
+        if (!mem)
+            throw_except<out_of_memory_error>("Out of memory!");
+        inner_node* in = new (mem) inner_node;
+        in->leaf  = false;
+        in->count = 0;
+        return in;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::free_node(node* n) {
+        assert(n != nullptr);
+        if (n->leaf) {
+            leaf_node* l = static_cast<leaf_node*>(n);
+            for (std::size_t i = 0; i < l->count; ++i) {
+                l->keys()[i].~K();
+                l->values()[i].~V();
+            }
+            l->~leaf_node();
+            m_allocator->deallocate(l, sizeof(leaf_node));
+        } else {
+            inner_node* in = static_cast<inner_node*>(n);
+            for (std::size_t i = 0; i < in->count; ++i)
+                in->keys()[i].~K();
+            in->~inner_node();
+            m_allocator->deallocate(in, sizeof(inner_node));
+        }
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::free_subtree(node* n) {
+        //глубина рекурсии равна высоте дерева
+        if (!n->leaf) {
+            inner_node* in = static_cast<inner_node*>(n);
+            for (std::size_t i = 0; i <= in->count; ++i)
+                free_subtree(in->children[i]);
+        }
+        free_node(n);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>::leaf_node* btree_map<K, V, COMPARATOR_T, NODE_SIZE>::find_leaf(const K& key) const {
+        node* n = m_root;
+        if (n == nullptr)
+            return nullptr;
+        while (!n->leaf) {
+            inner_node* in = static_cast<inner_node*>(n);
+            n = in->children[search_type::upper_bound(in->keys(), in->count, key, m_comparator)];
+        }
+        return static_cast<leaf_node*>(n);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::insert_separator(inner_node* in, std::size_t pos, K* sep, node* child) {
+        assert(in->count < INNER_CAPACITY);
+        shift_right(in->keys(), pos, in->count);
+        new (in->keys() + pos) K(std::move(*sep));
+        sep->~K();
+        for (std::size_t i = in->count + 1; i > pos + 1; --i)
+            in->children[i] = in->children[i - 1];
+        in->children[pos + 1] = child;
+        ++in->count;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename K_, typename V_>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::insert_into_leaf(leaf_node* l, std::size_t pos, K_&& key, V_&& value) {
+        assert(l->count < LEAF_CAPACITY);
+        K* keys   = l->keys();
+        V* values = l->values();
+        shift_right(keys,   pos, l->count);
+        shift_right(values, pos, l->count);
+        try {
+            new (keys + pos) K(std::forward<K_>(key));
+        } catch (...) {
+            shift_left(keys,   pos, l->count + 1);
+            shift_left(values, pos, l->count + 1);
+            throw;
+        }
+        try {
+            new (values + pos) V(std::forward<V_>(value));
+        } catch (...) {
+            keys[pos].~K();
+            shift_left(keys,   pos, l->count + 1);
+            shift_left(values, pos, l->count + 1);
+            throw;
+        }
+        ++l->count;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename K_, typename V_>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>::node* btree_map<K, V, COMPARATOR_T, NODE_SIZE>::insert0(node* n, K_&& key, V_&& value, bool& inserted, void* split_key) {
+        if (n->leaf) {
+            leaf_node* l = static_cast<leaf_node*>(n);
+            const std::size_t pos = search_type::lower_bound(l->keys(), l->count, key, m_comparator);
+            if (pos < l->count && m_comparator(l->keys()[pos], key) == 0) {
+                l->values()[pos] = std::forward<V_>(value);
+                inserted = false;
+                return nullptr;
+            }
+            inserted = true;
+            if (l->count < LEAF_CAPACITY) {
+                insert_into_leaf(l, pos, std::forward<K_>(key), std::forward<V_>(value));
+                return nullptr;
+            }
+
+            //Лист заполнен: запись сначала создаётся во временной памяти,
+            //чтобы исключение в конструкторе не оставило дерево разделённым наполовину.
+            alignas(K) unsigned char key_buf[sizeof(K)];
+            alignas(V) unsigned char value_buf[sizeof(V)];
+            K* tmp_key = new (key_buf) K(std::forward<K_>(key));
+            V* tmp_value;
+            try {
+                tmp_value = new (value_buf) V(std::forward<V_>(value));
+            } catch (...) {
+                tmp_key->~K();
+                throw;
+            }
+            leaf_node* right;
+            try {
+                right = alloc_leaf();
+            } catch (...) {
+                tmp_key->~K();
+                tmp_value->~V();
+                throw;
+            }
+
+            const std::size_t total = LEAF_CAPACITY + 1;
+            const std::size_t left_n = total / 2;
+            const std::size_t keep = pos < left_n ? left_n - 1 : left_n;
+            relocate(right->keys(),   l->keys()   + keep, l->count - keep);
+            relocate(right->values(), l->values() + keep, l->count - keep);
+            right->count = l->count - keep;
+            l->count = keep;
+
+            right->prev = l;
+            right->next = l->next;
+            if (l->next != nullptr)
+                l->next->prev = right;
+            else
+                m_last = right;
+            l->next = right;
+
+            if (pos < left_n)
+                insert_into_leaf(l, pos, std::move(*tmp_key), std::move(*tmp_value));
+            else
+                insert_into_leaf(right, pos - left_n, std::move(*tmp_key), std::move(*tmp_value));
+            tmp_key->~K();
+            tmp_value->~V();
+
+            new (split_key) K(right->keys()[0]);
+            return right;
+        }
+
+        inner_node* in = static_cast<inner_node*>(n);
+        const std::size_t idx = search_type::upper_bound(in->keys(), in->count, key, m_comparator);
+        node* child_split = insert0(in->children[idx], std::forward<K_>(key), std::forward<V_>(value), inserted, split_key);
+        if (child_split == nullptr)
+            return nullptr;
+
+        K* child_key = reinterpret_cast<K*>(split_key);
+        if (in->count < INNER_CAPACITY) {
+            insert_separator(in, idx, child_key, child_split);
+            return nullptr;
+        }
+
+        //Внутренний узел заполнен: средний ключ уходит к родителю.
+        alignas(K) unsigned char sep_buf[sizeof(K)];
+        K* sep = new (sep_buf) K(std::move(*child_key));
+        child_key->~K();
+
+        inner_node* right;
+        try {
+            right = alloc_inner();
+        } catch (...) {
+            sep->~K();
+            throw;
+        }
+
+        const std::size_t mid = INNER_CAPACITY / 2;
+        new (split_key) K(std::move(in->keys()[mid]));
+        in->keys()[mid].~K();
+        relocate(right->keys(), in->keys() + mid + 1, in->count - mid - 1);
+        for (std::size_t i = mid + 1; i <= in->count; ++i)
+            right->children[i - mid - 1] = in->children[i];
+        right->count = in->count - mid - 1;
+        in->count = mid;
+
+        if (idx <= mid)
+            insert_separator(in, idx, sep, child_split);
+        else
+            insert_separator(right, idx - mid - 1, sep, child_split);
+        return right;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename K_, typename V_>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::put(K_&& key, V_&& value) {
+        if (m_root == nullptr) {
+            leaf_node* l = alloc_leaf();
+            m_root  = l;
+            m_first = l;
+            m_last  = l;
+        }
+        bool inserted = false;
+        alignas(K) unsigned char split_key[sizeof(K)];
+        node* right = insert0(m_root, std::forward<K_>(key), std::forward<V_>(value), inserted, split_key);
+        if (right != nullptr) {
+            K* sep = reinterpret_cast<K*>(split_key);
+            inner_node* root;
+            try {
+                root = alloc_inner();
+            } catch (...) {
+                sep->~K();
+                throw;
+            }
+            new (root->keys()) K(std::move(*sep));
+            sep->~K();
+            root->children[0] = m_root;
+            root->children[1] = right;
+            root->count = 1;
+            m_root = root;
+        }
+        if (inserted)
+            ++m_size;
+        return inserted;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    V& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::get(const K& key) {
+        iterator<V> it = find(key);
+        if (it == end())
+            throw_except<no_such_element_exception>("No such element in map");
+        return (*it).get_value();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    const V& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::get(const K& key) const {
+        iterator<const V> it = find(key);
+        if (it == end())
+            throw_except<no_such_element_exception>("No such element in map");
+        return (*it).get_value();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    V& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::get_or_default(const K& key, V& value) {
+        iterator<V> it = find(key);
+        return it != end() ? (*it).get_value() : value;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    const V& btree_map<K, V, COMPARATOR_T, NODE_SIZE>::get_or_default(const K& key, const V& value) const {
+        iterator<const V> it = find(key);
+        return it != end() ? (*it).get_value() : value;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::contains_key(const K& key) const {
+        return find(key) != end();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::merge(inner_node* parent, std::size_t idx) {
+        node* a = parent->children[idx];
+        node* b = parent->children[idx + 1];
+        if (a->leaf) {
+            leaf_node* la = static_cast<leaf_node*>(a);
+            leaf_node* lb = static_cast<leaf_node*>(b);
+            relocate(la->keys()   + la->count, lb->keys(),   lb->count);
+            relocate(la->values() + la->count, lb->values(), lb->count);
+            la->count += lb->count;
+            lb->count  = 0;
+            la->next = lb->next;
+            if (lb->next != nullptr)
+                lb->next->prev = la;
+            else
+                m_last = la;
+        } else {
+            inner_node* ia = static_cast<inner_node*>(a);
+            inner_node* ib = static_cast<inner_node*>(b);
+            new (ia->keys() + ia->count) K(std::move(parent->keys()[idx]));
+            relocate(ia->keys() + ia->count + 1, ib->keys(), ib->count);
+            for (std::size_t i = 0; i <= ib->count; ++i)
+                ia->children[ia->count + 1 + i] = ib->children[i];
+            ia->count += 1 + ib->count;
+            ib->count  = 0;
+        }
+        free_node(b);
+
+        parent->keys()[idx].~K();
+        shift_left(parent->keys(), idx, parent->count);
+        for (std::size_t i = idx + 1; i < parent->count; ++i)
+            parent->children[i] = parent->children[i + 1];
+        --parent->count;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::rebalance(inner_node* parent, std::size_t idx) {
+        node* child = parent->children[idx];
+        node* left  = idx > 0 ? parent->children[idx - 1] : nullptr;
+        node* right = idx < parent->count ? parent->children[idx + 1] : nullptr;
+
+        if (left != nullptr && left->count > min_count(left)) {
+            if (child->leaf) {
+                leaf_node* c = static_cast<leaf_node*>(child);
+                leaf_node* l = static_cast<leaf_node*>(left);
+                shift_right(c->keys(),   0, c->count);
+                shift_right(c->values(), 0, c->count);
+                relocate(c->keys(),   l->keys()   + l->count - 1, 1);
+                relocate(c->values(), l->values() + l->count - 1, 1);
+                parent->keys()[idx - 1] = c->keys()[0];
+            } else {
+                inner_node* c = static_cast<inner_node*>(child);
+                inner_node* l = static_cast<inner_node*>(left);
+                shift_right(c->keys(), 0, c->count);
+                new (c->keys()) K(std::move(parent->keys()[idx - 1]));
+                parent->keys()[idx - 1] = std::move(l->keys()[l->count - 1]);
+                l->keys()[l->count - 1].~K();
+                for (std::size_t i = c->count + 1; i > 0; --i)
+                    c->children[i] = c->children[i - 1];
+                c->children[0] = l->children[l->count];
+            }
+            --left->count;
+            ++child->count;
+        } else if (right != nullptr && right->count > min_count(right)) {
+            if (child->leaf) {
+                leaf_node* c = static_cast<leaf_node*>(child);
+                leaf_node* r = static_cast<leaf_node*>(right);
+                relocate(c->keys()   + c->count, r->keys(),   1);
+                relocate(c->values() + c->count, r->values(), 1);
+                shift_left(r->keys(),   0, r->count);
+                shift_left(r->values(), 0, r->count);
+                parent->keys()[idx] = r->keys()[0];
+            } else {
+                inner_node* c = static_cast<inner_node*>(child);
+                inner_node* r = static_cast<inner_node*>(right);
+                new (c->keys() + c->count) K(std::move(parent->keys()[idx]));
+                parent->keys()[idx] = std::move(r->keys()[0]);
+                r->keys()[0].~K();
+                shift_left(r->keys(), 0, r->count);
+                c->children[c->count + 1] = r->children[0];
+                for (std::size_t i = 0; i < r->count; ++i)
+                    r->children[i] = r->children[i + 1];
+            }
+            --right->count;
+            ++child->count;
+        } else if (left != nullptr) {
+            merge(parent, idx - 1);
+        } else {
+            merge(parent, idx);
+        }
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::remove0(node* n, const K& key, V* ret) {
+        if (n->leaf) {
+            leaf_node* l = static_cast<leaf_node*>(n);
+            const std::size_t pos = search_type::lower_bound(l->keys(), l->count, key, m_comparator);
+            if (pos >= l->count || m_comparator(l->keys()[pos], key) != 0)
+                return false;
+            if (ret != nullptr)
+                *ret = std::move(l->values()[pos]);
+            l->keys()[pos].~K();
+            l->values()[pos].~V();
+            shift_left(l->keys(),   pos, l->count);
+            shift_left(l->values(), pos, l->count);
+            --l->count;
+            return true;
+        }
+        inner_node* in = static_cast<inner_node*>(n);
+        const std::size_t idx = search_type::upper_bound(in->keys(), in->count, key, m_comparator);
+        node* child = in->children[idx];
+        if (!remove0(child, key, ret))
+            return false;
+        if (child->count < min_count(child))
+            rebalance(in, idx);
+        return true;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::remove(const K& key, V* ret) {
+        if (m_root == nullptr || !remove0(m_root, key, ret))
+            return false;
+        --m_size;
+        if (m_root->count == 0) {
+            node* old = m_root;
+            if (old->leaf) {
+                m_root  = nullptr;
+                m_first = nullptr;
+                m_last  = nullptr;
+            } else {
+                m_root = static_cast<inner_node*>(old)->children[0];
+            }
+            free_node(old);
+        }
+        return true;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<typename SOURCE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::build(std::size_t n, SOURCE& source) {
+        assert(m_root == nullptr);
+        if (n == 0)
+            return;
+
+        //Все созданные узлы учитываются в nodes, чтобы при исключении освободить их без обхода
+        //недостроенного дерева. Каждый уровень не более чем вдвое меньше предыдущего.
+        const std::size_t leaves   = (n + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+        const std::size_t capacity = leaves * 2;
+        node** nodes = static_cast<node**>(m_allocator->allocate(sizeof(node*) * capacity));
+        if (!nodes)
+            throw_except<out_of_memory_error>("Out of memory!");
+        const K** lows = static_cast<const K**>(m_allocator->allocate(sizeof(const K*) * capacity));
+        if (!lows) {
+            m_allocator->deallocate(nodes, sizeof(node*) * capacity);
+            throw_except<out_of_memory_error>("Out of memory!");
+        }
+
+        std::size_t total = 0;
+        try {
+            //Записи распределяются по листьям равномерно, поэтому каждый лист заполнен не меньше чем наполовину.
+            std::size_t base  = n / leaves;
+            std::size_t extra = n % leaves;
+            for (std::size_t i = 0; i < leaves; ++i) {
+                leaf_node* l = alloc_leaf();
+                nodes[total++] = l;
+                l->prev = m_last;
+                if (m_last != nullptr)
+                    m_last->next = l;
+                else
+                    m_first = l;
+                m_last = l;
+
+                const std::size_t m = base + (i < extra ? 1 : 0);
+                for (std::size_t j = 0; j < m; ++j) {
+                    source.key(l->keys() + j);
+                    try {
+                        source.value(l->values() + j);
+                    } catch (...) {
+                        l->keys()[j].~K();
+                        throw;
+                    }
+                    ++l->count;
+                    source.next();
+                }
+                lows[total - 1] = l->keys();
+            }
+
+            std::size_t level = 0;
+            std::size_t count = leaves;
+            while (count > 1) {
+                const std::size_t groups = (count + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+                const std::size_t next_level = total;
+                std::size_t src = level;
+                base  = count / groups;
+                extra = count % groups;
+                for (std::size_t i = 0; i < groups; ++i) {
+                    const std::size_t m = base + (i < extra ? 1 : 0);
+                    inner_node* in = alloc_inner();
+                    nodes[total++] = in;
+                    in->children[0] = nodes[src];
+                    for (std::size_t j = 1; j < m; ++j) {
+                        new (in->keys() + j - 1) K(*lows[src + j]);
+                        in->children[j] = nodes[src + j];
+                        ++in->count;
+                    }
+                    lows[total - 1] = lows[src];
+                    src += m;
+                }
+                level = next_level;
+                count = groups;
+            }
+            m_root = nodes[level];
+        } catch (...) {
+            for (std::size_t i = 0; i < total; ++i)
+                free_node(nodes[i]);
+            m_first = nullptr;
+            m_last  = nullptr;
+            m_allocator->deallocate(nodes, sizeof(node*) * capacity);
+            m_allocator->deallocate(lows, sizeof(const K*) * capacity);
+            throw;
+        }
+        m_allocator->deallocate(nodes, sizeof(node*) * capacity);
+        m_allocator->deallocate(lows, sizeof(const K*) * capacity);
+        m_size = n;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::bulk_load(const K* keys, const V* values, std::size_t n) {
+        for (std::size_t i = 1; i < n; ++i) {
+            if (m_comparator(keys[i - 1], keys[i]) >= 0)
+                throw_except<illegal_argument_exception>("Keys must be sorted in strictly ascending order");
+        }
+        clear();
+        internal::btree_array_source<K, V> source = {keys, values, 0};
+        build(n, source);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    void btree_map<K, V, COMPARATOR_T, NODE_SIZE>::clear() {
+        if (m_root != nullptr)
+            free_subtree(m_root);
+        m_root  = nullptr;
+        m_first = nullptr;
+        m_last  = nullptr;
+        m_size  = 0;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    std::size_t btree_map<K, V, COMPARATOR_T, NODE_SIZE>::size() const {
+        return m_size;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    bool btree_map<K, V, COMPARATOR_T, NODE_SIZE>::is_empty() const {
+        return m_size == 0;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    tca::allocator* btree_map<K, V, COMPARATOR_T, NODE_SIZE>::get_allocator() const {
+        return m_allocator;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    btree_map<K, V, COMPARATOR_T, NODE_SIZE> btree_map<K, V, COMPARATOR_T, NODE_SIZE>::clone(tca::allocator* allocator) const {
+        if (allocator == nullptr)
+            allocator = m_allocator;
+        btree_map<K, V, COMPARATOR_T, NODE_SIZE> result(allocator);
+        result.m_comparator = m_comparator;
+        internal::btree_leaf_source<K, V, leaf_node> source = {m_first, 0};
+        result.build(m_size, source);
+        return result;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>:: template iterator<V> btree_map<K, V, COMPARATOR_T, NODE_SIZE>::find(const K& key) {
+        leaf_node* l = find_leaf(key);
+        if (l == nullptr)
+            return end();
+        const std::size_t pos = search_type::lower_bound(l->keys(), l->count, key, m_comparator);
+        if (pos < l->count && m_comparator(l->keys()[pos], key) == 0)
+            return iterator<V>(l, pos);
+        return end();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>:: template iterator<const V> btree_map<K, V, COMPARATOR_T, NODE_SIZE>::find(const K& key) const {
+        leaf_node* l = find_leaf(key);
+        if (l == nullptr)
+            return end();
+        const std::size_t pos = search_type::lower_bound(l->keys(), l->count, key, m_comparator);
+        if (pos < l->count && m_comparator(l->keys()[pos], key) == 0)
+            return iterator<const V>(l, pos);
+        return end();
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    template<bool UPPER>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>:: template iterator<V> btree_map<K, V, COMPARATOR_T, NODE_SIZE>::bound(const K& key) const {
+        leaf_node* l = find_leaf(key);
+        if (l == nullptr)
+            return iterator<V>(nullptr, 0);
+        const std::size_t pos = UPPER ? search_type::upper_bound(l->keys(), l->count, key, m_comparator)
+                                      : search_type::lower_bound(l->keys(), l->count, key, m_comparator);
+        if (pos < l->count)
+            return iterator<V>(l, pos);
+        return iterator<V>(l->next, 0);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T, std::size_t NODE_SIZE>
+    typename btree_map<K, V, COMPARATOR_T, NODE_SIZE>::range btree_map<K, V, COMPARATOR_T, NODE_SIZE>::sub_map(const K& from, const K& to) const {
+        if (m_comparator(from, to) >= 0)
+            return range(end(), end());
+        return range(lower_bound(from), lower_bound(to));
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_BTREE_MAP_H
@@ -482,6 +482,193 @@ namespace utf32
         
         return u8;
     }
+
+    /**
+     * Возвращается функциями перекодирования, если вход некорректен.
+     */
+    static const std::size_t INVALID = ~(std::size_t) 0;
+
+    /**
+     * Длина самого длинного корректного UTF-8 префикса buf, то есть смещение первой некорректной
+     * последовательности, или n, если весь буфер корректен.
+     *
+     * Корректность - по стандарту Unicode: без избыточных (overlong) форм, суррогатов
+     * и кодов больше 0x10FFFF, без обрезанных последовательностей в конце.
+     *
+     * С AVX2 проверяется по 32 байта за шаг без ветвлений на символ (таблицы переходов по полубайтам);
+     * иначе блоки ASCII пропускаются SSE2, а остальное проверяется скалярно.
+     */
+    std::size_t utf8_valid_prefix(const char* buf, std::size_t n);
+
+    /**
+     * @see utf8_valid_prefix(const char*, std::size_t)
+     */
+    inline bool validate_utf8(const char* buf, std::size_t n) {
+        return utf8_valid_prefix(buf, n) == n;
+    }
+
+    /**
+     * Проверяет, что все суррогаты UTF-16 (в порядке байтов системы) образуют пары.
+     */
+    bool validate_utf16(const std::uint16_t* buf, std::size_t n);
+
+    /**
+     * Количество кодовых точек в корректной UTF-8 строке (число байтов, не являющихся продолжением).
+     * Это же количество 32-битных символов, которое запишет utf8_to_utf32().
+     */
+    std::size_t count_utf8(const char* buf, std::size_t n);
+
+    /**
+     * Количество 16-битных символов, которое запишет utf8_to_utf16().
+     * Для некорректного входа - верхняя граница.
+     */
+    std::size_t utf16_length_from_utf8(const char* buf, std::size_t n);
+
+    /**
+     * Количество байтов, которое запишет utf16_to_utf8().
+     * Для некорректного входа - верхняя граница.
+     */
+    std::size_t utf8_length_from_utf16(const std::uint16_t* buf, std::size_t n);
+
+    /**
+     * Количество байтов, которое запишет utf32_to_utf8().
+     * Для некорректного входа - верхняя граница.
+     */
+    std::size_t utf8_length_from_utf32(const std::uint32_t* buf, std::size_t n);
+
+    /**
+     * Перекодирует UTF-8 в UTF-16 в порядке байтов системы, проверяя вход.
+     * Участки ASCII расширяются векторно.
+     *
+     * @param dst
+     *      Буфер не меньше utf16_length_from_utf8(src, n) символов (n всегда достаточно).
+     *      Завершающий ноль не пишется.
+     *
+     * @return
+     *      Количество записанных символов или INVALID. Смещение ошибки - utf8_valid_prefix().
+     */
+    std::size_t utf8_to_utf16(const char* src, std::size_t n, std::uint16_t* dst);
+
+    /**
+     * Перекодирует UTF-16 в порядке байтов системы в UTF-8. Непарный суррогат - ошибка.
+     *
+     * @param dst
+     *      Буфер не меньше utf8_length_from_utf16(src, n) байтов (3 * n всегда достаточно).
+     *
+     * @return
+     *      Количество записанных байтов или INVALID.
+     */
+    std::size_t utf16_to_utf8(const std::uint16_t* src, std::size_t n, char* dst);
+
+    /**
+     * Перекодирует UTF-8 в UTF-32 в порядке байтов системы, проверяя вход.
+     *
+     * @param dst
+     *      Буфер не меньше count_utf8(src, n) символов (n всегда достаточно).
+     *
+     * @return
+     *      Количество записанных символов или INVALID.
+     */
+    std::size_t utf8_to_utf32(const char* src, std::size_t n, std::uint32_t* dst);
+
+    /**
+     * Перекодирует UTF-32 в порядке байтов системы в UTF-8. Суррогаты и коды больше 0x10FFFF - ошибка.
+     *
+     * @param dst
+     *      Буфер не меньше utf8_length_from_utf32(src, n) байтов (4 * n всегда достаточно).
+     *
+     * @return
+     *      Количество записанных байтов или INVALID.
+     */
+    std::size_t utf32_to_utf8(const std::uint32_t* src, std::size_t n, char* dst);
+
+namespace internal
+{
+    /**
+     * Выбор UTF-16 или UTF-32 по размеру широкого символа.
+     */
+    template<std::size_t SIZE>
+    struct wide_codec;
+
+    template<>
+    struct wide_codec<2> {
+        typedef std::uint16_t unit;
+        static std::size_t length_from_utf8(const char* s, std::size_t n)   { return utf16_length_from_utf8(s, n); }
+        static std::size_t from_utf8(const char* s, std::size_t n, unit* d) { return utf8_to_utf16(s, n, d); }
+        static std::size_t utf8_length(const unit* s, std::size_t n)        { return utf8_length_from_utf16(s, n); }
+        static std::size_t to_utf8(const unit* s, std::size_t n, char* d)   { return utf16_to_utf8(s, n, d); }
+    };
+
+    template<>
+    struct wide_codec<4> {
+        typedef std::uint32_t unit;
+        static std::size_t length_from_utf8(const char* s, std::size_t n)   { return count_utf8(s, n); }
+        static std::size_t from_utf8(const char* s, std::size_t n, unit* d) { return utf8_to_utf32(s, n, d); }
+        static std::size_t utf8_length(const unit* s, std::size_t n)        { return utf8_length_from_utf32(s, n); }
+        static std::size_t to_utf8(const unit* s, std::size_t n, char* d)   { return utf32_to_utf8(s, n, d); }
+    };
+}
+
+    /**
+     * Дописывает к out UTF-8 строку u8, перекодированную в UTF-16 или UTF-32 по размеру WCHAR
+     * (для wchar_t - UTF-16 в Windows и UTF-32 в остальных системах). Память выделяется один раз
+     * по точно подсчитанной длине.
+     *
+     * @throws utf_format_exception
+     *      Если u8 не корректная UTF-8 строка. out при этом не изменяется.
+     */
+    template<typename WCHAR>
+    tstring<WCHAR>& utf8_to_wide(const char* u8, std::size_t len, tstring<WCHAR>& out) {
+        static_assert(sizeof(WCHAR) == 2 || sizeof(WCHAR) == 4, "WCHAR must be 2 (UTF-16) or 4 (UTF-32) bytes");
+        typedef internal::wide_codec<sizeof(WCHAR)> codec;
+        const std::size_t old_len = out.length();
+        out.set_length(old_len + codec::length_from_utf8(u8, len));
+        const std::size_t written = codec::from_utf8(u8, len, reinterpret_cast<typename codec::unit*>(out.cstr() + old_len));
+        if (written == INVALID) {
+            out.set_length(old_len);
+            throw_except<utf_format_exception>("Invalid UTF-8 sequence at offset %zu", utf8_valid_prefix(u8, len));
+        }
+        out.set_length(old_len + written);
+        return out;
+    }
+
+    /**
+     * @see utf8_to_wide(const char*, std::size_t, tstring<WCHAR>&)
+     */
+    template<typename WCHAR>
+    tstring<WCHAR>& utf8_to_wide(const tstring<char>& u8, tstring<WCHAR>& out) {
+        return utf8_to_wide(u8.cstr(), u8.length(), out);
+    }
+
+    /**
+     * Дописывает к out строку из UTF-16 или UTF-32 (по размеру WCHAR), перекодированную в UTF-8.
+     *
+     * @throws utf_format_exception
+     *      Если во входе непарный суррогат или недопустимый код. out при этом не изменяется.
+     */
+    template<typename WCHAR>
+    tstring<char>& wide_to_utf8(const WCHAR* w, std::size_t len, tstring<char>& out) {
+        static_assert(sizeof(WCHAR) == 2 || sizeof(WCHAR) == 4, "WCHAR must be 2 (UTF-16) or 4 (UTF-32) bytes");
+        typedef internal::wide_codec<sizeof(WCHAR)> codec;
+        const typename codec::unit* src = reinterpret_cast<const typename codec::unit*>(w);
+        const std::size_t old_len = out.length();
+        out.set_length(old_len + codec::utf8_length(src, len));
+        const std::size_t written = codec::to_utf8(src, len, out.cstr() + old_len);
+        if (written == INVALID) {
+            out.set_length(old_len);
+            throw_except<utf_format_exception>("Invalid UTF-%u string", (unsigned) (sizeof(WCHAR) * 8));
+        }
+        out.set_length(old_len + written);
+        return out;
+    }
+
+    /**
+     * @see wide_to_utf8(const WCHAR*, std::size_t, tstring<char>&)
+     */
+    template<typename WCHAR>
+    tstring<char>& wide_to_utf8(const tstring<WCHAR>& w, tstring<char>& out) {
+        return wide_to_utf8(w.cstr(), w.length(), out);
+    }
     
 }//namespace utf
 }//namespace jstd
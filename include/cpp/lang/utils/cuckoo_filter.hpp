@@ -0,0 +1,628 @@
+#ifndef JSTD_CPP_LANG_UTILS_CUCKOO_FILTER_H
+#define JSTD_CPP_LANG_UTILS_CUCKOO_FILTER_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/io/bytebuffer.hpp>
+#include <cpp/lang/utils/hash.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+namespace jstd
+{
+
+namespace internal
+{
+/**
+ * Корзина фильтра - одно 64-битное слово из 4 отпечатков по 16 бит. Пустой слот равен нулю.
+ * Поиск отпечатка и свободного слота выполняется над всем словом сразу (SWAR).
+ */
+namespace cuckoo
+{
+    static const std::size_t SLOTS = 4;
+    static const std::size_t FINGERPRINT_BITS = 16;
+    static const std::uint64_t LANE_LOW  = 0x0001000100010001ull;
+    static const std::uint64_t LANE_HIGH = 0x8000800080008000ull;
+
+    /**
+     * Максимальное количество вытеснений при вставке.
+     */
+    static const std::size_t MAX_KICKS = 500;
+
+    /**
+     * Количество ключей, для которых корзины вычисляются и предзагружаются заранее в add_all.
+     */
+    static const std::size_t BATCH = 16;
+
+    /**
+     * Сигнатура сериализованного фильтра ("JCF1").
+     */
+    static const std::uint32_t MAGIC = 0x3146434AU;
+
+    /**
+     * Старший бит каждой нулевой 16-битной дорожки x. Младший установленный бит указывает на первую нулевую дорожку точно,
+     * старшие могут быть ложными из-за заёма, поэтому используется только наличие бита и младший бит.
+     */
+    inline std::uint64_t zero_lanes(std::uint64_t x) {
+        return (x - LANE_LOW) & ~x & LANE_HIGH;
+    }
+
+    /**
+     * Номер первой дорожки bucket, равной fp, или SLOTS.
+     */
+    inline std::size_t find(std::uint64_t bucket, std::uint16_t fp) {
+        std::uint64_t z = zero_lanes(bucket ^ (LANE_LOW * fp));
+        return z == 0 ? SLOTS : simd::internal::ctz64(z) / FINGERPRINT_BITS;
+    }
+
+    inline std::uint16_t get(std::uint64_t bucket, std::size_t slot) {
+        return (std::uint16_t) (bucket >> (slot * FINGERPRINT_BITS));
+    }
+
+    inline void put(std::uint64_t& bucket, std::size_t slot, std::uint16_t fp) {
+        const std::size_t shift = slot * FINGERPRINT_BITS;
+        bucket = (bucket & ~(std::uint64_t(0xFFFF) << shift)) | ((std::uint64_t) fp << shift);
+    }
+
+    inline std::size_t next_pow2(std::size_t x) {
+        std::size_t p = 1;
+        while (p < x)
+            p <<= 1;
+        return p;
+    }
+
+    inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void) p;
+#endif
+    }
+}
+}
+
+/**
+ * Фильтр с кукушкиным хэшированием (cuckoo filter).
+ *
+ * Как и фильтр Блума, отвечает "точно нет" или "возможно да", но дополнительно поддерживает удаление.
+ * Хранит 16-битный отпечаток ключа в одной из двух корзин по 4 слота; вторая корзина вычисляется из первой
+ * и отпечатка, поэтому при вытеснении исходный ключ не нужен. Доля ложноположительных ответов около 8 / 65536.
+ *
+ * Удалять можно только ключи, которые были добавлены: удаление чужого ключа с тем же отпечатком
+ * приведёт к ложноотрицательному ответу. Один и тот же ключ можно добавить не более 8 раз.
+ *
+ * @tparam T
+ *      Тип ключей.
+ *
+ * @tparam HASH
+ *      Функтор хэш-кода.
+ */
+template<typename T, typename HASH = hash_for<T>>
+class cuckoo_filter {
+    /**
+     * Указатель на пользовательский аллокатор памяти.
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     * Корзины. Количество - степень двойки.
+     */
+    std::uint64_t* m_buckets;
+
+    /**
+     * Количество корзин.
+     */
+    std::size_t m_bucket_count;
+
+    /**
+     * Количество хранимых отпечатков, включая вытесненный.
+     */
+    std::size_t m_size;
+
+    /**
+     * Отпечаток, не поместившийся после MAX_KICKS вытеснений. Пока он занят, новые ключи не добавляются.
+     */
+    std::uint16_t m_victim_fp;
+
+    /**
+     * Корзина, к которой относится m_victim_fp.
+     */
+    std::size_t m_victim_bucket;
+
+    /**
+     * Состояние генератора для выбора вытесняемого слота.
+     */
+    std::uint64_t m_seed;
+
+    /**
+     * Функтор хэш-кода.
+     */
+    HASH m_hash;
+
+    /**
+     * Создаёт фильтр из bucket_count пустых корзин.
+     */
+    cuckoo_filter(std::size_t bucket_count, tca::allocator* allocator, const HASH& hash, int);
+
+    /**
+     * Выделяет память под bucket_count корзин и обнуляет её.
+     */
+    void init(std::size_t bucket_count);
+
+    /**
+     * Освобождает память.
+     */
+    void cleanup();
+
+    std::uint64_t hash_of(const T& key) const {
+        return mix_hash((std::uint64_t) m_hash(key));
+    }
+
+    static std::uint16_t fingerprint_of(std::uint64_t h) {
+        std::uint16_t fp = (std::uint16_t) (h >> 48);
+        return fp != 0 ? fp : 1;
+    }
+
+    std::size_t index_of(std::uint64_t h) const {
+        return (std::size_t) h & (m_bucket_count - 1);
+    }
+
+    std::size_t alt_index(std::size_t idx, std::uint16_t fp) const {
+        return (idx ^ (std::size_t) mix_hash(fp)) & (m_bucket_count - 1);
+    }
+
+    /**
+     * Проверяет, что у фильтра есть корзины (фильтр не перемещён).
+     *
+     * @throws illegal_state_exception
+     *      В отладочной сборке, если корзин нет.
+     */
+    bool check_buckets() const {
+        JSTD_DEBUG_CODE(
+            if (m_bucket_count == 0)
+                throw_except<illegal_state_exception>("cuckoo_filter has no buckets (moved-from)");
+        );
+        return m_bucket_count != 0;
+    }
+
+    /**
+     * Кладёт отпечаток в свободный слот корзины idx.
+     */
+    bool try_put(std::size_t idx, std::uint16_t fp);
+
+    /**
+     * Удаляет один отпечаток fp из корзины idx.
+     */
+    bool try_remove(std::size_t idx, std::uint16_t fp);
+
+    /**
+     * Вставка по готовому хэшу.
+     */
+    bool add_hashed(std::uint64_t h);
+
+public:
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 80;
+
+    /**
+     * Создаёт фильтр, рассчитанный примерно на capacity ключей (заполнение корзин до 95%).
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    explicit cuckoo_filter(std::size_t capacity, tca::allocator* allocator = tca::get_default_allocator(), const HASH& hash = HASH());
+
+    /**
+     *
+     */
+    cuckoo_filter(const cuckoo_filter<T, HASH>& filter);
+
+    /**
+     *
+     */
+    cuckoo_filter(cuckoo_filter<T, HASH>&& filter);
+
+    /**
+     *
+     */
+    cuckoo_filter<T, HASH>& operator=(const cuckoo_filter<T, HASH>& filter);
+
+    /**
+     *
+     */
+    cuckoo_filter<T, HASH>& operator=(cuckoo_filter<T, HASH>&& filter);
+
+    /**
+     * Создаёт копию фильтра.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего фильтра.
+     */
+    cuckoo_filter<T, HASH> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     *
+     */
+    ~cuckoo_filter();
+
+    /**
+     * Добавляет ключ.
+     *
+     * @return
+     *      false, если фильтр переполнен или перемещён и ключ не добавлен.
+     *
+     * @throws illegal_state_exception
+     *      В отладочной сборке, если фильтр перемещён.
+     */
+    bool add(const T& key) {
+        return add_hashed(hash_of(key));
+    }
+
+    /**
+     * Добавляет len ключей, предзагружая корзины очередной пачки ключей.
+     *
+     * @return
+     *      Количество добавленных ключей. Меньше len, если фильтр переполнился.
+     */
+    std::size_t add_all(const T* keys, std::size_t len);
+
+    /**
+     * Возвращает false, если ключа точно нет, и true, если ключ, возможно, есть.
+     * Перемещённый фильтр не содержит ключей.
+     */
+    bool might_contain(const T& key) const;
+
+    /**
+     * Удаляет ключ, добавленный ранее.
+     *
+     * @return
+     *      true, если отпечаток ключа найден и удалён.
+     */
+    bool remove(const T& key);
+
+    /**
+     * Удаляет все ключи.
+     */
+    void clear();
+
+    /**
+     * Количество хранимых ключей.
+     */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     * Количество слотов для отпечатков.
+     */
+    std::size_t capacity() const {
+        return m_bucket_count * internal::cuckoo::SLOTS;
+    }
+
+    /**
+     * Доля занятых слотов.
+     */
+    double load_factor() const {
+        return (double) m_size / (double) capacity();
+    }
+
+    /**
+     * Количество байт, которое запишет write.
+     */
+    std::size_t serialized_size() const {
+        return sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t) + sizeof(std::uint16_t) + m_bucket_count * sizeof(std::uint64_t);
+    }
+
+    /**
+     * Записывает фильтр в буфер, начиная с текущей позиции, в порядке байт буфера.
+     *
+     * @throws index_out_of_bound_exception
+     *      Если в буфере меньше serialized_size() байт.
+     */
+    void write(byte_buffer& buf) const;
+
+    /**
+     * Читает фильтр, записанный write, начиная с текущей позиции буфера.
+     *
+     * @throws invalid_data_format_exception
+     *      Если данные не являются сериализованным фильтром.
+     */
+    static cuckoo_filter<T, HASH> read(byte_buffer& buf, tca::allocator* allocator = tca::get_default_allocator(), const HASH& hash = HASH());
+
+    /**
+     * Записывает строковое представление фильтра в буфер.
+     */
+    int to_string(char buf[], std::size_t bufsize) const;
+};
+
+    template<typename T, typename HASH>
+    void cuckoo_filter<T, HASH>::init(std::size_t bucket_count) {
+        JSTD_DEBUG_CODE(
+            check_non_null(m_allocator);
+        );
+        void* buckets = m_allocator->allocate_align(bucket_count * sizeof(std::uint64_t), 64);
+        if (buckets == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        std::memset(buckets, 0, bucket_count * sizeof(std::uint64_t));
+        m_buckets       = static_cast<std::uint64_t*>(buckets);
+        m_bucket_count  = bucket_count;
+    }
+
+    template<typename T, typename HASH>
+    void cuckoo_filter<T, HASH>::cleanup() {
+        if (m_allocator != nullptr && m_buckets != nullptr)
+            m_allocator->deallocate(m_buckets);
+        m_buckets       = nullptr;
+        m_bucket_count  = 0;
+        m_size          = 0;
+        m_victim_fp     = 0;
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>::cuckoo_filter(std::size_t bucket_count, tca::allocator* allocator, const HASH& hash, int) :
+    m_allocator(allocator),
+    m_buckets(nullptr),
+    m_bucket_count(0),
+    m_size(0),
+    m_victim_fp(0),
+    m_victim_bucket(0),
+    m_seed(0x9E3779B97F4A7C15ull),
+    m_hash(hash) {
+        init(bucket_count);
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>::cuckoo_filter(std::size_t capacity, tca::allocator* allocator, const HASH& hash) :
+    cuckoo_filter(internal::cuckoo::next_pow2((std::size_t) ((double) capacity / (internal::cuckoo::SLOTS * 0.95)) + 1), allocator, hash, 0) {
+
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>::cuckoo_filter(const cuckoo_filter<T, HASH>& filter) :
+    cuckoo_filter(filter.m_bucket_count != 0 ? filter.m_bucket_count : 1, filter.m_allocator, filter.m_hash, 0) {
+        std::memcpy(m_buckets, filter.m_buckets, filter.m_bucket_count * sizeof(std::uint64_t));
+        m_size          = filter.m_size;
+        m_victim_fp     = filter.m_victim_fp;
+        m_victim_bucket = filter.m_victim_bucket;
+        m_seed          = filter.m_seed;
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>::cuckoo_filter(cuckoo_filter<T, HASH>&& filter) :
+    m_allocator(filter.m_allocator),
+    m_buckets(filter.m_buckets),
+    m_bucket_count(filter.m_bucket_count),
+    m_size(filter.m_size),
+    m_victim_fp(filter.m_victim_fp),
+    m_victim_bucket(filter.m_victim_bucket),
+    m_seed(filter.m_seed),
+    m_hash(std::move(filter.m_hash)) {
+        filter.m_buckets        = nullptr;
+        filter.m_bucket_count   = 0;
+        filter.m_size           = 0;
+        filter.m_victim_fp      = 0;
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>& cuckoo_filter<T, HASH>::operator=(const cuckoo_filter<T, HASH>& filter) {
+        if (&filter != this) {
+            cuckoo_filter<T, HASH> tmp = filter.clone(m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>& cuckoo_filter<T, HASH>::operator=(cuckoo_filter<T, HASH>&& filter) {
+        if (&filter != this) {
+            cleanup();
+            m_allocator     = filter.m_allocator;
+            m_buckets       = filter.m_buckets;
+            m_bucket_count  = filter.m_bucket_count;
+            m_size          = filter.m_size;
+            m_victim_fp     = filter.m_victim_fp;
+            m_victim_bucket = filter.m_victim_bucket;
+            m_seed          = filter.m_seed;
+            m_hash          = std::move(filter.m_hash);
+            filter.m_buckets        = nullptr;
+            filter.m_bucket_count   = 0;
+            filter.m_size           = 0;
+            filter.m_victim_fp      = 0;
+        }
+        return *this;
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH> cuckoo_filter<T, HASH>::clone(tca::allocator* allocator) const {
+        cuckoo_filter<T, HASH> copy(m_bucket_count, allocator != nullptr ? allocator : m_allocator, m_hash, 0);
+        std::memcpy(copy.m_buckets, m_buckets, m_bucket_count * sizeof(std::uint64_t));
+        copy.m_size             = m_size;
+        copy.m_victim_fp        = m_victim_fp;
+        copy.m_victim_bucket    = m_victim_bucket;
+        copy.m_seed             = m_seed;
+        return copy;
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH>::~cuckoo_filter() {
+        cleanup();
+    }
+
+    template<typename T, typename HASH>
+    bool cuckoo_filter<T, HASH>::try_put(std::size_t idx, std::uint16_t fp) {
+        std::uint64_t z = internal::cuckoo::zero_lanes(m_buckets[idx]);
+        if (z == 0)
+            return false;
+        internal::cuckoo::put(m_buckets[idx], simd::internal::ctz64(z) / internal::cuckoo::FINGERPRINT_BITS, fp);
+        return true;
+    }
+
+    template<typename T, typename HASH>
+    bool cuckoo_filter<T, HASH>::try_remove(std::size_t idx, std::uint16_t fp) {
+        std::size_t slot = internal::cuckoo::find(m_buckets[idx], fp);
+        if (slot == internal::cuckoo::SLOTS)
+            return false;
+        internal::cuckoo::put(m_buckets[idx], slot, 0);
+        return true;
+    }
+
+    template<typename T, typename HASH>
+    bool cuckoo_filter<T, HASH>::add_hashed(std::uint64_t h) {
+        if (m_victim_fp != 0 || !check_buckets())
+            return false;
+
+        std::uint16_t fp = fingerprint_of(h);
+        std::size_t idx  = index_of(h);
+        if (try_put(idx, fp) || try_put(alt_index(idx, fp), fp)) {
+            ++m_size;
+            return true;
+        }
+
+        if (h & (std::uint64_t(1) << 47))
+            idx = alt_index(idx, fp);
+        for (std::size_t kick = 0; kick < internal::cuckoo::MAX_KICKS; ++kick) {
+            m_seed ^= m_seed << 13;
+            m_seed ^= m_seed >> 7;
+            m_seed ^= m_seed << 17;
+            std::size_t slot = (std::size_t) (m_seed % internal::cuckoo::SLOTS);
+            std::uint16_t evicted = internal::cuckoo::get(m_buckets[idx], slot);
+            internal::cuckoo::put(m_buckets[idx], slot, fp);
+            fp  = evicted;
+            idx = alt_index(idx, fp);
+            if (try_put(idx, fp)) {
+                ++m_size;
+                return true;
+            }
+        }
+
+        m_victim_fp     = fp;
+        m_victim_bucket = idx;
+        ++m_size;
+        return true;
+    }
+
+    template<typename T, typename HASH>
+    std::size_t cuckoo_filter<T, HASH>::add_all(const T* keys, std::size_t len) {
+        if (!check_buckets())
+            return 0;
+        std::uint64_t hashes[internal::cuckoo::BATCH];
+        std::size_t added = 0;
+        for (std::size_t start = 0; start < len; start += internal::cuckoo::BATCH) {
+            const std::size_t n = len - start < internal::cuckoo::BATCH ? len - start : internal::cuckoo::BATCH;
+            for (std::size_t i = 0; i < n; ++i) {
+                hashes[i] = hash_of(keys[start + i]);
+                std::size_t idx = index_of(hashes[i]);
+                internal::cuckoo::prefetch(m_buckets + idx);
+                internal::cuckoo::prefetch(m_buckets + alt_index(idx, fingerprint_of(hashes[i])));
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!add_hashed(hashes[i]))
+                    return added;
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    template<typename T, typename HASH>
+    bool cuckoo_filter<T, HASH>::might_contain(const T& key) const {
+        if (m_bucket_count == 0)
+            return false;
+        std::uint64_t h     = hash_of(key);
+        std::uint16_t fp    = fingerprint_of(h);
+        std::size_t i1      = index_of(h);
+        std::size_t i2      = alt_index(i1, fp);
+        if (internal::cuckoo::find(m_buckets[i1], fp) != internal::cuckoo::SLOTS || internal::cuckoo::find(m_buckets[i2], fp) != internal::cuckoo::SLOTS)
+            return true;
+        return m_victim_fp == fp && (m_victim_bucket == i1 || m_victim_bucket == i2);
+    }
+
+    template<typename T, typename HASH>
+    bool cuckoo_filter<T, HASH>::remove(const T& key) {
+        if (m_bucket_count == 0)
+            return false;
+        std::uint64_t h     = hash_of(key);
+        std::uint16_t fp    = fingerprint_of(h);
+        std::size_t i1      = index_of(h);
+        std::size_t i2      = alt_index(i1, fp);
+
+        if (m_victim_fp == fp && (m_victim_bucket == i1 || m_victim_bucket == i2)) {
+            m_victim_fp = 0;
+            --m_size;
+            return true;
+        }
+        if (!try_remove(i1, fp) && !try_remove(i2, fp))
+            return false;
+        --m_size;
+
+        if (m_victim_fp != 0) {
+            std::uint16_t vfp   = m_victim_fp;
+            std::size_t vidx    = m_victim_bucket;
+            if (try_put(vidx, vfp) || try_put(alt_index(vidx, vfp), vfp))
+                m_victim_fp = 0;
+        }
+        return true;
+    }
+
+    template<typename T, typename HASH>
+    void cuckoo_filter<T, HASH>::clear() {
+        if (m_buckets != nullptr)
+            std::memset(m_buckets, 0, m_bucket_count * sizeof(std::uint64_t));
+        m_size      = 0;
+        m_victim_fp = 0;
+    }
+
+    template<typename T, typename HASH>
+    void cuckoo_filter<T, HASH>::write(byte_buffer& buf) const {
+        if (buf.remaining() < serialized_size())
+            throw_except<index_out_of_bound_exception>("Remaining %zu < %zu", buf.remaining(), serialized_size());
+        buf.put<std::uint32_t>(internal::cuckoo::MAGIC);
+        buf.put<std::uint64_t>((std::uint64_t) m_bucket_count);
+        buf.put<std::uint64_t>((std::uint64_t) m_size);
+        buf.put<std::uint16_t>(m_victim_fp);
+        buf.put<std::uint64_t>((std::uint64_t) m_victim_bucket);
+        buf.puts<std::uint64_t>(m_buckets, m_bucket_count);
+    }
+
+    template<typename T, typename HASH>
+    cuckoo_filter<T, HASH> cuckoo_filter<T, HASH>::read(byte_buffer& buf, tca::allocator* allocator, const HASH& hash) {
+        const std::size_t header = sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t) + sizeof(std::uint16_t);
+        if (buf.remaining() < header)
+            throw_except<invalid_data_format_exception>("Truncated cuckoo filter data!");
+        if (buf.get<std::uint32_t>() != internal::cuckoo::MAGIC)
+            throw_except<invalid_data_format_exception>("Invalid cuckoo filter signature!");
+        const std::uint64_t bucket_count    = buf.get<std::uint64_t>();
+        const std::uint64_t size            = buf.get<std::uint64_t>();
+        const std::uint16_t victim_fp       = buf.get<std::uint16_t>();
+        const std::uint64_t victim_bucket   = buf.get<std::uint64_t>();
+        if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0 || bucket_count > buf.remaining() / sizeof(std::uint64_t) ||
+            victim_bucket >= bucket_count || size > bucket_count * internal::cuckoo::SLOTS + 1)
+            throw_except<invalid_data_format_exception>("Invalid cuckoo filter header!");
+
+        cuckoo_filter<T, HASH> filter((std::size_t) bucket_count, allocator, hash, 0);
+        buf.gets<std::uint64_t>(filter.m_buckets, filter.m_bucket_count);
+        filter.m_size           = (std::size_t) size;
+        filter.m_victim_fp      = victim_fp;
+        filter.m_victim_bucket  = (std::size_t) victim_bucket;
+        return filter;
+    }
+
+    template<typename T, typename HASH>
+    int cuckoo_filter<T, HASH>::to_string(char buf[], std::size_t bufsize) const {
+        return std::snprintf(buf, bufsize, "[buckets=%lli, size=%lli, capacity=%lli]", (long long) m_bucket_count, (long long) m_size, (long long) capacity());
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_CUCKOO_FILTER_H
@@ -0,0 +1,698 @@
+#ifndef JSTD_CPP_LANG_UTILS_FLAT_MAP_H
+#define JSTD_CPP_LANG_UTILS_FLAT_MAP_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/array_list.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/sort.hpp>
+#include <cpp/lang/utils/span.hpp>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace jstd
+{
+
+namespace internal
+{
+/**
+ * Поиск в отсортированном массиве ключей.
+ */
+namespace flat
+{
+    /**
+     * Количество ключей, строго меньших key.
+     *
+     * Бинарный поиск без ветвлений: на каждом шаге остаётся ровно половина интервала,
+     * выбор половины компилируется в условное перемещение, поэтому нет промахов предсказателя переходов.
+     */
+    template<typename K, typename LESS>
+    std::size_t lower_bound(const K* keys, std::size_t n, const K& key, const LESS& less) {
+        if (n == 0)
+            return 0;
+        const K* base = keys;
+        while (n > 1) {
+            const std::size_t half = n >> 1;
+            base = less(base[half - 1], key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<std::size_t>(base - keys) + (less(*base, key) ? 1 : 0);
+    }
+
+    /**
+     * Количество ключей, не больших key.
+     */
+    template<typename K, typename LESS>
+    std::size_t upper_bound(const K* keys, std::size_t n, const K& key, const LESS& less) {
+        if (n == 0)
+            return 0;
+        const K* base = keys;
+        while (n > 1) {
+            const std::size_t half = n >> 1;
+            base = !less(key, base[half - 1]) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<std::size_t>(base - keys) + (!less(key, *base) ? 1 : 0);
+    }
+
+    /**
+     * Сравнение индексов по ключам. Равные ключи упорядочиваются по индексу,
+     * поэтому из нескольких одинаковых ключей последним в отсортированном порядке оказывается последний во входном массиве.
+     */
+    template<typename K, typename LESS>
+    struct index_less {
+        const K* keys;
+        const LESS& less;
+
+        bool operator()(std::size_t a, std::size_t b) const {
+            if (less(keys[a], keys[b]))
+                return true;
+            if (less(keys[b], keys[a]))
+                return false;
+            return a < b;
+        }
+    };
+
+    /**
+     * Сортирует n ключей по индексам и удаляет повторы, оставляя последнее вхождение каждого ключа.
+     *
+     * @return
+     *      Количество уникальных ключей. Их индексы во входном массиве записаны в начало order.
+     */
+    template<typename K, typename LESS>
+    std::size_t sorted_unique_order(const K* keys, std::size_t n, array_list<std::size_t>& order, const LESS& less) {
+        order.clear();
+        if (n > order.capacity())
+            order.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            order.add(i);
+        index_less<K, LESS> by_key = {keys, less};
+        pdq_sort(order.data(), n, by_key);
+
+        std::size_t* idx = order.data();
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i + 1 < n && !less(keys[idx[i]], keys[idx[i + 1]]))
+                continue;
+            idx[count++] = idx[i];
+        }
+        return count;
+    }
+
+    /**
+     * Доступ к элементам пачки через перестановку индексов.
+     */
+    template<typename T>
+    struct at_order {
+        const T* data;
+        const std::size_t* order;
+
+        const T& operator()(std::size_t i) const {
+            return data[order[i]];
+        }
+    };
+
+    /**
+     * Доступ к элементам пачки по порядку.
+     */
+    template<typename T>
+    struct at_index {
+        const T* data;
+
+        const T& operator()(std::size_t i) const {
+            return data[i];
+        }
+    };
+
+    /**
+     * Шаг слияния: откуда берётся очередной элемент результата.
+     */
+    enum merge_step : unsigned char {
+        /**
+         * Из текущего содержимого.
+         */
+        FROM_OLD,
+
+        /**
+         * Из пачки.
+         */
+        FROM_BATCH,
+
+        /**
+         * Ключи совпали: ключ из текущего содержимого, значение из пачки.
+         */
+        FROM_BOTH
+    };
+
+    /**
+     * Составляет план слияния отсортированного массива old с отсортированной пачкой без повторов.
+     * Выполняет только сравнения, поэтому исключение из компаратора ничего не портит.
+     */
+    template<typename K, typename KEY_AT, typename LESS>
+    void merge_plan(const K* old, std::size_t size, KEY_AT key_at, std::size_t n, array_list<unsigned char>& plan, const LESS& less) {
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < size && j < n) {
+            if (less(old[i], key_at(j))) {
+                plan.add(FROM_OLD);
+                ++i;
+            } else if (less(key_at(j), old[i])) {
+                plan.add(FROM_BATCH);
+                ++j;
+            } else {
+                plan.add(FROM_BOTH);
+                ++i;
+                ++j;
+            }
+        }
+        for (; i < size; ++i)
+            plan.add(FROM_OLD);
+        for (; j < n; ++j)
+            plan.add(FROM_BATCH);
+    }
+
+    /**
+     * Можно ли переносить элементы перемещением и вернуть их обратно, не рискуя исключением.
+     */
+    template<typename T>
+    struct nothrow_movable {
+        static const bool value = std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value;
+    };
+
+    /**
+     * Перемещает элемент, если MOVE, иначе копирует.
+     */
+    template<bool MOVE, typename T>
+    typename std::conditional<MOVE, T&&, const T&>::type take(T& value) {
+        return static_cast<typename std::conditional<MOVE, T&&, const T&>::type>(value);
+    }
+
+    /**
+     * Проверяет, что ключи упорядочены строго по возрастанию.
+     */
+    template<typename K, typename LESS>
+    bool is_strictly_sorted(const K* keys, std::size_t n, const LESS& less) {
+        for (std::size_t i = 1; i < n; ++i) {
+            if (!less(keys[i - 1], keys[i]))
+                return false;
+        }
+        return true;
+    }
+}
+}
+
+/**
+ * Упорядоченная карта в двух непрерывных отсортированных массивах: ключей и значений.
+ *
+ * Предназначена для таблиц, которые строятся один раз и затем в основном читаются
+ * (конфигурация, словари, справочники). Поиск - бинарный без ветвлений по плотному массиву ключей,
+ * значения не мешают поиску в кэше. Накладных расходов на узлы и пустые корзины нет.
+ *
+ * Вставка и удаление по одному ключу выполняются за O(n) из-за сдвига элементов.
+ * Для наполнения используйте assign (O(n log n)) или put_all/merge (слияние отсортированных пачек).
+ *
+ * Указатели и ссылки на ключи и значения становятся недействительными после любого изменения карты.
+ *
+ * @tparam K
+ *      Тип ключей.
+ *
+ * @tparam V
+ *      Тип значений.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор ключей, возвращающий отрицательное число, ноль или положительное число.
+ */
+template<typename K, typename V, typename COMPARATOR_T = compare_to<K>>
+class flat_map {
+    /**
+     * Ключи в порядке возрастания.
+     */
+    array_list<K> m_keys;
+
+    /**
+     * Значения, m_values[i] соответствует m_keys[i].
+     */
+    array_list<V> m_values;
+
+    /**
+     * Компаратор.
+     */
+    COMPARATOR_T m_compare;
+
+    typedef internal::sort_less<K, COMPARATOR_T> less_t;
+
+    less_t less() const {
+        less_t l = {const_cast<COMPARATOR_T&>(m_compare)};
+        return l;
+    }
+
+    /**
+     * Сливает текущее содержимое с отсортированной пачкой без повторов.
+     * При совпадении ключей берётся значение из пачки.
+     * Если компаратор или копирование бросает исключение, карта остаётся прежней.
+     */
+    template<typename KEY_AT, typename VALUE_AT>
+    void merge_sorted(std::size_t n, KEY_AT key_at, VALUE_AT value_at);
+
+public:
+    /**
+     *
+     */
+    static const std::size_t null_val = ~((std::size_t) 0);
+
+    /**
+     * Создаёт пустую карту.
+     */
+    flat_map(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт карту из n пар в произвольном порядке.
+     *
+     * @see assign
+     */
+    flat_map(const K* keys, const V* values, std::size_t n, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт копию карты.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущей карты.
+     */
+    flat_map<K, V, COMPARATOR_T> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Заменяет содержимое карты n парами в произвольном порядке за O(n log n).
+     * Если ключ встречается несколько раз, остаётся значение последнего вхождения (как при последовательных put).
+     */
+    void assign(const K* keys, const V* values, std::size_t n);
+
+    /**
+     * Заменяет содержимое карты парами из массивов, уже упорядоченных строго по возрастанию ключей, за O(n).
+     *
+     * @throws illegal_argument_exception
+     *      Если ключи не упорядочены строго по возрастанию.
+     */
+    void assign_sorted(const K* keys, const V* values, std::size_t n);
+
+    /**
+     * Помещает значение по ключу за O(log n) поиска и O(n) сдвига.
+     *
+     * @return
+     *      true - если была добавлена новая запись, false - если значение заменено.
+     *
+     * Если вставка значения бросает исключение, вставленный ключ удаляется.
+     */
+    template<typename K_, typename V_>
+    bool put(K_&& key, V_&& value);
+
+    /**
+     * Добавляет n пар в произвольном порядке: пачка сортируется и сливается с картой за O(size + n log n).
+     * Значения из пачки заменяют существующие, из повторов внутри пачки побеждает последнее вхождение.
+     * При исключении карта остаётся прежней.
+     */
+    void put_all(const K* keys, const V* values, std::size_t n);
+
+    /**
+     * Сливает с картой записи другой карты за O(size + other.size).
+     * Для совпадающих ключей берётся значение из other.
+     * При исключении карта остаётся прежней.
+     */
+    void merge(const flat_map<K, V, COMPARATOR_T>& other);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если значения по переданному ключу не существует.
+     */
+    V& get(const K& key);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если значения по переданному ключу не существует.
+     */
+    const V& get(const K& key) const;
+
+    /**
+     *
+     */
+    V& get_or_default(const K& key, V& value);
+
+    /**
+     *
+     */
+    const V& get_or_default(const K& key, const V& value) const;
+
+    /**
+     *
+     */
+    bool contains_key(const K& key) const;
+
+    /**
+     * Удаляет запись по ключу.
+     *
+     * @param ret
+     *      (Необязательно) указатель, куда будет перемещено удалённое значение.
+     *
+     * @return
+     *      true - если запись была удалена.
+     */
+    bool remove(const K& key, V* ret = nullptr);
+
+    /**
+     * Возвращает позицию записи с ключом key или null_val.
+     */
+    std::size_t index_of(const K& key) const;
+
+    /**
+     * Возвращает позицию первой записи с ключом >= key (size(), если такой нет).
+     */
+    std::size_t lower_bound(const K& key) const;
+
+    /**
+     * Возвращает позицию первой записи с ключом > key (size(), если такой нет).
+     */
+    std::size_t upper_bound(const K& key) const;
+
+    /**
+     *
+     */
+    const K& key_at(std::size_t idx) const {
+        return m_keys.at(idx);
+    }
+
+    /**
+     *
+     */
+    V& value_at(std::size_t idx) {
+        return m_values.at(idx);
+    }
+
+    /**
+     *
+     */
+    const V& value_at(std::size_t idx) const {
+        return m_values.at(idx);
+    }
+
+    /**
+     * Ключи в порядке возрастания.
+     */
+    span<const K> keys() const {
+        return span<const K>(m_keys.data(), m_keys.size());
+    }
+
+    /**
+     * Значения в порядке возрастания ключей.
+     */
+    span<V> values() {
+        return span<V>(m_values.data(), m_values.size());
+    }
+
+    /**
+     * Значения в порядке возрастания ключей.
+     */
+    span<const V> values() const {
+        return span<const V>(m_values.data(), m_values.size());
+    }
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_keys.size();
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_keys.is_empty();
+    }
+
+    /**
+     * Удаляет все записи, но не освобождает память.
+     */
+    void clear() {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    /**
+     * @see array_list::reserve
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const {
+        return m_keys.get_allocator();
+    }
+};
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    flat_map<K, V, COMPARATOR_T>::flat_map(tca::allocator* allocator) :
+        m_keys(allocator),
+        m_values(allocator),
+        m_compare() {
+
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    flat_map<K, V, COMPARATOR_T>::flat_map(const K* keys, const V* values, std::size_t n, tca::allocator* allocator) :
+        m_keys(allocator),
+        m_values(allocator),
+        m_compare() {
+        assign(keys, values, n);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    flat_map<K, V, COMPARATOR_T> flat_map<K, V, COMPARATOR_T>::clone(tca::allocator* allocator) const {
+        flat_map<K, V, COMPARATOR_T> copy(allocator != nullptr ? allocator : m_keys.get_allocator());
+        copy.m_keys     = m_keys.clone(allocator);
+        copy.m_values   = m_values.clone(allocator);
+        return copy;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    void flat_map<K, V, COMPARATOR_T>::reserve(std::size_t new_capacity) {
+        if (new_capacity > m_keys.capacity())
+            m_keys.reserve(new_capacity);
+        if (new_capacity > m_values.capacity())
+            m_values.reserve(new_capacity);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    void flat_map<K, V, COMPARATOR_T>::assign(const K* keys, const V* values, std::size_t n) {
+        JSTD_DEBUG_CODE(
+            if ((keys == nullptr || values == nullptr) && n != 0)
+                throw_except<null_pointer_exception>("keys and values must be != null");
+        )
+        array_list<std::size_t> order(m_keys.get_allocator());
+        const std::size_t count = internal::flat::sorted_unique_order(keys, n, order, less());
+        clear();
+        reserve(count);
+        const std::size_t* idx = order.data();
+        for (std::size_t i = 0; i < count; ++i) {
+            m_keys.add(keys[idx[i]]);
+            m_values.add(values[idx[i]]);
+        }
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    void flat_map<K, V, COMPARATOR_T>::assign_sorted(const K* keys, const V* values, std::size_t n) {
+        JSTD_DEBUG_CODE(
+            if ((keys == nullptr || values == nullptr) && n != 0)
+                throw_except<null_pointer_exception>("keys and values must be != null");
+        )
+        if (!internal::flat::is_strictly_sorted(keys, n, less()))
+            throw_except<illegal_argument_exception>("keys must be strictly ascending");
+        clear();
+        reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            m_keys.add(keys[i]);
+            m_values.add(values[i]);
+        }
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    template<typename KEY_AT, typename VALUE_AT>
+    void flat_map<K, V, COMPARATOR_T>::merge_sorted(std::size_t n, KEY_AT key_at, VALUE_AT value_at) {
+        if (n == 0)
+            return;
+        const less_t lt = less();
+        const std::size_t size = m_keys.size();
+        if (size == 0 || lt(m_keys.data()[size - 1], key_at(0))) {
+            reserve(size + n);
+            try {
+                for (std::size_t i = 0; i < n; ++i) {
+                    m_keys.add(key_at(i));
+                    m_values.add(value_at(i));
+                }
+            } catch (...) {
+                while (m_keys.size() > size)
+                    m_keys.remove_at(m_keys.size() - 1);
+                while (m_values.size() > size)
+                    m_values.remove_at(m_values.size() - 1);
+                throw;
+            }
+            return;
+        }
+
+        //Старые элементы переносятся перемещением, только если его можно откатить без исключений, иначе копируются
+        const bool MOVE = internal::flat::nothrow_movable<K>::value && internal::flat::nothrow_movable<V>::value;
+        tca::allocator* allocator = m_keys.get_allocator();
+        K* old_keys   = m_keys.data();
+        V* old_values = m_values.data();
+        array_list<unsigned char> plan(size + n, allocator);
+        internal::flat::merge_plan(old_keys, size, key_at, n, plan, lt);
+
+        const unsigned char* steps = plan.data();
+        const std::size_t count = plan.size();
+        array_list<K> keys(count, allocator);
+        array_list<V> values(count, allocator);
+        std::size_t i = 0;
+        std::size_t j = 0;
+        try {
+            for (std::size_t s = 0; s < count; ++s) {
+                switch (steps[s]) {
+                    case internal::flat::FROM_OLD:
+                        keys.add(internal::flat::take<MOVE>(old_keys[i]));
+                        values.add(internal::flat::take<MOVE>(old_values[i]));
+                        ++i;
+                        break;
+                    case internal::flat::FROM_BATCH:
+                        keys.add(key_at(j));
+                        values.add(value_at(j));
+                        ++j;
+                        break;
+                    default:
+                        keys.add(internal::flat::take<MOVE>(old_keys[i]));
+                        values.add(value_at(j));
+                        ++i;
+                        ++j;
+                        break;
+                }
+            }
+        } catch (...) {
+            if (MOVE) {
+                //Исключение бросает только копирование из пачки: возвращаем перемещённые элементы на место
+                i = 0;
+                for (std::size_t s = 0, added = keys.size(); s < added; ++s) {
+                    if (steps[s] == internal::flat::FROM_BATCH)
+                        continue;
+                    old_keys[i] = std::move(keys.data()[s]);
+                    if (steps[s] == internal::flat::FROM_OLD)
+                        old_values[i] = std::move(values.data()[s]);
+                    ++i;
+                }
+            }
+            throw;
+        }
+        m_keys   = std::move(keys);
+        m_values = std::move(values);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    void flat_map<K, V, COMPARATOR_T>::put_all(const K* keys, const V* values, std::size_t n) {
+        JSTD_DEBUG_CODE(
+            if ((keys == nullptr || values == nullptr) && n != 0)
+                throw_except<null_pointer_exception>("keys and values must be != null");
+        )
+        array_list<std::size_t> order(m_keys.get_allocator());
+        const std::size_t count = internal::flat::sorted_unique_order(keys, n, order, less());
+        internal::flat::at_order<K> key_at     = {keys, order.data()};
+        internal::flat::at_order<V> value_at   = {values, order.data()};
+        merge_sorted(count, key_at, value_at);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    void flat_map<K, V, COMPARATOR_T>::merge(const flat_map<K, V, COMPARATOR_T>& other) {
+        if (&other == this)
+            return;
+        internal::flat::at_index<K> key_at     = {other.m_keys.data()};
+        internal::flat::at_index<V> value_at   = {other.m_values.data()};
+        merge_sorted(other.size(), key_at, value_at);
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    template<typename K_, typename V_>
+    bool flat_map<K, V, COMPARATOR_T>::put(K_&& key, V_&& value) {
+        const std::size_t idx = lower_bound(key);
+        if (idx < m_keys.size() && !less()(key, m_keys.data()[idx])) {
+            m_values.data()[idx] = std::forward<V_>(value);
+            return false;
+        }
+        m_keys.add(idx, std::forward<K_>(key));
+        try {
+            m_values.add(idx, std::forward<V_>(value));
+        } catch (...) {
+            m_keys.remove_at(idx);
+            throw;
+        }
+        return true;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    std::size_t flat_map<K, V, COMPARATOR_T>::lower_bound(const K& key) const {
+        return internal::flat::lower_bound(m_keys.data(), m_keys.size(), key, less());
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    std::size_t flat_map<K, V, COMPARATOR_T>::upper_bound(const K& key) const {
+        return internal::flat::upper_bound(m_keys.data(), m_keys.size(), key, less());
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    std::size_t flat_map<K, V, COMPARATOR_T>::index_of(const K& key) const {
+        const std::size_t idx = lower_bound(key);
+        if (idx < m_keys.size() && !less()(key, m_keys.data()[idx]))
+            return idx;
+        return null_val;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    V& flat_map<K, V, COMPARATOR_T>::get(const K& key) {
+        const std::size_t idx = index_of(key);
+        if (idx == null_val)
+            throw_except<no_such_element_exception>("Key not found");
+        return m_values.data()[idx];
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    const V& flat_map<K, V, COMPARATOR_T>::get(const K& key) const {
+        const std::size_t idx = index_of(key);
+        if (idx == null_val)
+            throw_except<no_such_element_exception>("Key not found");
+        return m_values.data()[idx];
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    V& flat_map<K, V, COMPARATOR_T>::get_or_default(const K& key, V& value) {
+        const std::size_t idx = index_of(key);
+        return idx != null_val ? m_values.data()[idx] : value;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    const V& flat_map<K, V, COMPARATOR_T>::get_or_default(const K& key, const V& value) const {
+        const std::size_t idx = index_of(key);
+        return idx != null_val ? m_values.data()[idx] : value;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    bool flat_map<K, V, COMPARATOR_T>::contains_key(const K& key) const {
+        return index_of(key) != null_val;
+    }
+
+    template<typename K, typename V, typename COMPARATOR_T>
+    bool flat_map<K, V, COMPARATOR_T>::remove(const K& key, V* ret) {
+        const std::size_t idx = index_of(key);
+        if (idx == null_val)
+            return false;
+        m_keys.remove_at(idx);
+        m_values.remove_at(idx, ret);
+        return true;
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_FLAT_MAP_H
@@ -0,0 +1,382 @@
+#ifndef JSTD_CPP_LANG_UTILS_FLAT_SET_H
+#define JSTD_CPP_LANG_UTILS_FLAT_SET_H
+
+#include <cpp/lang/utils/flat_map.hpp>
+
+namespace jstd
+{
+
+/**
+ * Упорядоченное множество уникальных элементов в непрерывном отсортированном массиве.
+ *
+ * Аналог flat_map без значений: поиск бинарный без ветвлений, вставка и удаление одного элемента - O(n).
+ * Для наполнения используйте assign (O(n log n)) или add_all/merge (слияние отсортированных пачек).
+ *
+ * @tparam K
+ *      Тип элементов.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор элементов, возвращающий отрицательное число, ноль или положительное число.
+ */
+template<typename K, typename COMPARATOR_T = compare_to<K>>
+class flat_set {
+    /**
+     * Элементы в порядке возрастания.
+     */
+    array_list<K> m_keys;
+
+    /**
+     * Компаратор.
+     */
+    COMPARATOR_T m_compare;
+
+    typedef internal::sort_less<K, COMPARATOR_T> less_t;
+
+    less_t less() const {
+        less_t l = {const_cast<COMPARATOR_T&>(m_compare)};
+        return l;
+    }
+
+    /**
+     * Сортирует элементы и удаляет повторы.
+     */
+    void sort_unique();
+
+    /**
+     * Сливает текущее содержимое с отсортированным массивом без повторов.
+     * Если компаратор или копирование бросает исключение, множество остаётся прежним.
+     */
+    void merge_sorted(const K* keys, std::size_t n);
+
+public:
+    /**
+     *
+     */
+    static const std::size_t null_val = ~((std::size_t) 0);
+
+    /**
+     * Создаёт пустое множество.
+     */
+    flat_set(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт множество из n элементов в произвольном порядке.
+     *
+     * @see assign
+     */
+    flat_set(const K* keys, std::size_t n, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт копию множества.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего множества.
+     */
+    flat_set<K, COMPARATOR_T> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Заменяет содержимое множества n элементами в произвольном порядке за O(n log n). Повторы отбрасываются.
+     */
+    void assign(const K* keys, std::size_t n);
+
+    /**
+     * Заменяет содержимое множества элементами массива, уже упорядоченного строго по возрастанию, за O(n).
+     *
+     * @throws illegal_argument_exception
+     *      Если элементы не упорядочены строго по возрастанию.
+     */
+    void assign_sorted(const K* keys, std::size_t n);
+
+    /**
+     * Добавляет элемент за O(log n) поиска и O(n) сдвига.
+     *
+     * @return
+     *      true - если элемент был добавлен, false - если он уже есть.
+     */
+    template<typename K_>
+    bool add(K_&& key);
+
+    /**
+     * Добавляет n элементов в произвольном порядке: пачка сортируется и сливается с множеством за O(size + n log n).
+     * При исключении множество остаётся прежним.
+     */
+    void add_all(const K* keys, std::size_t n);
+
+    /**
+     * Сливает с множеством элементы другого множества за O(size + other.size).
+     * При исключении множество остаётся прежним.
+     */
+    void merge(const flat_set<K, COMPARATOR_T>& other);
+
+    /**
+     *
+     */
+    bool contains(const K& key) const;
+
+    /**
+     * Удаляет элемент.
+     *
+     * @return
+     *      true - если элемент был удалён.
+     */
+    bool remove(const K& key);
+
+    /**
+     * Возвращает позицию элемента или null_val.
+     */
+    std::size_t index_of(const K& key) const;
+
+    /**
+     * Возвращает позицию первого элемента >= key (size(), если такого нет).
+     */
+    std::size_t lower_bound(const K& key) const {
+        return internal::flat::lower_bound(m_keys.data(), m_keys.size(), key, less());
+    }
+
+    /**
+     * Возвращает позицию первого элемента > key (size(), если такого нет).
+     */
+    std::size_t upper_bound(const K& key) const {
+        return internal::flat::upper_bound(m_keys.data(), m_keys.size(), key, less());
+    }
+
+    /**
+     *
+     */
+    const K& at(std::size_t idx) const {
+        return m_keys.at(idx);
+    }
+
+    /**
+     * Элементы в порядке возрастания.
+     */
+    span<const K> keys() const {
+        return span<const K>(m_keys.data(), m_keys.size());
+    }
+
+    /**
+     *
+     */
+    const K* begin() const {
+        return m_keys.data();
+    }
+
+    /**
+     *
+     */
+    const K* end() const {
+        return m_keys.data() + m_keys.size();
+    }
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_keys.size();
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_keys.is_empty();
+    }
+
+    /**
+     * Удаляет все элементы, но не освобождает память.
+     */
+    void clear() {
+        m_keys.clear();
+    }
+
+    /**
+     * @see array_list::reserve
+     */
+    void reserve(std::size_t new_capacity) {
+        if (new_capacity > m_keys.capacity())
+            m_keys.reserve(new_capacity);
+    }
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const {
+        return m_keys.get_allocator();
+    }
+};
+
+    template<typename K, typename COMPARATOR_T>
+    flat_set<K, COMPARATOR_T>::flat_set(tca::allocator* allocator) :
+        m_keys(allocator),
+        m_compare() {
+
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    flat_set<K, COMPARATOR_T>::flat_set(const K* keys, std::size_t n, tca::allocator* allocator) :
+        m_keys(allocator),
+        m_compare() {
+        assign(keys, n);
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    flat_set<K, COMPARATOR_T> flat_set<K, COMPARATOR_T>::clone(tca::allocator* allocator) const {
+        flat_set<K, COMPARATOR_T> copy(allocator != nullptr ? allocator : m_keys.get_allocator());
+        copy.m_keys = m_keys.clone(allocator);
+        return copy;
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    void flat_set<K, COMPARATOR_T>::sort_unique() {
+        less_t lt = less();
+        K* data = m_keys.data();
+        const std::size_t n = m_keys.size();
+        if (n < 2)
+            return;
+        internal::pdq_sort(data, n, lt);
+        std::size_t count = 1;
+        for (std::size_t i = 1; i < n; ++i) {
+            if (lt(data[count - 1], data[i])) {
+                if (count != i)
+                    data[count] = std::move(data[i]);
+                ++count;
+            }
+        }
+        while (m_keys.size() > count)
+            m_keys.remove_at(m_keys.size() - 1);
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    void flat_set<K, COMPARATOR_T>::assign(const K* keys, std::size_t n) {
+        JSTD_DEBUG_CODE(
+            if (keys == nullptr && n != 0)
+                throw_except<null_pointer_exception>("keys must be != null");
+        )
+        clear();
+        reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            m_keys.add(keys[i]);
+        sort_unique();
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    void flat_set<K, COMPARATOR_T>::assign_sorted(const K* keys, std::size_t n) {
+        JSTD_DEBUG_CODE(
+            if (keys == nullptr && n != 0)
+                throw_except<null_pointer_exception>("keys must be != null");
+        )
+        if (!internal::flat::is_strictly_sorted(keys, n, less()))
+            throw_except<illegal_argument_exception>("keys must be strictly ascending");
+        clear();
+        reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            m_keys.add(keys[i]);
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    void flat_set<K, COMPARATOR_T>::merge_sorted(const K* keys, std::size_t n) {
+        if (n == 0)
+            return;
+        const less_t lt = less();
+        const std::size_t size = m_keys.size();
+        if (size == 0 || lt(m_keys.data()[size - 1], keys[0])) {
+            reserve(size + n);
+            try {
+                for (std::size_t i = 0; i < n; ++i)
+                    m_keys.add(keys[i]);
+            } catch (...) {
+                while (m_keys.size() > size)
+                    m_keys.remove_at(m_keys.size() - 1);
+                throw;
+            }
+            return;
+        }
+
+        //Старые элементы переносятся перемещением, только если его можно откатить без исключений, иначе копируются
+        const bool MOVE = internal::flat::nothrow_movable<K>::value;
+        tca::allocator* allocator = m_keys.get_allocator();
+        K* old_keys = m_keys.data();
+        array_list<unsigned char> plan(size + n, allocator);
+        internal::flat::at_index<K> key_at = {keys};
+        internal::flat::merge_plan(old_keys, size, key_at, n, plan, lt);
+
+        const unsigned char* steps = plan.data();
+        const std::size_t count = plan.size();
+        array_list<K> merged(count, allocator);
+        std::size_t i = 0;
+        std::size_t j = 0;
+        try {
+            for (std::size_t s = 0; s < count; ++s) {
+                if (steps[s] == internal::flat::FROM_BATCH) {
+                    merged.add(keys[j++]);
+                } else {
+                    if (steps[s] == internal::flat::FROM_BOTH)
+                        ++j;
+                    merged.add(internal::flat::take<MOVE>(old_keys[i++]));
+                }
+            }
+        } catch (...) {
+            if (MOVE) {
+                //Исключение бросает только копирование из пачки: возвращаем перемещённые элементы на место
+                i = 0;
+                for (std::size_t s = 0, added = merged.size(); s < added; ++s) {
+                    if (steps[s] != internal::flat::FROM_BATCH)
+                        old_keys[i++] = std::move(merged.data()[s]);
+                }
+            }
+            throw;
+        }
+        m_keys = std::move(merged);
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    void flat_set<K, COMPARATOR_T>::add_all(const K* keys, std::size_t n) {
+        JSTD_DEBUG_CODE(
+            if (keys == nullptr && n != 0)
+                throw_except<null_pointer_exception>("keys must be != null");
+        )
+        flat_set<K, COMPARATOR_T> batch(keys, n, m_keys.get_allocator());
+        merge_sorted(batch.m_keys.data(), batch.size());
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    void flat_set<K, COMPARATOR_T>::merge(const flat_set<K, COMPARATOR_T>& other) {
+        if (&other == this)
+            return;
+        merge_sorted(other.m_keys.data(), other.size());
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    template<typename K_>
+    bool flat_set<K, COMPARATOR_T>::add(K_&& key) {
+        const std::size_t idx = lower_bound(key);
+        if (idx < m_keys.size() && !less()(key, m_keys.data()[idx]))
+            return false;
+        m_keys.add(idx, std::forward<K_>(key));
+        return true;
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    std::size_t flat_set<K, COMPARATOR_T>::index_of(const K& key) const {
+        const std::size_t idx = lower_bound(key);
+        if (idx < m_keys.size() && !less()(key, m_keys.data()[idx]))
+            return idx;
+        return null_val;
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    bool flat_set<K, COMPARATOR_T>::contains(const K& key) const {
+        return index_of(key) != null_val;
+    }
+
+    template<typename K, typename COMPARATOR_T>
+    bool flat_set<K, COMPARATOR_T>::remove(const K& key) {
+        const std::size_t idx = index_of(key);
+        if (idx == null_val)
+            return false;
+        m_keys.remove_at(idx);
+        return true;
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_FLAT_SET_H
@@ -57,5 +57,26 @@ struct equal_to {
     }
 };
 
+/**
+ * Перемешивает биты хэш-кода (финализатор MurmurHash3).
+ *
+ * hash_for для примитивных типов возвращает само значение, поэтому структуры,
+ * которым нужны равномерно распределённые биты (фильтры, открытая адресация), пропускают хэш-код через эту функцию.
+ *
+ * @param h
+ *      Исходный хэш-код.
+ *
+ * @return
+ *      Хэш-код, каждый бит которого зависит от всех бит исходного.
+ */
+inline std::uint64_t mix_hash(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
 }
 #endif//JSTD_CPP_LANG_UTILS_HASH_H_
\ No newline at end of file
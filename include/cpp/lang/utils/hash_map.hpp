@@ -4,7 +4,9 @@
 #include <cpp/lang/exceptions.hpp>
 #include <cpp/lang/utils/hash.hpp>
 #include <cpp/lang/array.hpp>
+#include <cpp/lang/utils/temp_buffer.hpp>
 #include <cassert>
+#include <type_traits>
 
 namespace jstd
 {
@@ -55,6 +57,11 @@ public:
          */
         void set_next(entry* e);
 
+        /**
+         * Хеш-код ключа, вычисленный при вставке.
+         */
+        std::size_t get_hash() const;
+
         /**
          * 
          */
@@ -103,6 +110,42 @@ private:
      */
     float m_load_factor;
 
+    /**
+     * Общий блок узлов, созданных пакетно (from_range, clone), или nullptr.
+     * Узлы из блока не освобождаются по одному, блок освобождается целиком при очистке карты.
+     */
+    entry* m_slab;
+
+    /**
+     * Вместимость m_slab в узлах.
+     */
+    std::size_t m_slab_length;
+
+    /**
+     * Источник пакетной вставки: ключи и значения из массивов.
+     */
+    struct array_source;
+
+    /**
+     * Заполняет пустую карту n элементами источника: таблица корзин выделяется один раз,
+     * узлы создаются в одном блоке, ключи предварительно разбиваются по диапазонам корзин.
+     * Хеширование, разбиение и связывание диапазонов раздаются исполнителю runner.
+     *
+     * @see chunking
+     */
+    template<typename SOURCE, typename RUNNER>
+    void build(SOURCE& source, std::size_t n, const RUNNER& runner);
+
+    /**
+     * Освобождает блок пакетно созданных узлов. Узлы должны быть уже разрушены.
+     */
+    void release_slab();
+
+    /**
+     * Размер таблицы корзин, при котором n элементов не вызывают расширения.
+     */
+    std::size_t table_length_for(std::size_t n) const;
+
     /**
      * 
      */
@@ -120,9 +163,19 @@ private:
     void lazy_init();
 
     /**
-     * 
+     * Возвращает true, если узлы можно не обходить при очистке:
+     * аллокатор монотонный, а ключи и значения тривиально разрушаемые.
+     */
+    bool can_drop_entries() const {
+        return std::is_trivially_destructible<TKEY>::value &&
+               std::is_trivially_destructible<TVALUE>::value &&
+               m_allocator != nullptr && m_allocator->is_monotonic();
+    }
+
+    /**
+     * Переносит узлы в таблицу корзин длины new_length, используя сохранённые хеш-коды.
      */
-    void rehash();
+    void rehash(std::size_t new_length);
 
     /**
      * 
@@ -170,6 +223,39 @@ public:
      */
     hash_map<TKEY, TVALUE, THASHER, TEQUALER>& operator= (hash_map<TKEY, TVALUE, THASHER, TEQUALER>&& map);
     
+    /**
+     * Создаёт карту из n пар keys[i] -> values[i] за один проход.
+     * 
+     * Таблица корзин выделяется сразу нужного размера, все узлы создаются в одном блоке памяти,
+     * а ключи перед связыванием группируются по диапазонам корзин, поэтому соседние узлы цепочек лежат рядом.
+     * При повторяющихся ключах остаётся последнее значение, как при последовательных put.
+     * 
+     * @param values
+     *      Значения. Если nullptr, значения создаются конструктором по умолчанию.
+     * 
+     * @param allocator
+     *      Аллокатор карты. Временные массивы выделяются из tca::get_default_allocator().
+     */
+    static hash_map<TKEY, TVALUE, THASHER, TEQUALER> from_range(const TKEY* keys, const TVALUE* values, std::size_t n, float load_factor = 0.75f, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Вариант from_range, в котором хеширование, разбиение и связывание диапазонов корзин
+     * раздаются исполнителю runner. Для потоков пула передаётся parallel::pool_runner,
+     * тогда хешер и компаратор ключей должны допускать одновременные вызовы.
+     * 
+     * @param runner
+     *      Исполнитель порций.
+     * 
+     * @see chunking
+     */
+    template<typename RUNNER>
+    static hash_map<TKEY, TVALUE, THASHER, TEQUALER> from_range(const RUNNER& runner, const TKEY* keys, const TVALUE* values, std::size_t n, float load_factor = 0.75f, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Расширяет таблицу корзин так, чтобы n элементов помещались без перехеширования.
+     */
+    void reserve(std::size_t n);
+
     /**
      * 
      */
@@ -219,6 +305,23 @@ public:
      * 
      */
     const TVALUE& get_or_default(const TKEY& key, TVALUE& value) const;
+
+    /**
+     * Ищет значение по ключу другого типа без создания TKEY.
+     * THASHER и TEQUALER должны принимать K и давать для него тот же хеш-код, что и для равного TKEY
+     * (например, tstring_view для hash_map<string, V>).
+     * 
+     * @return
+     *      Указатель на значение или nullptr.
+     */
+    template<typename K>
+    TVALUE* find(const K& key);
+
+    /**
+     * @see find(const K&)
+     */
+    template<typename K>
+    const TVALUE* find(const K& key) const;
     
     /**
      * 
@@ -238,17 +341,28 @@ public:
     bool is_empty() const;
 
     /**
-     * 
+     * Удаляет все элементы. Таблица корзин сохраняется.
+     * Если can_drop_entries(), узлы не обходятся: очищается только таблица корзин.
      */
     void clear();
 
     /**
+     * Удаляет все элементы и освобождает таблицу корзин.
      * 
+     * С монотонным аллокатором (tca::base_allocator::is_monotonic) узлы не возвращаются аллокатору по одному,
+     * их память освобождается при сбросе аллокатора. Для тривиально разрушаемых ключей и значений это O(1),
+     * для остальных - O(n) вызовов деструкторов.
+     * С обычным аллокатором равносильно clear() с последующим освобождением таблицы корзин.
+     */
+    void release_all();
+
+    /**
+     * Создаёт копию карты пакетной вставкой (см. from_range).
      */
     hash_map<TKEY, TVALUE, THASHER, TEQUALER> clone(tca::allocator* allocator = nullptr) const;
 
     /**
-     * 
+     * Добавляет все элементы map. Таблица корзин расширяется заранее, один раз.
      */
     template<typename THASHER_, typename TEQUALER_>
     void put_all(const hash_map<TKEY, TVALUE, THASHER_, TEQUALER_>& map);
@@ -381,7 +495,9 @@ public:
         m_allocator(allocator),
         m_buckets(initial_capacity, allocator),
         m_size(0),
-        m_load_factor(load_factor) {
+        m_load_factor(load_factor),
+        m_slab(nullptr),
+        m_slab_length(0) {
         m_buckets.set(nullptr);
     }
 
@@ -396,9 +512,13 @@ public:
         m_allocator(map.m_allocator),
         m_buckets(std::move(map.m_buckets)),
         m_size(map.m_size),
-        m_load_factor(map.m_load_factor) {
-        map.m_allocator = nullptr;
-        map.m_size      = 0;
+        m_load_factor(map.m_load_factor),
+        m_slab(map.m_slab),
+        m_slab_length(map.m_slab_length) {
+        map.m_allocator     = nullptr;
+        map.m_size          = 0;
+        map.m_slab          = nullptr;
+        map.m_slab_length   = 0;
     }
     
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
@@ -419,16 +539,22 @@ public:
             m_buckets   = std::move(map.m_buckets);
             m_size          = map.m_size;
             m_load_factor   = map.m_load_factor;
+            m_slab          = map.m_slab;
+            m_slab_length   = map.m_slab_length;
 
-            map.m_allocator = nullptr;
-            map.m_size      = 0;
+            map.m_allocator     = nullptr;
+            map.m_size          = 0;
+            map.m_slab          = nullptr;
+            map.m_slab_length   = 0;
         }
         return *this;
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     hash_map<TKEY, TVALUE, THASHER, TEQUALER>::~hash_map() {
-        clear();
+        if (!can_drop_entries())
+            clear();
+        release_slab();
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
@@ -451,7 +577,196 @@ public:
     void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::free_entry(entry* e) {
         assert(e != nullptr);
         e->~entry();
-        m_allocator->deallocate(e, sizeof(entry));
+        if (e < m_slab || e >= m_slab + m_slab_length)
+            m_allocator->deallocate(e, sizeof(entry));
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::release_slab() {
+        if (m_slab != nullptr) {
+            m_allocator->deallocate(m_slab, sizeof(entry) * m_slab_length);
+            m_slab          = nullptr;
+            m_slab_length   = 0;
+        }
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    std::size_t hash_map<TKEY, TVALUE, THASHER, TEQUALER>::table_length_for(std::size_t n) const {
+        const std::size_t length = (std::size_t) ((double) n / m_load_factor) + 1;
+        return length < 16 ? 16 : length;
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    struct hash_map<TKEY, TVALUE, THASHER, TEQUALER>::array_source {
+        const TKEY*     keys;
+        const TVALUE*   values;
+
+        const TKEY& key(std::size_t i) const {
+            return keys[i];
+        }
+
+        std::size_t hash(std::size_t i) const {
+            THASHER hashcode;
+            return hashcode(keys[i]);
+        }
+
+        entry* construct(void* mem, std::size_t i, std::size_t hash) const {
+            if (values == nullptr)
+                return new (mem) entry(keys[i], TVALUE(), hash);
+            return new (mem) entry(keys[i], values[i], hash);
+        }
+
+        void assign(entry* e, std::size_t i) const {
+            if (values == nullptr)
+                e->set_value(TVALUE());
+            else
+                e->set_value(values[i]);
+        }
+    };
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    template<typename SOURCE, typename RUNNER>
+    void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::build(SOURCE& source, std::size_t n, const RUNNER& runner) {
+        assert(m_size == 0 && m_slab == nullptr);
+        const std::size_t length = table_length_for(n);
+        if (m_buckets.length < length) {
+            m_buckets = array<entry*>(length, m_allocator);
+            m_buckets.set(nullptr);
+        }
+        if (n == 0)
+            return;
+
+        m_slab = reinterpret_cast<entry*>(m_allocator->allocate_align(sizeof(entry) * n, alignof(entry)));
+        if (m_slab == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        m_slab_length = n;
+
+        //Порции входа и диапазоны корзин: порция c раскладывает свои ключи по диапазонам,
+        //после чего каждый диапазон корзин связывается независимо от остальных.
+        const std::size_t grain     = chunking::select_grain(runner.count_threads(), n, 0);
+        const std::size_t chunks    = chunking::count_chunks(n, grain);
+        const std::size_t parts     = chunks;
+
+        tca::allocator* temp = tca::get_default_allocator();
+        temp_buffer<std::size_t> hashes(temp, n);
+        temp_buffer<std::size_t> order(temp, n);
+        temp_buffer<std::size_t> offsets(temp, chunks * parts);
+        temp_buffer<std::size_t> bounds(temp, parts + 1);
+        temp_buffer<std::size_t> added(temp, parts);
+
+        struct partition_of {
+            std::size_t length;
+            std::size_t parts;
+            std::size_t operator()(std::size_t hash) const {
+                return (hash % length) * parts / length;
+            }
+        } const part = {m_buckets.length, parts};
+
+        //1. хеши и количество ключей каждой порции в каждом диапазоне
+        struct count_body {
+            SOURCE&         source;
+            partition_of    part;
+            std::size_t*    hashes;
+            std::size_t*    counts;
+            void operator()(std::size_t begin, std::size_t end, std::size_t chunk) {
+                std::size_t* c = counts + chunk * part.parts;
+                for (std::size_t p = 0; p < part.parts; ++p)
+                    c[p] = 0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    const std::size_t h = source.hash(i);
+                    hashes[i] = h;
+                    ++c[part(h)];
+                }
+            }
+        } count = {source, part, hashes.data(), offsets.data()};
+        chunking::run_ranges(runner, n, grain, count);
+
+        //2. начало каждой пары (диапазон, порция) в order; внутри диапазона порции идут по порядку
+        std::size_t* off = offsets.data();
+        std::size_t pos = 0;
+        for (std::size_t p = 0; p < parts; ++p) {
+            bounds.data()[p] = pos;
+            for (std::size_t c = 0; c < chunks; ++c) {
+                const std::size_t cnt = off[c * parts + p];
+                off[c * parts + p] = pos;
+                pos += cnt;
+            }
+        }
+        bounds.data()[parts] = pos;
+
+        //3. индексы ключей, сгруппированные по диапазонам с сохранением исходного порядка
+        struct scatter_body {
+            partition_of    part;
+            std::size_t*    hashes;
+            std::size_t*    offsets;
+            std::size_t*    order;
+            void operator()(std::size_t begin, std::size_t end, std::size_t chunk) {
+                std::size_t* o = offsets + chunk * part.parts;
+                for (std::size_t i = begin; i < end; ++i)
+                    order[o[part(hashes[i])]++] = i;
+            }
+        } scatter = {part, hashes.data(), off, order.data()};
+        chunking::run_ranges(runner, n, grain, scatter);
+
+        //4. узлы диапазона создаются в соседних ячейках блока и связываются в свои корзины
+        struct link_body {
+            SOURCE&         source;
+            entry**         buckets;
+            std::size_t     length;
+            entry*          slab;
+            std::size_t*    hashes;
+            std::size_t*    order;
+            std::size_t*    bounds;
+            std::size_t*    added;
+            void operator()(std::size_t p) {
+                TEQUALER equals;
+                std::size_t count = 0;
+                for (std::size_t k = bounds[p]; k < bounds[p + 1]; ++k) {
+                    const std::size_t i     = order[k];
+                    const std::size_t h     = hashes[i];
+                    const std::size_t idx   = h % length;
+                    entry* e = buckets[idx];
+                    while (e != nullptr && !(e->get_hash() == h && equals(e->get_key(), source.key(i))))
+                        e = e->get_next();
+                    if (e != nullptr) {
+                        source.assign(e, i);
+                        continue;
+                    }
+                    e = source.construct(slab + k, i, h);
+                    e->set_next(buckets[idx]);
+                    buckets[idx] = e;
+                    ++count;
+                }
+                added[p] = count;
+            }
+        } link = {source, m_buckets.data(), m_buckets.length, m_slab, hashes.data(), order.data(), bounds.data(), added.data()};
+        try {
+            runner.run(parts, link);
+        } catch (...) {
+            clear();
+            throw;
+        }
+
+        for (std::size_t p = 0; p < parts; ++p)
+            m_size += added.data()[p];
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    hash_map<TKEY, TVALUE, THASHER, TEQUALER> hash_map<TKEY, TVALUE, THASHER, TEQUALER>::from_range(const TKEY* keys, const TVALUE* values, std::size_t n, float load_factor, tca::allocator* allocator) {
+        return from_range(chunking::sequential_runner(), keys, values, n, load_factor, allocator);
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    template<typename RUNNER>
+    hash_map<TKEY, TVALUE, THASHER, TEQUALER> hash_map<TKEY, TVALUE, THASHER, TEQUALER>::from_range(const RUNNER& runner, const TKEY* keys, const TVALUE* values, std::size_t n, float load_factor, tca::allocator* allocator) {
+        JSTD_DEBUG_CODE(
+            if (keys == nullptr && n != 0)
+                throw_except<null_pointer_exception>("keys must be != null");
+        )
+        hash_map<TKEY, TVALUE, THASHER, TEQUALER> result(0, load_factor, allocator);
+        array_source source = {keys, values};
+        result.build(source, n, runner);
+        return hash_map<TKEY, TVALUE, THASHER, TEQUALER>(std::move(result));
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
@@ -463,44 +778,38 @@ public:
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
-    void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::rehash() {
-        array<entry*> _new((std::size_t) (m_buckets.length + (m_buckets.length >> 1)));
+    void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::rehash(std::size_t new_length) {
+        array<entry*> _new(new_length, m_allocator);
         _new.set(nullptr);
 
         array<entry*> old   = std::move(m_buckets);
         m_buckets           = std::move(_new);
         
-        THASHER hashcode;
         for (std::size_t i = 0, len = old.length; i < len; ++i) {
             for (entry* e = old[i]; e != nullptr; ) {
                 entry* current = e;
                 e = e->get_next();
-                std::size_t hash   = hashcode(current->get_key());
-                std::size_t idx    = hash % m_buckets.length;
-                
-                current->set_next(nullptr);
-                if (!m_buckets[idx])
-                {
-                    m_buckets[idx] = current;
-                }
-                else
-                {
-                    entry* entr = m_buckets[idx];
-                    while (entr->get_next())
-                        entr = entr->get_next();
-                    entr->set_next(current);
-                }
+                std::size_t idx = current->get_hash() % m_buckets.length;
+                current->set_next(m_buckets[idx]);
+                m_buckets[idx] = current;
             }
         }
     }
 
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::reserve(std::size_t n) {
+        const std::size_t length = table_length_for(n);
+        if (length > m_buckets.length)
+            rehash(length);
+    }
+
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     template<typename TKEY_, typename TVALUE_>
     bool hash_map<TKEY, TVALUE, THASHER, TEQUALER>::put(TKEY_&& key, TVALUE_&& value) {
         lazy_init();
 
         if (get_load_factor() > m_load_factor) 
-            rehash();
+            rehash((std::size_t) (m_buckets.length + (m_buckets.length >> 1)));
 
         THASHER hashcode;
         std::size_t hash    = hashcode(key);
@@ -560,6 +869,17 @@ public:
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     TVALUE* hash_map<TKEY, TVALUE, THASHER, TEQUALER>::get0(const TKEY& key) {
+        return find(key);
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    const TVALUE* hash_map<TKEY, TVALUE, THASHER, TEQUALER>::get0(const TKEY& key) const {
+        return find(key);
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    template<typename K>
+    TVALUE* hash_map<TKEY, TVALUE, THASHER, TEQUALER>::find(const K& key) {
         if (is_empty())
             return nullptr;
         THASHER hashcode;
@@ -574,7 +894,8 @@ public:
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
-    const TVALUE* hash_map<TKEY, TVALUE, THASHER, TEQUALER>::get0(const TKEY& key) const {
+    template<typename K>
+    const TVALUE* hash_map<TKEY, TVALUE, THASHER, TEQUALER>::find(const K& key) const {
         if (is_empty())
             return nullptr;
         THASHER hashcode;
@@ -681,18 +1002,39 @@ public:
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::clear() {
-        for (std::size_t i = 0; i < m_buckets.length; ++i) {
-            entry* e = m_buckets[i];
-            while (e) {
-                entry* current = e;
-                e = e->get_next();
-                free_entry(current);
+        if (!can_drop_entries()) {
+            for (std::size_t i = 0; i < m_buckets.length; ++i) {
+                entry* e = m_buckets[i];
+                while (e) {
+                    entry* current = e;
+                    e = e->get_next();
+                    free_entry(current);
+                }
             }
         }
+        release_slab();
         m_buckets.set(nullptr);
         m_size = 0;
     }
 
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::release_all() {
+        if (m_allocator == nullptr || !m_allocator->is_monotonic()) {
+            clear();
+        } else if (!can_drop_entries()) {
+            for (std::size_t i = 0; i < m_buckets.length; ++i) {
+                for (entry* e = m_buckets[i]; e != nullptr; ) {
+                    entry* current = e;
+                    e = e->get_next();
+                    current->~entry();
+                }
+            }
+        }
+        release_slab();
+        m_buckets   = array<entry*>();
+        m_size      = 0;
+    }
+
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     hash_map<TKEY, TVALUE, THASHER, TEQUALER> hash_map<TKEY, TVALUE, THASHER, TEQUALER>::clone(tca::allocator* allocator) const {
         if (allocator == nullptr) {
@@ -700,15 +1042,34 @@ public:
                 return hash_map<TKEY, TVALUE, THASHER, TEQUALER>();
             allocator = m_allocator;
         }
-        hash_map<TKEY, TVALUE, THASHER, TEQUALER> result(m_buckets.length, m_load_factor, allocator);
-        for (const entry& e : *this)
-            result.put(e.get_key(), e.get_value());
+        hash_map<TKEY, TVALUE, THASHER, TEQUALER> result(0, m_load_factor, allocator);
+        if (is_empty())
+            return hash_map<TKEY, TVALUE, THASHER, TEQUALER>(std::move(result));
+        //Ключи уникальны, поэтому узлы копируются в один блок и связываются в корзины за один обход
+        //без промежуточных массивов. При исключении result разрушает уже связанные узлы.
+        const std::size_t length = result.table_length_for(m_size);
+        result.m_buckets = array<entry*>(length, allocator);
+        result.m_buckets.set(nullptr);
+        result.m_slab = reinterpret_cast<entry*>(allocator->allocate_align(sizeof(entry) * m_size, alignof(entry)));
+        if (result.m_slab == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        result.m_slab_length = m_size;
+        for (const entry& e : *this) {
+            const std::size_t idx = e.get_hash() % length;
+            entry* copy = new (result.m_slab + result.m_size) entry(e.get_key(), e.get_value(), e.get_hash());
+            copy->set_next(result.m_buckets[idx]);
+            result.m_buckets[idx] = copy;
+            ++result.m_size;
+        }
         return hash_map<TKEY, TVALUE, THASHER, TEQUALER>(std::move(result));
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     template<typename THASHER_, typename TEQUALER_>
     void hash_map<TKEY, TVALUE, THASHER, TEQUALER>::put_all(const hash_map<TKEY, TVALUE, THASHER_, TEQUALER_>& map) {
+        if (map.is_empty())
+            return;
+        reserve(m_size + map.size());
         for (const entry& e : map) {
             put(e.get_key(), e.get_value());
         }
@@ -748,6 +1109,11 @@ public:
         m_next = e;
     }
 
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    std::size_t hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry::get_hash() const {
+        return m_hash;
+    }
+
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     TKEY& hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry::get_key() {
         return m_key;
@@ -214,6 +214,28 @@ public:
      */
     hash_set<K, KEY_HASH, KEY_EQUAL> clone(tca::allocator* allocator = nullptr) const;
 
+    /**
+     * Создаёт множество из n ключей за один проход.
+     *
+     * @see hash_map::from_range
+     */
+    static hash_set<K, KEY_HASH, KEY_EQUAL> from_range(const K* keys, std::size_t n, float load_factor = 0.75f, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Вариант from_range с исполнителем порций (например, parallel::pool_runner).
+     *
+     * @see hash_map::from_range
+     */
+    template<typename RUNNER>
+    static hash_set<K, KEY_HASH, KEY_EQUAL> from_range(const RUNNER& runner, const K* keys, std::size_t n, float load_factor = 0.75f, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Расширяет таблицу так, чтобы n элементов помещались без перехеширования.
+     */
+    void reserve(std::size_t n) {
+        m_storage.reserve(n);
+    }
+
     /**
      * 
      */
@@ -340,5 +362,18 @@ public:
         return hash_set<K, KEY_HASH, KEY_EQUAL>(std::move(result));
     }
 
+    template<typename K, typename KEY_HASH, typename KEY_EQUAL>
+    hash_set<K, KEY_HASH, KEY_EQUAL> hash_set<K, KEY_HASH, KEY_EQUAL>::from_range(const K* keys, std::size_t n, float load_factor, tca::allocator* allocator) {
+        return from_range(chunking::sequential_runner(), keys, n, load_factor, allocator);
+    }
+
+    template<typename K, typename KEY_HASH, typename KEY_EQUAL>
+    template<typename RUNNER>
+    hash_set<K, KEY_HASH, KEY_EQUAL> hash_set<K, KEY_HASH, KEY_EQUAL>::from_range(const RUNNER& runner, const K* keys, std::size_t n, float load_factor, tca::allocator* allocator) {
+        hash_set<K, KEY_HASH, KEY_EQUAL> result(allocator);
+        result.m_storage = hash_map<K, char, KEY_HASH, KEY_EQUAL>::from_range(runner, keys, (const char*) nullptr, n, load_factor, allocator);
+        return hash_set<K, KEY_HASH, KEY_EQUAL>(std::move(result));
+    }
+
 }
 #endif//JSTD_CPP_LANG_UTILS_HASH_SET_H
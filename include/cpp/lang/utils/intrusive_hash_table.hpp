@@ -0,0 +1,559 @@
+#ifndef JSTD_CPP_LANG_UTILS_INTRUSIVE_HASH_TABLE_H
+#define JSTD_CPP_LANG_UTILS_INTRUSIVE_HASH_TABLE_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/array.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cpp/lang/utils/hash.hpp>
+#include <cassert>
+#include <cstdint>
+
+namespace jstd
+{
+
+/**
+ * Поля связи для intrusive_hash_table, встраиваемые в объект.
+ *
+ * Объект может одновременно находиться в нескольких таблицах (и списках), если у него несколько хуков.
+ * Копирование хука не переносит связи: копия всегда не связана ни с одной таблицей.
+ *
+ * @tparam T
+ *      Тип объекта, содержащего хук.
+ */
+template<typename T>
+class hash_hook {
+    template<typename T_, typename K_, K_ T_::*KEY, hash_hook<T_> T_::*HOOK, typename HASH_, typename EQUAL_>
+    friend class intrusive_hash_table;
+
+    /**
+     * Следующий объект в цепочке корзины.
+     */
+    T* m_next;
+
+    /**
+     * Перемешанный хэш-код ключа. Сохраняется, чтобы не вычислять его при перестроении таблицы
+     * и не сравнивать ключи с заведомо другим хэшем.
+     */
+    std::size_t m_hash;
+
+    /**
+     * Таблица, в которой находится объект, или nullptr.
+     */
+    const void* m_owner;
+
+public:
+    /**
+     *
+     */
+    hash_hook() : m_next(nullptr), m_hash(0), m_owner(nullptr) {
+
+    }
+
+    /**
+     *
+     */
+    hash_hook(const hash_hook<T>&) : hash_hook() {
+
+    }
+
+    /**
+     *
+     */
+    hash_hook<T>& operator= (const hash_hook<T>&) {
+        return *this;
+    }
+
+    /**
+     * Объект не должен разрушаться, находясь в таблице.
+     */
+    ~hash_hook() {
+        assert(m_owner == nullptr);
+    }
+
+    /**
+     * @return
+     *      true, если объект находится в какой-либо таблице.
+     */
+    bool is_linked() const {
+        return m_owner != nullptr;
+    }
+};
+
+/**
+ * Интрузивная хэш-таблица с цепочками.
+ *
+ * Ключ и поля связи (hash_hook) хранятся в самих объектах, поэтому вставка и удаление не выделяют память под узлы.
+ * Память выделяется только под массив корзин при росте таблицы; reserve позволяет выделить его заранее.
+ * Таблица не владеет объектами: она не копирует, не перемещает и не разрушает их.
+ * Объект должен оставаться на месте, а его ключ - неизменным, пока объект находится в таблице.
+ *
+ * Пример:
+ * @code
+ *      struct session {
+ *          std::uint64_t id;
+ *          hash_hook<session> by_id;
+ *          list_hook<session> lru;
+ *      };
+ *      intrusive_hash_table<session, std::uint64_t, &session::id, &session::by_id> sessions;
+ * @endcode
+ *
+ * @tparam T
+ *      Тип объектов.
+ *
+ * @tparam K
+ *      Тип ключа.
+ *
+ * @tparam KEY
+ *      Указатель на поле ключа в объекте.
+ *
+ * @tparam HOOK
+ *      Указатель на поле hash_hook<T> в объекте.
+ *
+ * @tparam HASH
+ *      Хэш-функция ключа.
+ *
+ * @tparam EQUAL
+ *      Сравнение ключей на равенство.
+ */
+template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH = hash_for<K>, typename EQUAL = equal_to<K>>
+class intrusive_hash_table {
+    /**
+     * Количество корзин при первой вставке.
+     */
+    static const std::size_t INITIAL_BUCKETS = 16;
+
+    /**
+     *
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     * Корзины, длина - степень двойки.
+     */
+    array<T*> m_buckets;
+
+    /**
+     *
+     */
+    std::size_t m_size;
+
+    /**
+     *
+     */
+    static hash_hook<T>& hook(T& obj) {
+        return obj.*HOOK;
+    }
+
+    /**
+     *
+     */
+    static const hash_hook<T>& hook(const T& obj) {
+        return obj.*HOOK;
+    }
+
+    /**
+     *
+     */
+    static std::size_t hash_of(const K& key) {
+        HASH hasher;
+        return (std::size_t) mix_hash((std::uint64_t) hasher(key));
+    }
+
+    /**
+     *
+     */
+    std::size_t bucket_of(std::size_t hash) const {
+        return hash & (m_buckets.length - 1);
+    }
+
+    /**
+     * Ищет объект с ключом key и заданным хэшем.
+     */
+    T* find0(const K& key, std::size_t hash) const;
+
+    /**
+     * Перестраивает таблицу на buckets корзин (степень двойки).
+     */
+    void rehash(std::size_t buckets);
+
+public:
+    /**
+     * Итератор по объектам таблицы в порядке корзин.
+     * Удаление текущего объекта делает итератор недействительным.
+     */
+    template<typename TVALUE>
+    class iterator {
+        /**
+         *
+         */
+        T* const* m_buckets;
+
+        /**
+         *
+         */
+        std::size_t m_length;
+
+        /**
+         *
+         */
+        std::size_t m_idx;
+
+        /**
+         *
+         */
+        TVALUE* m_node;
+
+        /**
+         * Переходит к первому объекту в непустой корзине, начиная с m_idx.
+         */
+        void skip_empty() {
+            while (m_node == nullptr && m_idx < m_length)
+                m_node = m_buckets[m_idx++];
+        }
+
+    public:
+        /**
+         *
+         */
+        iterator(T* const* buckets, std::size_t length) : m_buckets(buckets), m_length(length), m_idx(0), m_node(nullptr) {
+            skip_empty();
+        }
+
+        /**
+         *
+         */
+        TVALUE& operator* () const {
+            return *m_node;
+        }
+
+        /**
+         *
+         */
+        TVALUE* operator-> () const {
+            return m_node;
+        }
+
+        /**
+         *
+         */
+        bool operator!=(const iterator<TVALUE>& it) const {
+            return m_node != it.m_node;
+        }
+
+        /**
+         *
+         */
+        bool operator==(const iterator<TVALUE>& it) const {
+            return m_node == it.m_node;
+        }
+
+        /**
+         *
+         */
+        iterator<TVALUE>& operator++ () {
+            m_node = hook(*m_node).m_next;
+            skip_empty();
+            return *this;
+        }
+    };
+
+    /**
+     *
+     */
+    intrusive_hash_table(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт таблицу, в которую можно добавить expected объектов без перестроения.
+     */
+    explicit intrusive_hash_table(std::size_t expected, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Таблица хранит адреса объектов, поэтому копирование запрещено.
+     */
+    intrusive_hash_table(const intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>&) = delete;
+
+    /**
+     *
+     */
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>& operator= (const intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>&) = delete;
+
+    /**
+     *
+     */
+    intrusive_hash_table(intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>&& table);
+
+    /**
+     *
+     */
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>& operator= (intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>&& table);
+
+    /**
+     * Отвязывает все объекты.
+     */
+    ~intrusive_hash_table();
+
+    /**
+     * Добавляет объект.
+     *
+     * @return
+     *      true - если объект добавлен, false - если объект с таким ключом уже есть (obj не связывается).
+     *
+     * @throws illegal_argument_exception
+     *      Если объект уже находится в какой-либо таблице по этому хуку (debug).
+     */
+    bool add(T& obj);
+
+    /**
+     * @return
+     *      Объект с ключом key или nullptr.
+     */
+    T* find(const K& key) const;
+
+    /**
+     *
+     */
+    bool contains_key(const K& key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @return
+     *      true, если объект находится именно в этой таблице.
+     */
+    bool contains(const T& obj) const {
+        return hook(obj).m_owner == this;
+    }
+
+    /**
+     * Удаляет объект из таблицы. Просматривается только цепочка его корзины.
+     *
+     * @throws illegal_argument_exception
+     *      Если объект не находится в этой таблице (debug).
+     */
+    void remove(T& obj);
+
+    /**
+     * Удаляет объект с ключом key.
+     *
+     * @return
+     *      Удалённый объект или nullptr.
+     */
+    T* remove_key(const K& key);
+
+    /**
+     * Выделяет корзины под expected объектов, чтобы последующие вставки не выделяли память.
+     */
+    void reserve(std::size_t expected);
+
+    /**
+     * Отвязывает все объекты. Память корзин сохраняется.
+     */
+    void clear();
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     *
+     */
+    std::size_t bucket_count() const {
+        return m_buckets.length;
+    }
+
+    /**
+     *
+     */
+    iterator<T> begin() {
+        return iterator<T>(m_buckets.data(), m_buckets.length);
+    }
+
+    /**
+     *
+     */
+    iterator<T> end() {
+        return iterator<T>(nullptr, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<const T> begin() const {
+        return iterator<const T>(m_buckets.data(), m_buckets.length);
+    }
+
+    /**
+     *
+     */
+    iterator<const T> end() const {
+        return iterator<const T>(nullptr, 0);
+    }
+};
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::intrusive_hash_table(tca::allocator* allocator) :
+        m_allocator(allocator),
+        m_buckets(),
+        m_size(0) {
+
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::intrusive_hash_table(std::size_t expected, tca::allocator* allocator) :
+        m_allocator(allocator),
+        m_buckets(),
+        m_size(0) {
+        reserve(expected);
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::intrusive_hash_table(intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>&& table) :
+        m_allocator(table.m_allocator),
+        m_buckets(std::move(table.m_buckets)),
+        m_size(table.m_size) {
+        for (iterator<T> it = begin(); it != end(); ++it)
+            hook(*it).m_owner = this;
+        table.m_size = 0;
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>& intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::operator= (intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>&& table) {
+        if (&table != this) {
+            clear();
+            m_allocator = table.m_allocator;
+            m_buckets   = std::move(table.m_buckets);
+            m_size      = table.m_size;
+            for (iterator<T> it = begin(); it != end(); ++it)
+                hook(*it).m_owner = this;
+            table.m_size = 0;
+        }
+        return *this;
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::~intrusive_hash_table() {
+        clear();
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    void intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::rehash(std::size_t buckets) {
+        assert(buckets != 0 && (buckets & (buckets - 1)) == 0);
+        array<T*> _new(buckets, m_allocator);
+        _new.set(nullptr);
+
+        array<T*> old   = std::move(m_buckets);
+        m_buckets       = std::move(_new);
+
+        for (std::size_t i = 0, len = old.length; i < len; ++i) {
+            for (T* e = old[i]; e != nullptr; ) {
+                hash_hook<T>& h = hook(*e);
+                T* next = h.m_next;
+                std::size_t idx = bucket_of(h.m_hash);
+                h.m_next = m_buckets[idx];
+                m_buckets[idx] = e;
+                e = next;
+            }
+        }
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    void intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::reserve(std::size_t expected) {
+        std::size_t buckets = m_buckets.length != 0 ? m_buckets.length : INITIAL_BUCKETS;
+        while (buckets < expected)
+            buckets <<= 1;
+        if (buckets != m_buckets.length)
+            rehash(buckets);
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    T* intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::find0(const K& key, std::size_t hash) const {
+        if (m_buckets.length == 0)
+            return nullptr;
+        EQUAL equals;
+        for (T* e = m_buckets[bucket_of(hash)]; e != nullptr; e = hook(*e).m_next) {
+            if (hook(*e).m_hash == hash && equals(e->*KEY, key))
+                return e;
+        }
+        return nullptr;
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    T* intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::find(const K& key) const {
+        return find0(key, hash_of(key));
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    bool intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::add(T& obj) {
+        JSTD_DEBUG_CODE(
+            if (hook(obj).m_owner != nullptr)
+                throw_except<illegal_argument_exception>("Object is already linked");
+        )
+        const std::size_t hash = hash_of(obj.*KEY);
+        if (find0(obj.*KEY, hash) != nullptr)
+            return false;
+        if (m_size >= m_buckets.length)
+            reserve(m_size + 1);
+
+        hash_hook<T>& h = hook(obj);
+        const std::size_t idx = bucket_of(hash);
+        h.m_hash    = hash;
+        h.m_owner   = this;
+        h.m_next    = m_buckets[idx];
+        m_buckets[idx] = &obj;
+        ++m_size;
+        return true;
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    void intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::remove(T& obj) {
+        JSTD_DEBUG_CODE(
+            if (hook(obj).m_owner != this)
+                throw_except<illegal_argument_exception>("Object is not in this table");
+        )
+        hash_hook<T>& h = hook(obj);
+        T** link = &m_buckets[bucket_of(h.m_hash)];
+        while (*link != &obj) {
+            assert(*link != nullptr);
+            link = &hook(**link).m_next;
+        }
+        *link       = h.m_next;
+        h.m_next    = nullptr;
+        h.m_owner   = nullptr;
+        --m_size;
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    T* intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::remove_key(const K& key) {
+        T* obj = find(key);
+        if (obj != nullptr)
+            remove(*obj);
+        return obj;
+    }
+
+    template<typename T, typename K, K T::*KEY, hash_hook<T> T::*HOOK, typename HASH, typename EQUAL>
+    void intrusive_hash_table<T, K, KEY, HOOK, HASH, EQUAL>::clear() {
+        for (std::size_t i = 0; i < m_buckets.length; ++i) {
+            for (T* e = m_buckets[i]; e != nullptr; ) {
+                hash_hook<T>& h = hook(*e);
+                e = h.m_next;
+                h.m_next    = nullptr;
+                h.m_owner   = nullptr;
+            }
+            m_buckets[i] = nullptr;
+        }
+        m_size = 0;
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_INTRUSIVE_HASH_TABLE_H
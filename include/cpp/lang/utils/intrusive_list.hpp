@@ -0,0 +1,562 @@
+#ifndef JSTD_CPP_LANG_UTILS_INTRUSIVE_LIST_H
+#define JSTD_CPP_LANG_UTILS_INTRUSIVE_LIST_H
+
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cassert>
+#include <cstdint>
+
+namespace jstd
+{
+
+/**
+ * Поля связи для intrusive_list, встраиваемые в объект.
+ *
+ * Объект может одновременно находиться в нескольких списках, если у него несколько полей list_hook.
+ * Копирование и перемещение хука не переносит связи: копия всегда не связана ни с одним списком.
+ *
+ * @tparam T
+ *      Тип объекта, содержащего хук.
+ */
+template<typename T>
+class list_hook {
+    template<typename T_, list_hook<T_> T_::*HOOK>
+    friend class intrusive_list;
+
+    /**
+     *
+     */
+    T* m_prev;
+
+    /**
+     *
+     */
+    T* m_next;
+
+    /**
+     * Список, в котором находится объект, или nullptr.
+     */
+    const void* m_owner;
+
+public:
+    /**
+     *
+     */
+    list_hook() : m_prev(nullptr), m_next(nullptr), m_owner(nullptr) {
+
+    }
+
+    /**
+     *
+     */
+    list_hook(const list_hook<T>&) : list_hook() {
+
+    }
+
+    /**
+     *
+     */
+    list_hook<T>& operator= (const list_hook<T>&) {
+        return *this;
+    }
+
+    /**
+     * Объект не должен разрушаться, находясь в списке.
+     */
+    ~list_hook() {
+        assert(m_owner == nullptr);
+    }
+
+    /**
+     * @return
+     *      true, если объект находится в каком-либо списке.
+     */
+    bool is_linked() const {
+        return m_owner != nullptr;
+    }
+};
+
+/**
+ * Интрузивный двусвязный список.
+ *
+ * Поля связи хранятся в самих объектах (list_hook), поэтому вставка и удаление никогда не выделяют память,
+ * а удаление объекта по ссылке выполняется за O(1) без поиска.
+ * Список не владеет объектами: он не копирует, не перемещает и не разрушает их.
+ * Объект должен оставаться на месте, пока находится в списке.
+ *
+ * Пример:
+ * @code
+ *      struct connection {
+ *          int fd;
+ *          list_hook<connection> idle_hook;
+ *          list_hook<connection> all_hook;
+ *      };
+ *      intrusive_list<connection, &connection::idle_hook> idle;
+ *      intrusive_list<connection, &connection::all_hook> all;
+ * @endcode
+ *
+ * @tparam T
+ *      Тип объектов.
+ *
+ * @tparam HOOK
+ *      Указатель на поле list_hook<T> в объекте.
+ */
+template<typename T, list_hook<T> T::*HOOK>
+class intrusive_list {
+    /**
+     *
+     */
+    T* m_first;
+
+    /**
+     *
+     */
+    T* m_last;
+
+    /**
+     *
+     */
+    std::size_t m_size;
+
+    /**
+     *
+     */
+    static list_hook<T>& hook(T& obj) {
+        return obj.*HOOK;
+    }
+
+    /**
+     *
+     */
+    static const list_hook<T>& hook(const T& obj) {
+        return obj.*HOOK;
+    }
+
+    /**
+     * @throws illegal_argument_exception
+     *      Если объект уже находится в списке (debug).
+     */
+    void check_unlinked(const T& obj) const;
+
+    /**
+     * @throws illegal_argument_exception
+     *      Если объект не находится в этом списке (debug).
+     */
+    void check_owned(const T& obj) const;
+
+    /**
+     * Вставляет obj между prev и next.
+     */
+    void link(T& obj, T* prev, T* next);
+
+public:
+    /**
+     * Итератор по объектам списка.
+     * Удаление текущего объекта делает итератор недействительным, остальные объекты можно удалять свободно.
+     */
+    template<typename TVALUE>
+    class iterator {
+        /**
+         *
+         */
+        TVALUE* m_node;
+
+    public:
+        /**
+         *
+         */
+        explicit iterator(TVALUE* node) : m_node(node) {}
+
+        /**
+         *
+         */
+        TVALUE& operator* () const {
+            return *m_node;
+        }
+
+        /**
+         *
+         */
+        TVALUE* operator-> () const {
+            return m_node;
+        }
+
+        /**
+         *
+         */
+        bool operator!=(const iterator<TVALUE>& it) const {
+            return m_node != it.m_node;
+        }
+
+        /**
+         *
+         */
+        bool operator==(const iterator<TVALUE>& it) const {
+            return m_node == it.m_node;
+        }
+
+        /**
+         *
+         */
+        iterator<TVALUE>& operator++ () {
+            m_node = hook(*m_node).m_next;
+            return *this;
+        }
+
+        /**
+         *
+         */
+        iterator<TVALUE> operator++ (int) {
+            iterator<TVALUE> tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+    };
+
+    /**
+     *
+     */
+    intrusive_list();
+
+    /**
+     * Список хранит адреса объектов, поэтому копирование запрещено.
+     */
+    intrusive_list(const intrusive_list<T, HOOK>&) = delete;
+
+    /**
+     *
+     */
+    intrusive_list<T, HOOK>& operator= (const intrusive_list<T, HOOK>&) = delete;
+
+    /**
+     *
+     */
+    intrusive_list(intrusive_list<T, HOOK>&& list);
+
+    /**
+     *
+     */
+    intrusive_list<T, HOOK>& operator= (intrusive_list<T, HOOK>&& list);
+
+    /**
+     * Отвязывает все объекты.
+     */
+    ~intrusive_list();
+
+    /**
+     * Вставляет объект в начало списка.
+     *
+     * @throws illegal_argument_exception
+     *      Если объект уже находится в каком-либо списке по этому хуку (debug).
+     */
+    void add_first(T& obj);
+
+    /**
+     * Вставляет объект в конец списка.
+     *
+     * @throws illegal_argument_exception
+     *      Если объект уже находится в каком-либо списке по этому хуку (debug).
+     */
+    void add_last(T& obj);
+
+    /**
+     * Вставляет объект перед pos.
+     *
+     * @throws illegal_argument_exception
+     *      Если pos не находится в этом списке или obj уже связан (debug).
+     */
+    void add_before(T& pos, T& obj);
+
+    /**
+     * Вставляет объект после pos.
+     *
+     * @throws illegal_argument_exception
+     *      Если pos не находится в этом списке или obj уже связан (debug).
+     */
+    void add_after(T& pos, T& obj);
+
+    /**
+     * Удаляет объект из списка за O(1).
+     *
+     * @throws illegal_argument_exception
+     *      Если объект не находится в этом списке (debug).
+     */
+    void remove(T& obj);
+
+    /**
+     * Удаляет первый объект.
+     *
+     * @return
+     *      Удалённый объект или nullptr, если список пуст.
+     */
+    T* remove_first();
+
+    /**
+     * Удаляет последний объект.
+     *
+     * @return
+     *      Удалённый объект или nullptr, если список пуст.
+     */
+    T* remove_last();
+
+    /**
+     * Перемещает объект этого списка в конец за O(1). Удобно для LRU.
+     */
+    void move_to_last(T& obj);
+
+    /**
+     * @return
+     *      true, если объект находится именно в этом списке.
+     */
+    bool contains(const T& obj) const {
+        return hook(obj).m_owner == this;
+    }
+
+    /**
+     * @throws no_such_element_exception
+     *      Если список пуст.
+     */
+    T& first() const;
+
+    /**
+     * @throws no_such_element_exception
+     *      Если список пуст.
+     */
+    T& last() const;
+
+    /**
+     * @return
+     *      Следующий объект или nullptr.
+     */
+    static T* next(const T& obj) {
+        return hook(obj).m_next;
+    }
+
+    /**
+     * @return
+     *      Предыдущий объект или nullptr.
+     */
+    static T* prev(const T& obj) {
+        return hook(obj).m_prev;
+    }
+
+    /**
+     * Отвязывает все объекты за O(n).
+     */
+    void clear();
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     *
+     */
+    iterator<T> begin() {
+        return iterator<T>(m_first);
+    }
+
+    /**
+     *
+     */
+    iterator<T> end() {
+        return iterator<T>(nullptr);
+    }
+
+    /**
+     *
+     */
+    iterator<const T> begin() const {
+        return iterator<const T>(m_first);
+    }
+
+    /**
+     *
+     */
+    iterator<const T> end() const {
+        return iterator<const T>(nullptr);
+    }
+};
+
+    template<typename T, list_hook<T> T::*HOOK>
+    intrusive_list<T, HOOK>::intrusive_list() : m_first(nullptr), m_last(nullptr), m_size(0) {
+
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    intrusive_list<T, HOOK>::intrusive_list(intrusive_list<T, HOOK>&& list) :
+        m_first(list.m_first),
+        m_last(list.m_last),
+        m_size(list.m_size) {
+        for (T* i = m_first; i != nullptr; i = hook(*i).m_next)
+            hook(*i).m_owner = this;
+        list.m_first    = nullptr;
+        list.m_last     = nullptr;
+        list.m_size     = 0;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    intrusive_list<T, HOOK>& intrusive_list<T, HOOK>::operator= (intrusive_list<T, HOOK>&& list) {
+        if (&list != this) {
+            clear();
+            m_first = list.m_first;
+            m_last  = list.m_last;
+            m_size  = list.m_size;
+            for (T* i = m_first; i != nullptr; i = hook(*i).m_next)
+                hook(*i).m_owner = this;
+            list.m_first    = nullptr;
+            list.m_last     = nullptr;
+            list.m_size     = 0;
+        }
+        return *this;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    intrusive_list<T, HOOK>::~intrusive_list() {
+        clear();
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::check_unlinked(const T& obj) const {
+        JSTD_DEBUG_CODE(
+            if (hook(obj).m_owner != nullptr)
+                throw_except<illegal_argument_exception>("Object is already linked");
+        )
+        (void) obj;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::check_owned(const T& obj) const {
+        JSTD_DEBUG_CODE(
+            if (hook(obj).m_owner != this)
+                throw_except<illegal_argument_exception>("Object is not in this list");
+        )
+        (void) obj;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::link(T& obj, T* prev, T* next) {
+        list_hook<T>& h = hook(obj);
+        h.m_prev    = prev;
+        h.m_next    = next;
+        h.m_owner   = this;
+        if (prev != nullptr)
+            hook(*prev).m_next = &obj;
+        else
+            m_first = &obj;
+        if (next != nullptr)
+            hook(*next).m_prev = &obj;
+        else
+            m_last = &obj;
+        ++m_size;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::add_first(T& obj) {
+        check_unlinked(obj);
+        link(obj, nullptr, m_first);
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::add_last(T& obj) {
+        check_unlinked(obj);
+        link(obj, m_last, nullptr);
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::add_before(T& pos, T& obj) {
+        check_owned(pos);
+        check_unlinked(obj);
+        link(obj, hook(pos).m_prev, &pos);
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::add_after(T& pos, T& obj) {
+        check_owned(pos);
+        check_unlinked(obj);
+        link(obj, &pos, hook(pos).m_next);
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::remove(T& obj) {
+        check_owned(obj);
+        list_hook<T>& h = hook(obj);
+        if (h.m_prev != nullptr)
+            hook(*h.m_prev).m_next = h.m_next;
+        else
+            m_first = h.m_next;
+        if (h.m_next != nullptr)
+            hook(*h.m_next).m_prev = h.m_prev;
+        else
+            m_last = h.m_prev;
+        h.m_prev    = nullptr;
+        h.m_next    = nullptr;
+        h.m_owner   = nullptr;
+        --m_size;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    T* intrusive_list<T, HOOK>::remove_first() {
+        T* obj = m_first;
+        if (obj != nullptr)
+            remove(*obj);
+        return obj;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    T* intrusive_list<T, HOOK>::remove_last() {
+        T* obj = m_last;
+        if (obj != nullptr)
+            remove(*obj);
+        return obj;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::move_to_last(T& obj) {
+        check_owned(obj);
+        if (m_last == &obj)
+            return;
+        remove(obj);
+        link(obj, m_last, nullptr);
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    T& intrusive_list<T, HOOK>::first() const {
+        if (m_first == nullptr)
+            throw_except<no_such_element_exception>("List is empty");
+        return *m_first;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    T& intrusive_list<T, HOOK>::last() const {
+        if (m_last == nullptr)
+            throw_except<no_such_element_exception>("List is empty");
+        return *m_last;
+    }
+
+    template<typename T, list_hook<T> T::*HOOK>
+    void intrusive_list<T, HOOK>::clear() {
+        for (T* i = m_first; i != nullptr; ) {
+            list_hook<T>& h = hook(*i);
+            i = h.m_next;
+            h.m_prev    = nullptr;
+            h.m_next    = nullptr;
+            h.m_owner   = nullptr;
+        }
+        m_first = nullptr;
+        m_last  = nullptr;
+        m_size  = 0;
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_INTRUSIVE_LIST_H
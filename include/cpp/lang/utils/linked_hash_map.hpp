@@ -5,6 +5,7 @@
 #include <cpp/lang/utils/hash.hpp>
 #include <cpp/lang/array.hpp>
 #include <cassert>
+#include <type_traits>
 
 namespace jstd
 {
@@ -69,6 +70,11 @@ public:
          * 
          */
         TKEY& get_key();
+
+        /**
+         * Хеш-код ключа, посчитанный при вставке.
+         */
+        std::size_t get_hash() const;
         
         /**
          * 
@@ -174,6 +180,16 @@ private:
      */
     void lazy_init();
 
+    /**
+     * Возвращает true, если узлы можно не обходить при очистке:
+     * аллокатор монотонный, а ключи и значения тривиально разрушаемые.
+     */
+    bool can_drop_entries() const {
+        return std::is_trivially_destructible<TKEY>::value &&
+               std::is_trivially_destructible<TVALUE>::value &&
+               m_allocator != nullptr && m_allocator->is_monotonic();
+    }
+
     /**
      * 
      */
@@ -246,6 +262,31 @@ public:
     template<typename TKEY_, typename TVALUE_>
     bool put(TKEY_&& key, TVALUE_&& value);
 
+    /**
+     * Ищет запись по ключу, а если её нет - добавляет запись с ключом key и значением TVALUE(args...).
+     * Ключ хешируется один раз. key и args используются только при добавлении.
+     * В режиме access_order найденная запись перемещается в конец списка, как при get.
+     *
+     * @param inserted
+     *      Сюда записывается true, если запись была добавлена.
+     *
+     * @return
+     *      Запись с ключом key или nullptr, если новая запись сразу удалена через remove_eldest_entry.
+     */
+    template<typename TKEY_, typename... ARGS>
+    entry* try_emplace(TKEY_&& key, bool& inserted, ARGS&&... args);
+
+    /**
+     * Возвращает запись по ключу или nullptr.
+     * В режиме access_order найденная запись перемещается в конец списка, как при get.
+     */
+    entry* find_entry(const TKEY& key);
+
+    /**
+     * Удаляет запись этой карты по указателю. Ключ повторно не хешируется и не сравнивается.
+     */
+    void remove_entry(entry* e);
+
     /**
      * @throws no_such_element_exception
      *      Если значения по переданному ключу не существует.
@@ -308,10 +349,21 @@ public:
     bool is_empty() const;
 
     /**
-     * 
+     * Удаляет все элементы. Таблица корзин сохраняется.
+     * Если can_drop_entries(), узлы не обходятся: очищается только таблица корзин.
      */
     void clear();
 
+    /**
+     * Удаляет все элементы и освобождает таблицу корзин.
+     * 
+     * С монотонным аллокатором (tca::base_allocator::is_monotonic) узлы не возвращаются аллокатору по одному,
+     * их память освобождается при сбросе аллокатора. Для тривиально разрушаемых ключей и значений это O(1),
+     * для остальных - O(n) вызовов деструкторов.
+     * С обычным аллокатором равносильно clear() с последующим освобождением таблицы корзин.
+     */
+    void release_all();
+
     /**
      * 
      */
@@ -502,7 +554,8 @@ public:
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::~linked_hash_map() {
-        clear();
+        if (!can_drop_entries())
+            clear();
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
@@ -648,10 +701,14 @@ public:
     }
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
-    TVALUE* linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::get0(const TKEY& key) {
+    template<typename TKEY_, typename... ARGS>
+    typename linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry* linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::try_emplace(TKEY_&& key, bool& inserted, ARGS&&... args) {
+        lazy_init();
+
         THASHER hashcode;
         std::size_t hash   = hashcode(key);
         std::size_t idx    = hash % m_buckets.length;
+
         TEQUALER equals;
         for (entry* i = m_buckets[idx]; i != nullptr; i = i->get_next()) {
             if (equals(i->get_key(), key)) {
@@ -659,14 +716,83 @@ public:
                     unlink(i);
                     link_last(i);
                 }
-                return &i->get_value();
+                inserted = false;
+                return i;
+            }
+        }
+
+        if (get_load_factor() > m_load_factor) {
+            rehash();
+            idx = hash % m_buckets.length;
+        }
+
+        entry* _new = alloc_entry(std::forward<TKEY_>(key), TVALUE(std::forward<ARGS>(args)...), hash);
+        _new->set_next(m_buckets[idx]);
+        m_buckets[idx] = _new;
+
+        link_last(_new);
+        ++m_size;
+        inserted = true;
+
+        entry* eldest = m_head;
+        assert(eldest != nullptr);
+        if (remove_eldest_entry(eldest)) {
+            remove_entry(eldest);
+            if (eldest == _new)
+                return nullptr;
+        }
+        return _new;
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    void linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::remove_entry(entry* e) {
+        assert(e != nullptr && m_buckets.length != 0);
+        const std::size_t idx = e->get_hash() % m_buckets.length;
+        if (m_buckets[idx] == e) {
+            m_buckets[idx] = e->get_next();
+        } else {
+            entry* prev = m_buckets[idx];
+            while (prev->get_next() != e) {
+                prev = prev->get_next();
+                assert(prev != nullptr);
+            }
+            prev->set_next(e->get_next());
+        }
+        unlink(e);
+        free_entry(e);
+        --m_size;
+    }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    typename linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry* linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::find_entry(const TKEY& key) {
+        if (is_empty())
+            return nullptr;
+        THASHER hashcode;
+        std::size_t hash   = hashcode(key);
+        std::size_t idx    = hash % m_buckets.length;
+        TEQUALER equals;
+        for (entry* i = m_buckets[idx]; i != nullptr; i = i->get_next()) {
+            if (equals(i->get_key(), key)) {
+                if (m_access_order) {
+                    unlink(i);
+                    link_last(i);
+                }
+                return i;
             }
         }
         return nullptr;
     }
 
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    TVALUE* linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::get0(const TKEY& key) {
+        entry* e = find_entry(key);
+        return e != nullptr ? &e->get_value() : nullptr;
+    }
+
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     const TVALUE* linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::get0(const TKEY& key) const {
+        if (is_empty())
+            return nullptr;
         THASHER hashcode;
         std::size_t hash   = hashcode(key);
         std::size_t idx    = hash % m_buckets.length;
@@ -682,6 +808,8 @@ public:
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     template<typename TVALUE_>
     bool linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::replace(const TKEY& key, TVALUE_&& value) {
+        if (is_empty())
+            return false;
         THASHER hashcode;
         std::size_t hash   = hashcode(key);
         std::size_t idx    = hash % m_buckets.length;
@@ -834,17 +962,35 @@ public:
 
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     void linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::clear() {
-        while (m_head)
-        {
-            entry* for_removal = m_head;
-            m_head = m_head->get_list_next();
-            free_entry(for_removal);
+        if (!can_drop_entries()) {
+            while (m_head)
+            {
+                entry* for_removal = m_head;
+                m_head = m_head->get_list_next();
+                free_entry(for_removal);
+            }
         }
         m_buckets.set(nullptr);
         m_head = m_tail = nullptr;
         m_size = 0;
     }
 
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    void linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::release_all() {
+        if (m_allocator == nullptr || !m_allocator->is_monotonic()) {
+            clear();
+        } else if (!can_drop_entries()) {
+            for (entry* e = m_head; e != nullptr; ) {
+                entry* current = e;
+                e = e->get_list_next();
+                current->~entry();
+            }
+        }
+        m_buckets   = array<entry*>();
+        m_head      = m_tail = nullptr;
+        m_size      = 0;
+    }
+
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER> linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::clone(tca::allocator* allocator) const {
         if (allocator == nullptr) {
@@ -910,6 +1056,11 @@ public:
     TKEY& linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry::get_key() {
         return m_key;
     }
+
+    template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
+    std::size_t linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry::get_hash() const {
+        return m_hash;
+    }
     
     template<typename TKEY, typename TVALUE, typename THASHER, typename TEQUALER>
     TVALUE& linked_hash_map<TKEY, TVALUE, THASHER, TEQUALER>::entry::get_value() {
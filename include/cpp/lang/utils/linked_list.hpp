@@ -7,6 +7,7 @@
 #include <utility>
 #include <cstdint>
 #include <cassert>
+#include <type_traits>
 
 namespace jstd {
 
@@ -248,6 +249,14 @@ class linked_list {
      */
     void delete_node(list_node<T>* node);
 
+    /**
+     * Возвращает true, если узлы можно не обходить при очистке:
+     * аллокатор монотонный, а T тривиально разрушаемый.
+     */
+    bool can_drop_nodes() const {
+        return std::is_trivially_destructible<T>::value && _allocator != nullptr && _allocator->is_monotonic();
+    }
+
     /**
      * Возвращает указатель на узел по индексу.
      * 
@@ -347,9 +356,20 @@ public:
     /**
      * 
      *      Удаляет все элементы из списка.
+     *      Если can_drop_nodes(), узлы не обходятся и очистка выполняется за O(1).
      */
     void clear();
 
+    /**
+     * Удаляет все элементы, не возвращая память узлов аллокатору по одному.
+     * 
+     * С монотонным аллокатором (tca::base_allocator::is_monotonic) выполняется за O(1)
+     * для тривиально разрушаемых T и за O(n) вызовов деструкторов для остальных:
+     * память узлов возвращается при сбросе аллокатора.
+     * С обычным аллокатором равносильно clear().
+     */
+    void release_all();
+
     /**
      * Добавляет элемент в конец списка.
      * 
@@ -644,12 +664,35 @@ public:
 
     template<typename T>
     linked_list<T>::~linked_list() {
-        clear();
+        if (!can_drop_nodes())
+            clear();
+    }
+
+    template<typename T>
+    void linked_list<T>::release_all() {
+        if (_allocator == nullptr || !_allocator->is_monotonic()) {
+            clear();
+            return;
+        }
+        if (!std::is_trivially_destructible<T>::value) {
+            for (list_node<T>* i = _head; i != nullptr; ) {
+                list_node<T>* current = i;
+                i = i->get_next();
+                current->~list_node();
+            }
+        }
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
     }
 
     template<typename T>
     void linked_list<T>::clear() {
-        if (_allocator != nullptr) {
+        if (can_drop_nodes()) {
+            _head = nullptr;
+            _tail = nullptr;
+            _size = 0;
+        } else if (_allocator != nullptr) {
             for (list_node<T>* i = _head; i != nullptr; ) {
                 list_node<T>* current = i;
                 i = i->get_next();
@@ -0,0 +1,543 @@
+#ifndef JSTD_CPP_LANG_UTILS_LRU_CACHE_H
+#define JSTD_CPP_LANG_UTILS_LRU_CACHE_H
+
+#include <cpp/lang/utils/linked_hash_map.hpp>
+#include <cpp/lang/concurrency/mutex.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/array.hpp>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+namespace jstd
+{
+
+/**
+ * Политика вытеснения записей из кэша.
+ */
+enum struct cache_policy {
+    LRU,    /* Точный LRU. Каждое попадание перемещает запись в конец списка доступа.                   */
+    CLOCK   /* Аппроксимация LRU (второй шанс). Попадание только выставляет бит обращения, список не меняется. */
+};
+
+/**
+ * Функтор для вычисления "веса" записи кэша.
+ * Используется для ограничения кэша по занимаемому объёму.
+ *
+ * По умолчанию вес записи равен sizeof(K) + sizeof(V).
+ * Для типов, владеющих динамической памятью (строки, массивы),
+ * необходимо определить специализацию.
+ *
+ * @tparam K
+ *      Тип ключа.
+ *
+ * @tparam V
+ *      Тип значения.
+ */
+template<typename K, typename V>
+struct cache_weigher {
+    std::size_t operator() (const K&, const V&) const {
+        return sizeof(K) + sizeof(V);
+    }
+};
+
+/**
+ * Потокобезопасный кэш с ограничением по количеству записей и/или суммарному весу.
+ *
+ * Кэш разделён на сегменты (шарды), каждый из которых защищён собственным мьютексом.
+ * Ключ попадает в сегмент по своему хеш-коду, поэтому потоки, работающие с разными ключами,
+ * в большинстве случаев не конкурируют за одну блокировку.
+ * Ограничения (max_entries и max_weight) делятся между сегментами без округления вверх: сумма ограничений сегментов
+ * равна заданному. Сегмент вытесняет записи по своему ограничению, поэтому при неравномерном распределении ключей
+ * вытеснение может начаться раньше, чем кэш заполнится целиком.
+ *
+ * Каждый сегмент построен на linked_hash_map:
+ *      - cache_policy::LRU     - карта в режиме access_order, попадание перемещает запись в конец списка.
+ *      - cache_policy::CLOCK   - карта в режиме порядка вставки, попадание только выставляет бит обращения,
+ *                                а при вытеснении "стрелка" обходит список и даёт записям с выставленным битом второй шанс.
+ *                                Попадание не перестраивает список, но, как и любая операция, выполняется под блокировкой сегмента.
+ *
+ * @tparam K
+ *      Тип ключа.
+ *
+ * @tparam V
+ *      Тип значения. Должен быть копируемым, так как get() возвращает копию значения.
+ *
+ * @tparam HASHER
+ *      Хеш-функция ключа.
+ *
+ * @tparam EQUALER
+ *      Функция сравнения ключей.
+ *
+ * @tparam WEIGHER
+ *      Функтор вычисления веса записи.
+ */
+template<typename K, typename V, typename HASHER = hash_for<K>, typename EQUALER = equal_to<K>, typename WEIGHER = cache_weigher<K, V>>
+class lru_cache {
+public:
+    /**
+     * Слушатель вытеснения записей.
+     *
+     * Вызывается, когда запись удаляется из кэша из-за превышения ограничений.
+     * Вызов происходит под блокировкой сегмента, поэтому обработчик не должен обращаться к этому же кэшу.
+     */
+    class eviction_listener {
+    public:
+        /**
+         * @param key
+         *      Ключ вытесняемой записи.
+         *
+         * @param value
+         *      Значение вытесняемой записи. Можно забрать через std::move.
+         */
+        virtual void on_evict(const K& key, V& value) = 0;
+
+        /**
+         *
+         */
+        virtual ~eviction_listener() {}
+    };
+
+private:
+    /**
+     * Значение, хранимое в карте сегмента.
+     */
+    struct slot {
+        /**
+         *
+         */
+        V value;
+
+        /**
+         * Вес записи, посчитанный при вставке.
+         */
+        std::size_t weight;
+
+        /**
+         * Бит обращения для политики CLOCK.
+         */
+        bool referenced;
+
+        /**
+         *
+         */
+        template<typename V_>
+        slot(V_&& v, std::size_t w) : value(std::forward<V_>(v)), weight(w), referenced(false) {}
+    };
+
+    /**
+     *
+     */
+    typedef linked_hash_map<K, slot, HASHER, EQUALER> map_type;
+
+    /**
+     *
+     */
+    typedef typename map_type::entry entry;
+
+    /**
+     * Сегмент кэша.
+     */
+    struct shard {
+        /**
+         *
+         */
+        mutex m_lock;
+
+        /**
+         *
+         */
+        map_type m_map;
+
+        /**
+         * Текущая позиция "стрелки" для политики CLOCK.
+         */
+        entry* m_hand;
+
+        /**
+         * Суммарный вес записей сегмента.
+         */
+        std::size_t m_weight;
+
+        /**
+         * Максимальное количество записей сегмента.
+         */
+        std::size_t m_max_entries;
+
+        /**
+         * Максимальный вес сегмента. Учитывается, только если задан max_weight кэша.
+         */
+        std::size_t m_max_weight;
+
+        /**
+         *
+         */
+        shard() : m_lock(), m_map(), m_hand(nullptr), m_weight(0), m_max_entries(0), m_max_weight(0) {}
+    };
+
+    /**
+     *
+     */
+    array<shard> m_shards;
+
+    /**
+     * Маска для выбора сегмента. (количество сегментов - 1)
+     */
+    std::size_t m_shard_mask;
+
+    /**
+     * Ограничен ли вес записей.
+     */
+    bool m_weight_limited;
+
+    /**
+     *
+     */
+    cache_policy m_policy;
+
+    /**
+     *
+     */
+    eviction_listener* m_listener;
+
+    /**
+     *
+     */
+    lru_cache(const lru_cache&)             = delete;
+
+    /**
+     *
+     */
+    lru_cache& operator= (const lru_cache&) = delete;
+
+    /**
+     * Возвращает сегмент для ключа.
+     */
+    shard& shard_for(const K& key);
+
+    /**
+     *
+     */
+    const shard& shard_for(const K& key) const;
+
+    /**
+     * Вытесняет записи сегмента, пока он не уложится в ограничения.
+     * Вызывается под блокировкой сегмента.
+     */
+    void evict(shard& s);
+
+    /**
+     * Выбирает жертву для вытеснения.
+     */
+    entry* select_victim(shard& s);
+
+    /**
+     * Удаляет запись из сегмента, сдвигая "стрелку", если она указывает на удаляемую запись.
+     * Вызывается под блокировкой сегмента.
+     */
+    void remove_entry(shard& s, entry* e);
+
+public:
+    /**
+     * Создаёт кэш.
+     *
+     * @param max_entries
+     *      Максимальное количество записей во всём кэше. Должно быть > 0.
+     *
+     * @param max_weight
+     *      Максимальный суммарный вес записей во всём кэше. 0 - без ограничения.
+     *
+     * @param shards
+     *      Количество сегментов. Округляется вверх до степени двойки, но не превышает max_entries,
+     *      чтобы каждому сегменту досталась хотя бы одна запись.
+     *
+     * @param policy
+     *      Политика вытеснения.
+     *
+     * @param allocator
+     *      Аллокатор для сегментов и записей.
+     *
+     * @throws illegal_argument_exception
+     *      Если max_entries == 0 или shards == 0.
+     */
+    lru_cache(std::size_t max_entries,
+              std::size_t max_weight        = 0,
+              std::size_t shards            = 16,
+              cache_policy policy           = cache_policy::LRU,
+              tca::allocator* allocator     = tca::get_scoped_or_default());
+
+    /**
+     *
+     */
+    ~lru_cache();
+
+    /**
+     * Помещает значение в кэш. Если ключ уже есть, значение заменяется.
+     * После вставки сегмент вытесняет записи, пока не уложится в ограничения.
+     *
+     * @return
+     *      true - если была добавлена новая запись, false - если значение заменено.
+     */
+    template<typename K_, typename V_>
+    bool put(K_&& key, V_&& value);
+
+    /**
+     * Копирует значение по ключу в out.
+     * Для LRU перемещает запись в конец списка, для CLOCK выставляет бит обращения.
+     *
+     * @param key
+     *      Ключ.
+     *
+     * @param out
+     *      Указатель, куда будет скопировано значение. Может быть nullptr.
+     *
+     * @return
+     *      true - если значение найдено.
+     */
+    bool get(const K& key, V* out);
+
+    /**
+     * Проверяет наличие ключа. Не влияет на порядок вытеснения.
+     */
+    bool contains_key(const K& key) const;
+
+    /**
+     * Удаляет запись по ключу. Слушатель вытеснения не вызывается.
+     *
+     * @param key
+     *      Ключ.
+     *
+     * @param ret
+     *      (Необязательно) указатель, куда будет перемещено удалённое значение.
+     *
+     * @return
+     *      true - если запись была удалена.
+     */
+    bool remove(const K& key, V* ret = nullptr);
+
+    /**
+     * Удаляет все записи. Слушатель вытеснения не вызывается.
+     */
+    void clear();
+
+    /**
+     * Возвращает количество записей.
+     * Значение является моментальным снимком и может устареть при конкурентном доступе.
+     */
+    std::size_t size() const;
+
+    /**
+     * Возвращает суммарный вес записей.
+     * Значение является моментальным снимком и может устареть при конкурентном доступе.
+     */
+    std::size_t weight() const;
+
+    /**
+     * Устанавливает слушатель вытеснения.
+     * Должен вызываться до начала конкурентной работы с кэшем.
+     *
+     * @param listener
+     *      Слушатель или nullptr.
+     */
+    void set_eviction_listener(eviction_listener* listener);
+
+    /**
+     *
+     */
+    cache_policy get_policy() const;
+};
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    lru_cache<K, V, HASHER, EQUALER, WEIGHER>::lru_cache(std::size_t max_entries, std::size_t max_weight, std::size_t shards, cache_policy policy, tca::allocator* allocator) :
+        m_shards(),
+        m_shard_mask(0),
+        m_weight_limited(max_weight != 0),
+        m_policy(policy),
+        m_listener(nullptr) {
+        if (max_entries == 0)
+            throw_except<illegal_argument_exception>("max_entries must be > 0");
+        if (shards == 0)
+            throw_except<illegal_argument_exception>("shards must be > 0");
+
+        std::size_t count = 1;
+        while (count < shards && count * 2 <= max_entries)
+            count <<= 1;
+
+        m_shards            = array<shard>(count, allocator);
+        m_shard_mask        = count - 1;
+
+        //остаток от деления достаётся первым сегментам, чтобы сумма ограничений совпадала с заданной
+        const bool access_order = policy == cache_policy::LRU;
+        for (std::size_t i = 0; i < count; ++i) {
+            shard& s = m_shards[i];
+            s.m_map         = map_type(0, 0.75f, access_order, allocator);
+            s.m_max_entries = max_entries / count + (i < max_entries % count ? 1 : 0);
+            s.m_max_weight  = max_weight / count + (i < max_weight % count ? 1 : 0);
+        }
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    lru_cache<K, V, HASHER, EQUALER, WEIGHER>::~lru_cache() {
+
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    typename lru_cache<K, V, HASHER, EQUALER, WEIGHER>::shard& lru_cache<K, V, HASHER, EQUALER, WEIGHER>::shard_for(const K& key) {
+        HASHER hashcode;
+        std::size_t h = hashcode(key);
+        //перемешиваем старшие биты в младшие, чтобы последовательные ключи не попадали в один сегмент
+        h ^= (h >> 16);
+        h *= (std::size_t) 0x9E3779B97F4A7C15ull;
+        h ^= (h >> 29);
+        return m_shards[h & m_shard_mask];
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    const typename lru_cache<K, V, HASHER, EQUALER, WEIGHER>::shard& lru_cache<K, V, HASHER, EQUALER, WEIGHER>::shard_for(const K& key) const {
+        return const_cast<lru_cache<K, V, HASHER, EQUALER, WEIGHER>*>(this)->shard_for(key);
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    template<typename K_, typename V_>
+    bool lru_cache<K, V, HASHER, EQUALER, WEIGHER>::put(K_&& key, V_&& value) {
+        shard& s = shard_for(key);
+        WEIGHER weigher;
+        const std::size_t w = weigher(key, value);
+        bool inserted;
+        {
+            unique_lock lock(s.m_lock);
+            //value забирается только при вставке, поэтому при попадании его ещё можно присвоить
+            entry* e = s.m_map.try_emplace(std::forward<K_>(key), inserted, std::forward<V_>(value), w);
+            assert(e != nullptr);
+            if (!inserted) {
+                //try_emplace перемещает запись в конец списка в режиме access_order
+                slot& old = e->get_value();
+                s.m_weight  -= old.weight;
+                old.value       = std::forward<V_>(value);
+                old.weight      = w;
+                old.referenced  = true;
+            }
+            s.m_weight += w;
+            evict(s);
+        }
+        return inserted;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    bool lru_cache<K, V, HASHER, EQUALER, WEIGHER>::get(const K& key, V* out) {
+        shard& s = shard_for(key);
+        unique_lock lock(s.m_lock);
+        entry* e = s.m_map.find_entry(key);
+        if (e == nullptr)
+            return false;
+        slot& sl = e->get_value();
+        sl.referenced = true;
+        if (out != nullptr)
+            *out = sl.value;
+        return true;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    bool lru_cache<K, V, HASHER, EQUALER, WEIGHER>::contains_key(const K& key) const {
+        shard& s = const_cast<shard&>(shard_for(key));
+        unique_lock lock(s.m_lock);
+        return s.m_map.contains_key(key);
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    bool lru_cache<K, V, HASHER, EQUALER, WEIGHER>::remove(const K& key, V* ret) {
+        shard& s = shard_for(key);
+        unique_lock lock(s.m_lock);
+        entry* e = s.m_map.find_entry(key);
+        if (e == nullptr)
+            return false;
+        if (ret != nullptr)
+            *ret = std::move(e->get_value().value);
+        remove_entry(s, e);
+        return true;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    void lru_cache<K, V, HASHER, EQUALER, WEIGHER>::clear() {
+        for (std::size_t i = 0; i < m_shards.length; ++i) {
+            shard& s = m_shards[i];
+            unique_lock lock(s.m_lock);
+            s.m_map.clear();
+            s.m_hand    = nullptr;
+            s.m_weight  = 0;
+        }
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    std::size_t lru_cache<K, V, HASHER, EQUALER, WEIGHER>::size() const {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < m_shards.length; ++i) {
+            shard& s = const_cast<shard&>(m_shards[i]);
+            unique_lock lock(s.m_lock);
+            result += s.m_map.size();
+        }
+        return result;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    std::size_t lru_cache<K, V, HASHER, EQUALER, WEIGHER>::weight() const {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < m_shards.length; ++i) {
+            shard& s = const_cast<shard&>(m_shards[i]);
+            unique_lock lock(s.m_lock);
+            result += s.m_weight;
+        }
+        return result;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    void lru_cache<K, V, HASHER, EQUALER, WEIGHER>::set_eviction_listener(eviction_listener* listener) {
+        m_listener = listener;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    cache_policy lru_cache<K, V, HASHER, EQUALER, WEIGHER>::get_policy() const {
+        return m_policy;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    void lru_cache<K, V, HASHER, EQUALER, WEIGHER>::evict(shard& s) {
+        while (!s.m_map.is_empty() &&
+                (s.m_map.size() > s.m_max_entries || (m_weight_limited && s.m_weight > s.m_max_weight))) {
+            entry* victim = select_victim(s);
+            assert(victim != nullptr);
+            if (m_listener != nullptr)
+                m_listener->on_evict(victim->get_key(), victim->get_value().value);
+            remove_entry(s, victim);
+        }
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    typename lru_cache<K, V, HASHER, EQUALER, WEIGHER>::entry* lru_cache<K, V, HASHER, EQUALER, WEIGHER>::select_victim(shard& s) {
+        entry* const head = &*s.m_map.begin();
+        if (m_policy == cache_policy::LRU)
+            return head;
+
+        //CLOCK: обходим список по кругу, снимая бит обращения, пока не найдём запись без него.
+        //Цикл конечен: за один полный оборот все биты будут сняты.
+        entry* e = s.m_hand != nullptr ? s.m_hand : head;
+        while (e->get_value().referenced) {
+            e->get_value().referenced = false;
+            e = e->get_list_next() != nullptr ? e->get_list_next() : head;
+        }
+        s.m_hand = e;
+        return e;
+    }
+
+    template<typename K, typename V, typename HASHER, typename EQUALER, typename WEIGHER>
+    void lru_cache<K, V, HASHER, EQUALER, WEIGHER>::remove_entry(shard& s, entry* e) {
+        assert(e != nullptr);
+        if (s.m_hand == e)
+            s.m_hand = e->get_list_next();
+        s.m_weight -= e->get_value().weight;
+        s.m_map.remove_entry(e);
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_LRU_CACHE_H
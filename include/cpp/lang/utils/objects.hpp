@@ -3,13 +3,17 @@
 
 #include <cstdint>
 #include <cpp/lang/utils/hash.hpp>
+#include <cpp/lang/utils/comparator.hpp>
 #include <cpp/lang/utils/cond_compile.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <type_traits>
 
 namespace jstd
 {
 
 class null_pointer_exception;
 class illegal_argument_exception;
+class no_such_element_exception;
 
 template<typename T>
 void throw_except(const char* format, ...);
@@ -17,6 +21,99 @@ void throw_except(const char* format, ...);
 namespace objects
 {
 
+namespace internal
+{
+    /**
+     * Векторное ядро выбирается, только если сравнение выполняется функтором по умолчанию.
+     */
+    template<typename T, typename EQUAL_TO>
+    struct is_simd_equal {
+        static const bool value = std::is_same<EQUAL_TO, equal_to<T>>::value && simd::is_vectorizable<T>::value;
+    };
+
+    template<typename T, typename T_COMPARATOR>
+    struct is_simd_compare {
+        static const bool value = std::is_same<T_COMPARATOR, compare_to<T>>::value && simd::is_vectorizable_minmax<T>::value;
+    };
+
+    template<bool SIMD>
+    struct dispatch {};
+
+    template<typename T, typename EQUAL_TO>
+    bool equals(const T* a1, const T* a2, std::size_t len, dispatch<true>) {
+        return simd::equals(a1, a2, len);
+    }
+
+    template<typename T, typename EQUAL_TO>
+    bool equals(const T* a1, const T* a2, std::size_t len, dispatch<false>) {
+        const EQUAL_TO equals_to;
+        for (std::size_t i = 0; i < len; ++i)
+            if (!equals_to(a1[i], a2[i]))
+                return false;
+        return true;
+    }
+
+    template<typename T, typename EQUAL_TO>
+    std::size_t index_of(const T* array, std::size_t len, const T& value, dispatch<true>) {
+        return simd::find(array, len, value);
+    }
+
+    template<typename T, typename EQUAL_TO>
+    std::size_t index_of(const T* array, std::size_t len, const T& value, dispatch<false>) {
+        const EQUAL_TO equals_to;
+        for (std::size_t i = 0; i < len; ++i)
+            if (equals_to(value, array[i]))
+                return i;
+        return len;
+    }
+
+    template<typename T, typename EQUAL_TO>
+    std::size_t last_index_of(const T* array, std::size_t len, const T& value, dispatch<true>) {
+        return simd::find_last(array, len, value);
+    }
+
+    template<typename T, typename EQUAL_TO>
+    std::size_t last_index_of(const T* array, std::size_t len, const T& value, dispatch<false>) {
+        const EQUAL_TO equals_to;
+        for (std::size_t i = len; i > 0; --i)
+            if (equals_to(value, array[i - 1]))
+                return i - 1;
+        return len;
+    }
+
+    template<typename T, typename EQUAL_TO>
+    std::size_t count(const T* array, std::size_t len, const T& value, dispatch<true>) {
+        return simd::count(array, len, value);
+    }
+
+    template<typename T, typename EQUAL_TO>
+    std::size_t count(const T* array, std::size_t len, const T& value, dispatch<false>) {
+        const EQUAL_TO equals_to;
+        std::size_t r = 0;
+        for (std::size_t i = 0; i < len; ++i)
+            if (equals_to(value, array[i]))
+                ++r;
+        return r;
+    }
+
+    template<typename T, typename T_COMPARATOR, bool MIN>
+    T extremum(const T* array, std::size_t len, dispatch<true>) {
+        return MIN ? simd::minimum(array, len) : simd::maximum(array, len);
+    }
+
+    template<typename T, typename T_COMPARATOR, bool MIN>
+    T extremum(const T* array, std::size_t len, dispatch<false>) {
+        const T_COMPARATOR compare;
+        const T* r = array;
+        for (std::size_t i = 1; i < len; ++i) {
+            const int c = compare(array[i], *r);
+            if (MIN ? c < 0 : c > 0)
+                r = array + i;
+        }
+        return *r;
+    }
+}
+
     /**
      * Вычисляет хеш-код для массива элементов типа T.
      * 
@@ -77,6 +174,7 @@ namespace objects
      * 
      * Функция принимает два указателя на массивы и их длину,
      * после чего посимвольно сравнивает их содержимое.
+     * Для примитивных типов и функтора равенства по умолчанию используется векторное сравнение (simd::equals).
      * Если массивы полностью совпадают, возвращает true.
      * Если есть хоть одно несовпадение — false.
      * 
@@ -110,11 +208,116 @@ namespace objects
             if (a1 == nullptr) throw_except<null_pointer_exception>("a1 must be != null");
             if (a2 == nullptr) throw_except<null_pointer_exception>("a2 must be != null");
         );
-        const EQUAL_TO equals_to;
-        for (std::size_t i = 0; i < len; ++i)
-            if (!equals_to(a1[i], a2[i]))
-                return false;
-        return true;
+        return internal::equals<T, EQUAL_TO>(a1, a2, len, internal::dispatch<internal::is_simd_equal<T, EQUAL_TO>::value>());
+    }
+
+    /**
+     * Возвращает индекс первого элемента массива, равного value.
+     * 
+     * Для примитивных типов и функтора равенства по умолчанию используется векторный поиск (simd::find).
+     * 
+     * @param array 
+     *      Указатель на массив. Должен быть != nullptr.
+     * 
+     * @param len 
+     *      Длина массива.
+     * 
+     * @param value 
+     *      Искомое значение.
+     * 
+     * @return 
+     *      Индекс элемента или len, если элемент не найден.
+     * 
+     * @throws null_pointer_exception 
+     *      Если array == nullptr.
+     */
+    template<typename T, typename EQUAL_TO = equal_to<T>>
+    std::size_t index_of(const T* array, std::size_t len, const T& value) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0) throw_except<null_pointer_exception>("array must be != null");
+        );
+        return internal::index_of<T, EQUAL_TO>(array, len, value, internal::dispatch<internal::is_simd_equal<T, EQUAL_TO>::value>());
+    }
+
+    /**
+     * Возвращает индекс последнего элемента массива, равного value.
+     * 
+     * @return 
+     *      Индекс элемента или len, если элемент не найден.
+     * 
+     * @see index_of
+     */
+    template<typename T, typename EQUAL_TO = equal_to<T>>
+    std::size_t last_index_of(const T* array, std::size_t len, const T& value) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0) throw_except<null_pointer_exception>("array must be != null");
+        );
+        return internal::last_index_of<T, EQUAL_TO>(array, len, value, internal::dispatch<internal::is_simd_equal<T, EQUAL_TO>::value>());
+    }
+
+    /**
+     * Возвращает количество элементов массива, равных value.
+     * 
+     * @see index_of
+     */
+    template<typename T, typename EQUAL_TO = equal_to<T>>
+    std::size_t count(const T* array, std::size_t len, const T& value) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0) throw_except<null_pointer_exception>("array must be != null");
+        );
+        return internal::count<T, EQUAL_TO>(array, len, value, internal::dispatch<internal::is_simd_equal<T, EQUAL_TO>::value>());
+    }
+
+    /**
+     * Присваивает value всем элементам массива.
+     * Для примитивных типов используются векторные записи (simd::fill).
+     * 
+     * @throws null_pointer_exception 
+     *      Если array == nullptr.
+     */
+    template<typename T>
+    void fill(T* array, std::size_t len, const T& value) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0) throw_except<null_pointer_exception>("array must be != null");
+        );
+        simd::fill(array, len, value);
+    }
+
+    /**
+     * Возвращает наименьший элемент массива.
+     * 
+     * Для примитивных типов и компаратора по умолчанию используется векторный поиск (simd::minimum).
+     * Его результат совпадает со скалярным проходом, в том числе для float и double с NaN.
+     * 
+     * @throws null_pointer_exception 
+     *      Если array == nullptr.
+     * 
+     * @throws no_such_element_exception 
+     *      Если len == 0.
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    T minimum(const T* array, std::size_t len) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0) throw_except<null_pointer_exception>("array must be != null");
+        );
+        if (len == 0)
+            throw_except<no_such_element_exception>("array is empty");
+        return internal::extremum<T, T_COMPARATOR, true>(array, len, internal::dispatch<internal::is_simd_compare<T, T_COMPARATOR>::value>());
+    }
+
+    /**
+     * Возвращает наибольший элемент массива.
+     * 
+     * @see minimum
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    T maximum(const T* array, std::size_t len) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0) throw_except<null_pointer_exception>("array must be != null");
+        );
+        if (len == 0)
+            throw_except<no_such_element_exception>("array is empty");
+        return internal::extremum<T, T_COMPARATOR, false>(array, len, internal::dispatch<internal::is_simd_compare<T, T_COMPARATOR>::value>());
     }
 }//namespace objects
 
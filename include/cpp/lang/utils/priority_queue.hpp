@@ -0,0 +1,746 @@
+#ifndef JSTD_CPP_LANG_UTILS_PRIORITY_QUEUE_H
+#define JSTD_CPP_LANG_UTILS_PRIORITY_QUEUE_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/array_list.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/slot_map.hpp>
+#include <cpp/lang/utils/sort.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+namespace jstd
+{
+
+namespace internal
+{
+/**
+ * Операции над 4-арной кучей в непрерывном массиве.
+ * Потомки узла i - 4i+1 .. 4i+4, поэтому все потомки узла обычно лежат в одной кэш-линии, а высота кучи вдвое меньше, чем у двоичной.
+ *
+ * PLACE вызывается как place(data, idx) после каждой записи элемента в позицию idx (для индексированной очереди).
+ */
+namespace heap
+{
+    static const std::size_t ARITY = 4;
+
+    /**
+     * PLACE, который ничего не делает.
+     */
+    struct no_place {
+        template<typename E>
+        void operator()(E*, std::size_t) const {
+
+        }
+    };
+
+    template<typename E, typename LESS, typename PLACE>
+    void sift_up(E* data, std::size_t idx, const LESS& less, const PLACE& place) {
+        E tmp = std::move(data[idx]);
+        while (idx > 0) {
+            std::size_t parent = (idx - 1) / ARITY;
+            if (!less(tmp, data[parent]))
+                break;
+            data[idx] = std::move(data[parent]);
+            place(data, idx);
+            idx = parent;
+        }
+        data[idx] = std::move(tmp);
+        place(data, idx);
+    }
+
+    template<typename E, typename LESS, typename PLACE>
+    void sift_down(E* data, std::size_t idx, std::size_t size, const LESS& less, const PLACE& place) {
+        E tmp = std::move(data[idx]);
+        for (;;) {
+            std::size_t first = idx * ARITY + 1;
+            if (first >= size)
+                break;
+            std::size_t last = size - first > ARITY ? first + ARITY : size;
+            std::size_t best = first;
+            for (std::size_t c = first + 1; c < last; ++c) {
+                if (less(data[c], data[best]))
+                    best = c;
+            }
+            if (!less(data[best], tmp))
+                break;
+            data[idx] = std::move(data[best]);
+            place(data, idx);
+            idx = best;
+        }
+        data[idx] = std::move(tmp);
+        place(data, idx);
+    }
+
+    /**
+     * Восстанавливает свойство кучи за O(n).
+     */
+    template<typename E, typename LESS, typename PLACE>
+    void heapify(E* data, std::size_t size, const LESS& less, const PLACE& place) {
+        if (size < 2)
+            return;
+        for (std::size_t i = (size - 2) / ARITY + 1; i > 0; --i)
+            sift_down(data, i - 1, size, less, place);
+    }
+}
+}
+
+/**
+ * Очередь с приоритетом на 4-арной куче в непрерывном массиве.
+ *
+ * В голове очереди находится наименьший по компаратору элемент (как в java.util.PriorityQueue).
+ * Для очереди по убыванию передайте компаратор с обратным порядком.
+ *
+ * @tparam E
+ *      Тип элементов.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор, возвращающий отрицательное число, ноль или положительное число.
+ */
+template<typename E, typename COMPARATOR_T = compare_to<E>>
+class priority_queue {
+    /**
+     * Элементы в порядке кучи.
+     */
+    array_list<E> m_heap;
+
+    /**
+     * Компаратор.
+     */
+    COMPARATOR_T m_compare;
+
+    typedef internal::sort_less<E, COMPARATOR_T> less_t;
+
+public:
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 80;
+
+    /**
+     * Создаёт пустую очередь.
+     */
+    priority_queue(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт пустую очередь с заданной начальной вместимостью.
+     */
+    explicit priority_queue(std::size_t init_capacity, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт очередь из копий len элементов массива. Куча строится за O(n).
+     */
+    priority_queue(const E* array, std::size_t len, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт копию очереди.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущей очереди.
+     */
+    priority_queue<E, COMPARATOR_T> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Добавляет элемент за O(log n).
+     */
+    template<typename _E>
+    void add(_E&& e);
+
+    /**
+     * Добавляет копии len элементов массива.
+     * Если добавляется много элементов относительно размера очереди, куча перестраивается целиком за O(n + len).
+     */
+    void add_all(const E* array, std::size_t len);
+
+    /**
+     * Возвращает головной элемент, не удаляя его.
+     *
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    const E& peek() const;
+
+    /**
+     * Удаляет головной элемент.
+     *
+     * @param ret
+     *      Если не nullptr, в него перемещается удалённый элемент.
+     *
+     * @return
+     *      false, если очередь пуста.
+     */
+    bool poll(E* ret = nullptr);
+
+    /**
+     * Заменяет головной элемент на e за один спуск по куче. Быстрее, чем poll и add.
+     * Удобно для выборки top-K: очередь из K элементов, голова которой заменяется более подходящим.
+     *
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    template<typename _E>
+    void replace_top(_E&& e);
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_heap.size();
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_heap.is_empty();
+    }
+
+    /**
+     * Удаляет все элементы, но не освобождает память.
+     */
+    void clear() {
+        m_heap.clear();
+    }
+
+    /**
+     * @see array_list::reserve
+     */
+    void reserve(std::size_t new_capacity) {
+        if (new_capacity > m_heap.capacity())
+            m_heap.reserve(new_capacity);
+    }
+
+    /**
+     * Возвращает указатель на элементы в порядке кучи.
+     */
+    const E* data() const {
+        return m_heap.data();
+    }
+
+    /**
+     * Записывает строковое представление очереди в буфер.
+     */
+    int to_string(char buf[], std::size_t bufsize) const {
+        return m_heap.to_string(buf, bufsize);
+    }
+};
+
+/**
+ * Очередь с приоритетом, в которой каждый элемент доступен по дескриптору.
+ *
+ * add возвращает дескриптор, по которому элемент можно прочитать, изменить его приоритет
+ * (decrease_key, update) или удалить из середины очереди за O(log n).
+ * Дескриптор содержит поколение ячейки, как в slot_map: после удаления элемента ячейка выдаётся повторно
+ * с новым поколением, и старый дескриптор больше не находит элемент (contains возвращает false,
+ * get/update/decrease_key выбрасывают no_such_element_exception, remove возвращает false).
+ *
+ * Основа для планировщиков, таймеров и алгоритмов на графах (Дейкстра, Прим).
+ *
+ * @tparam E
+ *      Тип элементов.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор, возвращающий отрицательное число, ноль или положительное число.
+ */
+template<typename E, typename COMPARATOR_T = compare_to<E>>
+class indexed_priority_queue {
+public:
+    /**
+     * Дескриптор элемента.
+     */
+    typedef slot_handle handle;
+
+    /**
+     *
+     */
+    static const std::size_t null_val = ~((std::size_t) 0);
+
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 80;
+
+private:
+    struct entry {
+        E value;
+        std::uint32_t id;
+
+        template<typename _E>
+        entry(_E&& v, std::uint32_t h) : value(std::forward<_E>(v)), id(h) {
+
+        }
+    };
+
+    /**
+     * Ячейка дескриптора: позиция элемента в куче и поколение.
+     * Нечётное поколение - ячейка занята, чётное - свободна.
+     */
+    struct slot {
+        std::size_t     pos;
+        std::uint32_t   generation;
+    };
+
+    struct entry_less {
+        COMPARATOR_T& compare;
+
+        bool operator()(const entry& a, const entry& b) const {
+            return compare(a.value, b.value) < 0;
+        }
+    };
+
+    struct place_entry {
+        slot* slots;
+
+        void operator()(entry* data, std::size_t idx) const {
+            slots[data[idx].id].pos = idx;
+        }
+    };
+
+    /**
+     * Элементы в порядке кучи.
+     */
+    array_list<entry> m_heap;
+
+    /**
+     * Ячейки дескрипторов.
+     */
+    array_list<slot> m_slots;
+
+    /**
+     * Индексы свободных ячеек.
+     */
+    array_list<std::uint32_t> m_free;
+
+    /**
+     * Компаратор.
+     */
+    COMPARATOR_T m_compare;
+
+    /**
+     * Восстанавливает порядок кучи после изменения элемента в позиции idx.
+     */
+    void fix(std::size_t idx);
+
+    /**
+     * Удаляет элемент в позиции idx и освобождает его дескриптор.
+     */
+    void remove_at(std::size_t idx, E* ret);
+
+    /**
+     * Увеличивает поколение ячейки и возвращает её в список свободных.
+     * Ячейка с исчерпанными поколениями больше не выдаётся.
+     */
+    void release_slot(std::uint32_t idx);
+
+    /**
+     * Позиция элемента в куче.
+     *
+     * @throws no_such_element_exception
+     *      Если дескриптор не принадлежит очереди или устарел.
+     */
+    std::size_t position_of(handle h) const;
+
+public:
+    /**
+     * Создаёт пустую очередь.
+     */
+    indexed_priority_queue(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт копию очереди с теми же дескрипторами.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущей очереди.
+     */
+    indexed_priority_queue<E, COMPARATOR_T> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Добавляет элемент за O(log n).
+     *
+     * @return
+     *      Дескриптор элемента.
+     *
+     * @throws illegal_state_exception
+     *      Если исчерпаны индексы дескрипторов (2^32 - 1 ячеек).
+     */
+    template<typename _E>
+    handle add(_E&& e);
+
+    /**
+     * @see priority_queue::peek
+     */
+    const E& peek() const;
+
+    /**
+     * Возвращает дескриптор головного элемента.
+     *
+     * @throws no_such_element_exception
+     *      Если очередь пуста.
+     */
+    handle peek_handle() const;
+
+    /**
+     * @see priority_queue::poll
+     */
+    bool poll(E* ret = nullptr);
+
+    /**
+     * Возвращает true, если дескриптор принадлежит элементу очереди.
+     * Для дескриптора удалённого элемента возвращает false, даже если его ячейка уже выдана повторно.
+     */
+    bool contains(handle h) const {
+        return h.index < m_slots.size() && (h.generation & 1) != 0 && m_slots.data()[h.index].generation == h.generation;
+    }
+
+    /**
+     * Возвращает элемент по дескриптору.
+     *
+     * @throws no_such_element_exception
+     *      Если дескриптор не принадлежит очереди.
+     */
+    const E& get(handle h) const;
+
+    /**
+     * Уменьшает ключ элемента (поднимает его к голове) за O(log n).
+     *
+     * @throws no_such_element_exception
+     *      Если дескриптор не принадлежит очереди.
+     *
+     * @throws illegal_argument_exception
+     *      Если новое значение больше текущего по компаратору.
+     */
+    template<typename _E>
+    void decrease_key(handle h, _E&& e);
+
+    /**
+     * Заменяет элемент на e с произвольным изменением приоритета за O(log n).
+     *
+     * @throws no_such_element_exception
+     *      Если дескриптор не принадлежит очереди.
+     */
+    template<typename _E>
+    void update(handle h, _E&& e);
+
+    /**
+     * Удаляет элемент по дескриптору за O(log n).
+     *
+     * @param ret
+     *      Если не nullptr, в него перемещается удалённый элемент.
+     *
+     * @return
+     *      false, если дескриптор не принадлежит очереди.
+     */
+    bool remove(handle h, E* ret = nullptr);
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_heap.size();
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_heap.is_empty();
+    }
+
+    /**
+     * Удаляет все элементы. Все дескрипторы становятся недействительными.
+     */
+    void clear();
+
+    /**
+     * @see array_list::reserve
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * Записывает строковое представление очереди в буфер.
+     */
+    int to_string(char buf[], std::size_t bufsize) const {
+        return std::snprintf(buf, bufsize, "[size=%lli, handles=%lli]", (long long) m_heap.size(), (long long) m_slots.size());
+    }
+};
+
+    template<typename E, typename COMPARATOR_T>
+    priority_queue<E, COMPARATOR_T>::priority_queue(tca::allocator* allocator) : m_heap(allocator), m_compare() {
+
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    priority_queue<E, COMPARATOR_T>::priority_queue(std::size_t init_capacity, tca::allocator* allocator) : m_heap(init_capacity, allocator), m_compare() {
+
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    priority_queue<E, COMPARATOR_T>::priority_queue(const E* array, std::size_t len, tca::allocator* allocator) : m_heap(allocator), m_compare() {
+        add_all(array, len);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    priority_queue<E, COMPARATOR_T> priority_queue<E, COMPARATOR_T>::clone(tca::allocator* allocator) const {
+        priority_queue<E, COMPARATOR_T> copy(*this);
+        if (allocator != nullptr)
+            copy.m_heap = m_heap.clone(allocator);
+        return copy;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    template<typename _E>
+    void priority_queue<E, COMPARATOR_T>::add(_E&& e) {
+        m_heap.add(std::forward<_E>(e));
+        less_t less = { m_compare };
+        internal::heap::sift_up(m_heap.data(), m_heap.size() - 1, less, internal::heap::no_place());
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    void priority_queue<E, COMPARATOR_T>::add_all(const E* array, std::size_t len) {
+        if (len == 0)
+            return;
+        JSTD_DEBUG_CODE(
+            check_non_null(array);
+        );
+        const std::size_t old_size = m_heap.size();
+        if (old_size + len > m_heap.capacity())
+            m_heap.reserve(old_size + len);
+        for (std::size_t i = 0; i < len; ++i)
+            m_heap.add(array[i]);
+
+        less_t less = { m_compare };
+        if (len > old_size / 2) {
+            internal::heap::heapify(m_heap.data(), m_heap.size(), less, internal::heap::no_place());
+        } else {
+            for (std::size_t i = old_size; i < m_heap.size(); ++i)
+                internal::heap::sift_up(m_heap.data(), i, less, internal::heap::no_place());
+        }
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    const E& priority_queue<E, COMPARATOR_T>::peek() const {
+        if (m_heap.is_empty())
+            throw_except<no_such_element_exception>("Queue is empty");
+        return m_heap.data()[0];
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    bool priority_queue<E, COMPARATOR_T>::poll(E* ret) {
+        if (m_heap.is_empty())
+            return false;
+        E* data = m_heap.data();
+        if (ret != nullptr)
+            *ret = std::move(data[0]);
+        const std::size_t last = m_heap.size() - 1;
+        if (last > 0)
+            data[0] = std::move(data[last]);
+        m_heap.remove_at(last);
+        if (last > 1) {
+            less_t less = { m_compare };
+            internal::heap::sift_down(m_heap.data(), 0, last, less, internal::heap::no_place());
+        }
+        return true;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    template<typename _E>
+    void priority_queue<E, COMPARATOR_T>::replace_top(_E&& e) {
+        if (m_heap.is_empty())
+            throw_except<no_such_element_exception>("Queue is empty");
+        m_heap.data()[0] = std::forward<_E>(e);
+        less_t less = { m_compare };
+        internal::heap::sift_down(m_heap.data(), 0, m_heap.size(), less, internal::heap::no_place());
+    }
+
+    /**
+     * ==========================================================================================================================================
+     */
+    template<typename E, typename COMPARATOR_T>
+    indexed_priority_queue<E, COMPARATOR_T>::indexed_priority_queue(tca::allocator* allocator) :
+    m_heap(allocator),
+    m_slots(allocator),
+    m_free(allocator),
+    m_compare() {
+
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    indexed_priority_queue<E, COMPARATOR_T> indexed_priority_queue<E, COMPARATOR_T>::clone(tca::allocator* allocator) const {
+        indexed_priority_queue<E, COMPARATOR_T> copy(*this);
+        if (allocator != nullptr) {
+            copy.m_heap = m_heap.clone(allocator);
+            copy.m_slots = m_slots.clone(allocator);
+            copy.m_free = m_free.clone(allocator);
+        }
+        // Копия списка свободных ячеек создаётся без запаса, а release_slot рассчитывает на место под все ячейки.
+        if (copy.m_free.capacity() < copy.m_slots.size())
+            copy.m_free.reserve(copy.m_slots.size());
+        return copy;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    std::size_t indexed_priority_queue<E, COMPARATOR_T>::position_of(handle h) const {
+        if (!contains(h))
+            throw_except<no_such_element_exception>("Stale or invalid handle %u:%u", (unsigned) h.index, (unsigned) h.generation);
+        return m_slots.data()[h.index].pos;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    void indexed_priority_queue<E, COMPARATOR_T>::fix(std::size_t idx) {
+        entry_less less     = { m_compare };
+        place_entry place   = { m_slots.data() };
+        entry* data         = m_heap.data();
+        if (idx > 0 && less(data[idx], data[(idx - 1) / internal::heap::ARITY]))
+            internal::heap::sift_up(data, idx, less, place);
+        else
+            internal::heap::sift_down(data, idx, m_heap.size(), less, place);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    void indexed_priority_queue<E, COMPARATOR_T>::remove_at(std::size_t idx, E* ret) {
+        entry* data = m_heap.data();
+        const std::uint32_t id = data[idx].id;
+        if (ret != nullptr)
+            *ret = std::move(data[idx].value);
+
+        const std::size_t last = m_heap.size() - 1;
+        if (idx != last) {
+            data[idx] = std::move(data[last]);
+            m_slots.data()[data[idx].id].pos = idx;
+        }
+        m_heap.remove_at(last);
+        release_slot(id);
+        if (idx < last)
+            fix(idx);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    void indexed_priority_queue<E, COMPARATOR_T>::release_slot(std::uint32_t idx) {
+        slot& s = m_slots.data()[idx];
+        s.pos = null_val;
+        if (++s.generation == 0) {
+            // Поколения исчерпаны: ячейка больше не выдаётся, чтобы старые дескрипторы не ожили.
+            return;
+        }
+        // Место под все ячейки зарезервировано в add, поэтому добавление не выделяет память.
+        m_free.add(idx);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    template<typename _E>
+    typename indexed_priority_queue<E, COMPARATOR_T>::handle indexed_priority_queue<E, COMPARATOR_T>::add(_E&& e) {
+        // m_free всегда вмещает все ячейки, поэтому release_slot не выделяет память и удаление не бросает исключений.
+        const bool reuse = !m_free.is_empty();
+        std::uint32_t idx;
+        if (reuse) {
+            idx = m_free.data()[m_free.size() - 1];
+        } else {
+            if (m_slots.size() >= (std::size_t) UINT32_MAX)
+                throw_except<illegal_state_exception>("indexed_priority_queue is out of handles");
+            if (m_free.capacity() <= m_slots.size())
+                m_free.reserve(m_slots.size() < 8 ? 16 : m_slots.size() * 2);
+            slot s = {(std::size_t) null_val, 0};
+            m_slots.add(s);
+            idx = (std::uint32_t) (m_slots.size() - 1);
+        }
+        try {
+            m_heap.add(entry(std::forward<_E>(e), idx));
+        } catch (...) {
+            if (!reuse)
+                m_free.add(idx);
+            throw;
+        }
+        if (reuse)
+            m_free.remove_at(m_free.size() - 1);
+
+        slot& s = m_slots.data()[idx];
+        ++s.generation;
+        entry_less less     = { m_compare };
+        place_entry place   = { m_slots.data() };
+        internal::heap::sift_up(m_heap.data(), m_heap.size() - 1, less, place);
+        return handle(idx, s.generation);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    const E& indexed_priority_queue<E, COMPARATOR_T>::peek() const {
+        if (m_heap.is_empty())
+            throw_except<no_such_element_exception>("Queue is empty");
+        return m_heap.data()[0].value;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    typename indexed_priority_queue<E, COMPARATOR_T>::handle indexed_priority_queue<E, COMPARATOR_T>::peek_handle() const {
+        if (m_heap.is_empty())
+            throw_except<no_such_element_exception>("Queue is empty");
+        const std::uint32_t idx = m_heap.data()[0].id;
+        return handle(idx, m_slots.data()[idx].generation);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    bool indexed_priority_queue<E, COMPARATOR_T>::poll(E* ret) {
+        if (m_heap.is_empty())
+            return false;
+        remove_at(0, ret);
+        return true;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    const E& indexed_priority_queue<E, COMPARATOR_T>::get(handle h) const {
+        return m_heap.data()[position_of(h)].value;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    template<typename _E>
+    void indexed_priority_queue<E, COMPARATOR_T>::decrease_key(handle h, _E&& e) {
+        const std::size_t idx = position_of(h);
+        entry& en = m_heap.data()[idx];
+        if (m_compare(e, en.value) > 0)
+            throw_except<illegal_argument_exception>("New key is greater than the current key");
+        en.value = std::forward<_E>(e);
+        if (idx > 0) {
+            entry_less less     = { m_compare };
+            place_entry place   = { m_slots.data() };
+            internal::heap::sift_up(m_heap.data(), idx, less, place);
+        }
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    template<typename _E>
+    void indexed_priority_queue<E, COMPARATOR_T>::update(handle h, _E&& e) {
+        const std::size_t idx = position_of(h);
+        m_heap.data()[idx].value = std::forward<_E>(e);
+        fix(idx);
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    bool indexed_priority_queue<E, COMPARATOR_T>::remove(handle h, E* ret) {
+        if (!contains(h))
+            return false;
+        remove_at(m_slots.data()[h.index].pos, ret);
+        return true;
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    void indexed_priority_queue<E, COMPARATOR_T>::clear() {
+        // Ячейки не сбрасываются, а освобождаются с новым поколением: старые дескрипторы не должны совпасть с новыми.
+        const entry* data = m_heap.data();
+        for (std::size_t i = 0, n = m_heap.size(); i < n; ++i)
+            release_slot(data[i].id);
+        m_heap.clear();
+    }
+
+    template<typename E, typename COMPARATOR_T>
+    void indexed_priority_queue<E, COMPARATOR_T>::reserve(std::size_t new_capacity) {
+        if (new_capacity > m_heap.capacity())
+            m_heap.reserve(new_capacity);
+        if (new_capacity > m_slots.capacity())
+            m_slots.reserve(new_capacity);
+        if (new_capacity > m_free.capacity())
+            m_free.reserve(new_capacity);
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_PRIORITY_QUEUE_H
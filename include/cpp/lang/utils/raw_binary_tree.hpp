@@ -126,6 +126,10 @@ namespace jstd
  *      Данная структура уже может использоваться в качестве узла дерева.
  * }
  * 
+ * Необязательные поля узла поддерживаются деревом при вставке, удалении и балансировке:
+ *      size    - количество узлов в поддереве;
+ *      parent  - указатель на родителя (nullptr у корня), позволяет обходить дерево без поиска от корня.
+ * 
  */
 template<typename K, typename COMPARATOR_T = compare_to<K>, typename NODE_T = avlt_entry<K>>
 class raw_binary_tree {
@@ -232,6 +236,53 @@ private:
     static void calc_height(node* entry) {
         assert(entry != nullptr);
         entry->height = (math::max(get_height(entry->left), get_height(entry->right)) + 1);
+        calc_size(entry, 0);
+        link_parent(entry, entry->left, 0);
+        link_parent(entry, entry->right, 0);
+    }
+
+    /**
+     * Пересчитывает размер поддерева, если узел содержит поле size.
+     * Поле необязательное, узлы без него (например avlt_entry) не затрагиваются.
+     */
+    template<typename NODE_>
+    static auto calc_size(NODE_* entry, int) -> decltype(entry->size = 0, void()) {
+        entry->size = 1 + get_size(entry->left, 0) + get_size(entry->right, 0);
+    }
+
+    /**
+     * 
+     */
+    template<typename NODE_>
+    static void calc_size(NODE_*, long) {
+
+    }
+
+    /**
+     * 
+     */
+    template<typename NODE_>
+    static auto get_size(NODE_* n, int) -> decltype((std::size_t) n->size) {
+        return n ? (std::size_t) n->size : 0;
+    }
+
+    /**
+     * Записывает parent в поле parent узла child, если такое поле есть.
+     * Узел, у которого изменились дочерние узлы, всегда проходит через calc_height,
+     * поэтому ссылки на родителя обновляются только здесь и у корня.
+     */
+    template<typename NODE_>
+    static auto link_parent(NODE_* parent, NODE_* child, int) -> decltype(child->parent = parent, void()) {
+        if (child != nullptr)
+            child->parent = parent;
+    }
+
+    /**
+     * 
+     */
+    template<typename NODE_>
+    static void link_parent(NODE_*, NODE_*, long) {
+
     }
 
 public:
@@ -291,6 +342,16 @@ public:
      * 
      */
     node* ceil_entry(const K& key) const;
+
+    /**
+     * Возвращает узел с наименьшим ключом, строго большим key, или nullptr.
+     */
+    node* higher_entry(const K& key) const;
+
+    /**
+     * Возвращает узел с наибольшим ключом, строго меньшим key, или nullptr.
+     */
+    node* lower_entry(const K& key) const;
     
     /**
      * 
@@ -530,12 +591,14 @@ public:
     void raw_binary_tree<K, COMPARATOR_T, NODE_T>::insert_entry(node* in) {
         assert(in != nullptr);
         m_root = insert_entry0(m_root, in);
+        link_parent((node*) nullptr, m_root, 0);
     }
 
     template<typename K, typename COMPARATOR_T, typename NODE_T>
     typename raw_binary_tree<K, COMPARATOR_T, NODE_T>::node* raw_binary_tree<K, COMPARATOR_T, NODE_T>::remove_entry(const K& key) {
         node* deleted = nullptr;
         m_root = remove_entry0(m_root, key, &deleted);
+        link_parent((node*) nullptr, m_root, 0);
         return deleted;
     }
 
@@ -544,6 +607,7 @@ public:
         assert(entry != nullptr);
         node* deleted = nullptr;
         m_root = remove_entry0(m_root, entry, &deleted);
+        link_parent((node*) nullptr, m_root, 0);
         return deleted;
     }
 
@@ -551,9 +615,10 @@ public:
     typename raw_binary_tree<K, COMPARATOR_T, NODE_T>::node* raw_binary_tree<K, COMPARATOR_T, NODE_T>::search_entry(const K& key) const {
         node* node = m_root;
         while (node) {
-            if (node->key == key)
+            int32_t cmp = m_key_comparator(key, node->key);
+            if (cmp == 0)
                 return node;
-            if (key > node->key)
+            if (cmp > 0)
             {
                 node = node->right;
             }
@@ -611,6 +676,46 @@ public:
         return ceil;
     }
 
+    template<typename K, typename COMPARATOR_T, typename NODE_T>
+    typename raw_binary_tree<K, COMPARATOR_T, NODE_T>::node* raw_binary_tree<K, COMPARATOR_T, NODE_T>::higher_entry(const K& key) const {
+        node* root   = m_root;
+        node* higher = nullptr;
+        const COMPARATOR_T& compare = m_key_comparator;
+        while (root)
+        {
+            if (compare(key, root->key) < 0)
+            {
+                higher = root;
+                root = root->left;
+            }
+            else
+            {
+                root = root->right;
+            }
+        }
+        return higher;
+    }
+
+    template<typename K, typename COMPARATOR_T, typename NODE_T>
+    typename raw_binary_tree<K, COMPARATOR_T, NODE_T>::node* raw_binary_tree<K, COMPARATOR_T, NODE_T>::lower_entry(const K& key) const {
+        node* root  = m_root;
+        node* lower = nullptr;
+        const COMPARATOR_T& compare = m_key_comparator;
+        while (root)
+        {
+            if (compare(key, root->key) > 0)
+            {
+                lower = root;
+                root = root->right;
+            }
+            else
+            {
+                root = root->left;
+            }
+        }
+        return lower;
+    }
+
     template<typename K, typename COMPARATOR_T, typename NODE_T>
     typename raw_binary_tree<K, COMPARATOR_T, NODE_T>::node* raw_binary_tree<K, COMPARATOR_T, NODE_T>::first_entry() const {
         node* root = m_root;
@@ -0,0 +1,966 @@
+#ifndef JSTD_CPP_LANG_UTILS_SIMD_H
+#define JSTD_CPP_LANG_UTILS_SIMD_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Набор инструкций выбирается во время компиляции:
+ * JSTD_SIMD_AVX2 - 256-битные регистры (-mavx2, /arch:AVX2),
+ * JSTD_SIMD_SSE2 - 128-битные регистры (все x86-64 процессоры).
+ * Без них все функции выполняются скалярными циклами.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define JSTD_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+#if defined(JSTD_SIMD_SSE2) && defined(__AVX2__)
+#   define JSTD_SIMD_AVX2
+#   include <immintrin.h>
+#endif
+
+namespace jstd
+{
+
+/**
+ * Векторные ядра поиска, подсчёта, сравнения, заполнения и поиска минимума/максимума
+ * для массивов примитивных типов.
+ *
+ * Векторизуются целые числа, перечисления и указатели любого размера (1, 2, 4, 8 байт),
+ * а также float и double. Для остальных типов используются скалярные циклы
+ * через operator== и operator<.
+ *
+ * Сравнение float и double выполняется по правилам IEEE, как и operator==: NaN не равен ничему, -0.0 == 0.0.
+ */
+namespace simd
+{
+
+namespace internal
+{
+    /**
+     * Номер младшего установленного бита. x != 0.
+     */
+    inline unsigned ctz(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return (unsigned) __builtin_ctz(x);
+#else
+        unsigned r = 0;
+        while ((x & 1) == 0) {
+            x >>= 1;
+            ++r;
+        }
+        return r;
+#endif
+    }
+
+    /**
+     * Номер старшего установленного бита. x != 0.
+     */
+    inline unsigned bsr(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 31u - (unsigned) __builtin_clz(x);
+#else
+        unsigned r = 0;
+        while (x >>= 1)
+            ++r;
+        return r;
+#endif
+    }
+
+    inline unsigned popcount(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return (unsigned) __builtin_popcount(x);
+#else
+        x = x - ((x >> 1) & 0x55555555u);
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        return (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+    }
+
+    /**
+     * @see ctz. x != 0.
+     */
+    inline unsigned ctz64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return (unsigned) __builtin_ctzll(x);
+#else
+        std::uint32_t lo = (std::uint32_t) x;
+        return lo != 0 ? ctz(lo) : 32u + ctz((std::uint32_t) (x >> 32));
+#endif
+    }
+
+    /**
+     * @see bsr. x != 0.
+     */
+    inline unsigned bsr64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - (unsigned) __builtin_clzll(x);
+#else
+        std::uint32_t hi = (std::uint32_t) (x >> 32);
+        return hi != 0 ? 32u + bsr(hi) : bsr((std::uint32_t) x);
+#endif
+    }
+
+    inline unsigned popcount64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return (unsigned) __builtin_popcountll(x);
+#else
+        return popcount((std::uint32_t) x) + popcount((std::uint32_t) (x >> 32));
+#endif
+    }
+
+    /**
+     * Равенство значений типа T совпадает с побитовым равенством.
+     */
+    template<typename T, typename U = typename std::remove_cv<T>::type>
+    struct is_bitwise_comparable {
+        static const bool value = std::is_integral<U>::value || std::is_enum<U>::value || std::is_pointer<U>::value;
+    };
+
+    /**
+     * Вид векторных операций для типа T.
+     */
+    enum lane_kind {
+        LANE_NONE,
+        LANE_BITWISE,
+        LANE_FLOAT,
+        LANE_DOUBLE
+    };
+
+    template<typename T, typename U = typename std::remove_cv<T>::type>
+    struct kind_of {
+        static const lane_kind value =  std::is_same<U, float>::value  ? LANE_FLOAT  :
+                                        std::is_same<U, double>::value ? LANE_DOUBLE :
+                                        (is_bitwise_comparable<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) ? LANE_BITWISE :
+                                        LANE_NONE;
+    };
+
+    template<std::size_t SIZE> struct uint_of;
+    template<> struct uint_of<1> { typedef std::uint8_t  type; };
+    template<> struct uint_of<2> { typedef std::uint16_t type; };
+    template<> struct uint_of<4> { typedef std::uint32_t type; };
+    template<> struct uint_of<8> { typedef std::uint64_t type; };
+
+    template<typename T>
+    inline typename uint_of<sizeof(T)>::type bits_of(const T& value) {
+        typename uint_of<sizeof(T)>::type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    /**
+     * Векторные операции над элементами типа T.
+     *
+     * eq(a, b) возвращает маску movemask_epi8, в которой каждой совпавшей паре элементов
+     * соответствует sizeof(T) установленных бит.
+     */
+    template<typename T, lane_kind KIND = kind_of<T>::value>
+    struct lane_ops {
+        static const bool enabled = false;
+    };
+
+#if defined(JSTD_SIMD_AVX2)
+    typedef __m256i vint;
+    const std::uint32_t FULL_MASK = 0xFFFFFFFFu;
+
+    inline vint load_bits(const void* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    inline void store_bits(void* p, vint v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+
+    inline std::uint32_t movemask(vint v) {
+        return (std::uint32_t) _mm256_movemask_epi8(v);
+    }
+
+    template<std::size_t SIZE> struct int_lanes;
+    template<> struct int_lanes<1> {
+        static vint set1(std::uint8_t v)        { return _mm256_set1_epi8((char) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm256_cmpeq_epi8(a, b); }
+    };
+    template<> struct int_lanes<2> {
+        static vint set1(std::uint16_t v)       { return _mm256_set1_epi16((short) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm256_cmpeq_epi16(a, b); }
+    };
+    template<> struct int_lanes<4> {
+        static vint set1(std::uint32_t v)       { return _mm256_set1_epi32((int) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm256_cmpeq_epi32(a, b); }
+    };
+    template<> struct int_lanes<8> {
+        static vint set1(std::uint64_t v)       { return _mm256_set1_epi64x((long long) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm256_cmpeq_epi64(a, b); }
+    };
+
+    template<>
+    struct lane_ops<float, LANE_FLOAT> {
+        static const bool enabled = true;
+        typedef __m256 reg;
+        static reg  set1(float v)               { return _mm256_set1_ps(v); }
+        static reg  load(const float* p)        { return _mm256_loadu_ps(p); }
+        static void store(float* p, reg v)      { _mm256_storeu_ps(p, v); }
+        static std::uint32_t eq(reg a, reg b)   { return movemask(_mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+        static reg  vmin(reg a, reg b)          { return _mm256_min_ps(a, b); }
+        static reg  vmax(reg a, reg b)          { return _mm256_max_ps(a, b); }
+        static reg  nan(reg a)                  { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+        static reg  vor(reg a, reg b)           { return _mm256_or_ps(a, b); }
+        static bool any(reg a)                  { return _mm256_movemask_ps(a) != 0; }
+    };
+
+    template<>
+    struct lane_ops<double, LANE_DOUBLE> {
+        static const bool enabled = true;
+        typedef __m256d reg;
+        static reg  set1(double v)              { return _mm256_set1_pd(v); }
+        static reg  load(const double* p)       { return _mm256_loadu_pd(p); }
+        static void store(double* p, reg v)     { _mm256_storeu_pd(p, v); }
+        static std::uint32_t eq(reg a, reg b)   { return movemask(_mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+        static reg  vmin(reg a, reg b)          { return _mm256_min_pd(a, b); }
+        static reg  vmax(reg a, reg b)          { return _mm256_max_pd(a, b); }
+        static reg  nan(reg a)                  { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+        static reg  vor(reg a, reg b)           { return _mm256_or_pd(a, b); }
+        static bool any(reg a)                  { return _mm256_movemask_pd(a) != 0; }
+    };
+
+    /**
+     * Векторные min/max для целых типов.
+     */
+    template<typename T> struct int_minmax { static const bool enabled = false; };
+    template<> struct int_minmax<std::int32_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm256_min_epi32(a, b); }
+        static vint vmax(vint a, vint b) { return _mm256_max_epi32(a, b); }
+    };
+    template<> struct int_minmax<std::uint32_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm256_min_epu32(a, b); }
+        static vint vmax(vint a, vint b) { return _mm256_max_epu32(a, b); }
+    };
+    template<> struct int_minmax<std::int16_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm256_min_epi16(a, b); }
+        static vint vmax(vint a, vint b) { return _mm256_max_epi16(a, b); }
+    };
+    template<> struct int_minmax<std::uint16_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm256_min_epu16(a, b); }
+        static vint vmax(vint a, vint b) { return _mm256_max_epu16(a, b); }
+    };
+    template<> struct int_minmax<std::int8_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm256_min_epi8(a, b); }
+        static vint vmax(vint a, vint b) { return _mm256_max_epi8(a, b); }
+    };
+    template<> struct int_minmax<std::uint8_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm256_min_epu8(a, b); }
+        static vint vmax(vint a, vint b) { return _mm256_max_epu8(a, b); }
+    };
+
+#elif defined(JSTD_SIMD_SSE2)
+    typedef __m128i vint;
+    const std::uint32_t FULL_MASK = 0xFFFFu;
+
+    inline vint load_bits(const void* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    inline void store_bits(void* p, vint v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+
+    inline std::uint32_t movemask(vint v) {
+        return (std::uint32_t) _mm_movemask_epi8(v);
+    }
+
+    template<std::size_t SIZE> struct int_lanes;
+    template<> struct int_lanes<1> {
+        static vint set1(std::uint8_t v)        { return _mm_set1_epi8((char) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm_cmpeq_epi8(a, b); }
+    };
+    template<> struct int_lanes<2> {
+        static vint set1(std::uint16_t v)       { return _mm_set1_epi16((short) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm_cmpeq_epi16(a, b); }
+    };
+    template<> struct int_lanes<4> {
+        static vint set1(std::uint32_t v)       { return _mm_set1_epi32((int) v); }
+        static vint cmpeq(vint a, vint b)       { return _mm_cmpeq_epi32(a, b); }
+    };
+    template<> struct int_lanes<8> {
+        static vint set1(std::uint64_t v)       { return _mm_set1_epi64x((long long) v); }
+        static vint cmpeq(vint a, vint b) {
+            //в SSE2 нет сравнения 64-битных чисел: обе 32-битные половины должны совпасть
+            const vint e = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    };
+
+    template<>
+    struct lane_ops<float, LANE_FLOAT> {
+        static const bool enabled = true;
+        typedef __m128 reg;
+        static reg  set1(float v)               { return _mm_set1_ps(v); }
+        static reg  load(const float* p)        { return _mm_loadu_ps(p); }
+        static void store(float* p, reg v)      { _mm_storeu_ps(p, v); }
+        static std::uint32_t eq(reg a, reg b)   { return movemask(_mm_castps_si128(_mm_cmpeq_ps(a, b))); }
+        static reg  vmin(reg a, reg b)          { return _mm_min_ps(a, b); }
+        static reg  vmax(reg a, reg b)          { return _mm_max_ps(a, b); }
+        static reg  nan(reg a)                  { return _mm_cmpunord_ps(a, a); }
+        static reg  vor(reg a, reg b)           { return _mm_or_ps(a, b); }
+        static bool any(reg a)                  { return _mm_movemask_ps(a) != 0; }
+    };
+
+    template<>
+    struct lane_ops<double, LANE_DOUBLE> {
+        static const bool enabled = true;
+        typedef __m128d reg;
+        static reg  set1(double v)              { return _mm_set1_pd(v); }
+        static reg  load(const double* p)       { return _mm_loadu_pd(p); }
+        static void store(double* p, reg v)     { _mm_storeu_pd(p, v); }
+        static std::uint32_t eq(reg a, reg b)   { return movemask(_mm_castpd_si128(_mm_cmpeq_pd(a, b))); }
+        static reg  vmin(reg a, reg b)          { return _mm_min_pd(a, b); }
+        static reg  vmax(reg a, reg b)          { return _mm_max_pd(a, b); }
+        static reg  nan(reg a)                  { return _mm_cmpunord_pd(a, a); }
+        static reg  vor(reg a, reg b)           { return _mm_or_pd(a, b); }
+        static bool any(reg a)                  { return _mm_movemask_pd(a) != 0; }
+    };
+
+    /**
+     * Векторные min/max для целых типов, доступные в SSE2.
+     */
+    template<typename T> struct int_minmax { static const bool enabled = false; };
+    template<> struct int_minmax<std::int32_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) {
+            const vint gt = _mm_cmpgt_epi32(a, b);
+            return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+        }
+        static vint vmax(vint a, vint b) {
+            const vint gt = _mm_cmpgt_epi32(a, b);
+            return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+        }
+    };
+    template<> struct int_minmax<std::int16_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm_min_epi16(a, b); }
+        static vint vmax(vint a, vint b) { return _mm_max_epi16(a, b); }
+    };
+    template<> struct int_minmax<std::uint8_t> {
+        static const bool enabled = true;
+        static vint vmin(vint a, vint b) { return _mm_min_epu8(a, b); }
+        static vint vmax(vint a, vint b) { return _mm_max_epu8(a, b); }
+    };
+#else
+    //без SIMD векторные ветки не выбираются, но должны компилироваться
+    const std::uint32_t FULL_MASK = 0;
+#endif
+
+#if defined(JSTD_SIMD_SSE2)
+    template<typename T>
+    struct lane_ops<T, LANE_BITWISE> {
+        static const bool enabled = true;
+        typedef vint reg;
+        static reg  set1(const T& v)            { return int_lanes<sizeof(T)>::set1(bits_of(v)); }
+        static reg  load(const T* p)            { return load_bits(p); }
+        static void store(T* p, reg v)          { store_bits(p, v); }
+        static std::uint32_t eq(reg a, reg b)   { return movemask(int_lanes<sizeof(T)>::cmpeq(a, b)); }
+    };
+
+    /**
+     * min/max: float, double и целые типы, для которых есть инструкции.
+     */
+    template<typename T, lane_kind KIND = kind_of<T>::value>
+    struct minmax_ops {
+        static const bool enabled = false;
+    };
+
+    template<typename T>
+    struct minmax_ops<T, LANE_FLOAT> : lane_ops<T> {};
+
+    template<typename T>
+    struct minmax_ops<T, LANE_DOUBLE> : lane_ops<T> {};
+
+    template<typename T, bool ENABLED = int_minmax<typename std::remove_cv<T>::type>::enabled>
+    struct int_minmax_ops {
+        static const bool enabled = false;
+    };
+
+    template<typename T>
+    struct int_minmax_ops<T, true> : lane_ops<T> {
+        static vint vmin(vint a, vint b) { return int_minmax<typename std::remove_cv<T>::type>::vmin(a, b); }
+        static vint vmax(vint a, vint b) { return int_minmax<typename std::remove_cv<T>::type>::vmax(a, b); }
+    };
+
+    template<typename T>
+    struct minmax_ops<T, LANE_BITWISE> : int_minmax_ops<T> {};
+#else
+    template<typename T>
+    struct minmax_ops {
+        static const bool enabled = false;
+    };
+#endif
+
+    template<bool B>
+    struct enabled_tag {};
+
+    typedef enabled_tag<true>  vector_tag;
+    typedef enabled_tag<false> scalar_tag;
+
+    template<typename T>
+    std::size_t find(const T* array, std::size_t len, const T& value, scalar_tag) {
+        for (std::size_t i = 0; i < len; ++i)
+            if (array[i] == value)
+                return i;
+        return len;
+    }
+
+    template<typename T>
+    std::size_t find(const T* array, std::size_t len, const T& value, vector_tag) {
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        const typename ops::reg key = ops::set1(value);
+        std::size_t i = 0;
+        for (; i + 4 * LANES <= len; i += 4 * LANES) {
+            const std::uint32_t m0 = ops::eq(ops::load(array + i), key);
+            const std::uint32_t m1 = ops::eq(ops::load(array + i + LANES), key);
+            const std::uint32_t m2 = ops::eq(ops::load(array + i + 2 * LANES), key);
+            const std::uint32_t m3 = ops::eq(ops::load(array + i + 3 * LANES), key);
+            if ((m0 | m1 | m2 | m3) != 0) {
+                if (m0 != 0) return i + ctz(m0) / sizeof(T);
+                if (m1 != 0) return i + LANES + ctz(m1) / sizeof(T);
+                if (m2 != 0) return i + 2 * LANES + ctz(m2) / sizeof(T);
+                return i + 3 * LANES + ctz(m3) / sizeof(T);
+            }
+        }
+        for (; i + LANES <= len; i += LANES) {
+            const std::uint32_t m = ops::eq(ops::load(array + i), key);
+            if (m != 0)
+                return i + ctz(m) / sizeof(T);
+        }
+        for (; i < len; ++i)
+            if (array[i] == value)
+                return i;
+        return len;
+    }
+
+    template<typename T>
+    std::size_t find_last(const T* array, std::size_t len, const T& value, scalar_tag) {
+        for (std::size_t i = len; i > 0; --i)
+            if (array[i - 1] == value)
+                return i - 1;
+        return len;
+    }
+
+    template<typename T>
+    std::size_t find_last(const T* array, std::size_t len, const T& value, vector_tag) {
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        const typename ops::reg key = ops::set1(value);
+        std::size_t i = len;
+        for (; i >= LANES; i -= LANES) {
+            const std::uint32_t m = ops::eq(ops::load(array + i - LANES), key);
+            if (m != 0)
+                return i - LANES + bsr(m) / sizeof(T);
+        }
+        for (; i > 0; --i)
+            if (array[i - 1] == value)
+                return i - 1;
+        return len;
+    }
+
+    template<typename T>
+    std::size_t count(const T* array, std::size_t len, const T& value, scalar_tag) {
+        std::size_t r = 0;
+        for (std::size_t i = 0; i < len; ++i)
+            r += array[i] == value;
+        return r;
+    }
+
+    template<typename T>
+    std::size_t count(const T* array, std::size_t len, const T& value, vector_tag) {
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        const typename ops::reg key = ops::set1(value);
+        std::size_t bits = 0;
+        std::size_t i = 0;
+        for (; i + LANES <= len; i += LANES)
+            bits += popcount(ops::eq(ops::load(array + i), key));
+        std::size_t r = bits / sizeof(T);
+        for (; i < len; ++i)
+            r += array[i] == value;
+        return r;
+    }
+
+    template<typename T>
+    bool equals(const T* a1, const T* a2, std::size_t len, scalar_tag) {
+        for (std::size_t i = 0; i < len; ++i)
+            if (!(a1[i] == a2[i]))
+                return false;
+        return true;
+    }
+
+    template<typename T>
+    bool equals(const T* a1, const T* a2, std::size_t len, vector_tag) {
+        //побитовое равенство: memcmp уже векторизован в стандартной библиотеке
+        if (is_bitwise_comparable<T>::value)
+            return len == 0 || std::memcmp(a1, a2, len * sizeof(T)) == 0;
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        std::size_t i = 0;
+        for (; i + LANES <= len; i += LANES)
+            if (ops::eq(ops::load(a1 + i), ops::load(a2 + i)) != FULL_MASK)
+                return false;
+        for (; i < len; ++i)
+            if (!(a1[i] == a2[i]))
+                return false;
+        return true;
+    }
+
+    template<typename T>
+    void fill(T* array, std::size_t len, const T& value, scalar_tag) {
+        for (std::size_t i = 0; i < len; ++i)
+            array[i] = value;
+    }
+
+    template<typename T>
+    void fill(T* array, std::size_t len, const T& value, vector_tag) {
+        if (sizeof(T) == 1 && is_bitwise_comparable<T>::value) {
+            std::memset(array, (int) bits_of(value), len);
+            return;
+        }
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        const typename ops::reg v = ops::set1(value);
+        std::size_t i = 0;
+        for (; i + LANES <= len; i += LANES)
+            ops::store(array + i, v);
+        for (; i < len; ++i)
+            array[i] = value;
+    }
+
+    template<typename T>
+    T minimum(const T* array, std::size_t len, scalar_tag) {
+        T r = array[0];
+        for (std::size_t i = 1; i < len; ++i)
+            if (array[i] < r)
+                r = array[i];
+        return r;
+    }
+
+    template<typename T>
+    T maximum(const T* array, std::size_t len, scalar_tag) {
+        T r = array[0];
+        for (std::size_t i = 1; i < len; ++i)
+            if (r < array[i])
+                r = array[i];
+        return r;
+    }
+
+#if defined(JSTD_SIMD_SSE2)
+    template<typename T, bool MIN>
+    T min_max(const T* array, std::size_t len, enabled_tag<false>) {
+        typedef minmax_ops<T> ops;
+        typedef typename ops::reg reg;
+        const std::size_t LANES = sizeof(reg) / sizeof(T);
+        if (len < LANES)
+            return MIN ? minimum(array, len, scalar_tag()) : maximum(array, len, scalar_tag());
+        reg acc = ops::load(array);
+        std::size_t i = LANES;
+        for (; i + LANES <= len; i += LANES)
+            acc = MIN ? ops::vmin(acc, ops::load(array + i)) : ops::vmax(acc, ops::load(array + i));
+        T lanes[sizeof(reg) / sizeof(T)];
+        ops::store(lanes, acc);
+        T r = MIN ? minimum(lanes, LANES, scalar_tag()) : maximum(lanes, LANES, scalar_tag());
+        for (; i < len; ++i) {
+            if (MIN ? array[i] < r : r < array[i])
+                r = array[i];
+        }
+        return r;
+    }
+
+    /**
+     * min/max для float и double с тем же результатом, что у скалярного прохода через operator<.
+     *
+     * minps/maxps при NaN возвращают второй операнд, поэтому ответ зависел бы от положения NaN.
+     * Если в векторной части встречается NaN, массив просматривается скалярно. Хвост проверяется через operator<,
+     * который пропускает NaN так же, как скалярный проход (первый элемент уже проверен на NaN).
+     * Нули разного знака равны, скалярный проход возвращает первый из них, векторный - любой, поэтому нулевой
+     * результат заменяется первым нулём массива.
+     */
+    template<typename T, bool MIN>
+    T min_max(const T* array, std::size_t len, enabled_tag<true>) {
+        typedef minmax_ops<T> ops;
+        typedef typename ops::reg reg;
+        const std::size_t LANES = sizeof(reg) / sizeof(T);
+        if (len < LANES)
+            return MIN ? minimum(array, len, scalar_tag()) : maximum(array, len, scalar_tag());
+        reg acc = ops::load(array);
+        reg nan = ops::nan(acc);
+        std::size_t i = LANES;
+        for (; i + LANES <= len; i += LANES) {
+            const reg v = ops::load(array + i);
+            acc = MIN ? ops::vmin(acc, v) : ops::vmax(acc, v);
+            nan = ops::vor(nan, ops::nan(v));
+        }
+        if (ops::any(nan))
+            return MIN ? minimum(array, len, scalar_tag()) : maximum(array, len, scalar_tag());
+        T lanes[sizeof(reg) / sizeof(T)];
+        ops::store(lanes, acc);
+        T r = MIN ? minimum(lanes, LANES, scalar_tag()) : maximum(lanes, LANES, scalar_tag());
+        for (; i < len; ++i) {
+            if (MIN ? array[i] < r : r < array[i])
+                r = array[i];
+        }
+        if (r == T(0))
+            r = array[find(array, len, T(0), vector_tag())];
+        return r;
+    }
+
+    /**
+     * float и double.
+     */
+    template<typename T>
+    struct is_ieee {
+        static const bool value = kind_of<T>::value == LANE_FLOAT || kind_of<T>::value == LANE_DOUBLE;
+    };
+
+    template<typename T>
+    T minimum(const T* array, std::size_t len, vector_tag) {
+        return min_max<T, true>(array, len, enabled_tag<is_ieee<T>::value>());
+    }
+
+    template<typename T>
+    T maximum(const T* array, std::size_t len, vector_tag) {
+        return min_max<T, false>(array, len, enabled_tag<is_ieee<T>::value>());
+    }
+#endif
+}
+
+    /**
+     * Поддерживает ли тип T векторные find, find_last, count, equals и fill.
+     */
+    template<typename T>
+    struct is_vectorizable {
+        static const bool value = internal::lane_ops<typename std::remove_cv<T>::type>::enabled;
+    };
+
+    /**
+     * Поддерживает ли тип T векторные min и max.
+     */
+    template<typename T>
+    struct is_vectorizable_minmax {
+        static const bool value = internal::minmax_ops<typename std::remove_cv<T>::type>::enabled;
+    };
+
+namespace internal
+{
+    /**
+     * Поиск подпоследовательности переходит на Two-Way, если проверка кандидатов
+     * стоит больше SEQ_WORK_FACTOR сравнений на просмотренный элемент (плюс SEQ_WORK_SLACK).
+     * Для коротких образцов (меньше SEQ_TWO_WAY_MIN) худший случай и так ограничен длиной образца.
+     */
+    const std::size_t SEQ_TWO_WAY_MIN   = 16;
+    const std::size_t SEQ_WORK_FACTOR   = 4;
+    const std::size_t SEQ_WORK_SLACK    = 4096;
+
+    /**
+     * Максимальный суффикс образца для Two-Way. При reversed используется обратный порядок элементов.
+     *
+     * @return
+     *      Позиция перед началом суффикса (может быть ~0).
+     */
+    template<typename T>
+    std::size_t maximal_suffix(const T* s, std::size_t m, bool reversed, std::size_t& period) {
+        std::size_t ip = ~(std::size_t) 0;
+        std::size_t jp = 0;
+        std::size_t k  = 1;
+        std::size_t p  = 1;
+        while (jp + k < m) {
+            const typename uint_of<sizeof(T)>::type a = bits_of(s[ip + k]);
+            const typename uint_of<sizeof(T)>::type b = bits_of(s[jp + k]);
+            if (a == b) {
+                if (k == p) {
+                    jp += p;
+                    k = 1;
+                } else {
+                    ++k;
+                }
+            } else if (reversed ? a < b : a > b) {
+                jp += k;
+                k = 1;
+                p = jp - ip;
+            } else {
+                ip = jp++;
+                k = p = 1;
+            }
+        }
+        period = p;
+        return ip;
+    }
+
+    /**
+     * Алгоритм Two-Way (Crochemore-Perrin): линейное время и O(1) памяти при любых данных.
+     * m >= 1, n >= m.
+     *
+     * @return
+     *      Индекс первого вхождения или n.
+     */
+    template<typename T>
+    std::size_t two_way(const T* h, std::size_t n, const T* s, std::size_t m) {
+        std::size_t p1, p2;
+        const std::size_t ms1 = maximal_suffix(s, m, false, p1);
+        const std::size_t ms2 = maximal_suffix(s, m, true, p2);
+        std::size_t ms = ms1;
+        std::size_t p  = p1;
+        if (ms2 + 1 > ms1 + 1) {
+            ms = ms2;
+            p  = p2;
+        }
+
+        // Для периодичного образца после совпадения первые m - p элементов уже проверены.
+        std::size_t mem0;
+        if (std::memcmp(s, s + p, (ms + 1) * sizeof(T)) != 0) {
+            mem0 = 0;
+            p = (ms > m - ms - 1 ? ms : m - ms - 1) + 1;
+        } else {
+            mem0 = m - p;
+        }
+
+        std::size_t mem = 0;
+        std::size_t pos = 0;
+        while (n - pos >= m) {
+            std::size_t k = ms + 1 > mem ? ms + 1 : mem;
+            while (k < m && s[k] == h[pos + k])
+                ++k;
+            if (k < m) {
+                pos += k - ms;
+                mem = 0;
+                continue;
+            }
+            k = ms + 1;
+            while (k > mem && s[k - 1] == h[pos + k - 1])
+                --k;
+            if (k <= mem)
+                return pos;
+            pos += p;
+            mem = mem0;
+        }
+        return n;
+    }
+
+    template<typename T>
+    std::size_t find_sequence(const T* h, std::size_t n, const T* s, std::size_t m, scalar_tag) {
+        const std::size_t end = n - m + 1;
+        for (std::size_t i = 0; i < end; ++i) {
+            i += find(h + i, end - i, s[0], enabled_tag<is_vectorizable<T>::value>());
+            if (i == end)
+                break;
+            if (equals(h + i + 1, s + 1, m - 1, enabled_tag<is_vectorizable<T>::value>()))
+                return i;
+        }
+        return n;
+    }
+
+    template<typename T>
+    std::size_t find_last_sequence(const T* h, std::size_t n, const T* s, std::size_t m, scalar_tag) {
+        for (std::size_t j = n - m + 1; j > 0;) {
+            const std::size_t i = find_last(h, j, s[0], enabled_tag<is_vectorizable<T>::value>());
+            if (i == j)
+                break;
+            if (equals(h + i + 1, s + 1, m - 1, enabled_tag<is_vectorizable<T>::value>()))
+                return i;
+            j = i;
+        }
+        return n;
+    }
+
+#if defined(JSTD_SIMD_SSE2)
+    /**
+     * Маска movemask для одного элемента типа T.
+     */
+    template<typename T>
+    std::uint32_t lane_mask() {
+        return sizeof(T) >= 4 ? (sizeof(T) == 4 ? 0xFu : 0xFFu) : (sizeof(T) == 2 ? 0x3u : 0x1u);
+    }
+
+    /**
+     * Фильтр по первому и последнему элементу образца: сравниваются сразу LANES позиций,
+     * полное сравнение выполняется только для позиций, где совпали оба.
+     * Если кандидатов слишком много, оставшаяся часть ищется через two_way().
+     */
+    template<typename T>
+    std::size_t find_sequence(const T* h, std::size_t n, const T* s, std::size_t m, vector_tag) {
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        const typename ops::reg first = ops::set1(s[0]);
+        const typename ops::reg last  = ops::set1(s[m - 1]);
+        const std::size_t end = n - m + 1;
+        std::size_t work = 0;
+        std::size_t i = 0;
+        for (; i + LANES <= end; i += LANES) {
+            std::uint32_t mask = ops::eq(ops::load(h + i), first) & ops::eq(ops::load(h + i + m - 1), last);
+            while (mask != 0) {
+                const unsigned bit = ctz(mask);
+                const std::size_t k = bit / sizeof(T);
+                if (std::memcmp(h + i + k + 1, s + 1, (m - 2) * sizeof(T)) == 0)
+                    return i + k;
+                mask &= ~(lane_mask<T>() << bit);
+                work += m;
+            }
+            if (m >= SEQ_TWO_WAY_MIN && work > SEQ_WORK_FACTOR * (i + LANES) + SEQ_WORK_SLACK) {
+                const std::size_t from = i + LANES;
+                const std::size_t r = two_way(h + from, n - from, s, m);
+                return r == n - from ? n : from + r;
+            }
+        }
+        for (; i < end; ++i)
+            if (h[i] == s[0] && h[i + m - 1] == s[m - 1] && std::memcmp(h + i + 1, s + 1, (m - 2) * sizeof(T)) == 0)
+                return i;
+        return n;
+    }
+
+    template<typename T>
+    std::size_t find_last_sequence(const T* h, std::size_t n, const T* s, std::size_t m, vector_tag) {
+        typedef lane_ops<T> ops;
+        const std::size_t LANES = sizeof(typename ops::reg) / sizeof(T);
+        const typename ops::reg first = ops::set1(s[0]);
+        const typename ops::reg last  = ops::set1(s[m - 1]);
+        std::size_t j = n - m + 1;
+        for (; j >= LANES; j -= LANES) {
+            const std::size_t i = j - LANES;
+            std::uint32_t mask = ops::eq(ops::load(h + i), first) & ops::eq(ops::load(h + i + m - 1), last);
+            while (mask != 0) {
+                const unsigned bit = bsr(mask) + 1 - (unsigned) sizeof(T);
+                const std::size_t k = bit / sizeof(T);
+                if (std::memcmp(h + i + k + 1, s + 1, (m - 2) * sizeof(T)) == 0)
+                    return i + k;
+                mask &= ~(lane_mask<T>() << bit);
+            }
+        }
+        for (; j > 0; --j) {
+            const std::size_t i = j - 1;
+            if (h[i] == s[0] && h[i + m - 1] == s[m - 1] && std::memcmp(h + i + 1, s + 1, (m - 2) * sizeof(T)) == 0)
+                return i;
+        }
+        return n;
+    }
+#endif
+
+    /**
+     * Векторный поиск подпоследовательности: для типов с побитовым равенством.
+     */
+    template<typename T>
+    struct is_sequence_vectorizable {
+        static const bool value = is_vectorizable<T>::value && is_bitwise_comparable<T>::value;
+    };
+}
+
+    /**
+     * Индекс первого элемента, равного value.
+     *
+     * @return
+     *      Индекс элемента или len, если элемент не найден.
+     */
+    template<typename T>
+    std::size_t find(const T* array, std::size_t len, const T& value) {
+        return internal::find(array, len, value, internal::enabled_tag<is_vectorizable<T>::value>());
+    }
+
+    /**
+     * Индекс последнего элемента, равного value.
+     *
+     * @return
+     *      Индекс элемента или len, если элемент не найден.
+     */
+    template<typename T>
+    std::size_t find_last(const T* array, std::size_t len, const T& value) {
+        return internal::find_last(array, len, value, internal::enabled_tag<is_vectorizable<T>::value>());
+    }
+
+    /**
+     * Индекс первого вхождения последовательности seq длины seq_len.
+     *
+     * Позиции-кандидаты отбираются векторным сравнением первого и последнего элементов seq,
+     * при большом числе ложных кандидатов поиск переходит на алгоритм Two-Way, поэтому время линейно.
+     *
+     * @return
+     *      Индекс вхождения или len, если вхождения нет. Пустая seq находится в позиции 0.
+     */
+    template<typename T>
+    std::size_t find_sequence(const T* array, std::size_t len, const T* seq, std::size_t seq_len) {
+        if (seq_len == 0)
+            return 0;
+        if (seq_len > len)
+            return len;
+        if (seq_len == 1)
+            return find(array, len, seq[0]);
+        return internal::find_sequence(array, len, seq, seq_len, internal::enabled_tag<internal::is_sequence_vectorizable<T>::value>());
+    }
+
+    /**
+     * Индекс последнего вхождения последовательности seq длины seq_len.
+     *
+     * @return
+     *      Индекс вхождения или len, если вхождения нет. Пустая seq находится в позиции len.
+     */
+    template<typename T>
+    std::size_t find_last_sequence(const T* array, std::size_t len, const T* seq, std::size_t seq_len) {
+        if (seq_len == 0 || seq_len > len)
+            return len;
+        if (seq_len == 1)
+            return find_last(array, len, seq[0]);
+        return internal::find_last_sequence(array, len, seq, seq_len, internal::enabled_tag<internal::is_sequence_vectorizable<T>::value>());
+    }
+
+    /**
+     * Количество элементов, равных value.
+     */
+    template<typename T>
+    std::size_t count(const T* array, std::size_t len, const T& value) {
+        return internal::count(array, len, value, internal::enabled_tag<is_vectorizable<T>::value>());
+    }
+
+    /**
+     * Поэлементное равенство двух массивов длины len.
+     */
+    template<typename T>
+    bool equals(const T* a1, const T* a2, std::size_t len) {
+        return internal::equals(a1, a2, len, internal::enabled_tag<is_vectorizable<T>::value>());
+    }
+
+    /**
+     * Присваивает value всем элементам массива.
+     */
+    template<typename T>
+    void fill(T* array, std::size_t len, const T& value) {
+        internal::fill(array, len, value, internal::enabled_tag<is_vectorizable<T>::value>());
+    }
+
+    /**
+     * Наименьший элемент массива. len > 0.
+     * Результат совпадает с последовательным проходом через operator<: для float и double NaN пропускаются,
+     * если только NaN не стоит первым (тогда возвращается он), из равных нулей возвращается первый.
+     */
+    template<typename T>
+    T minimum(const T* array, std::size_t len) {
+        return internal::minimum(array, len, internal::enabled_tag<is_vectorizable_minmax<T>::value>());
+    }
+
+    /**
+     * Наибольший элемент массива. len > 0.
+     *
+     * @see minimum
+     */
+    template<typename T>
+    T maximum(const T* array, std::size_t len) {
+        return internal::maximum(array, len, internal::enabled_tag<is_vectorizable_minmax<T>::value>());
+    }
+
+}//namespace simd
+
+}//namespace jstd
+
+#endif//JSTD_CPP_LANG_UTILS_SIMD_H
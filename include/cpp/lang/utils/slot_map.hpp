@@ -0,0 +1,433 @@
+#ifndef JSTD_CPP_LANG_UTILS_SLOT_MAP_H
+#define JSTD_CPP_LANG_UTILS_SLOT_MAP_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/array_list.hpp>
+#include <cpp/lang/utils/span.hpp>
+#include <cstdint>
+#include <utility>
+
+namespace jstd
+{
+
+/**
+ * Дескриптор элемента slot_map: индекс ячейки и её поколение.
+ *
+ * При удалении элемента поколение ячейки увеличивается, поэтому старые дескрипторы
+ * перестают находить элемент, даже если ячейка уже занята новым.
+ * Дескриптор с нулевым поколением никогда не бывает действительным (см. slot_handle()).
+ */
+struct slot_handle {
+    /**
+     * Индекс ячейки в таблице косвенности.
+     */
+    std::uint32_t index;
+
+    /**
+     * Поколение ячейки на момент выдачи дескриптора.
+     */
+    std::uint32_t generation;
+
+    /**
+     * Недействительный дескриптор.
+     */
+    slot_handle() : index(0), generation(0) {
+
+    }
+
+    /**
+     *
+     */
+    slot_handle(std::uint32_t idx, std::uint32_t gen) : index(idx), generation(gen) {
+
+    }
+
+    /**
+     * Упаковывает дескриптор в 64-битное число (поколение в старших битах).
+     */
+    std::uint64_t value() const {
+        return ((std::uint64_t) generation << 32) | index;
+    }
+
+    /**
+     * Распаковывает дескриптор, полученный через value().
+     */
+    static slot_handle from_value(std::uint64_t v) {
+        return slot_handle((std::uint32_t) v, (std::uint32_t) (v >> 32));
+    }
+
+    /**
+     *
+     */
+    bool operator==(const slot_handle& h) const {
+        return index == h.index && generation == h.generation;
+    }
+
+    /**
+     *
+     */
+    bool operator!=(const slot_handle& h) const {
+        return !(*this == h);
+    }
+};
+
+/**
+ * Контейнер с устойчивыми дескрипторами и плотным хранением элементов.
+ *
+ * Элементы лежат в непрерывном массиве без дыр, поэтому обход так же быстр, как у array_list.
+ * Дескриптор указывает на ячейку таблицы косвенности, которая хранит позицию элемента в плотном массиве.
+ * Вставка, удаление и поиск по дескриптору - O(1). При удалении на место элемента переносится последний,
+ * поэтому порядок элементов не сохраняется, а указатели на элементы недействительны после любого изменения.
+ *
+ * Свободные ячейки образуют список внутри самой таблицы косвенности, отдельных выделений памяти на элемент нет.
+ *
+ * @tparam T
+ *      Тип элементов.
+ */
+template<typename T>
+class slot_map {
+    /**
+     * Ячейка таблицы косвенности.
+     */
+    struct slot {
+        /**
+         * Для занятой ячейки - позиция элемента в m_data, для свободной - следующая свободная ячейка.
+         */
+        std::uint32_t index;
+
+        /**
+         * Текущее поколение. Нечётное у занятой ячейки, чётное у свободной.
+         */
+        std::uint32_t generation;
+    };
+
+    /**
+     * Конец списка свободных ячеек.
+     */
+    static const std::uint32_t NO_SLOT = ~((std::uint32_t) 0);
+
+    /**
+     * Элементы без промежутков.
+     */
+    array_list<T> m_data;
+
+    /**
+     * Для каждого элемента m_data - индекс его ячейки.
+     */
+    array_list<std::uint32_t> m_owner;
+
+    /**
+     * Таблица косвенности.
+     */
+    array_list<slot> m_slots;
+
+    /**
+     * Первая свободная ячейка или NO_SLOT.
+     */
+    std::uint32_t m_free_head;
+
+    /**
+     * Возвращает занятую ячейку дескриптора или nullptr.
+     */
+    const slot* find(slot_handle h) const {
+        if (h.index >= m_slots.size())
+            return nullptr;
+        const slot* s = m_slots.data() + h.index;
+        return s->generation == h.generation && (s->generation & 1) != 0 ? s : nullptr;
+    }
+
+    /**
+     * Освобождает ячейку и возвращает её в список свободных.
+     */
+    void release_slot(std::uint32_t idx);
+
+public:
+    /**
+     * Создаёт пустой контейнер.
+     */
+    slot_map(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт пустой контейнер с заданной начальной вместимостью.
+     */
+    explicit slot_map(std::size_t init_capacity, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт копию контейнера с теми же дескрипторами.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего контейнера.
+     */
+    slot_map<T> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Добавляет элемент за O(1).
+     *
+     * @return
+     *      Дескриптор элемента.
+     *
+     * @throws illegal_state_exception
+     *      Если исчерпаны 32-битные индексы ячеек.
+     */
+    template<typename _T>
+    slot_handle add(_T&& value);
+
+    /**
+     * Возвращает указатель на элемент или nullptr, если дескриптор недействителен.
+     */
+    T* get(slot_handle h);
+
+    /**
+     * Возвращает указатель на элемент или nullptr, если дескриптор недействителен.
+     */
+    const T* get(slot_handle h) const;
+
+    /**
+     * @throws no_such_element_exception
+     *      Если дескриптор недействителен.
+     */
+    T& at(slot_handle h);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если дескриптор недействителен.
+     */
+    const T& at(slot_handle h) const;
+
+    /**
+     * Возвращает true, если дескриптор указывает на существующий элемент.
+     */
+    bool contains(slot_handle h) const {
+        return find(h) != nullptr;
+    }
+
+    /**
+     * Удаляет элемент за O(1). На его место переносится последний элемент плотного массива.
+     *
+     * @param ret
+     *      Если не nullptr, в него перемещается удалённый элемент.
+     *
+     * @return
+     *      false, если дескриптор недействителен.
+     */
+    bool remove(slot_handle h, T* ret = nullptr);
+
+    /**
+     * Возвращает дескриптор элемента, находящегося в позиции idx плотного массива.
+     */
+    slot_handle handle_at(std::size_t idx) const {
+        const std::uint32_t s = m_owner.at(idx);
+        return slot_handle(s, m_slots.data()[s].generation);
+    }
+
+    /**
+     * Удаляет все элементы. Все выданные дескрипторы становятся недействительными.
+     */
+    void clear();
+
+    /**
+     * Резервирует место под new_capacity элементов.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_data.size();
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_data.is_empty();
+    }
+
+    /**
+     * Элементы в плотном массиве.
+     */
+    span<T> values() {
+        return span<T>(m_data.data(), m_data.size());
+    }
+
+    /**
+     * Элементы в плотном массиве.
+     */
+    span<const T> values() const {
+        return span<const T>(m_data.data(), m_data.size());
+    }
+
+    /**
+     *
+     */
+    T* begin() {
+        return m_data.data();
+    }
+
+    /**
+     *
+     */
+    T* end() {
+        return m_data.data() + m_data.size();
+    }
+
+    /**
+     *
+     */
+    const T* begin() const {
+        return m_data.data();
+    }
+
+    /**
+     *
+     */
+    const T* end() const {
+        return m_data.data() + m_data.size();
+    }
+};
+
+    template<typename T>
+    slot_map<T>::slot_map(tca::allocator* allocator) :
+        m_data(allocator),
+        m_owner(allocator),
+        m_slots(allocator),
+        m_free_head(NO_SLOT) {
+
+    }
+
+    template<typename T>
+    slot_map<T>::slot_map(std::size_t init_capacity, tca::allocator* allocator) :
+        m_data(init_capacity, allocator),
+        m_owner(init_capacity, allocator),
+        m_slots(init_capacity, allocator),
+        m_free_head(NO_SLOT) {
+
+    }
+
+    template<typename T>
+    slot_map<T> slot_map<T>::clone(tca::allocator* allocator) const {
+        slot_map<T> copy(allocator != nullptr ? allocator : m_data.get_allocator());
+        copy.m_data         = m_data.clone(allocator);
+        copy.m_owner        = m_owner.clone(allocator);
+        copy.m_slots        = m_slots.clone(allocator);
+        copy.m_free_head    = m_free_head;
+        return copy;
+    }
+
+    template<typename T>
+    void slot_map<T>::reserve(std::size_t new_capacity) {
+        if (new_capacity > m_data.capacity())
+            m_data.reserve(new_capacity);
+        if (new_capacity > m_owner.capacity())
+            m_owner.reserve(new_capacity);
+        if (new_capacity > m_slots.capacity())
+            m_slots.reserve(new_capacity);
+    }
+
+    template<typename T>
+    template<typename _T>
+    slot_handle slot_map<T>::add(_T&& value) {
+        std::uint32_t idx = m_free_head;
+        const bool fresh = idx == NO_SLOT;
+        if (fresh) {
+            if (m_slots.size() >= NO_SLOT)
+                throw_except<illegal_state_exception>("slot_map is full");
+            slot s = {0, 0};
+            m_slots.add(s);
+            idx = (std::uint32_t) (m_slots.size() - 1);
+        }
+
+        const std::uint32_t pos = (std::uint32_t) m_data.size();
+        bool stored = false;
+        try {
+            m_data.add(std::forward<_T>(value));
+            stored = true;
+            m_owner.add(idx);
+        } catch (...) {
+            //новая ячейка ещё не в списке свободных: без отката она была бы потеряна навсегда
+            if (stored)
+                m_data.remove_at(pos);
+            if (fresh)
+                m_slots.remove_at(idx);
+            throw;
+        }
+
+        slot& s = m_slots.data()[idx];
+        if (idx == m_free_head)
+            m_free_head = s.index;
+        s.index = pos;
+        ++s.generation;
+        return slot_handle(idx, s.generation);
+    }
+
+    template<typename T>
+    T* slot_map<T>::get(slot_handle h) {
+        const slot* s = find(h);
+        return s != nullptr ? m_data.data() + s->index : nullptr;
+    }
+
+    template<typename T>
+    const T* slot_map<T>::get(slot_handle h) const {
+        const slot* s = find(h);
+        return s != nullptr ? m_data.data() + s->index : nullptr;
+    }
+
+    template<typename T>
+    T& slot_map<T>::at(slot_handle h) {
+        T* e = get(h);
+        if (e == nullptr)
+            throw_except<no_such_element_exception>("Stale or invalid handle");
+        return *e;
+    }
+
+    template<typename T>
+    const T& slot_map<T>::at(slot_handle h) const {
+        const T* e = get(h);
+        if (e == nullptr)
+            throw_except<no_such_element_exception>("Stale or invalid handle");
+        return *e;
+    }
+
+    template<typename T>
+    void slot_map<T>::release_slot(std::uint32_t idx) {
+        slot& s = m_slots.data()[idx];
+        ++s.generation;
+        if (s.generation == 0) {
+            // Поколения исчерпаны: ячейка больше не выдаётся, чтобы старые дескрипторы не ожили.
+            return;
+        }
+        s.index     = m_free_head;
+        m_free_head = idx;
+    }
+
+    template<typename T>
+    bool slot_map<T>::remove(slot_handle h, T* ret) {
+        const slot* s = find(h);
+        if (s == nullptr)
+            return false;
+        const std::uint32_t pos  = s->index;
+        const std::uint32_t last = (std::uint32_t) (m_data.size() - 1);
+        if (pos != last) {
+            const std::uint32_t moved = m_owner.data()[last];
+            m_slots.data()[moved].index = pos;
+            m_owner.data()[pos]         = moved;
+        }
+        m_data.fast_remove_at(pos, ret);
+        m_owner.remove_at(last);
+        release_slot(h.index);
+        return true;
+    }
+
+    template<typename T>
+    void slot_map<T>::clear() {
+        const std::uint32_t* owner = m_owner.data();
+        for (std::size_t i = 0, n = m_owner.size(); i < n; ++i)
+            release_slot(owner[i]);
+        m_data.clear();
+        m_owner.clear();
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_SLOT_MAP_H
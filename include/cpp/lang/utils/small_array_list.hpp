@@ -0,0 +1,626 @@
+#ifndef JSTD_CPP_LANG_UTILS_SMALL_ARRAY_LIST_H
+#define JSTD_CPP_LANG_UTILS_SMALL_ARRAY_LIST_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/array_list.hpp>
+#include <cpp/lang/utils/hash.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/objects.hpp>
+#include <cpp/lang/utils/utils.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <initializer_list>
+#include <cassert>
+
+namespace jstd
+{
+
+/**
+ * Динамический массив со встроенным буфером на N элементов.
+ *
+ * Пока в списке не больше N элементов, они хранятся внутри самого объекта и аллокатор не используется.
+ * При переполнении элементы переносятся в память, выделенную аллокатором, и дальше список ведёт себя как array_list.
+ * Интерфейс и итераторы совпадают с array_list.
+ *
+ * В отличие от array_list, перемещение списка со встроенным буфером перемещает каждый элемент.
+ *
+ * @tparam E
+ *      Тип элементов, хранящихся в списке.
+ *
+ * @tparam N
+ *      Количество элементов во встроенном буфере.
+ */
+template<typename E, std::size_t N>
+class small_array_list {
+    static_assert(N > 0, "Inline capacity must be > 0");
+
+    /**
+     * Указатель на пользовательский аллокатор памяти.
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     * Указатель на массив элементов: встроенный буфер или память аллокатора.
+     */
+    E* m_data;
+
+    /**
+     * Текущая вместимость массива.
+     */
+    std::size_t m_capacity;
+
+    /**
+     * Текущее количество элементов в списке.
+     */
+    std::size_t m_size;
+
+    /**
+     * Встроенный буфер.
+     */
+    alignas(E) unsigned char m_inline[sizeof(E) * N];
+
+    /**
+     *
+     */
+    E* inline_data() {
+        return reinterpret_cast<E*>(m_inline);
+    }
+
+    /**
+     * Вызывает деструкторы для элементов в диапазоне [start, end).
+     */
+    void call_destructors(std::size_t start, std::size_t end);
+
+    /**
+     * Разрушает элементы, освобождает память аллокатора и возвращает список на встроенный буфер.
+     */
+    void cleanup();
+
+    /**
+     * Увеличивает вместимость массива с коэффициентом роста 1.5x.
+     */
+    void grow();
+
+    /**
+     * Забирает содержимое списка list. Текущий список должен быть пуст и использовать встроенный буфер.
+     */
+    void steal(small_array_list<E, N>& list);
+
+public:
+    /**
+     *
+     */
+    static const std::size_t null_val = ~((std::size_t) 0);
+
+    /**
+     * Количество элементов во встроенном буфере.
+     */
+    static const std::size_t INLINE_CAPACITY = N;
+
+    /**
+     *
+     */
+    template<typename DATA_TYPE, typename VALUE_TYPE>
+    using iterator = typename array_list<E>:: template iterator<DATA_TYPE, VALUE_TYPE>;
+
+    /**
+     * Создаёт пустой список. Аллокатор используется только после переполнения встроенного буфера.
+     */
+    small_array_list(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт список с заданной начальной вместимостью.
+     */
+    explicit small_array_list(std::size_t init_capacity, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт список с заданным аллокатором и инициализирующим листом.
+     */
+    small_array_list(const std::initializer_list<E>& init_list, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    small_array_list(const small_array_list<E, N>& list);
+
+    /**
+     *
+     */
+    small_array_list(small_array_list<E, N>&& list);
+
+    /**
+     *
+     */
+    small_array_list<E, N>& operator=(const small_array_list<E, N>& list);
+
+    /**
+     *
+     */
+    small_array_list<E, N>& operator=(small_array_list<E, N>&& list);
+
+    /**
+     * @see array_list::clone
+     */
+    small_array_list<E, N> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     *
+     */
+    ~small_array_list();
+
+    /**
+     * @see array_list::add
+     */
+    template<typename _E>
+    void add(_E&& e);
+
+    /**
+     * @see array_list::add
+     */
+    template<typename _E>
+    void add(std::size_t idx, _E&& e);
+
+    /**
+     * @see array_list::last_index_of
+     */
+    std::size_t last_index_of(const E& e) const;
+
+    /**
+     * @see array_list::index_of
+     */
+    std::size_t index_of(const E& e) const;
+
+    /**
+     * @see array_list::contains
+     */
+    bool contains(const E& e) const {
+        return index_of(e) != null_val;
+    }
+
+    /**
+     * @see array_list::remove
+     */
+    bool remove(const E& e);
+
+    /**
+     * @see array_list::remove_at
+     */
+    bool remove_at(std::size_t idx, E* ret = nullptr);
+
+    /**
+     * @see array_list::fast_remove_at
+     */
+    bool fast_remove_at(std::size_t idx, E* ret = nullptr);
+
+    /**
+     * @see array_list::set
+     */
+    template<typename _E>
+    bool set(std::size_t idx, _E&& e, E* ret_old_value = nullptr);
+
+    /**
+     * @see array_list::at
+     */
+    E& at(std::size_t idx) const;
+
+    /**
+     *
+     */
+    std::size_t size() const;
+
+    /**
+     *
+     */
+    std::size_t capacity() const;
+
+    /**
+     * Возвращает true, если элементы хранятся во встроенном буфере.
+     */
+    bool is_inline() const;
+
+    /**
+     * Гарантирует, что список может вместить не менее {@code new_capacity} элементов без перераспределения.
+     * Вместимость никогда не уменьшается.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * Удаляет все элементы, но не освобождает память.
+     */
+    void clear();
+
+    /**
+     *
+     */
+    bool is_empty() const;
+
+    /**
+     * @see array_list::equals
+     */
+    bool equals(const small_array_list<E, N>& other) const;
+
+    /**
+     * @see array_list::hashcode
+     */
+    std::size_t hashcode() const;
+
+    /**
+     * Возвращает указатель на сырые данные.
+     */
+    E* data() {
+        return m_data;
+    }
+
+    /**
+     * Возвращает указатель на сырые данные. (Константная версия)
+     */
+    const E* data() const {
+        return m_data;
+    }
+
+    /**
+     * @see array_list::intersect_sort
+     */
+    template<typename COMPARATOR_T = compare_to<E>>
+    void intersect_sort();
+
+    /**
+     * @see array_list::sort
+     */
+    template<typename COMPARATOR_T = compare_to<E>>
+    void sort();
+
+    /**
+     * @see array_list::stable_sort
+     */
+    template<typename COMPARATOR_T = compare_to<E>>
+    void stable_sort(tca::allocator* allocator = nullptr);
+
+    /**
+     * @see array_list::binary_search
+     */
+    template<typename COMPARATOR_T = compare_to<E>>
+    std::size_t binary_search(const E& searched) const;
+
+    /**
+     * Минимальный размер буфера для хранения строкового представления объекта.
+     */
+    static const int32_t TO_STRING_MIN_BUFFER_SIZE = 80;
+
+    /**
+     * @see array_list::to_string
+     */
+    int to_string(char buf[], std::size_t bufsize) const;
+
+    iterator<const E, const E&> begin() const {
+        return iterator<const E, const E&>(m_data, 0, m_size);
+    }
+
+    iterator<const E, const E&> end() const {
+        return iterator<const E, const E&>(m_data, m_size, m_size);
+    }
+
+    iterator<E, E&> begin() {
+        return iterator<E, E&>(m_data, 0, m_size);
+    }
+
+    iterator<E, E&> end() {
+        return iterator<E, E&>(m_data, m_size, m_size);
+    }
+};
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>::small_array_list(tca::allocator* allocator) :
+    m_allocator(allocator),
+    m_data(inline_data()),
+    m_capacity(N),
+    m_size(0) {
+
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>::small_array_list(std::size_t init_capacity, tca::allocator* allocator) : small_array_list<E, N>(allocator) {
+        reserve(init_capacity);
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>::small_array_list(const std::initializer_list<E>& init_list, tca::allocator* allocator) : small_array_list<E, N>(allocator) {
+        reserve(init_list.size());
+        for (const E& e : init_list)
+            add(e);
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>::small_array_list(const small_array_list<E, N>& list) : small_array_list<E, N>(list.m_allocator) {
+        reserve(list.m_size);
+        for (std::size_t i = 0; i < list.m_size; ++i)
+            add(list.m_data[i]);
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>::small_array_list(small_array_list<E, N>&& list) : small_array_list<E, N>(list.m_allocator) {
+        steal(list);
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>& small_array_list<E, N>::operator= (const small_array_list<E, N>& list) {
+        if (&list != this) {
+            small_array_list<E, N> tmp = list.clone(m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>& small_array_list<E, N>::operator= (small_array_list<E, N>&& list) {
+        if (&list != this) {
+            cleanup();
+            m_allocator = list.m_allocator;
+            steal(list);
+        }
+        return *this;
+    }
+
+    template<typename E, std::size_t N>
+    void small_array_list<E, N>::steal(small_array_list<E, N>& list) {
+        assert(m_size == 0 && is_inline());
+        if (list.is_inline()) {
+            relocate(m_data, list.m_data, list.m_size);
+            m_size = list.m_size;
+        } else {
+            m_data      = list.m_data;
+            m_capacity  = list.m_capacity;
+            m_size      = list.m_size;
+            list.m_data     = list.inline_data();
+            list.m_capacity = N;
+        }
+        list.m_size = 0;
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N> small_array_list<E, N>::clone(tca::allocator* allocator) const {
+        if (allocator == nullptr)
+            allocator = m_allocator;
+        small_array_list<E, N> list(allocator);
+        list.reserve(m_size);
+        for (std::size_t i = 0; i < m_size; ++i)
+            list.add(m_data[i]);
+        return list;
+    }
+
+    template<typename E, std::size_t N>
+    small_array_list<E, N>::~small_array_list() {
+        cleanup();
+    }
+
+    template<typename E, std::size_t N>
+    template<typename _E>
+    void small_array_list<E, N>::add(_E&& e) {
+        if (m_size + 1 > m_capacity)
+            grow();
+        new (m_data + m_size) E(std::forward<_E>(e));
+        ++m_size;
+    }
+
+    template<typename E, std::size_t N>
+    template<typename _E>
+    void small_array_list<E, N>::add(std::size_t idx, _E&& e) {
+        check_index(idx, m_size + 1);
+
+        if (m_size + 1 > m_capacity)
+            grow();
+
+        relocate(m_data + idx + 1, m_data + idx, m_size - idx);
+        try {
+            new (m_data + idx) E(std::forward<_E>(e));
+        } catch (...) {
+            relocate(m_data + idx, m_data + idx + 1, m_size - idx);
+            throw;
+        }
+
+        ++m_size;
+    }
+
+    template<typename E, std::size_t N>
+    std::size_t small_array_list<E, N>::last_index_of(const E& e) const {
+        const std::size_t idx = objects::last_index_of(m_data, m_size, e);
+        return idx != m_size ? idx : null_val;
+    }
+
+    template<typename E, std::size_t N>
+    std::size_t small_array_list<E, N>::index_of(const E& e) const {
+        const std::size_t idx = objects::index_of(m_data, m_size, e);
+        return idx != m_size ? idx : null_val;
+    }
+
+    template<typename E, std::size_t N>
+    bool small_array_list<E, N>::remove(const E& e) {
+        std::size_t finded_index = index_of(e);
+        if (finded_index == null_val)
+            return false;
+        return remove_at(finded_index, nullptr);
+    }
+
+    template<typename E, std::size_t N>
+    bool small_array_list<E, N>::remove_at(std::size_t idx, E* ret) {
+        check_index(idx, m_size);
+
+        if (ret != nullptr)
+            *ret = std::move(m_data[idx]);
+
+        m_data[idx].~E();
+
+        relocate(m_data + idx, m_data + idx + 1, m_size - idx - 1);
+
+        --m_size;
+
+        return true;
+    }
+
+    template<typename E, std::size_t N>
+    bool small_array_list<E, N>::fast_remove_at(std::size_t idx, E* ret) {
+        check_index(idx, m_size);
+        if (idx == m_size - 1)
+            return remove_at(idx, ret);
+
+        std::swap(m_data[idx], m_data[m_size - 1]);
+
+        if (ret != nullptr)
+            *ret = std::move(m_data[m_size - 1]);
+
+        m_data[m_size - 1].~E();
+        --m_size;
+
+        return true;
+    }
+
+    template<typename E, std::size_t N>
+    template<typename _E>
+    bool small_array_list<E, N>::set(std::size_t idx, _E&& e, E* ret_old_value) {
+        check_index(idx, m_size);
+        if (ret_old_value != nullptr)
+            *ret_old_value = std::move(m_data[idx]);
+        m_data[idx] = std::forward<_E>(e);
+        return true;
+    }
+
+    template<typename E, std::size_t N>
+    E& small_array_list<E, N>::at(std::size_t idx) const {
+        check_index(idx, m_size);
+        return m_data[idx];
+    }
+
+    template<typename E, std::size_t N>
+    std::size_t small_array_list<E, N>::size() const {
+        return m_size;
+    }
+
+    template<typename E, std::size_t N>
+    std::size_t small_array_list<E, N>::capacity() const {
+        return m_capacity;
+    }
+
+    template<typename E, std::size_t N>
+    bool small_array_list<E, N>::is_inline() const {
+        return m_data == reinterpret_cast<const E*>(m_inline);
+    }
+
+    template<typename E, std::size_t N>
+    void small_array_list<E, N>::grow() {
+        reserve(m_capacity + (m_capacity >> 1) + 1);
+    }
+
+    template<typename E, std::size_t N>
+    void small_array_list<E, N>::reserve(std::size_t new_capacity) {
+        if (new_capacity <= m_capacity)
+            return;
+
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator is null");
+        )
+
+        E* new_data = reinterpret_cast<E*>(m_allocator->allocate_align(sizeof(E) * new_capacity, alignof(E)));
+        if (new_data == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+
+        relocate(new_data, m_data, m_size);
+
+        if (!is_inline())
+            m_allocator->deallocate(m_data, sizeof(E) * m_capacity);
+        m_data      = new_data;
+        m_capacity  = new_capacity;
+    }
+
+    template<typename E, std::size_t N>
+    void small_array_list<E, N>::clear() {
+        call_destructors(0, m_size);
+        m_size = 0;
+    }
+
+    template<typename E, std::size_t N>
+    bool small_array_list<E, N>::is_empty() const {
+        return m_size == 0;
+    }
+
+    template<typename E, std::size_t N>
+    void small_array_list<E, N>::call_destructors(std::size_t start, std::size_t end) {
+        assert(start <= end);
+        while (end > start)
+            m_data[--end].~E();
+    }
+
+    template<typename E, std::size_t N>
+    void small_array_list<E, N>::cleanup() {
+        call_destructors(0, m_size);
+        if (!is_inline() && m_allocator != nullptr)
+            m_allocator->deallocate(m_data, sizeof(E) * m_capacity);
+        m_data      = inline_data();
+        m_capacity  = N;
+        m_size      = 0;
+    }
+
+    template<typename E, std::size_t N>
+    bool small_array_list<E, N>::equals(const small_array_list<E, N>& other) const {
+        if (size() != other.size())
+            return false;
+        return objects::equals(data(), other.data(), size());
+    }
+
+    template<typename E, std::size_t N>
+    std::size_t small_array_list<E, N>::hashcode() const {
+        if (size() == 0)
+            return 0;
+        return objects::hashcode(data(), size());
+    }
+
+    template<typename E, std::size_t N>
+    template<typename COMPARATOR_T>
+    void small_array_list<E, N>::intersect_sort() {
+        utils::intersect_sort<E, COMPARATOR_T>(m_data, m_size);
+    }
+
+    template<typename E, std::size_t N>
+    template<typename COMPARATOR_T>
+    void small_array_list<E, N>::sort() {
+        utils::sort<E, COMPARATOR_T>(m_data, m_size);
+    }
+
+    template<typename E, std::size_t N>
+    template<typename COMPARATOR_T>
+    void small_array_list<E, N>::stable_sort(tca::allocator* allocator) {
+        utils::stable_sort<E, COMPARATOR_T>(m_data, m_size, allocator != nullptr ? allocator : m_allocator);
+    }
+
+    template<typename E, std::size_t N>
+    template<typename COMPARATOR_T>
+    std::size_t small_array_list<E, N>::binary_search(const E& searched) const {
+        COMPARATOR_T compare_to;
+        std::size_t start   = 0;
+        std::size_t end     = m_size;
+        while (start < end) {
+            const std::size_t mid       = (end - start) / 2 + start;
+            const int compare_result    = compare_to(searched, m_data[mid]);
+
+            if (compare_result == 0)
+                return mid;
+            else if (compare_result < 0)
+                end     = mid;
+            else
+                start   = mid + 1;
+        }
+        return null_val;
+    }
+
+    template<typename E, std::size_t N>
+    int small_array_list<E, N>::to_string(char buf[], std::size_t bufsize) const {
+        return std::snprintf(buf, bufsize, "[data=0x%llx, capacity=%lli, size=%lli, inline=%s]", (long long) m_data, (long long) m_capacity, (long long) m_size, is_inline() ? "true" : "false");
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_SMALL_ARRAY_LIST_H
@@ -0,0 +1,901 @@
+#ifndef JSTD_CPP_LANG_UTILS_SOA_H
+#define JSTD_CPP_LANG_UTILS_SOA_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/arrays.hpp>
+#include <cpp/lang/utils/span.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+
+namespace jstd
+{
+
+namespace internal
+{
+/**
+ * Общая часть soa_array и soa_list: раскладка столбцов в одном блоке памяти,
+ * построчные операции над всеми столбцами, прокси-ссылка на строку и итератор.
+ */
+namespace soa
+{
+    template<std::size_t... I>
+    struct index_seq {};
+
+    template<std::size_t N, std::size_t... I>
+    struct make_index_seq : make_index_seq<N - 1, N - 1, I...> {};
+
+    template<std::size_t... I>
+    struct make_index_seq<0, I...> {
+        typedef index_seq<I...> type;
+    };
+
+    /**
+     * Выравнивание начала каждого столбца. Достаточно для выровненных загрузок AVX-512 и не делит кэш-линию между столбцами.
+     */
+    static const std::size_t COLUMN_ALIGN = 64;
+
+    inline std::size_t align_up(std::size_t x) {
+        return (x + COLUMN_ALIGN - 1) & ~(COLUMN_ALIGN - 1);
+    }
+
+    template<typename... Ts>
+    struct max_align;
+
+    template<>
+    struct max_align<> {
+        static const std::size_t value = 1;
+    };
+
+    template<typename T, typename... Ts>
+    struct max_align<T, Ts...> {
+        static const std::size_t value = alignof(T) > max_align<Ts...>::value ? alignof(T) : max_align<Ts...>::value;
+    };
+
+    /**
+     * Вызывает op(std::get<I>(columns)...) для каждого столбца.
+     */
+    template<typename TUPLE, typename OP, std::size_t... I>
+    void for_each_column(TUPLE& columns, const OP& op, index_seq<I...>) {
+        int unused[] = {0, (op(std::get<I>(columns)), 0)...};
+        (void) unused;
+    }
+
+    /**
+     * Вызывает op(std::get<I>(dst), std::get<I>(src)) для каждого столбца.
+     */
+    template<typename TUPLE, typename OP, std::size_t... I>
+    void for_each_column(TUPLE& dst, TUPLE& src, const OP& op, index_seq<I...>) {
+        int unused[] = {0, (op(std::get<I>(dst), std::get<I>(src)), 0)...};
+        (void) unused;
+    }
+
+    /**
+     * Создаёт элементы [from, to) конструктором по умолчанию.
+     */
+    struct construct_op {
+        std::size_t from;
+        std::size_t to;
+
+        template<typename T>
+        void operator()(T* column) const {
+            for (std::size_t i = from; i < to; ++i)
+                new (column + i) T();
+        }
+    };
+
+    /**
+     * Разрушает элементы [from, to).
+     */
+    struct destroy_op {
+        std::size_t from;
+        std::size_t to;
+
+        template<typename T>
+        void operator()(T* column) const {
+            for (std::size_t i = from; i < to; ++i)
+                column[i].~T();
+        }
+    };
+
+    /**
+     * Переносит n элементов в неинициализированный столбец dst и разрушает исходные.
+     */
+    struct relocate_op {
+        std::size_t n;
+
+        template<typename T>
+        void operator()(T* dst, T* src) const {
+            relocate(dst, src, n);
+        }
+    };
+
+    /**
+     * Копирует n элементов в неинициализированный столбец dst.
+     */
+    struct copy_op {
+        std::size_t n;
+
+        template<typename T>
+        void operator()(T* dst, T* src) const {
+            for (std::size_t i = 0; i < n; ++i)
+                new (dst + i) T(src[i]);
+        }
+    };
+
+    /**
+     * Удаляет элемент idx со сдвигом хвоста [idx + 1, size) влево.
+     */
+    struct erase_op {
+        std::size_t idx;
+        std::size_t size;
+
+        template<typename T>
+        void operator()(T* column) const {
+            for (std::size_t i = idx + 1; i < size; ++i)
+                column[i - 1] = std::move(column[i]);
+            column[size - 1].~T();
+        }
+    };
+
+    /**
+     * Переносит последний элемент на место idx.
+     */
+    struct swap_remove_op {
+        std::size_t idx;
+        std::size_t last;
+
+        template<typename T>
+        void operator()(T* column) const {
+            if (idx != last)
+                column[idx] = std::move(column[last]);
+            column[last].~T();
+        }
+    };
+
+    /**
+     * Прокси-ссылка на строку: хранит указатель на кортеж столбцов и индекс строки.
+     *
+     * Копирование прокси копирует ссылку, а не значения. Для записи значений используется set.
+     *
+     * @tparam CONST
+     *      true для ссылки только для чтения.
+     */
+    template<bool CONST, typename... Ts>
+    class row {
+        typedef std::tuple<Ts*...> columns_t;
+        typedef typename make_index_seq<sizeof...(Ts)>::type indices;
+
+        const columns_t* m_columns;
+        std::size_t m_idx;
+
+        template<std::size_t... I>
+        std::tuple<Ts...> copy(index_seq<I...>) const {
+            return std::tuple<Ts...>(std::get<I>(*m_columns)[m_idx]...);
+        }
+
+        template<std::size_t... I, typename... Args>
+        void assign(index_seq<I...>, Args&&... values) const {
+            int unused[] = {0, ((std::get<I>(*m_columns)[m_idx] = std::forward<Args>(values)), 0)...};
+            (void) unused;
+        }
+
+    public:
+        /**
+         * Тип поля I с учётом константности ссылки.
+         */
+        template<std::size_t I>
+        using field_type = typename std::conditional<CONST,
+                                                     const typename std::tuple_element<I, std::tuple<Ts...>>::type,
+                                                     typename std::tuple_element<I, std::tuple<Ts...>>::type>::type;
+
+        row(const columns_t* columns, std::size_t idx) : m_columns(columns), m_idx(idx) {
+
+        }
+
+        /**
+         * Неконстантная ссылка приводится к константной.
+         */
+        operator row<true, Ts...>() const {
+            return row<true, Ts...>(m_columns, m_idx);
+        }
+
+        /**
+         * Возвращает ссылку на поле I строки.
+         */
+        template<std::size_t I>
+        field_type<I>& get() const {
+            return std::get<I>(*m_columns)[m_idx];
+        }
+
+        /**
+         * Индекс строки в контейнере.
+         */
+        std::size_t index() const {
+            return m_idx;
+        }
+
+        /**
+         * Возвращает копию значений строки.
+         */
+        std::tuple<Ts...> value() const {
+            return copy(indices());
+        }
+
+        /**
+         * Присваивает значения всем полям строки.
+         */
+        template<typename... Args>
+        void set(Args&&... values) const {
+            static_assert(!CONST, "Cannot assign through a const row");
+            static_assert(sizeof...(Args) == sizeof...(Ts), "Expected one value per column");
+            assign(indices(), std::forward<Args>(values)...);
+        }
+    };
+
+    /**
+     * Итератор по строкам. Разыменование возвращает прокси-ссылку row.
+     */
+    template<bool CONST, typename... Ts>
+    class row_iterator {
+        const std::tuple<Ts*...>* m_columns;
+        std::size_t m_idx;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef row<CONST, Ts...> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef row<CONST, Ts...> reference;
+
+        row_iterator(const std::tuple<Ts*...>* columns, std::size_t idx) : m_columns(columns), m_idx(idx) {
+
+        }
+
+        row<CONST, Ts...> operator*() const {
+            return row<CONST, Ts...>(m_columns, m_idx);
+        }
+
+        row_iterator& operator++() {
+            ++m_idx;
+            return *this;
+        }
+
+        row_iterator operator++(int) {
+            row_iterator tmp = *this;
+            ++m_idx;
+            return tmp;
+        }
+
+        bool operator==(const row_iterator& it) const {
+            return m_idx == it.m_idx;
+        }
+
+        bool operator!=(const row_iterator& it) const {
+            return m_idx != it.m_idx;
+        }
+    };
+
+    /**
+     * Хранилище столбцов. Все столбцы лежат в одном блоке памяти аллокатора,
+     * каждый начинается с адреса, выровненного на COLUMN_ALIGN.
+     */
+    template<typename... Ts>
+    class storage {
+        static_assert(sizeof...(Ts) > 0, "At least one column is required");
+        static_assert(max_align<Ts...>::value <= COLUMN_ALIGN, "Column type alignment exceeds COLUMN_ALIGN");
+
+    public:
+        /**
+         * Количество столбцов.
+         */
+        static const std::size_t COLUMNS = sizeof...(Ts);
+
+        /**
+         * Тип элементов столбца I.
+         */
+        template<std::size_t I>
+        using column_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+        typedef row<false, Ts...> reference;
+        typedef row<true, Ts...> const_reference;
+        typedef row_iterator<false, Ts...> iterator;
+        typedef row_iterator<true, Ts...> const_iterator;
+
+        /**
+         * Минимальный размер буфера для хранения строкового представления объекта.
+         */
+        static const int32_t TO_STRING_MIN_BUFFER_SIZE = 80;
+
+    protected:
+        typedef std::tuple<Ts*...> columns_t;
+        typedef typename make_index_seq<sizeof...(Ts)>::type indices;
+
+        /**
+         * Указатель на пользовательский аллокатор памяти.
+         */
+        tca::allocator* m_allocator;
+
+        /**
+         * Блок памяти со всеми столбцами.
+         */
+        void* m_block;
+
+        /**
+         * Указатели на начала столбцов внутри m_block.
+         */
+        columns_t m_columns;
+
+        /**
+         * Количество строк.
+         */
+        std::size_t m_size;
+
+        /**
+         * Количество строк, для которых выделена память.
+         */
+        std::size_t m_capacity;
+
+        storage(tca::allocator* allocator) :
+        m_allocator(allocator),
+        m_block(nullptr),
+        m_columns(),
+        m_size(0),
+        m_capacity(0) {
+
+        }
+
+        ~storage() {
+            release();
+        }
+
+        /**
+         * Вычисляет смещения столбцов для вместимости capacity и возвращает размер блока.
+         *
+         * @throws out_of_memory_error
+         *      Если размер блока не помещается в size_t.
+         */
+        static std::size_t layout(std::size_t capacity, std::size_t offsets[]);
+
+        template<std::size_t... I>
+        static columns_t make_columns(char* base, const std::size_t offsets[], index_seq<I...>) {
+            return columns_t(reinterpret_cast<Ts*>(base + offsets[I])...);
+        }
+
+        /**
+         * Переносит строки в новый блок на new_capacity строк. new_capacity >= m_size.
+         *
+         * @throws out_of_memory_error
+         *      Eсли не удалось выделить память.
+         */
+        void reallocate(std::size_t new_capacity);
+
+        /**
+         * Разрушает все строки и освобождает блок.
+         */
+        void release();
+
+        /**
+         * Копирует строки other в пустое хранилище.
+         */
+        void copy_from(const storage<Ts...>& other);
+
+        /**
+         * Забирает блок other. Текущее хранилище должно быть пустым и без памяти.
+         */
+        void steal(storage<Ts...>& other);
+
+        template<std::size_t... I, typename... Args>
+        void construct_row(std::size_t idx, index_seq<I...>, Args&&... values) {
+            int unused[] = {0, (new (std::get<I>(m_columns) + idx) Ts(std::forward<Args>(values)), 0)...};
+            (void) unused;
+        }
+
+    public:
+        /**
+         * Количество строк.
+         */
+        std::size_t size() const {
+            return m_size;
+        }
+
+        /**
+         *
+         */
+        bool is_empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * Возвращает столбец I в виде span. Начало столбца выровнено на COLUMN_ALIGN.
+         */
+        template<std::size_t I>
+        span<column_type<I>> column() {
+            return span<column_type<I>>(std::get<I>(m_columns), m_size);
+        }
+
+        /**
+         * Возвращает столбец I в виде span. (Константная версия)
+         */
+        template<std::size_t I>
+        span<const column_type<I>> column() const {
+            return span<const column_type<I>>(std::get<I>(m_columns), m_size);
+        }
+
+        /**
+         * Возвращает ссылку на поле I строки idx.
+         */
+        template<std::size_t I>
+        column_type<I>& get(std::size_t idx) {
+            check_index(idx, m_size);
+            return std::get<I>(m_columns)[idx];
+        }
+
+        /**
+         * Возвращает ссылку на поле I строки idx. (Константная версия)
+         */
+        template<std::size_t I>
+        const column_type<I>& get(std::size_t idx) const {
+            check_index(idx, m_size);
+            return std::get<I>(m_columns)[idx];
+        }
+
+        /**
+         * Возвращает прокси-ссылку на строку idx.
+         */
+        reference at(std::size_t idx) {
+            check_index(idx, m_size);
+            return reference(&m_columns, idx);
+        }
+
+        /**
+         * Возвращает прокси-ссылку на строку idx. (Константная версия)
+         */
+        const_reference at(std::size_t idx) const {
+            check_index(idx, m_size);
+            return const_reference(&m_columns, idx);
+        }
+
+        reference operator[](std::size_t idx) {
+            return at(idx);
+        }
+
+        const_reference operator[](std::size_t idx) const {
+            return at(idx);
+        }
+
+        /**
+         * Записывает строковое представление в буфер.
+         */
+        int to_string(char buf[], std::size_t bufsize) const {
+            return std::snprintf(buf, bufsize, "[data=0x%llx, columns=%lli, capacity=%lli, size=%lli]", (long long) m_block, (long long) COLUMNS, (long long) m_capacity, (long long) m_size);
+        }
+
+        iterator begin() {
+            return iterator(&m_columns, 0);
+        }
+
+        iterator end() {
+            return iterator(&m_columns, m_size);
+        }
+
+        const_iterator begin() const {
+            return const_iterator(&m_columns, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(&m_columns, m_size);
+        }
+    };
+
+    template<typename... Ts>
+    std::size_t storage<Ts...>::layout(std::size_t capacity, std::size_t offsets[]) {
+        const std::size_t sizes[] = { sizeof(Ts)... };
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < COLUMNS; ++i) {
+            if (capacity > (~((std::size_t) 0) - total - COLUMN_ALIGN) / sizes[i])
+                throw_except<out_of_memory_error>("Out of memory!");
+            offsets[i] = total;
+            total = align_up(total + sizes[i] * capacity);
+        }
+        return total;
+    }
+
+    template<typename... Ts>
+    void storage<Ts...>::reallocate(std::size_t new_capacity) {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator is null");
+        )
+
+        std::size_t offsets[COLUMNS];
+        std::size_t bytes = layout(new_capacity, offsets);
+        void* block = m_allocator->allocate_align(bytes, COLUMN_ALIGN);
+        if (block == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+
+        columns_t columns = make_columns(static_cast<char*>(block), offsets, indices());
+        if (m_block != nullptr) {
+            relocate_op op = { m_size };
+            for_each_column(columns, m_columns, op, indices());
+            m_allocator->deallocate(m_block);
+        }
+        m_block     = block;
+        m_columns   = columns;
+        m_capacity  = new_capacity;
+    }
+
+    template<typename... Ts>
+    void storage<Ts...>::release() {
+        if (m_block != nullptr) {
+            destroy_op op = { 0, m_size };
+            for_each_column(m_columns, op, indices());
+            m_allocator->deallocate(m_block);
+        }
+        m_block     = nullptr;
+        m_columns   = columns_t();
+        m_size      = 0;
+        m_capacity  = 0;
+    }
+
+    template<typename... Ts>
+    void storage<Ts...>::copy_from(const storage<Ts...>& other) {
+        if (other.m_size == 0)
+            return;
+        reallocate(other.m_size);
+        copy_op op = { other.m_size };
+        for_each_column(m_columns, const_cast<columns_t&>(other.m_columns), op, indices());
+        m_size = other.m_size;
+    }
+
+    template<typename... Ts>
+    void storage<Ts...>::steal(storage<Ts...>& other) {
+        m_block     = other.m_block;
+        m_columns   = other.m_columns;
+        m_size      = other.m_size;
+        m_capacity  = other.m_capacity;
+        other.m_block       = nullptr;
+        other.m_columns     = columns_t();
+        other.m_size        = 0;
+        other.m_capacity    = 0;
+    }
+}
+}
+
+/**
+ * Массив фиксированной длины в раскладке "структура массивов" (SoA).
+ *
+ * Каждое поле строки хранится в собственном столбце, все столбцы лежат в одном блоке памяти аллокатора,
+ * начало каждого столбца выровнено на 64 байта. Столбцы доступны через column<I>() в виде span
+ * для векторных циклов, строки - через прокси-ссылку at(idx)/operator[] и итераторы.
+ *
+ * @tparam Ts
+ *      Типы полей строки.
+ */
+template<typename... Ts>
+class soa_array : public internal::soa::storage<Ts...> {
+    typedef internal::soa::storage<Ts...> base;
+
+public:
+    /**
+     * Создаёт пустой массив.
+     */
+    soa_array(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт массив из length строк, поля которых созданы конструкторами по умолчанию.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    explicit soa_array(std::size_t length, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    soa_array(const soa_array<Ts...>& array);
+
+    /**
+     *
+     */
+    soa_array(soa_array<Ts...>&& array);
+
+    /**
+     *
+     */
+    soa_array<Ts...>& operator=(const soa_array<Ts...>& array);
+
+    /**
+     *
+     */
+    soa_array<Ts...>& operator=(soa_array<Ts...>&& array);
+
+    /**
+     * Создаёт копию массива.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего массива.
+     */
+    soa_array<Ts...> clone(tca::allocator* allocator = nullptr) const;
+};
+
+/**
+ * Динамический список в раскладке "структура массивов" (SoA).
+ *
+ * Раскладка та же, что у soa_array. При росте все столбцы переносятся в новый блок одним выделением памяти,
+ * вместимость растёт с коэффициентом 1.5x.
+ *
+ * @tparam Ts
+ *      Типы полей строки.
+ */
+template<typename... Ts>
+class soa_list : public internal::soa::storage<Ts...> {
+    typedef internal::soa::storage<Ts...> base;
+
+    /**
+     * Начальная вместимость при первом добавлении.
+     */
+    static const std::size_t DEFAULT_CAPACITY = 16;
+
+    /**
+     * Увеличивает вместимость с коэффициентом роста 1.5x.
+     */
+    void grow();
+
+public:
+    /**
+     * Создаёт пустой список.
+     */
+    soa_list(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     * Создаёт пустой список с заданной начальной вместимостью.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    explicit soa_list(std::size_t init_capacity, tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    soa_list(const soa_list<Ts...>& list);
+
+    /**
+     *
+     */
+    soa_list(soa_list<Ts...>&& list);
+
+    /**
+     *
+     */
+    soa_list<Ts...>& operator=(const soa_list<Ts...>& list);
+
+    /**
+     *
+     */
+    soa_list<Ts...>& operator=(soa_list<Ts...>&& list);
+
+    /**
+     * @see soa_array::clone
+     */
+    soa_list<Ts...> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Добавляет строку в конец списка. Принимает по одному значению на столбец.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    template<typename... Args>
+    void add(Args&&... values);
+
+    /**
+     * Удаляет строку idx со сдвигом последующих строк.
+     */
+    bool remove_at(std::size_t idx);
+
+    /**
+     * Удаляет строку idx, перенося на её место последнюю строку. Порядок строк не сохраняется.
+     */
+    bool fast_remove_at(std::size_t idx);
+
+    /**
+     * Изменяет количество строк. Новые строки создаются конструкторами по умолчанию.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    void resize(std::size_t new_size);
+
+    /**
+     * Гарантирует, что список может вместить не менее {@code new_capacity} строк без перераспределения.
+     * Вместимость никогда не уменьшается.
+     *
+     * @throws out_of_memory_error
+     *      Eсли не удалось выделить память.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * Удаляет все строки, но не освобождает память.
+     */
+    void clear();
+
+    /**
+     * Количество строк, которое список вмещает без перераспределения.
+     */
+    std::size_t capacity() const {
+        return this->m_capacity;
+    }
+};
+
+    template<typename... Ts>
+    soa_array<Ts...>::soa_array(tca::allocator* allocator) : base(allocator) {
+
+    }
+
+    template<typename... Ts>
+    soa_array<Ts...>::soa_array(std::size_t length, tca::allocator* allocator) : base(allocator) {
+        if (length > 0) {
+            this->reallocate(length);
+            internal::soa::construct_op op = { 0, length };
+            internal::soa::for_each_column(this->m_columns, op, typename base::indices());
+            this->m_size = length;
+        }
+    }
+
+    template<typename... Ts>
+    soa_array<Ts...>::soa_array(const soa_array<Ts...>& array) : base(array.m_allocator) {
+        this->copy_from(array);
+    }
+
+    template<typename... Ts>
+    soa_array<Ts...>::soa_array(soa_array<Ts...>&& array) : base(array.m_allocator) {
+        this->steal(array);
+    }
+
+    template<typename... Ts>
+    soa_array<Ts...>& soa_array<Ts...>::operator=(const soa_array<Ts...>& array) {
+        if (&array != this) {
+            soa_array<Ts...> tmp = array.clone(this->m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename... Ts>
+    soa_array<Ts...>& soa_array<Ts...>::operator=(soa_array<Ts...>&& array) {
+        if (&array != this) {
+            this->release();
+            this->m_allocator = array.m_allocator;
+            this->steal(array);
+        }
+        return *this;
+    }
+
+    template<typename... Ts>
+    soa_array<Ts...> soa_array<Ts...>::clone(tca::allocator* allocator) const {
+        soa_array<Ts...> copy(allocator != nullptr ? allocator : this->m_allocator);
+        copy.copy_from(*this);
+        return copy;
+    }
+
+    /**
+     * ==========================================================================================================================================
+     */
+    template<typename... Ts>
+    soa_list<Ts...>::soa_list(tca::allocator* allocator) : base(allocator) {
+
+    }
+
+    template<typename... Ts>
+    soa_list<Ts...>::soa_list(std::size_t init_capacity, tca::allocator* allocator) : base(allocator) {
+        reserve(init_capacity);
+    }
+
+    template<typename... Ts>
+    soa_list<Ts...>::soa_list(const soa_list<Ts...>& list) : base(list.m_allocator) {
+        this->copy_from(list);
+    }
+
+    template<typename... Ts>
+    soa_list<Ts...>::soa_list(soa_list<Ts...>&& list) : base(list.m_allocator) {
+        this->steal(list);
+    }
+
+    template<typename... Ts>
+    soa_list<Ts...>& soa_list<Ts...>::operator=(const soa_list<Ts...>& list) {
+        if (&list != this) {
+            soa_list<Ts...> tmp = list.clone(this->m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename... Ts>
+    soa_list<Ts...>& soa_list<Ts...>::operator=(soa_list<Ts...>&& list) {
+        if (&list != this) {
+            this->release();
+            this->m_allocator = list.m_allocator;
+            this->steal(list);
+        }
+        return *this;
+    }
+
+    template<typename... Ts>
+    soa_list<Ts...> soa_list<Ts...>::clone(tca::allocator* allocator) const {
+        soa_list<Ts...> copy(allocator != nullptr ? allocator : this->m_allocator);
+        copy.copy_from(*this);
+        return copy;
+    }
+
+    template<typename... Ts>
+    void soa_list<Ts...>::grow() {
+        const std::size_t cap   = this->m_capacity;
+        const std::size_t step  = cap >> 1;
+        this->reallocate(cap > 0 ? cap + (step > 0 ? step : 1) : DEFAULT_CAPACITY);
+    }
+
+    template<typename... Ts>
+    template<typename... Args>
+    void soa_list<Ts...>::add(Args&&... values) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "Expected one value per column");
+        if (this->m_size >= this->m_capacity)
+            grow();
+        this->construct_row(this->m_size, typename base::indices(), std::forward<Args>(values)...);
+        ++this->m_size;
+    }
+
+    template<typename... Ts>
+    bool soa_list<Ts...>::remove_at(std::size_t idx) {
+        check_index(idx, this->m_size);
+        internal::soa::erase_op op = { idx, this->m_size };
+        internal::soa::for_each_column(this->m_columns, op, typename base::indices());
+        --this->m_size;
+        return true;
+    }
+
+    template<typename... Ts>
+    bool soa_list<Ts...>::fast_remove_at(std::size_t idx) {
+        check_index(idx, this->m_size);
+        internal::soa::swap_remove_op op = { idx, this->m_size - 1 };
+        internal::soa::for_each_column(this->m_columns, op, typename base::indices());
+        --this->m_size;
+        return true;
+    }
+
+    template<typename... Ts>
+    void soa_list<Ts...>::resize(std::size_t new_size) {
+        if (new_size > this->m_size) {
+            reserve(new_size);
+            internal::soa::construct_op op = { this->m_size, new_size };
+            internal::soa::for_each_column(this->m_columns, op, typename base::indices());
+        } else {
+            internal::soa::destroy_op op = { new_size, this->m_size };
+            internal::soa::for_each_column(this->m_columns, op, typename base::indices());
+        }
+        this->m_size = new_size;
+    }
+
+    template<typename... Ts>
+    void soa_list<Ts...>::reserve(std::size_t new_capacity) {
+        if (new_capacity > this->m_capacity)
+            this->reallocate(new_capacity);
+    }
+
+    template<typename... Ts>
+    void soa_list<Ts...>::clear() {
+        internal::soa::destroy_op op = { 0, this->m_size };
+        internal::soa::for_each_column(this->m_columns, op, typename base::indices());
+        this->m_size = 0;
+    }
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_SOA_H
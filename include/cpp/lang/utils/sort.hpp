@@ -0,0 +1,643 @@
+#ifndef JSTD_CPP_LANG_UTILS_SORT_H
+#define JSTD_CPP_LANG_UTILS_SORT_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+#include <new>
+
+namespace jstd
+{
+
+namespace internal
+{
+    /**
+     * Отрезки короче этого сортируются вставками.
+     */
+    const std::size_t SORT_INSERTION_THRESHOLD = 24;
+
+    /**
+     * Для отрезков длиннее этого опорный элемент выбирается как медиана медиан (ninther).
+     */
+    const std::size_t SORT_NINTHER_THRESHOLD = 128;
+
+    /**
+     * Максимальное количество перемещений, после которого частичная сортировка вставками сдаётся.
+     */
+    const std::size_t SORT_PARTIAL_INSERTION_LIMIT = 8;
+
+    /**
+     * Отрезки короче этого сортируются вставками в сортировке слиянием.
+     */
+    const std::size_t SORT_MERGE_RUN = 32;
+
+    /**
+     * Обёртка над компаратором вида int(a, b), дающая строгое "меньше".
+     */
+    template<typename T, typename T_COMPARATOR>
+    struct sort_less {
+        T_COMPARATOR& compare;
+
+        bool operator()(const T& a, const T& b) const {
+            return compare(a, b) < 0;
+        }
+    };
+
+    template<typename T>
+    inline void sort_swap(T* a, T* b) {
+        T tmp = std::move(*a);
+        *a = std::move(*b);
+        *b = std::move(tmp);
+    }
+
+    template<typename T, typename LESS>
+    inline void sort2(T* a, T* b, LESS& less) {
+        if (less(*b, *a))
+            sort_swap(a, b);
+    }
+
+    template<typename T, typename LESS>
+    inline void sort3(T* a, T* b, T* c, LESS& less) {
+        sort2(a, b, less);
+        sort2(b, c, less);
+        sort2(a, b, less);
+    }
+
+    /**
+     * Устойчивая сортировка вставками отрезка [begin, end).
+     * Если компаратор бросает исключение, вставляемый элемент возвращается в освободившуюся ячейку.
+     */
+    template<typename T, typename LESS>
+    void insertion_sort(T* begin, T* end, LESS& less) {
+        if (begin == end)
+            return;
+        for (T* cur = begin + 1; cur != end; ++cur) {
+            T* sift   = cur;
+            T* sift_1 = cur - 1;
+            if (less(*sift, *sift_1)) {
+                T tmp = std::move(*sift);
+                try {
+                    do {
+                        *sift-- = std::move(*sift_1);
+                    } while (sift != begin && less(tmp, *--sift_1));
+                } catch (...) {
+                    *sift = std::move(tmp);
+                    throw;
+                }
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    /**
+     * Сортировка вставками без проверки левой границы: элемент перед begin не больше любого элемента отрезка.
+     */
+    template<typename T, typename LESS>
+    void unguarded_insertion_sort(T* begin, T* end, LESS& less) {
+        if (begin == end)
+            return;
+        for (T* cur = begin + 1; cur != end; ++cur) {
+            T* sift   = cur;
+            T* sift_1 = cur - 1;
+            if (less(*sift, *sift_1)) {
+                T tmp = std::move(*sift);
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (less(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    /**
+     * Сортировка вставками, которая прекращается после SORT_PARTIAL_INSERTION_LIMIT перемещений.
+     *
+     * @return
+     *      true - если отрезок полностью отсортирован.
+     */
+    template<typename T, typename LESS>
+    bool partial_insertion_sort(T* begin, T* end, LESS& less) {
+        if (begin == end)
+            return true;
+        std::size_t limit = 0;
+        for (T* cur = begin + 1; cur != end; ++cur) {
+            T* sift   = cur;
+            T* sift_1 = cur - 1;
+            if (less(*sift, *sift_1)) {
+                T tmp = std::move(*sift);
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != begin && less(tmp, *--sift_1));
+                *sift = std::move(tmp);
+                limit += cur - sift;
+            }
+            if (limit > SORT_PARTIAL_INSERTION_LIMIT)
+                return false;
+        }
+        return true;
+    }
+
+    template<typename T, typename LESS>
+    void sift_down(T* a, std::size_t n, std::size_t i, LESS& less) {
+        T tmp = std::move(a[i]);
+        for (;;) {
+            std::size_t child = 2 * i + 1;
+            if (child >= n)
+                break;
+            if (child + 1 < n && less(a[child], a[child + 1]))
+                ++child;
+            if (!less(tmp, a[child]))
+                break;
+            a[i] = std::move(a[child]);
+            i = child;
+        }
+        a[i] = std::move(tmp);
+    }
+
+    template<typename T, typename LESS>
+    void heap_sort(T* a, std::size_t n, LESS& less) {
+        if (n < 2)
+            return;
+        for (std::size_t i = n / 2; i > 0; --i)
+            sift_down(a, n, i - 1, less);
+        for (std::size_t i = n - 1; i > 0; --i) {
+            sort_swap(a, a + i);
+            sift_down(a, i, 0, less);
+        }
+    }
+
+    /**
+     * Разбиение относительно опорного элемента *begin. Элементы, равные опорному, уходят вправо.
+     *
+     * @param already_partitioned
+     *      Устанавливается в true, если перестановки не потребовались.
+     *
+     * @return
+     *      Итоговая позиция опорного элемента.
+     */
+    template<typename T, typename LESS>
+    T* partition_right(T* begin, T* end, LESS& less, bool& already_partitioned) {
+        T pivot(std::move(*begin));
+        T* first = begin;
+        T* last  = end;
+
+        //медиана трёх гарантирует наличие элемента >= pivot справа, поэтому поиск слева без проверки границы
+        while (less(*++first, pivot));
+
+        if (first - 1 == begin)
+            while (first < last && !less(*--last, pivot));
+        else
+            while (!less(*--last, pivot));
+
+        already_partitioned = first >= last;
+
+        while (first < last) {
+            sort_swap(first, last);
+            while (less(*++first, pivot));
+            while (!less(*--last, pivot));
+        }
+
+        T* pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return pivot_pos;
+    }
+
+    /**
+     * Разбиение, при котором элементы, равные опорному, уходят влево.
+     * Используется, когда элемент перед begin равен опорному: равные элементы сразу оказываются на своих местах.
+     */
+    template<typename T, typename LESS>
+    T* partition_left(T* begin, T* end, LESS& less) {
+        T pivot(std::move(*begin));
+        T* first = begin;
+        T* last  = end;
+
+        while (less(pivot, *--last));
+
+        if (last + 1 == end)
+            while (first < last && !less(pivot, *++first));
+        else
+            while (!less(pivot, *++first));
+
+        while (first < last) {
+            sort_swap(first, last);
+            while (less(pivot, *--last));
+            while (!less(pivot, *++first));
+        }
+
+        T* pivot_pos = last;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return pivot_pos;
+    }
+
+    /**
+     * Основной цикл pattern-defeating quicksort.
+     *
+     * @param bad_allowed
+     *      Количество допустимых сильно несбалансированных разбиений, после которого отрезок сортируется пирамидой.
+     *
+     * @param leftmost
+     *      true - если отрезок является самым левым (слева нет элемента-ограничителя).
+     */
+    template<typename T, typename LESS>
+    void pdq_sort_loop(T* begin, T* end, LESS& less, int bad_allowed, bool leftmost) {
+        for (;;) {
+            const std::size_t size = end - begin;
+
+            if (size < SORT_INSERTION_THRESHOLD) {
+                if (leftmost)
+                    insertion_sort(begin, end, less);
+                else
+                    unguarded_insertion_sort(begin, end, less);
+                return;
+            }
+
+            const std::size_t s2 = size / 2;
+            if (size > SORT_NINTHER_THRESHOLD) {
+                sort3(begin, begin + s2, end - 1, less);
+                sort3(begin + 1, begin + (s2 - 1), end - 2, less);
+                sort3(begin + 2, begin + (s2 + 1), end - 3, less);
+                sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), less);
+                sort_swap(begin, begin + s2);
+            } else {
+                sort3(begin + s2, begin, end - 1, less);
+            }
+
+            //опорный элемент равен ограничителю слева: все равные ему элементы уже на месте
+            if (!leftmost && !less(*(begin - 1), *begin)) {
+                begin = partition_left(begin, end, less) + 1;
+                continue;
+            }
+
+            bool already_partitioned = false;
+            T* pivot_pos = partition_right(begin, end, less, already_partitioned);
+
+            const std::size_t l_size = pivot_pos - begin;
+            const std::size_t r_size = end - (pivot_pos + 1);
+            const bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+            if (highly_unbalanced) {
+                if (--bad_allowed == 0) {
+                    heap_sort(begin, size, less);
+                    return;
+                }
+
+                //перемешивание разрушает шаблоны, приводящие к плохим разбиениям
+                if (l_size >= SORT_INSERTION_THRESHOLD) {
+                    sort_swap(begin, begin + l_size / 4);
+                    sort_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if (l_size > SORT_NINTHER_THRESHOLD) {
+                        sort_swap(begin + 1, begin + (l_size / 4 + 1));
+                        sort_swap(begin + 2, begin + (l_size / 4 + 2));
+                        sort_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        sort_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if (r_size >= SORT_INSERTION_THRESHOLD) {
+                    sort_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    sort_swap(end - 1, end - r_size / 4);
+                    if (r_size > SORT_NINTHER_THRESHOLD) {
+                        sort_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        sort_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        sort_swap(end - 2, end - (1 + r_size / 4));
+                        sort_swap(end - 3, end - (2 + r_size / 4));
+                    }
+                }
+            } else if (already_partitioned
+                        && partial_insertion_sort(begin, pivot_pos, less)
+                        && partial_insertion_sort(pivot_pos + 1, end, less)) {
+                return;
+            }
+
+            //левая часть рекурсивно, правая - в цикле
+            pdq_sort_loop(begin, pivot_pos, less, bad_allowed, leftmost);
+            begin    = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+
+    template<typename T, typename LESS>
+    void pdq_sort(T* array, std::size_t len, LESS& less) {
+        if (len < 2)
+            return;
+        int log2 = 0;
+        for (std::size_t n = len; n > 1; n >>= 1)
+            ++log2;
+        pdq_sort_loop(array, array + len, less, log2, true);
+    }
+
+    /**
+     * Разрушает объекты, созданные в начале неинициализированного буфера, в том числе при выходе по исключению.
+     */
+    template<typename T>
+    class scratch_guard {
+        scratch_guard(const scratch_guard&)             = delete;
+        scratch_guard& operator= (const scratch_guard&) = delete;
+
+        T*          m_buf;
+        std::size_t m_constructed;
+    public:
+        scratch_guard(T* buf) : m_buf(buf), m_constructed(0) {}
+
+        void push(T&& value) {
+            new (m_buf + m_constructed) T(std::move(value));
+            ++m_constructed;
+        }
+
+        std::size_t size() const {
+            return m_constructed;
+        }
+
+        ~scratch_guard() {
+            for (std::size_t i = 0; i < m_constructed; ++i)
+                m_buf[i].~T();
+        }
+    };
+
+    /**
+     * Сортировка слиянием сверху вниз. buf - неинициализированная память не менее чем на len / 2 элементов.
+     *
+     * Если компаратор или перемещение бросает исключение, не слитые элементы левой половины возвращаются
+     * из буфера в массив: массив остаётся перестановкой исходных элементов, объекты буфера разрушаются.
+     */
+    template<typename T, typename LESS>
+    void merge_sort(T* a, std::size_t len, T* buf, LESS& less) {
+        if (len <= SORT_MERGE_RUN) {
+            insertion_sort(a, a + len, less);
+            return;
+        }
+        const std::size_t mid = len / 2;
+        merge_sort(a, mid, buf, less);
+        merge_sort(a + mid, len - mid, buf, less);
+
+        if (!less(a[mid], a[mid - 1]))
+            return;
+
+        scratch_guard<T> left(buf);
+        std::size_t i = 0;
+        std::size_t j = mid;
+        std::size_t k = 0;
+        try {
+            while (left.size() < mid)
+                left.push(std::move(a[left.size()]));
+
+            while (i < mid && j < len) {
+                if (less(a[j], buf[i]))
+                    a[k++] = std::move(a[j++]);
+                else
+                    a[k++] = std::move(buf[i++]);
+            }
+            while (i < mid)
+                a[k++] = std::move(buf[i++]);
+        } catch (...) {
+            //ячейки a[k, k + (left.size() - i)) освобождены перемещением и ждут элементов buf[i, left.size())
+            for (std::size_t t = i; t < left.size(); ++t)
+                a[k++] = std::move(buf[t]);
+            throw;
+        }
+    }
+
+    /**
+     * Преобразование арифметического ключа в беззнаковое число с тем же порядком.
+     */
+    template<typename K, bool FLOATING = std::is_floating_point<K>::value>
+    struct radix_key {
+        typedef typename std::make_unsigned<K>::type type;
+
+        static type encode(K key) {
+            //у знаковых типов инвертируется знаковый бит
+            const type sign = std::is_signed<K>::value ? (type) ((type) 1 << (sizeof(K) * 8 - 1)) : (type) 0;
+            return ((type) key) ^ sign;
+        }
+    };
+
+    /**
+     * bool: std::make_unsigned для него не определён.
+     */
+    template<>
+    struct radix_key<bool, false> {
+        typedef std::uint8_t type;
+
+        static type encode(bool key) {
+            return key ? 1 : 0;
+        }
+    };
+
+    template<typename K>
+    struct radix_key<K, true> {
+        typedef typename std::conditional<sizeof(K) == 4, std::uint32_t, std::uint64_t>::type type;
+
+        static type encode(K key) {
+            static_assert(sizeof(K) == sizeof(type), "Unsupported floating point type");
+            type bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            const type sign = (type) 1 << (sizeof(type) * 8 - 1);
+            //отрицательные числа - инвертируются все биты, положительные - только знаковый
+            return (bits & sign) ? ~bits : (bits | sign);
+        }
+    };
+
+    /**
+     * Ключом является сам элемент.
+     */
+    template<typename T>
+    struct radix_identity {
+        const T& operator()(const T& value) const {
+            return value;
+        }
+    };
+}
+
+namespace utils
+{
+
+    /**
+     * Неустойчивая сортировка массива (pattern-defeating quicksort).
+     *
+     * Короткие отрезки сортируются вставками, опорный элемент выбирается медианой трёх или девяти элементов.
+     * При серии плохих разбиений отрезок досортировывается пирамидальной сортировкой, поэтому время работы
+     * в худшем случае O(n log n), а глубина рекурсии - O(log n).
+     * Уже отсортированные и почти отсортированные массивы обрабатываются за O(n).
+     *
+     * @tparam T
+     *      Тип элементов массива.
+     *
+     * @tparam T_COMPARATOR
+     *      Тип компаратора, возвращающего int (<0, 0, >0). По умолчанию — compare_to<T>.
+     *
+     * @param array
+     *      Указатель на массив, который нужно отсортировать.
+     *
+     * @param len
+     *      Количество элементов в массиве.
+     *
+     * @throws null_pointer_exception
+     *      Eсли array == nullptr
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    void sort(T* array, std::size_t len) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        T_COMPARATOR compare;
+        internal::sort_less<T, T_COMPARATOR> less = {compare};
+        internal::pdq_sort(array, len, less);
+    }
+
+    /**
+     * Пирамидальная сортировка. O(n log n) в худшем случае без дополнительной памяти.
+     *
+     * @see sort
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    void heap_sort(T* array, std::size_t len) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        T_COMPARATOR compare;
+        internal::sort_less<T, T_COMPARATOR> less = {compare};
+        internal::heap_sort(array, len, less);
+    }
+
+    /**
+     * Устойчивая сортировка слиянием: равные элементы сохраняют исходный порядок.
+     *
+     * Временный буфер на len / 2 элементов выделяется переданным аллокатором и освобождается перед возвратом.
+     * Уже упорядоченные пары соседних отрезков не сливаются.
+     *
+     * @param allocator
+     *      Аллокатор для временного буфера.
+     *
+     * @throws out_of_memory_error
+     *      Если не удалось выделить буфер.
+     */
+    template<typename T, typename T_COMPARATOR = compare_to<T>>
+    void stable_sort(T* array, std::size_t len, tca::allocator* allocator = tca::get_default_allocator()) {
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        T_COMPARATOR compare;
+        internal::sort_less<T, T_COMPARATOR> less = {compare};
+        if (len <= internal::SORT_MERGE_RUN) {
+            internal::insertion_sort(array, array + len, less);
+            return;
+        }
+        const std::size_t buf_size = sizeof(T) * (len / 2);
+        T* buf = reinterpret_cast<T*>(allocator->allocate_align(buf_size, alignof(T)));
+        if (buf == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        try {
+            internal::merge_sort(array, len, buf, less);
+        } catch (...) {
+            allocator->deallocate(buf, buf_size);
+            throw;
+        }
+        allocator->deallocate(buf, buf_size);
+    }
+
+    /**
+     * Устойчивая поразрядная сортировка (LSD, разряд - 1 байт) по арифметическому ключу.
+     *
+     * Ключ элемента получается функтором {@code KEY_EXTRACTOR} и может быть целым числом или числом
+     * с плавающей запятой (float, double). Отрицательные числа упорядочиваются корректно.
+     * Проходы, в которых все ключи имеют одинаковый байт, пропускаются.
+     * Время работы O(n * sizeof(key)), буфер на len элементов выделяется переданным аллокатором.
+     *
+     * @tparam KEY_EXTRACTOR
+     *      Функтор {@code KEY operator()(const T&) const}.
+     *
+     * @throws out_of_memory_error
+     *      Если не удалось выделить буфер.
+     */
+    template<typename T, typename KEY_EXTRACTOR>
+    void radix_sort_by(T* array, std::size_t len, KEY_EXTRACTOR key_of = KEY_EXTRACTOR(), tca::allocator* allocator = tca::get_default_allocator()) {
+        typedef typename std::decay<decltype(key_of(*array))>::type key_type;
+        static_assert(std::is_arithmetic<key_type>::value, "Radix sort key must be integral or floating point");
+        typedef internal::radix_key<key_type> radix;
+        typedef typename radix::type code_type;
+        const std::size_t PASSES = sizeof(code_type);
+
+        JSTD_DEBUG_CODE(
+            if (array == nullptr && len != 0)
+                throw_except<null_pointer_exception>("array must be != null");
+        )
+        if (len < 2)
+            return;
+
+        std::size_t counts[PASSES][256];
+        std::memset(counts, 0, sizeof(counts));
+        for (std::size_t i = 0; i < len; ++i) {
+            code_type code = radix::encode(key_of(array[i]));
+            for (std::size_t p = 0; p < PASSES; ++p)
+                ++counts[p][(code >> (p * 8)) & 0xFF];
+        }
+
+        const std::size_t buf_size = sizeof(T) * len;
+        T* buf = reinterpret_cast<T*>(allocator->allocate_align(buf_size, alignof(T)));
+        if (buf == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+
+        //на каждом проходе элементы перемещаются в неинициализированный массив, источник разрушается
+        T* src = array;
+        T* dst = buf;
+        for (std::size_t p = 0; p < PASSES; ++p) {
+            std::size_t* count = counts[p];
+            bool trivial = false;
+            for (std::size_t b = 0; b < 256; ++b) {
+                if (count[b] == len) {
+                    trivial = true;
+                    break;
+                }
+            }
+            if (trivial)
+                continue;
+
+            std::size_t offset = 0;
+            for (std::size_t b = 0; b < 256; ++b) {
+                const std::size_t c = count[b];
+                count[b] = offset;
+                offset  += c;
+            }
+            for (std::size_t i = 0; i < len; ++i) {
+                const std::size_t b = (radix::encode(key_of(src[i])) >> (p * 8)) & 0xFF;
+                new (dst + count[b]++) T(std::move(src[i]));
+                src[i].~T();
+            }
+            T* tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+
+        if (src != array) {
+            for (std::size_t i = 0; i < len; ++i) {
+                new (array + i) T(std::move(src[i]));
+                src[i].~T();
+            }
+        }
+        allocator->deallocate(buf, buf_size);
+    }
+
+    /**
+     * Поразрядная сортировка массива целых чисел или чисел с плавающей запятой.
+     *
+     * @see radix_sort_by
+     */
+    template<typename T>
+    void radix_sort(T* array, std::size_t len, tca::allocator* allocator = tca::get_default_allocator()) {
+        radix_sort_by<T, internal::radix_identity<T>>(array, len, internal::radix_identity<T>(), allocator);
+    }
+}
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_SORT_H
@@ -0,0 +1,107 @@
+#ifndef JSTD_CPP_LANG_UTILS_SPAN_H
+#define JSTD_CPP_LANG_UTILS_SPAN_H
+
+#include <cpp/lang/exceptions.hpp>
+#include <cstddef>
+#include <type_traits>
+
+namespace jstd
+{
+
+/**
+ * Невладеющее представление непрерывного участка памяти из size элементов.
+ *
+ * Не выделяет и не освобождает память, не вызывает конструкторы и деструкторы.
+ * Копирование span копирует только указатель и размер.
+ *
+ * @tparam T
+ *      Тип элементов. Для представления только для чтения используется const T.
+ */
+template<typename T>
+class span {
+    /**
+     * Указатель на первый элемент.
+     */
+    T* m_data;
+
+    /**
+     * Количество элементов.
+     */
+    std::size_t m_size;
+
+public:
+    /**
+     * Создаёт пустое представление.
+     */
+    span() : m_data(nullptr), m_size(0) {
+
+    }
+
+    /**
+     * Создаёт представление size элементов, начиная с data.
+     */
+    span(T* data, std::size_t size) : m_data(data), m_size(size) {
+
+    }
+
+    /**
+     * Преобразование span<U> в span<T>, например span<int> в span<const int>.
+     */
+    template<typename U, typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+    span(const span<U>& s) : m_data(s.data()), m_size(s.size()) {
+
+    }
+
+    /**
+     * Возвращает указатель на первый элемент.
+     */
+    T* data() const {
+        return m_data;
+    }
+
+    /**
+     * Возвращает количество элементов.
+     */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     * Возвращает ссылку на элемент по индексу. Индекс проверяется только в отладочной сборке.
+     */
+    T& operator[](std::size_t idx) const {
+        check_index(idx, m_size);
+        return m_data[idx];
+    }
+
+    /**
+     * Возвращает представление count элементов, начиная с offset.
+     *
+     * @throws index_out_of_bound_exception
+     *      Если диапазон выходит за границы представления.
+     */
+    span<T> subspan(std::size_t offset, std::size_t count) const {
+        if (offset > m_size || count > m_size - offset)
+            throw_except<index_out_of_bound_exception>("Range [%zu, %zu) out of bound for length %zu!", offset, offset + count, m_size);
+        return span<T>(m_data + offset, count);
+    }
+
+    T* begin() const {
+        return m_data;
+    }
+
+    T* end() const {
+        return m_data + m_size;
+    }
+};
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_SPAN_H
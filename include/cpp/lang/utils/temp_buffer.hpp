@@ -0,0 +1,145 @@
+#ifndef JSTD_CPP_LANG_UTILS_TEMP_BUFFER_H
+#define JSTD_CPP_LANG_UTILS_TEMP_BUFFER_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cstddef>
+#include <new>
+
+namespace jstd
+{
+
+/**
+ * Временный массив для промежуточных результатов.
+ * Разрушает первые constructed элементов и освобождает память в деструкторе,
+ * в том числе при выходе по исключению.
+ *
+ * @tparam T
+ *      Тип элементов.
+ */
+template<typename T>
+class temp_buffer {
+    temp_buffer(const temp_buffer&)             = delete;
+    temp_buffer& operator= (const temp_buffer&) = delete;
+
+    tca::allocator* m_allocator;
+    T*              m_data;
+    std::size_t     m_length;
+    std::size_t     m_constructed;
+public:
+    /**
+     * @throws out_of_memory_error
+     *      Если не удалось выделить память.
+     */
+    temp_buffer(tca::allocator* allocator, std::size_t length) : m_allocator(allocator), m_data(nullptr), m_length(length), m_constructed(0) {
+        m_data = reinterpret_cast<T*>(m_allocator->allocate_align(sizeof(T) * m_length, alignof(T)));
+        if (m_data == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+    }
+
+    /**
+     * Заполняет массив копиями value.
+     */
+    void fill(const T& value) {
+        for (; m_constructed < m_length; ++m_constructed)
+            new (m_data + m_constructed) T(value);
+    }
+
+    /**
+     * Сообщает, что первые constructed элементов созданы и должны быть разрушены в деструкторе.
+     */
+    void set_constructed(std::size_t constructed) {
+        m_constructed = constructed;
+    }
+
+    T* data() {
+        return m_data;
+    }
+
+    ~temp_buffer() {
+        for (std::size_t i = 0; i < m_constructed; ++i)
+            m_data[i].~T();
+        m_allocator->deallocate(m_data, sizeof(T) * m_length);
+    }
+};
+
+/**
+ * Разбиение диапазона [0, len) на порции для пакетных операций.
+ *
+ * Исполнитель (runner) - объект с методами:
+ *      std::size_t count_threads() const          - количество потоков, разбирающих порции;
+ *      void run(std::size_t count, BODY& body) const - вызывает body(idx) для каждого idx из [0, count).
+ *
+ * sequential_runner выполняет всё в вызывающем потоке, parallel::pool_runner - в потоках пула.
+ */
+namespace chunking
+{
+
+    /**
+     * Минимальный размер порции при автоматическом выборе.
+     */
+    const std::size_t MIN_GRAIN = 1024;
+
+    /**
+     * Количество порций на поток при автоматическом выборе: сглаживает неравномерную нагрузку.
+     */
+    const std::size_t CHUNKS_PER_THREAD = 4;
+
+    /**
+     * Возвращает grain, если он задан, иначе размер порции, дающий CHUNKS_PER_THREAD порций на поток.
+     */
+    inline std::size_t select_grain(std::size_t threads, std::size_t len, std::size_t grain) {
+        if (grain != 0)
+            return grain;
+        grain = len / (threads * CHUNKS_PER_THREAD);
+        return grain < MIN_GRAIN ? MIN_GRAIN : grain;
+    }
+
+    inline std::size_t count_chunks(std::size_t len, std::size_t grain) {
+        return (len + grain - 1) / grain;
+    }
+
+    /**
+     * Вызывает body(begin, end, chunk_idx) для каждой порции [begin, end) диапазона [0, len).
+     */
+    template<typename RANGE_BODY>
+    class range_body {
+        RANGE_BODY& m_body;
+        std::size_t m_len;
+        std::size_t m_grain;
+    public:
+        range_body(RANGE_BODY& body, std::size_t len, std::size_t grain) : m_body(body), m_len(len), m_grain(grain) {}
+
+        void operator()(std::size_t idx) {
+            const std::size_t begin = idx * m_grain;
+            const std::size_t end   = m_len - begin < m_grain ? m_len : begin + m_grain;
+            m_body(begin, end, idx);
+        }
+    };
+
+    /**
+     * Исполнитель, разбирающий порции по порядку в вызывающем потоке.
+     */
+    struct sequential_runner {
+        std::size_t count_threads() const {
+            return 1;
+        }
+
+        template<typename BODY>
+        void run(std::size_t count, BODY& body) const {
+            for (std::size_t i = 0; i < count; ++i)
+                body(i);
+        }
+    };
+
+    template<typename RUNNER, typename RANGE_BODY>
+    void run_ranges(const RUNNER& runner, std::size_t len, std::size_t grain, RANGE_BODY& body) {
+        range_body<RANGE_BODY> chunk(body, len, grain);
+        runner.run(count_chunks(len, grain), chunk);
+    }
+
+}//namespace chunking
+
+}//namespace jstd
+
+#endif//JSTD_CPP_LANG_UTILS_TEMP_BUFFER_H
@@ -2,6 +2,7 @@
 #define JSTD_CPP_LANG_UTILS_TRAITS_H
 
 #include <utility>
+#include <type_traits>
 
 namespace jstd
 {
@@ -410,6 +411,47 @@ ___JSTD__MAKE_IS_UNSIGNED_SPECIALIZATION__(unsigned long long);
 
 #undef ___JSTD__MAKE_IS_UNSIGNED_SPECIALIZATION__
 
+/**
+ * Признак того, что объект типа T можно перенести в другое место памяти побайтовым копированием,
+ * не вызывая конструктор перемещения для нового объекта и деструктор для старого.
+ *
+ * Контейнеры используют его при росте и сдвиге элементов: диапазон таких объектов переносится одним memmove.
+ * По умолчанию признак истинен для тривиально копируемых типов. Другие типы включают его явной специализацией
+ * (см. JSTD_TRIVIALLY_RELOCATABLE), если объект не хранит указателей на самого себя или свои поля
+ * и его адрес нигде не зарегистрирован. Так устроены, например, tstring, shared_ptr, unique_ptr и array_list.
+ *
+ * @tparam T
+ *      Проверяемый тип.
+ */
+template<typename T>
+struct is_trivially_relocatable {
+    static const bool value = std::is_trivially_copyable<T>::value;
+};
+
+/**
+ *
+ */
+template<typename T>
+struct is_trivially_relocatable<const T> {
+    static const bool value = is_trivially_relocatable<T>::value;
+};
+
+/**
+ * Помечает нешаблонный тип как тривиально переносимый. Используется в глобальном пространстве имён.
+ *
+ * @code
+ *      struct connection { ... };
+ *      JSTD_TRIVIALLY_RELOCATABLE(connection)
+ * @endcode
+ */
+#define JSTD_TRIVIALLY_RELOCATABLE(type)                                \
+                    namespace jstd {                                    \
+                        template<>                                      \
+                        struct is_trivially_relocatable<type> {         \
+                            static const bool value = true;             \
+                        };                                              \
+                    }
+
 
     template<typename TARGET_T, typename SOURCE_T>
     static void assign_static_cast(TARGET_T& t, SOURCE_T&& s) {
@@ -0,0 +1,727 @@
+#ifndef JSTD_CPP_LANG_UTILS_TREE_MAP_H
+#define JSTD_CPP_LANG_UTILS_TREE_MAP_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/comparator.hpp>
+#include <cpp/lang/utils/raw_binary_tree.hpp>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+namespace jstd
+{
+
+/**
+ * Упорядоченная карта на основе AVL-дерева (raw_binary_tree).
+ *
+ * Ключи хранятся в порядке, определённом компаратором {@code COMPARATOR_T}.
+ * Узлы выделяются через аллокатор карты. Каждый узел хранит размер своего поддерева,
+ * поэтому помимо обычных операций за O(log n) доступны порядковые запросы:
+ * rank (позиция ключа) и select (ключ по позиции).
+ *
+ * @tparam TKEY
+ *      Тип ключа.
+ *
+ * @tparam TVALUE
+ *      Тип значения.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор ключей, возвращающий int (<0, 0, >0).
+ */
+template<typename TKEY, typename TVALUE, typename COMPARATOR_T = compare_to<TKEY>>
+class tree_map {
+public:
+    /**
+     * Узел дерева. Поля left, right, parent, key, height и size используются raw_binary_tree.
+     */
+    class entry {
+    public:
+        /**
+         *
+         */
+        entry* left;
+
+        /**
+         *
+         */
+        entry* right;
+
+        /**
+         * Родитель узла, nullptr у корня.
+         */
+        entry* parent;
+
+        /**
+         * Ключ неизменяем: его изменение нарушило бы порядок дерева.
+         */
+        const TKEY key;
+
+        /**
+         *
+         */
+        signed char height;
+
+        /**
+         * Количество узлов в поддереве, включая этот узел.
+         */
+        std::size_t size;
+
+        /**
+         *
+         */
+        TVALUE value;
+
+        /**
+         *
+         */
+        template<typename TKEY_, typename TVALUE_>
+        entry(TKEY_&& k, TVALUE_&& v);
+
+        /**
+         *
+         */
+        const TKEY& get_key() const {
+            return key;
+        }
+
+        /**
+         *
+         */
+        TVALUE& get_value() {
+            return value;
+        }
+
+        /**
+         *
+         */
+        const TVALUE& get_value() const {
+            return value;
+        }
+    };
+
+private:
+    /**
+     *
+     */
+    typedef raw_binary_tree<TKEY, COMPARATOR_T, entry> tree_type;
+
+    /**
+     *
+     */
+    tca::allocator* m_allocator;
+
+    /**
+     *
+     */
+    tree_type m_tree;
+
+    /**
+     *
+     */
+    template<typename TKEY_, typename TVALUE_>
+    entry* alloc_entry(TKEY_&& key, TVALUE_&& value);
+
+    /**
+     *
+     */
+    void free_entry(entry* e);
+
+    /**
+     * Освобождает поддерево.
+     */
+    void free_subtree(entry* e);
+
+    /**
+     *
+     */
+    static std::size_t subtree_size(const entry* e) {
+        return e ? e->size : 0;
+    }
+
+public:
+    /**
+     *
+     */
+    tree_map(tca::allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    tree_map(const tree_map<TKEY, TVALUE, COMPARATOR_T>& map);
+
+    /**
+     * Забирает записи map. map остаётся пустой картой с тем же аллокатором.
+     */
+    tree_map(tree_map<TKEY, TVALUE, COMPARATOR_T>&& map);
+
+    /**
+     *
+     */
+    tree_map<TKEY, TVALUE, COMPARATOR_T>& operator= (const tree_map<TKEY, TVALUE, COMPARATOR_T>& map);
+
+    /**
+     * Забирает записи map. map остаётся пустой картой с тем же аллокатором.
+     */
+    tree_map<TKEY, TVALUE, COMPARATOR_T>& operator= (tree_map<TKEY, TVALUE, COMPARATOR_T>&& map);
+
+    /**
+     *
+     */
+    ~tree_map();
+
+    /**
+     * Помещает значение по ключу. Если ключ уже существует, значение заменяется.
+     *
+     * @return
+     *      true - если была добавлена новая запись, false - если значение заменено.
+     */
+    template<typename TKEY_, typename TVALUE_>
+    bool put(TKEY_&& key, TVALUE_&& value);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если значения по переданному ключу не существует.
+     */
+    TVALUE& get(const TKEY& key);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если значения по переданному ключу не существует.
+     */
+    const TVALUE& get(const TKEY& key) const;
+
+    /**
+     *
+     */
+    TVALUE& get_or_default(const TKEY& key, TVALUE& value);
+
+    /**
+     *
+     */
+    const TVALUE& get_or_default(const TKEY& key, const TVALUE& value) const;
+
+    /**
+     *
+     */
+    bool contains_key(const TKEY& key) const;
+
+    /**
+     * Удаляет запись по ключу.
+     *
+     * @param ret
+     *      (Необязательно) указатель, куда будет перемещено удалённое значение.
+     *
+     * @return
+     *      true - если запись была удалена.
+     */
+    bool remove(const TKEY& key, TVALUE* ret = nullptr);
+
+    /**
+     *
+     */
+    void clear();
+
+    /**
+     *
+     */
+    std::size_t size() const;
+
+    /**
+     *
+     */
+    bool is_empty() const;
+
+    /**
+     *
+     */
+    tca::allocator* get_allocator() const;
+
+    /**
+     *
+     */
+    tree_map<TKEY, TVALUE, COMPARATOR_T> clone(tca::allocator* allocator = nullptr) const;
+
+    /**
+     * Возвращает запись с наименьшим ключом или nullptr, если карта пуста.
+     */
+    const entry* first_entry() const;
+
+    /**
+     * Возвращает запись с наибольшим ключом или nullptr, если карта пуста.
+     */
+    const entry* last_entry() const;
+
+    /**
+     * Возвращает запись с наибольшим ключом <= key или nullptr.
+     */
+    const entry* floor_entry(const TKEY& key) const;
+
+    /**
+     * Возвращает запись с наименьшим ключом >= key или nullptr.
+     */
+    const entry* ceil_entry(const TKEY& key) const;
+
+    /**
+     * Возвращает запись с наибольшим ключом < key или nullptr.
+     */
+    const entry* lower_entry(const TKEY& key) const;
+
+    /**
+     * Возвращает запись с наименьшим ключом > key или nullptr.
+     */
+    const entry* higher_entry(const TKEY& key) const;
+
+    /**
+     * Возвращает количество ключей, строго меньших key. O(log n).
+     */
+    std::size_t rank(const TKEY& key) const;
+
+    /**
+     * Возвращает запись, стоящую на позиции idx в порядке возрастания ключей. O(log n).
+     *
+     * @throws index_out_of_bound_exception
+     *      Если idx >= size().
+     */
+    const entry& select(std::size_t idx) const;
+
+    /**
+     * Возвращает количество ключей в полуинтервале [from, to). O(log n).
+     */
+    std::size_t count_range(const TKEY& from, const TKEY& to) const;
+
+    /**
+     * Итератор по записям в порядке возрастания ключей.
+     * Переход к следующей записи идёт по ссылкам на дочерние узлы и родителя без сравнения ключей,
+     * полный обход занимает O(n).
+     */
+    template<typename TENTRY>
+    class iterator {
+        /**
+         *
+         */
+        TENTRY* m_entry;
+
+    public:
+        /**
+         *
+         */
+        iterator(TENTRY* e);
+
+        /**
+         *
+         */
+        TENTRY& operator* () const;
+
+        /**
+         *
+         */
+        bool operator!=(const iterator<TENTRY>&) const;
+
+        /**
+         *
+         */
+        iterator<TENTRY>& operator++ ();
+
+        /**
+         *
+         */
+        iterator<TENTRY> operator++ (int);
+    };
+
+    /**
+     * Диапазон записей [from, to) для использования в range-based for.
+     */
+    class range {
+        /**
+         *
+         */
+        const entry* m_begin;
+
+        /**
+         *
+         */
+        const entry* m_end;
+
+    public:
+        /**
+         *
+         */
+        range(const entry* b, const entry* e) : m_begin(b), m_end(e) {}
+
+        /**
+         *
+         */
+        iterator<const entry> begin() const {
+            return iterator<const entry>(m_begin);
+        }
+
+        /**
+         *
+         */
+        iterator<const entry> end() const {
+            return iterator<const entry>(m_end);
+        }
+    };
+
+    /**
+     * Возвращает диапазон записей с ключами из полуинтервала [from, to).
+     * Диапазон не копирует данные и становится недействительным после изменения карты.
+     */
+    range sub_map(const TKEY& from, const TKEY& to) const;
+
+    /**
+     *
+     */
+    iterator<entry> begin() {
+        return iterator<entry>(m_tree.first_entry());
+    }
+
+    /**
+     *
+     */
+    iterator<entry> end() {
+        return iterator<entry>(nullptr);
+    }
+
+    /**
+     *
+     */
+    iterator<const entry> begin() const {
+        return iterator<const entry>(m_tree.first_entry());
+    }
+
+    /**
+     *
+     */
+    iterator<const entry> end() const {
+        return iterator<const entry>(nullptr);
+    }
+};
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TKEY_, typename TVALUE_>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>::entry::entry(TKEY_&& k, TVALUE_&& v) :
+        left(nullptr),
+        right(nullptr),
+        parent(nullptr),
+        key(std::forward<TKEY_>(k)),
+        height(1),
+        size(1),
+        value(std::forward<TVALUE_>(v)) {
+
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>::tree_map(tca::allocator* allocator) :
+        m_allocator(allocator),
+        m_tree() {
+
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>::tree_map(const tree_map<TKEY, TVALUE, COMPARATOR_T>& map) :
+        tree_map(map.m_allocator) {
+        (*this) = map.clone();
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>::tree_map(tree_map<TKEY, TVALUE, COMPARATOR_T>&& map) :
+        m_allocator(map.m_allocator),
+        m_tree(std::move(map.m_tree)) {
+
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>& tree_map<TKEY, TVALUE, COMPARATOR_T>::operator= (const tree_map<TKEY, TVALUE, COMPARATOR_T>& map) {
+        if (&map != this) {
+            tree_map<TKEY, TVALUE, COMPARATOR_T> tmp = map.clone(m_allocator);
+            (*this) = std::move(tmp);
+        }
+        return *this;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>& tree_map<TKEY, TVALUE, COMPARATOR_T>::operator= (tree_map<TKEY, TVALUE, COMPARATOR_T>&& map) {
+        if (&map != this) {
+            clear();
+            m_allocator = map.m_allocator;
+            m_tree      = std::move(map.m_tree);
+        }
+        return *this;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>::~tree_map() {
+        clear();
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TKEY_, typename TVALUE_>
+    typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::alloc_entry(TKEY_&& key, TVALUE_&& value) {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator must be != null");
+        );
+        void* mem = m_allocator->allocate_align(sizeof(entry), alignof(entry));
+        if (!mem)
+            throw_except<out_of_memory_error>("Out of memory!");
+        entry* e = nullptr;
+        try {
+            e = new(mem) entry(std::forward<TKEY_>(key), std::forward<TVALUE_>(value));
+        } catch (...) {
+            m_allocator->deallocate(mem, sizeof(entry));
+            throw;
+        }
+        return e;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    void tree_map<TKEY, TVALUE, COMPARATOR_T>::free_entry(entry* e) {
+        assert(e != nullptr);
+        e->~entry();
+        m_allocator->deallocate(e, sizeof(entry));
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    void tree_map<TKEY, TVALUE, COMPARATOR_T>::free_subtree(entry* e) {
+        //глубина рекурсии ограничена высотой AVL-дерева
+        if (e == nullptr)
+            return;
+        free_subtree(e->left);
+        free_subtree(e->right);
+        free_entry(e);
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TKEY_, typename TVALUE_>
+    bool tree_map<TKEY, TVALUE, COMPARATOR_T>::put(TKEY_&& key, TVALUE_&& value) {
+        entry* e = m_tree.search_entry(key);
+        if (e != nullptr) {
+            e->value = std::forward<TVALUE_>(value);
+            return false;
+        }
+        m_tree.insert_entry(alloc_entry(std::forward<TKEY_>(key), std::forward<TVALUE_>(value)));
+        return true;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    TVALUE& tree_map<TKEY, TVALUE, COMPARATOR_T>::get(const TKEY& key) {
+        entry* e = m_tree.search_entry(key);
+        if (e == nullptr)
+            throw_except<no_such_element_exception>("No such element in map");
+        return e->value;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const TVALUE& tree_map<TKEY, TVALUE, COMPARATOR_T>::get(const TKEY& key) const {
+        const entry* e = m_tree.search_entry(key);
+        if (e == nullptr)
+            throw_except<no_such_element_exception>("No such element in map");
+        return e->value;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    TVALUE& tree_map<TKEY, TVALUE, COMPARATOR_T>::get_or_default(const TKEY& key, TVALUE& value) {
+        entry* e = m_tree.search_entry(key);
+        return e != nullptr ? e->value : value;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const TVALUE& tree_map<TKEY, TVALUE, COMPARATOR_T>::get_or_default(const TKEY& key, const TVALUE& value) const {
+        const entry* e = m_tree.search_entry(key);
+        return e != nullptr ? e->value : value;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    bool tree_map<TKEY, TVALUE, COMPARATOR_T>::contains_key(const TKEY& key) const {
+        return m_tree.search_entry(key) != nullptr;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    bool tree_map<TKEY, TVALUE, COMPARATOR_T>::remove(const TKEY& key, TVALUE* ret) {
+        entry* e = m_tree.remove_entry(key);
+        if (e == nullptr)
+            return false;
+        if (ret != nullptr)
+            *ret = std::move(e->value);
+        free_entry(e);
+        return true;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    void tree_map<TKEY, TVALUE, COMPARATOR_T>::clear() {
+        if (m_allocator == nullptr)
+            return;
+        free_subtree(m_tree.get_root());
+        m_tree = tree_type(m_tree.get_comparator());
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    std::size_t tree_map<TKEY, TVALUE, COMPARATOR_T>::size() const {
+        return subtree_size(m_tree.get_root());
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    bool tree_map<TKEY, TVALUE, COMPARATOR_T>::is_empty() const {
+        return m_tree.get_root() == nullptr;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tca::allocator* tree_map<TKEY, TVALUE, COMPARATOR_T>::get_allocator() const {
+        return m_allocator;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    tree_map<TKEY, TVALUE, COMPARATOR_T> tree_map<TKEY, TVALUE, COMPARATOR_T>::clone(tca::allocator* allocator) const {
+        if (allocator == nullptr) {
+            if (m_allocator == nullptr)
+                return tree_map<TKEY, TVALUE, COMPARATOR_T>();
+            allocator = m_allocator;
+        }
+        tree_map<TKEY, TVALUE, COMPARATOR_T> result(allocator);
+        result.m_tree.set_comparator(m_tree.get_comparator());
+        for (const entry& e : *this)
+            result.m_tree.insert_entry(result.alloc_entry(e.key, e.value));
+        return tree_map<TKEY, TVALUE, COMPARATOR_T>(std::move(result));
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::first_entry() const {
+        return m_tree.first_entry();
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::last_entry() const {
+        return m_tree.last_entry();
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::floor_entry(const TKEY& key) const {
+        return m_tree.floor_entry(key);
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::ceil_entry(const TKEY& key) const {
+        return m_tree.ceil_entry(key);
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::lower_entry(const TKEY& key) const {
+        return m_tree.lower_entry(key);
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry* tree_map<TKEY, TVALUE, COMPARATOR_T>::higher_entry(const TKEY& key) const {
+        return m_tree.higher_entry(key);
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    std::size_t tree_map<TKEY, TVALUE, COMPARATOR_T>::rank(const TKEY& key) const {
+        const COMPARATOR_T& compare = m_tree.get_comparator();
+        const entry* n = m_tree.get_root();
+        std::size_t result = 0;
+        while (n)
+        {
+            if (compare(key, n->key) > 0)
+            {
+                result += subtree_size(n->left) + 1;
+                n = n->right;
+            }
+            else
+            {
+                n = n->left;
+            }
+        }
+        return result;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    const typename tree_map<TKEY, TVALUE, COMPARATOR_T>::entry& tree_map<TKEY, TVALUE, COMPARATOR_T>::select(std::size_t idx) const {
+        if (idx >= size())
+            throw_except<index_out_of_bound_exception>("Index %zu out of bound for length %zu!", idx, size());
+        const entry* n = m_tree.get_root();
+        while (true)
+        {
+            assert(n != nullptr);
+            const std::size_t left_size = subtree_size(n->left);
+            if (idx < left_size)
+            {
+                n = n->left;
+            }
+            else if (idx > left_size)
+            {
+                idx -= left_size + 1;
+                n = n->right;
+            }
+            else
+            {
+                return *n;
+            }
+        }
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    std::size_t tree_map<TKEY, TVALUE, COMPARATOR_T>::count_range(const TKEY& from, const TKEY& to) const {
+        const std::size_t lo = rank(from);
+        const std::size_t hi = rank(to);
+        return hi > lo ? hi - lo : 0;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    typename tree_map<TKEY, TVALUE, COMPARATOR_T>::range tree_map<TKEY, TVALUE, COMPARATOR_T>::sub_map(const TKEY& from, const TKEY& to) const {
+        if (m_tree.get_comparator()(from, to) >= 0)
+            return range(nullptr, nullptr);
+        return range(m_tree.ceil_entry(from), m_tree.ceil_entry(to));
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TENTRY>
+    tree_map<TKEY, TVALUE, COMPARATOR_T>::iterator<TENTRY>::iterator(TENTRY* e) :
+        m_entry(e) {
+
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TENTRY>
+    TENTRY& tree_map<TKEY, TVALUE, COMPARATOR_T>::iterator<TENTRY>::operator* () const {
+        JSTD_DEBUG_CODE(check_non_null(m_entry));
+        return *m_entry;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TENTRY>
+    bool tree_map<TKEY, TVALUE, COMPARATOR_T>::iterator<TENTRY>::operator!=(const iterator<TENTRY>& it) const {
+        return m_entry != it.m_entry;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TENTRY>
+    typename tree_map<TKEY, TVALUE, COMPARATOR_T>::template iterator<TENTRY>& tree_map<TKEY, TVALUE, COMPARATOR_T>::iterator<TENTRY>::operator++ () {
+        JSTD_DEBUG_CODE(check_non_null(m_entry));
+        if (m_entry->right != nullptr) {
+            m_entry = m_entry->right;
+            while (m_entry->left != nullptr)
+                m_entry = m_entry->left;
+        } else {
+            //подъём, пока узел - правый потомок: все такие предки уже пройдены
+            TENTRY* child = m_entry;
+            m_entry = m_entry->parent;
+            while (m_entry != nullptr && m_entry->right == child) {
+                child   = m_entry;
+                m_entry = m_entry->parent;
+            }
+        }
+        return *this;
+    }
+
+    template<typename TKEY, typename TVALUE, typename COMPARATOR_T>
+    template<typename TENTRY>
+    typename tree_map<TKEY, TVALUE, COMPARATOR_T>::template iterator<TENTRY> tree_map<TKEY, TVALUE, COMPARATOR_T>::iterator<TENTRY>::operator++ (int) {
+        iterator<TENTRY> it(*this);
+        ++(*this);
+        return it;
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_TREE_MAP_H
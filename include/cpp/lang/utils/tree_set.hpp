@@ -0,0 +1,199 @@
+#ifndef JSTD_CPP_LANG_UTILS_TREE_SET_H
+#define JSTD_CPP_LANG_UTILS_TREE_SET_H
+
+#include <cpp/lang/utils/tree_map.hpp>
+
+namespace jstd
+{
+
+/**
+ * Упорядоченное множество уникальных элементов на основе tree_map.
+ *
+ * Аналогично hash_set, значения в нижележащей карте не играют роли (используется '\0').
+ * Итерация выполняется по записям карты в порядке возрастания ключей, ключ доступен через entry::get_key().
+ *
+ * @tparam K
+ *      Тип элементов.
+ *
+ * @tparam COMPARATOR_T
+ *      Компаратор элементов.
+ */
+template<typename K, typename COMPARATOR_T = compare_to<K>>
+class tree_set {
+    /**
+     *
+     */
+    static const char DEFAULT_VALUE = '\0';
+
+    /**
+     *
+     */
+    tree_map<K, char, COMPARATOR_T> m_storage;
+
+    /**
+     *
+     */
+    static const K* key_of(const typename tree_map<K, char, COMPARATOR_T>::entry* e) {
+        return e != nullptr ? &e->get_key() : nullptr;
+    }
+
+public:
+    /**
+     *
+     */
+    typedef typename tree_map<K, char, COMPARATOR_T>::entry entry;
+
+    /**
+     *
+     */
+    typedef typename tree_map<K, char, COMPARATOR_T>::range range;
+
+    /**
+     *
+     */
+    tree_set(tca::allocator* allocator = tca::get_default_allocator()) : m_storage(allocator) {}
+
+    /**
+     * Добавляет элемент.
+     *
+     * @return
+     *      true - если элемента ещё не было в множестве.
+     */
+    template<typename _K>
+    bool add(_K&& key) {
+        const char value = DEFAULT_VALUE;
+        return m_storage.put(std::forward<_K>(key), value);
+    }
+
+    /**
+     *
+     */
+    bool remove(const K& key) {
+        return m_storage.remove(key);
+    }
+
+    /**
+     *
+     */
+    bool contains(const K& key) const {
+        return m_storage.contains_key(key);
+    }
+
+    /**
+     *
+     */
+    void clear() {
+        m_storage.clear();
+    }
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_storage.size();
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_storage.is_empty();
+    }
+
+    /**
+     *
+     */
+    tree_set<K, COMPARATOR_T> clone(tca::allocator* allocator = nullptr) const {
+        tree_set<K, COMPARATOR_T> result;
+        result.m_storage = m_storage.clone(allocator);
+        return result;
+    }
+
+    /**
+     * Возвращает наименьший элемент или nullptr.
+     */
+    const K* first() const {
+        return key_of(m_storage.first_entry());
+    }
+
+    /**
+     * Возвращает наибольший элемент или nullptr.
+     */
+    const K* last() const {
+        return key_of(m_storage.last_entry());
+    }
+
+    /**
+     * Возвращает наибольший элемент <= key или nullptr.
+     */
+    const K* floor(const K& key) const {
+        return key_of(m_storage.floor_entry(key));
+    }
+
+    /**
+     * Возвращает наименьший элемент >= key или nullptr.
+     */
+    const K* ceil(const K& key) const {
+        return key_of(m_storage.ceil_entry(key));
+    }
+
+    /**
+     * Возвращает наибольший элемент < key или nullptr.
+     */
+    const K* lower(const K& key) const {
+        return key_of(m_storage.lower_entry(key));
+    }
+
+    /**
+     * Возвращает наименьший элемент > key или nullptr.
+     */
+    const K* higher(const K& key) const {
+        return key_of(m_storage.higher_entry(key));
+    }
+
+    /**
+     * @see tree_map::rank
+     */
+    std::size_t rank(const K& key) const {
+        return m_storage.rank(key);
+    }
+
+    /**
+     * @see tree_map::select
+     */
+    const K& select(std::size_t idx) const {
+        return m_storage.select(idx).get_key();
+    }
+
+    /**
+     * @see tree_map::count_range
+     */
+    std::size_t count_range(const K& from, const K& to) const {
+        return m_storage.count_range(from, to);
+    }
+
+    /**
+     * @see tree_map::sub_map
+     */
+    range sub_set(const K& from, const K& to) const {
+        return m_storage.sub_map(from, to);
+    }
+
+    /**
+     *
+     */
+    typename tree_map<K, char, COMPARATOR_T>:: template iterator<const entry> begin() const {
+        return m_storage.begin();
+    }
+
+    /**
+     *
+     */
+    typename tree_map<K, char, COMPARATOR_T>:: template iterator<const entry> end() const {
+        return m_storage.end();
+    }
+};
+
+}
+
+#endif//JSTD_CPP_LANG_UTILS_TREE_SET_H
@@ -513,6 +513,14 @@ public:
     unique_ptr<T[]> make_unique_array(std::size_t len, tca::allocator* allocator = tca::get_scoped_or_default()) {
         return unique_ptr<T[]>(len, allocator);
     }
+
+    /**
+     *
+     */
+    template<typename T>
+    struct is_trivially_relocatable<unique_ptr<T>> {
+        static const bool value = true;
+    };
 }
 
 #endif//JSTD_CPP_LANG_UTILS_UNIQUE_PTR_H
@@ -0,0 +1,791 @@
+#ifndef JSTD_CPP_LANG_UTILS_UNROLLED_LIST_H
+#define JSTD_CPP_LANG_UTILS_UNROLLED_LIST_H
+
+#include <allocators/allocator.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/arrays.hpp>
+#include <cpp/lang/utils/hash.hpp>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+#include <new>
+
+namespace jstd
+{
+
+/**
+ * Развёрнутый двусвязный список: каждый узел хранит до K элементов подряд.
+ *
+ * Интерфейс совместим с linked_list, но выделение памяти происходит один раз на K элементов,
+ * а обход идёт по непрерывным блокам. Вставка в середину сдвигает не более K элементов узла;
+ * полный узел делится пополам. Узел, заполненный меньше чем наполовину после удаления,
+ * сливается с соседом, если их элементы помещаются в один узел.
+ *
+ * В отличие от linked_list, вставка и удаление перемещают соседние элементы узла,
+ * поэтому после любого изменения указатели на элементы и итераторы недействительны,
+ * кроме итераторов, возвращённых самими add(iterator, ...) и remove_at(iterator, ...).
+ * Итератор (узел, позиция) после сдвига указывал бы на соседний элемент, а устойчивые итераторы потребовали бы
+ * косвенности на каждый элемент и лишили бы узлы непрерывного хранения.
+ *
+ * @tparam T
+ *      Тип элементов.
+ *
+ * @tparam K
+ *      Вместимость одного узла (не меньше 2).
+ */
+template<typename T, std::size_t K = 16>
+class unrolled_list {
+    static_assert(K >= 2, "K must be >= 2");
+
+    /**
+     * Узел списка.
+     */
+    struct block {
+        block*      prev;
+        block*      next;
+
+        /**
+         * Количество элементов в узле, от 1 до K.
+         */
+        std::size_t count;
+
+        /**
+         * Память под K элементов. Заняты первые count.
+         */
+        typename std::aligned_storage<sizeof(T) * K, alignof(T)>::type storage;
+
+        T* data() {
+            return reinterpret_cast<T*>(&storage);
+        }
+
+        const T* data() const {
+            return reinterpret_cast<const T*>(&storage);
+        }
+    };
+
+    /**
+     * Аллокатор узлов.
+     */
+    tca::base_allocator*    m_allocator;
+
+    /**
+     *
+     */
+    block*                  m_head;
+
+    /**
+     *
+     */
+    block*                  m_tail;
+
+    /**
+     * Количество элементов во всех узлах.
+     */
+    std::size_t             m_size;
+
+public:
+    /**
+     * Итератор по элементам. Хранит узел и позицию в нём.
+     */
+    template<typename BLOCK_TYPE, typename VALUE_TYPE>
+    class iterator {
+        friend class unrolled_list<T, K>;
+
+        BLOCK_TYPE* m_block;
+        std::size_t m_idx;
+    public:
+        iterator() : m_block(nullptr), m_idx(0) {
+
+        }
+
+        iterator(BLOCK_TYPE* b, std::size_t idx) : m_block(b), m_idx(idx) {
+
+        }
+
+        bool operator==(const iterator& it) const {
+            return m_block == it.m_block && m_idx == it.m_idx;
+        }
+
+        bool operator!=(const iterator& it) const {
+            return !(*this == it);
+        }
+
+        iterator& operator++() {
+            if (++m_idx == m_block->count) {
+                m_block = m_block->next;
+                m_idx   = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        VALUE_TYPE operator*() const {
+            return m_block->data()[m_idx];
+        }
+    };
+
+private:
+    /**
+     * Выделяет пустой узел.
+     */
+    block* new_block();
+
+    /**
+     * Разрушает элементы узла и освобождает его память. Узел должен быть уже исключён из цепочки.
+     */
+    void delete_block(block* b);
+
+    /**
+     * Вставляет узел b после pos (в начало, если pos == nullptr).
+     */
+    void link_after(block* pos, block* b);
+
+    /**
+     * Исключает узел из цепочки, не освобождая его.
+     */
+    void unlink_block(block* b);
+
+    /**
+     * Возвращает узел, содержащий элемент с индексом idx, и позицию элемента в нём.
+     */
+    block* find(std::size_t idx, std::size_t* offset) const;
+
+    /**
+     * Вставляет значение в узел b перед позицией offset (offset <= b->count). Полный узел делится пополам.
+     *
+     * @return
+     *      Позиция вставленного элемента.
+     */
+    template<typename _T>
+    iterator<block, T&> insert(block* b, std::size_t offset, _T&& value);
+
+    /**
+     * Удаляет элемент узла b в позиции offset и при необходимости сливает узел с соседом.
+     *
+     * @return
+     *      Позиция элемента, следовавшего за удалённым.
+     */
+    iterator<block, T&> erase(block* b, std::size_t offset, T* _return);
+
+    /**
+     * Возвращает true, если узлы можно не обходить при очистке:
+     * аллокатор монотонный, а T тривиально разрушаемый.
+     */
+    bool can_drop_blocks() const {
+        return std::is_trivially_destructible<T>::value && m_allocator != nullptr && m_allocator->is_monotonic();
+    }
+
+public:
+    /**
+     *
+     */
+    static const std::size_t null_val = ~((std::size_t) 0);
+
+    /**
+     * @param allocator
+     *      Аллокатор узлов.
+     */
+    unrolled_list(tca::base_allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    unrolled_list(const std::initializer_list<T>& init_list, tca::base_allocator* allocator = tca::get_default_allocator());
+
+    /**
+     *
+     */
+    unrolled_list(const unrolled_list<T, K>& other);
+
+    /**
+     *
+     */
+    unrolled_list(unrolled_list<T, K>&& other);
+
+    /**
+     *
+     */
+    unrolled_list<T, K>& operator=(const unrolled_list<T, K>& other);
+
+    /**
+     *
+     */
+    unrolled_list<T, K>& operator=(unrolled_list<T, K>&& other);
+
+    /**
+     *
+     */
+    ~unrolled_list();
+
+    /**
+     * Удаляет все элементы и освобождает узлы.
+     * Если can_drop_blocks(), узлы не обходятся и очистка выполняется за O(1).
+     */
+    void clear();
+
+    /**
+     * @see linked_list::release_all
+     */
+    void release_all();
+
+    /**
+     * Добавляет элемент в конец списка.
+     */
+    template<typename _T>
+    void add(_T&& value);
+
+    /**
+     * Добавляет элемент в начало списка.
+     */
+    template<typename _T>
+    void add_first(_T&& value);
+
+    /**
+     * Добавляет элемент в конец списка.
+     */
+    template<typename _T>
+    void add_last(_T&& value);
+
+    /**
+     * Вставляет элемент по индексу за O(n / K + K).
+     *
+     * @throws index_out_of_bound_exception
+     *      Если idx > size().
+     */
+    template<typename _T>
+    void add(std::size_t idx, _T&& value);
+
+    /**
+     * Вставляет элемент перед pos за O(K) без поиска по индексу.
+     *
+     * @return
+     *      Итератор на вставленный элемент.
+     */
+    template<typename _T>
+    iterator<block, T&> add(iterator<block, T&> pos, _T&& value);
+
+    /**
+     * Удаляет элемент по индексу.
+     *
+     * @param _return
+     *      [optional] Указатель, куда будет записано удалённое значение.
+     */
+    void remove_at(std::size_t idx, T* _return = nullptr);
+
+    /**
+     * Удаляет элемент, на который указывает pos, за O(K).
+     *
+     * @param _return
+     *      [optional] Указатель, куда будет записано удалённое значение.
+     *
+     * @return
+     *      Итератор на следующий элемент.
+     */
+    iterator<block, T&> remove_at(iterator<block, T&> pos, T* _return = nullptr);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если список пуст.
+     */
+    void remove_first(T* _return = nullptr);
+
+    /**
+     * @throws no_such_element_exception
+     *      Если список пуст.
+     */
+    void remove_last(T* _return = nullptr);
+
+    /**
+     * Удаляет первое вхождение значения (сравнение через jstd::equal_to<T>).
+     * Если значения нет, список не меняется.
+     *
+     * @param _return
+     *      [optional] Указатель, куда будет записано удалённое значение.
+     */
+    void remove(const T& v, T* _return = nullptr);
+
+    /**
+     * Добавляет элемент в конец (аналог push_back).
+     */
+    template<typename _T>
+    void push(_T&& value);
+
+    /**
+     * Удаляет последний элемент (аналог pop_back).
+     */
+    void pop(T* _return = nullptr);
+
+    /**
+     *
+     */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+     *
+     */
+    bool is_empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     * Возвращает элемент по индексу за O(n / K).
+     */
+    T& at(std::size_t idx);
+
+    /**
+     * Возвращает элемент по индексу за O(n / K).
+     */
+    const T& at(std::size_t idx) const;
+
+    /**
+     * @see linked_list::contains
+     */
+    bool contains(const T& value) const;
+
+    /**
+     * @return
+     *      Индекс первого вхождения или null_val.
+     */
+    std::size_t index_of(const T& value) const;
+
+    /**
+     * Создаёт копию списка.
+     *
+     * @param allocator
+     *      Аллокатор для копии. Если nullptr, используется аллокатор текущего списка.
+     */
+    unrolled_list<T, K> clone(tca::base_allocator* allocator = nullptr) const;
+
+    /**
+     *
+     */
+    iterator<const block, const T&> begin() const {
+        return iterator<const block, const T&>(m_head, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<const block, const T&> end() const {
+        return iterator<const block, const T&>(nullptr, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<block, T&> begin() {
+        return iterator<block, T&>(m_head, 0);
+    }
+
+    /**
+     *
+     */
+    iterator<block, T&> end() {
+        return iterator<block, T&>(nullptr, 0);
+    }
+};
+
+    template<typename T, std::size_t K>
+    typename unrolled_list<T, K>::block* unrolled_list<T, K>::new_block() {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator must be != null");
+        )
+        void* mem = m_allocator->allocate_align(sizeof(block), alignof(block));
+        if (mem == nullptr)
+            throw_except<out_of_memory_error>("Out of memory");
+        block* b = reinterpret_cast<block*>(mem);
+        b->prev     = nullptr;
+        b->next     = nullptr;
+        b->count    = 0;
+        return b;
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::delete_block(block* b) {
+        T* data = b->data();
+        for (std::size_t i = 0; i < b->count; ++i)
+            data[i].~T();
+        m_allocator->deallocate(b, sizeof(block));
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::link_after(block* pos, block* b) {
+        block* next = pos != nullptr ? pos->next : m_head;
+        b->prev = pos;
+        b->next = next;
+        if (pos != nullptr)
+            pos->next = b;
+        else
+            m_head = b;
+        if (next != nullptr)
+            next->prev = b;
+        else
+            m_tail = b;
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::unlink_block(block* b) {
+        if (b->prev != nullptr)
+            b->prev->next = b->next;
+        else
+            m_head = b->next;
+        if (b->next != nullptr)
+            b->next->prev = b->prev;
+        else
+            m_tail = b->prev;
+    }
+
+    template<typename T, std::size_t K>
+    typename unrolled_list<T, K>::block* unrolled_list<T, K>::find(std::size_t idx, std::size_t* offset) const {
+        assert(idx < m_size);
+        block* b;
+        if (idx < (m_size >> 1)) {
+            for (b = m_head; idx >= b->count; b = b->next)
+                idx -= b->count;
+        } else {
+            std::size_t rest = m_size - idx;
+            for (b = m_tail; rest > b->count; b = b->prev)
+                rest -= b->count;
+            idx = b->count - rest;
+        }
+        *offset = idx;
+        return b;
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    typename unrolled_list<T, K>::template iterator<typename unrolled_list<T, K>::block, T&> unrolled_list<T, K>::insert(block* b, std::size_t offset, _T&& value) {
+        assert(offset <= b->count);
+        if (b->count == K) {
+            block* half = new_block();
+            const std::size_t keep = K / 2;
+            relocate(half->data(), b->data() + keep, K - keep);
+            half->count = K - keep;
+            b->count    = keep;
+            link_after(b, half);
+            if (offset > keep) {
+                b = half;
+                offset -= keep;
+            }
+        }
+
+        T* data = b->data();
+        relocate(data + offset + 1, data + offset, b->count - offset);
+        try {
+            new (data + offset) T(std::forward<_T>(value));
+        } catch (...) {
+            relocate(data + offset, data + offset + 1, b->count - offset);
+            if (b->count == 0) {
+                unlink_block(b);
+                delete_block(b);
+            }
+            throw;
+        }
+        ++b->count;
+        ++m_size;
+        return iterator<block, T&>(b, offset);
+    }
+
+    template<typename T, std::size_t K>
+    typename unrolled_list<T, K>::template iterator<typename unrolled_list<T, K>::block, T&> unrolled_list<T, K>::erase(block* b, std::size_t offset, T* _return) {
+        assert(offset < b->count);
+        T* data = b->data();
+        if (_return != nullptr)
+            *_return = std::move(data[offset]);
+        data[offset].~T();
+        relocate(data + offset, data + offset + 1, b->count - offset - 1);
+        --b->count;
+        --m_size;
+
+        if (b->count == 0) {
+            block* next = b->next;
+            unlink_block(b);
+            m_allocator->deallocate(b, sizeof(block));
+            return iterator<block, T&>(next, 0);
+        }
+
+        if (b->count < K / 2) {
+            block* next = b->next;
+            block* prev = b->prev;
+            if (next != nullptr && b->count + next->count <= K) {
+                relocate(data + b->count, next->data(), next->count);
+                b->count += next->count;
+                unlink_block(next);
+                m_allocator->deallocate(next, sizeof(block));
+            } else if (prev != nullptr && prev->count + b->count <= K) {
+                relocate(prev->data() + prev->count, data, b->count);
+                offset     += prev->count;
+                prev->count += b->count;
+                unlink_block(b);
+                m_allocator->deallocate(b, sizeof(block));
+                b = prev;
+            }
+        }
+
+        if (offset < b->count)
+            return iterator<block, T&>(b, offset);
+        return iterator<block, T&>(b->next, 0);
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>::unrolled_list(tca::base_allocator* allocator) :
+        m_allocator(allocator),
+        m_head(nullptr),
+        m_tail(nullptr),
+        m_size(0) {
+
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>::unrolled_list(const std::initializer_list<T>& init_list, tca::base_allocator* allocator) : unrolled_list<T, K>(allocator) {
+        for (const T& value : init_list)
+            add_last(value);
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>::unrolled_list(const unrolled_list<T, K>& other) : unrolled_list<T, K>(other.clone()) {
+
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>::unrolled_list(unrolled_list<T, K>&& other) :
+        m_allocator(other.m_allocator),
+        m_head(other.m_head),
+        m_tail(other.m_tail),
+        m_size(other.m_size) {
+        other.m_allocator   = nullptr;
+        other.m_head        = nullptr;
+        other.m_tail        = nullptr;
+        other.m_size        = 0;
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>& unrolled_list<T, K>::operator=(const unrolled_list<T, K>& other) {
+        if (&other != this)
+            *this = other.clone(m_allocator);
+        return *this;
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>& unrolled_list<T, K>::operator=(unrolled_list<T, K>&& other) {
+        if (&other != this) {
+            clear();
+            m_allocator = other.m_allocator;
+            m_head      = other.m_head;
+            m_tail      = other.m_tail;
+            m_size      = other.m_size;
+
+            other.m_allocator   = nullptr;
+            other.m_head        = nullptr;
+            other.m_tail        = nullptr;
+            other.m_size        = 0;
+        }
+        return *this;
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K>::~unrolled_list() {
+        if (!can_drop_blocks())
+            clear();
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::clear() {
+        if (!can_drop_blocks()) {
+            for (block* b = m_head; b != nullptr; ) {
+                block* current = b;
+                b = b->next;
+                delete_block(current);
+            }
+        }
+        m_head = nullptr;
+        m_tail = nullptr;
+        m_size = 0;
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::release_all() {
+        if (m_allocator == nullptr || !m_allocator->is_monotonic()) {
+            clear();
+            return;
+        }
+        if (!std::is_trivially_destructible<T>::value) {
+            for (block* b = m_head; b != nullptr; b = b->next) {
+                T* data = b->data();
+                for (std::size_t i = 0; i < b->count; ++i)
+                    data[i].~T();
+            }
+        }
+        m_head = nullptr;
+        m_tail = nullptr;
+        m_size = 0;
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    void unrolled_list<T, K>::add_last(_T&& value) {
+        if (m_tail == nullptr || m_tail->count == K)
+            link_after(m_tail, new_block());
+        insert(m_tail, m_tail->count, std::forward<_T>(value));
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    void unrolled_list<T, K>::add_first(_T&& value) {
+        if (m_head == nullptr || m_head->count == K)
+            link_after(nullptr, new_block());
+        insert(m_head, 0, std::forward<_T>(value));
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    void unrolled_list<T, K>::add(_T&& value) {
+        add_last(std::forward<_T>(value));
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    void unrolled_list<T, K>::add(std::size_t idx, _T&& value) {
+        JSTD_DEBUG_CODE(
+            if (idx > m_size)
+                throw_except<index_out_of_bound_exception>("Index %zu out of bound for length %zu", idx, m_size);
+        )
+        if (idx == m_size) {
+            add_last(std::forward<_T>(value));
+            return;
+        }
+        std::size_t offset;
+        block* b = find(idx, &offset);
+        insert(b, offset, std::forward<_T>(value));
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    typename unrolled_list<T, K>::template iterator<typename unrolled_list<T, K>::block, T&> unrolled_list<T, K>::add(iterator<block, T&> pos, _T&& value) {
+        if (pos.m_block == nullptr) {
+            add_last(std::forward<_T>(value));
+            return iterator<block, T&>(m_tail, m_tail->count - 1);
+        }
+        return insert(pos.m_block, pos.m_idx, std::forward<_T>(value));
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::remove_at(std::size_t idx, T* _return) {
+        check_index(idx, m_size);
+        std::size_t offset;
+        block* b = find(idx, &offset);
+        erase(b, offset, _return);
+    }
+
+    template<typename T, std::size_t K>
+    typename unrolled_list<T, K>::template iterator<typename unrolled_list<T, K>::block, T&> unrolled_list<T, K>::remove_at(iterator<block, T&> pos, T* _return) {
+        JSTD_DEBUG_CODE(
+            if (pos.m_block == nullptr)
+                throw_except<no_such_element_exception>("Iterator points past the end");
+        )
+        return erase(pos.m_block, pos.m_idx, _return);
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::remove_first(T* _return) {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        erase(m_head, 0, _return);
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::remove_last(T* _return) {
+        if (m_size == 0)
+            throw_except<no_such_element_exception>();
+        erase(m_tail, m_tail->count - 1, _return);
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::remove(const T& v, T* _return) {
+        equal_to<T> equals;
+        for (block* b = m_head; b != nullptr; b = b->next) {
+            T* data = b->data();
+            for (std::size_t i = 0; i < b->count; ++i) {
+                if (equals(v, data[i])) {
+                    erase(b, i, _return);
+                    return;
+                }
+            }
+        }
+    }
+
+    template<typename T, std::size_t K>
+    template<typename _T>
+    void unrolled_list<T, K>::push(_T&& value) {
+        add_last(std::forward<_T>(value));
+    }
+
+    template<typename T, std::size_t K>
+    void unrolled_list<T, K>::pop(T* _return) {
+        remove_last(_return);
+    }
+
+    template<typename T, std::size_t K>
+    T& unrolled_list<T, K>::at(std::size_t idx) {
+        check_index(idx, m_size);
+        std::size_t offset;
+        block* b = find(idx, &offset);
+        return b->data()[offset];
+    }
+
+    template<typename T, std::size_t K>
+    const T& unrolled_list<T, K>::at(std::size_t idx) const {
+        check_index(idx, m_size);
+        std::size_t offset;
+        const block* b = find(idx, &offset);
+        return b->data()[offset];
+    }
+
+    template<typename T, std::size_t K>
+    bool unrolled_list<T, K>::contains(const T& value) const {
+        return index_of(value) != null_val;
+    }
+
+    template<typename T, std::size_t K>
+    std::size_t unrolled_list<T, K>::index_of(const T& value) const {
+        equal_to<T> equals;
+        std::size_t base = 0;
+        for (const block* b = m_head; b != nullptr; b = b->next) {
+            const T* data = b->data();
+            for (std::size_t i = 0; i < b->count; ++i)
+                if (equals(value, data[i]))
+                    return base + i;
+            base += b->count;
+        }
+        return null_val;
+    }
+
+    template<typename T, std::size_t K>
+    unrolled_list<T, K> unrolled_list<T, K>::clone(tca::base_allocator* allocator) const {
+        if (allocator == nullptr) {
+            if (m_allocator == nullptr)
+                return unrolled_list<T, K>();
+            allocator = m_allocator;
+        }
+        unrolled_list<T, K> result(allocator);
+        for (const block* b = m_head; b != nullptr; b = b->next) {
+            block* copy = result.new_block();
+            result.link_after(result.m_tail, copy);
+            placement_copy(copy->data(), b->data(), b->count);
+            copy->count     = b->count;
+            result.m_size  += b->count;
+        }
+        return unrolled_list<T, K>(std::move(result));
+    }
+}
+
+#endif//JSTD_CPP_LANG_UTILS_UNROLLED_LIST_H
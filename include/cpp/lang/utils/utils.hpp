@@ -4,6 +4,7 @@
 #include <cpp/lang/utils/cond_compile.hpp>
 #include <cpp/lang/utils/comparator.hpp>
 #include <cpp/lang/utils/traits.hpp>
+#include <cpp/lang/utils/sort.hpp>
 #include <cpp/lang/system.hpp>
 #include <cstdint>
 #include <utility>
@@ -325,41 +326,9 @@ namespace utils
         }
     }
 
-namespace internal
-{
-    template<typename T, typename T_COMPARATOR>
-    void quick_sort_impl(T* array, std::size_t left, std::size_t right, T_COMPARATOR& compare) {
-        
-        if (left >= right) return;
-
-        std::size_t i = left;
-        std::size_t j = right;
-        T& pivot = array[(left + right) / 2];
-
-        while (i <= j) {
-            while (compare(array[i], pivot) < 0) ++i;
-            while (compare(array[j], pivot) > 0) --j;
-
-            if (i <= j) {
-                if (i != j) {
-                    T tmp = std::move(array[i]);
-                    array[i] = std::move(array[j]);
-                    array[j] = std::move(tmp);
-                }
-                ++i;
-                
-                if (j == 0) break;
-                --j;
-            }
-        }
-
-        if (left < j)   quick_sort_impl(array, left, j, compare);
-        if (i < right)  quick_sort_impl(array, i, right, compare);
-    }
-}
-
     /**
      * Выполняет быструю сортировку массива с использованием пользовательского компаратора.
+     * Реализована через pattern-defeating quicksort: O(n log n) в худшем случае.
      *
      * @tparam T 
      *      Тип элементов массива.
@@ -380,6 +349,8 @@ namespace internal
      *      Eсли len < 0
      * 
      * @since 1.0
+     * 
+     * @see sort
      */
     template<typename T, typename T_COMPARATOR = compare_to<T>>
     void quick_sort(T* array, std::size_t len) {
@@ -387,9 +358,9 @@ namespace internal
             if (array == nullptr)
                 throw_except<null_pointer_exception>("array must be != null");
         )
-        if (len <= 1) return;
         T_COMPARATOR compare;
-        internal::quick_sort_impl(array, 0, len - 1, compare);
+        jstd::internal::sort_less<T, T_COMPARATOR> less = {compare};
+        jstd::internal::pdq_sort(array, len, less);
     }
 }
 
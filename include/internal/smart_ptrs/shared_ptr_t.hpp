@@ -834,6 +834,22 @@ public:
         return weak_ptr<T>();
     }
 
+    /**
+     * Указатели хранят только адрес блока управления, блок не ссылается на них.
+     */
+    template<typename T>
+    struct is_trivially_relocatable<shared_ptr<T>> {
+        static const bool value = true;
+    };
+
+    /**
+     *
+     */
+    template<typename T>
+    struct is_trivially_relocatable<weak_ptr<T>> {
+        static const bool value = true;
+    };
+
 } //namespace jstd
 
 #endif//JSTD_INTERNAL_SMART_PTRS_SHARED_PTR_T_H
\ No newline at end of file
@@ -42,6 +42,11 @@ namespace internal
         return &s_malloc_allocator;
     }
 
+    allocator* get_scoped_or_default() {
+        allocator* scoped = internal::scoped_allocator;
+        return scoped != nullptr ? scoped : get_default_allocator();
+    }
+
     allocator* get_exception_allocator() {
         return get_default_allocator();
     }
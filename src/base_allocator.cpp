@@ -44,4 +44,8 @@ namespace tca{
         assert(m_parent != nullptr);
         m_parent->deallocate(p, sz);
     }
+
+    bool base_allocator::is_monotonic() const {
+        return false;
+    }
 }
\ No newline at end of file
@@ -43,7 +43,8 @@ namespace jstd {
     m_position(0), 
     m_limit(0), 
     m_mark(null_value()),
-    m_order(system::native_byte_order())  {
+    m_order(system::native_byte_order()),
+    m_readonly(false) {
         if (capacity > 0) {
             char* data = (char*) allocator->allocate_align(capacity, alignof(char));
             if (data == nullptr)
@@ -0,0 +1,596 @@
+#include <cpp/lang/utils/coder.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cstring>
+
+namespace jstd
+{
+namespace utf
+{
+namespace
+{
+    using simd::internal::popcount;
+
+    inline bool is_continuation(unsigned char b) {
+        return (b & 0xC0) == 0x80;
+    }
+
+    /**
+     * Разбирает одну многобайтовую последовательность, начинающуюся в s[i] (s[i] >= 0x80).
+     * Допустимые формы - таблица 3-7 стандарта Unicode. При успехе сдвигает i за последовательность.
+     */
+    inline bool decode_multibyte(const unsigned char* s, std::size_t n, std::size_t& i, utfpoint& cp) {
+        const unsigned char b0 = s[i];
+        if (b0 < 0xC2)
+            return false;
+        if (b0 < 0xE0) {
+            if (n - i < 2 || !is_continuation(s[i + 1]))
+                return false;
+            cp = ((utfpoint) (b0 & 0x1F) << 6) | (utfpoint) (s[i + 1] & 0x3F);
+            i += 2;
+            return true;
+        }
+        if (b0 < 0xF0) {
+            if (n - i < 3)
+                return false;
+            const unsigned char b1 = s[i + 1];
+            const unsigned char b2 = s[i + 2];
+            if (!is_continuation(b1) || !is_continuation(b2))
+                return false;
+            if (b0 == 0xE0 && b1 < 0xA0) return false; // избыточная форма
+            if (b0 == 0xED && b1 > 0x9F) return false; // суррогат
+            cp = ((utfpoint) (b0 & 0x0F) << 12) | ((utfpoint) (b1 & 0x3F) << 6) | (utfpoint) (b2 & 0x3F);
+            i += 3;
+            return true;
+        }
+        if (b0 < 0xF5) {
+            if (n - i < 4)
+                return false;
+            const unsigned char b1 = s[i + 1];
+            const unsigned char b2 = s[i + 2];
+            const unsigned char b3 = s[i + 3];
+            if (!is_continuation(b1) || !is_continuation(b2) || !is_continuation(b3))
+                return false;
+            if (b0 == 0xF0 && b1 < 0x90) return false; // избыточная форма
+            if (b0 == 0xF4 && b1 > 0x8F) return false; // больше 0x10FFFF
+            cp = ((utfpoint) (b0 & 0x07) << 18) | ((utfpoint) (b1 & 0x3F) << 12) | ((utfpoint) (b2 & 0x3F) << 6) | (utfpoint) (b3 & 0x3F);
+            i += 4;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Записывает кодовую точку (<= 0x10FFFF, не суррогат) в UTF-8.
+     */
+    inline std::size_t encode_utf8(char* dst, utfpoint cp) {
+        if (cp < 0x80) {
+            dst[0] = (char) cp;
+            return 1;
+        }
+        if (cp < 0x800) {
+            dst[0] = (char) (0xC0 | (cp >> 6));
+            dst[1] = (char) (0x80 | (cp & 0x3F));
+            return 2;
+        }
+        if (cp < 0x10000) {
+            dst[0] = (char) (0xE0 | (cp >> 12));
+            dst[1] = (char) (0x80 | ((cp >> 6) & 0x3F));
+            dst[2] = (char) (0x80 | (cp & 0x3F));
+            return 3;
+        }
+        dst[0] = (char) (0xF0 | (cp >> 18));
+        dst[1] = (char) (0x80 | ((cp >> 12) & 0x3F));
+        dst[2] = (char) (0x80 | ((cp >> 6) & 0x3F));
+        dst[3] = (char) (0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+#if defined(JSTD_SIMD_AVX2)
+    const std::size_t LANES = 32;
+    const std::uint32_t FULL_MASK = 0xFFFFFFFFu;
+    typedef __m256i vec;
+
+    inline vec load(const void* p)              { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    inline void store(void* p, vec v)           { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    inline std::uint32_t movemask(vec v)        { return (std::uint32_t) _mm256_movemask_epi8(v); }
+    inline vec zero()                           { return _mm256_setzero_si256(); }
+    inline vec splat8(int c)                    { return _mm256_set1_epi8((char) c); }
+    inline vec splat16(int c)                   { return _mm256_set1_epi16((short) c); }
+    inline vec splat32(unsigned c)              { return _mm256_set1_epi32((int) c); }
+    inline vec vor(vec a, vec b)                { return _mm256_or_si256(a, b); }
+    inline vec vand(vec a, vec b)               { return _mm256_and_si256(a, b); }
+    inline vec lt8(vec a, vec b)                { return _mm256_cmpgt_epi8(b, a); }
+    inline vec eq8(vec a, vec b)                { return _mm256_cmpeq_epi8(a, b); }
+    inline vec eq16(vec a, vec b)               { return _mm256_cmpeq_epi16(a, b); }
+    inline vec max_u8(vec a, vec b)             { return _mm256_max_epu8(a, b); }
+    inline vec subs_u16(vec a, vec b)           { return _mm256_subs_epu16(a, b); }
+
+    /**
+     * LANES байтов ASCII -> LANES 16-битных символов.
+     */
+    inline void widen16(std::uint16_t* dst, const unsigned char* src) {
+        store(dst,      _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+        store(dst + 16, _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16))));
+    }
+
+    /**
+     * LANES байтов ASCII -> LANES 32-битных символов.
+     */
+    inline void widen32(std::uint32_t* dst, const unsigned char* src) {
+        for (std::size_t k = 0; k < LANES; k += 8)
+            store(dst + k, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + k))));
+    }
+
+    /**
+     * Упаковка внутри 128-битных половин перемешивает 64-битные части: возвращаем их по порядку.
+     */
+    inline vec pack16(vec a, vec b)             { return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8); }
+    inline vec pack32(vec a, vec b)             { return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8); }
+#elif defined(JSTD_SIMD_SSE2)
+    const std::size_t LANES = 16;
+    const std::uint32_t FULL_MASK = 0xFFFFu;
+    typedef __m128i vec;
+
+    inline vec load(const void* p)              { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    inline void store(void* p, vec v)           { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    inline std::uint32_t movemask(vec v)        { return (std::uint32_t) _mm_movemask_epi8(v); }
+    inline vec zero()                           { return _mm_setzero_si128(); }
+    inline vec splat8(int c)                    { return _mm_set1_epi8((char) c); }
+    inline vec splat16(int c)                   { return _mm_set1_epi16((short) c); }
+    inline vec splat32(unsigned c)              { return _mm_set1_epi32((int) c); }
+    inline vec vor(vec a, vec b)                { return _mm_or_si128(a, b); }
+    inline vec vand(vec a, vec b)               { return _mm_and_si128(a, b); }
+    inline vec lt8(vec a, vec b)                { return _mm_cmplt_epi8(a, b); }
+    inline vec eq8(vec a, vec b)                { return _mm_cmpeq_epi8(a, b); }
+    inline vec eq16(vec a, vec b)               { return _mm_cmpeq_epi16(a, b); }
+    inline vec max_u8(vec a, vec b)             { return _mm_max_epu8(a, b); }
+    inline vec subs_u16(vec a, vec b)           { return _mm_subs_epu16(a, b); }
+
+    inline void widen16(std::uint16_t* dst, const unsigned char* src) {
+        const vec v = load(src);
+        store(dst,     _mm_unpacklo_epi8(v, zero()));
+        store(dst + 8, _mm_unpackhi_epi8(v, zero()));
+    }
+
+    inline void widen32(std::uint32_t* dst, const unsigned char* src) {
+        const vec v  = load(src);
+        const vec lo = _mm_unpacklo_epi8(v, zero());
+        const vec hi = _mm_unpackhi_epi8(v, zero());
+        store(dst,      _mm_unpacklo_epi16(lo, zero()));
+        store(dst + 4,  _mm_unpackhi_epi16(lo, zero()));
+        store(dst + 8,  _mm_unpacklo_epi16(hi, zero()));
+        store(dst + 12, _mm_unpackhi_epi16(hi, zero()));
+    }
+
+    inline vec pack16(vec a, vec b)             { return _mm_packus_epi16(a, b); }
+    inline vec pack32(vec a, vec b)             { return _mm_packs_epi32(a, b); }
+#endif
+
+#if defined(JSTD_SIMD_SSE2)
+    /**
+     * LANES 16-битных символов, все меньше 0x80.
+     */
+    inline bool is_ascii16(const std::uint16_t* src) {
+        const std::size_t HALF = LANES / 2;
+        const vec t = vand(vor(load(src), load(src + HALF)), splat16(0xFF80));
+        return movemask(eq8(t, zero())) == FULL_MASK;
+    }
+
+    /**
+     * LANES 32-битных символов, все меньше 0x80.
+     */
+    inline bool is_ascii32(const std::uint32_t* src) {
+        const std::size_t Q = LANES / 4;
+        const vec t = vand(vor(vor(load(src), load(src + Q)), vor(load(src + 2 * Q), load(src + 3 * Q))), splat32(0xFFFFFF80u));
+        return movemask(eq8(t, zero())) == FULL_MASK;
+    }
+
+    inline void narrow16(unsigned char* dst, const std::uint16_t* src) {
+        store(dst, pack16(load(src), load(src + LANES / 2)));
+    }
+
+    inline void narrow32(unsigned char* dst, const std::uint32_t* src) {
+        const std::size_t Q = LANES / 4;
+        const vec lo = pack32(load(src),         load(src + Q));
+        const vec hi = pack32(load(src + 2 * Q), load(src + 3 * Q));
+        store(dst, pack16(lo, hi));
+    }
+#endif
+
+    /**
+     * Скалярная проверка с позиции i, которая должна быть началом последовательности.
+     */
+    std::size_t scalar_valid_prefix(const unsigned char* s, std::size_t n, std::size_t i) {
+        while (i < n) {
+#if defined(JSTD_SIMD_SSE2)
+            if (n - i >= LANES && movemask(load(s + i)) == 0) {
+                i += LANES;
+                continue;
+            }
+#endif
+            if (s[i] < 0x80) {
+                ++i;
+                continue;
+            }
+            utfpoint cp;
+            if (!decode_multibyte(s, n, i, cp))
+                return i;
+        }
+        return n;
+    }
+
+#if defined(JSTD_SIMD_AVX2)
+    /**
+     * Векторная проверка UTF-8 по таблицам (J. Keiser, D. Lemire, "Validating UTF-8 In Less Than One
+     * Instruction Per Byte", 2021). Для каждого байта и его предшественника три поиска по полубайтам
+     * дают битовую маску нарушений; ненулевое пересечение масок - ошибка. Третий и четвёртый
+     * байты последовательности проверяются отдельно по байтам на 2 и 3 позиции назад.
+     */
+    class utf8_checker {
+        static const unsigned char TOO_SHORT        = 1 << 0; // 11______ 0_______ | 11______ 11______
+        static const unsigned char TOO_LONG         = 1 << 1; // 0_______ 10______
+        static const unsigned char OVERLONG_3       = 1 << 2; // 11100000 100_____
+        static const unsigned char TOO_LARGE        = 1 << 3; // 11110100 1001____ и выше
+        static const unsigned char SURROGATE        = 1 << 4; // 11101101 101_____
+        static const unsigned char OVERLONG_2       = 1 << 5; // 1100000_ 10______
+        static const unsigned char TOO_LARGE_1000   = 1 << 6; // 11110101 1000____ и выше
+        static const unsigned char OVERLONG_4       = 1 << 6; // 11110000 1000____
+        static const unsigned char TWO_CONTS        = 1 << 7; // 10______ 10______
+        static const unsigned char CARRY            = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+        vec m_error;
+        vec m_prev_input;
+        vec m_prev_incomplete;
+
+        static vec table(const unsigned char (&t)[16]) {
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t)));
+        }
+
+        static vec high_nibbles(vec v) {
+            return vand(_mm256_srli_epi16(v, 4), splat8(0x0F));
+        }
+
+        /**
+         * Байты input, сдвинутые на N позиций назад, с последними байтами prev в начале.
+         */
+        template<int N>
+        static vec prev(vec input, vec prev) {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+        }
+
+        static vec special_cases(vec input, vec prev1) {
+            static const unsigned char BYTE_1_HIGH[16] = {
+                // 0_______ ________ <ASCII в первом байте>
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                // 10______ ________ <продолжение в первом байте>
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                // 1100____ ________
+                TOO_SHORT | OVERLONG_2,
+                // 1101____ ________
+                TOO_SHORT,
+                // 1110____ ________
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                // 1111____ ________
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+            };
+            static const unsigned char BYTE_1_LOW[16] = {
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,   // ____0000
+                CARRY | OVERLONG_2,                             // ____0001
+                CARRY,                                          // ____001_
+                CARRY,
+                CARRY | TOO_LARGE,                              // ____0100
+                CARRY | TOO_LARGE | TOO_LARGE_1000,             // ____0101
+                CARRY | TOO_LARGE | TOO_LARGE_1000,             // ____011_
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,             // ____1___
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, // ____1101
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000
+            };
+            static const unsigned char BYTE_2_HIGH[16] = {
+                // ________ 0_______ <ASCII во втором байте>
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                // ________ 1000____
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                // ________ 1001____
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                // ________ 101_____
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE,
+                // ________ 11______
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+            };
+            const vec byte_1_high = _mm256_shuffle_epi8(table(BYTE_1_HIGH), high_nibbles(prev1));
+            const vec byte_1_low  = _mm256_shuffle_epi8(table(BYTE_1_LOW),  vand(prev1, splat8(0x0F)));
+            const vec byte_2_high = _mm256_shuffle_epi8(table(BYTE_2_HIGH), high_nibbles(input));
+            return vand(vand(byte_1_high, byte_1_low), byte_2_high);
+        }
+
+    public:
+        utf8_checker() : m_error(zero()), m_prev_input(zero()), m_prev_incomplete(zero()) {
+
+        }
+
+        void check(vec input) {
+            if (movemask(input) == 0) {
+                // Блок ASCII: ошибка, только если предыдущий блок оборвался посреди последовательности.
+                m_error           = vor(m_error, m_prev_incomplete);
+                m_prev_incomplete = zero();
+            } else {
+                const vec sc    = special_cases(input, prev<1>(input, m_prev_input));
+                // Два продолжения подряд допустимы, только если это третий или четвёртый байт.
+                const vec third  = _mm256_subs_epu8(prev<2>(input, m_prev_input), splat8(0xE0 - 0x80));
+                const vec fourth = _mm256_subs_epu8(prev<3>(input, m_prev_input), splat8(0xF0 - 0x80));
+                const vec must23 = vand(vor(third, fourth), splat8(0x80));
+                m_error = vor(m_error, _mm256_xor_si256(must23, sc));
+
+                // Ведущий байт в последних трёх позициях, которому не хватает продолжений.
+                static const unsigned char MAX_TAIL[32] = {
+                    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+                };
+                m_prev_incomplete = _mm256_subs_epu8(input, load(MAX_TAIL));
+            }
+            m_prev_input = input;
+        }
+
+        bool has_error() const {
+            return !_mm256_testz_si256(m_error, m_error);
+        }
+    };
+
+    /**
+     * Позиция не позже block_start, с которой скалярная проверка найдёт ошибку, обнаруженную в блоке:
+     * ошибка блока может начинаться в трёх последних байтах предыдущего блока, а всё, что раньше, уже проверено.
+     */
+    inline std::size_t restart_point(const unsigned char* s, std::size_t block_start) {
+        std::size_t p = block_start >= 3 ? block_start - 3 : 0;
+        while (p > 0 && is_continuation(s[p]))
+            --p;
+        return p;
+    }
+#endif
+}//namespace
+
+    std::size_t utf8_valid_prefix(const char* buf, std::size_t n) {
+        const unsigned char* s = reinterpret_cast<const unsigned char*>(buf);
+#if defined(JSTD_SIMD_AVX2)
+        utf8_checker checker;
+        std::size_t i = 0;
+        for (; n - i >= LANES; i += LANES) {
+            checker.check(load(s + i));
+            if (checker.has_error())
+                return scalar_valid_prefix(s, n, restart_point(s, i));
+        }
+        // Хвост дополняется нулями: они ASCII, поэтому оборванная в конце последовательность тоже будет найдена.
+        unsigned char tail[LANES] = {0};
+        if (n != i)
+            std::memcpy(tail, s + i, n - i);
+        checker.check(load(tail));
+        if (checker.has_error())
+            return scalar_valid_prefix(s, n, restart_point(s, i));
+        return n;
+#else
+        return scalar_valid_prefix(s, n, 0);
+#endif
+    }
+
+    bool validate_utf16(const std::uint16_t* buf, std::size_t n) {
+        std::size_t i = 0;
+        while (i < n) {
+#if defined(JSTD_SIMD_SSE2)
+            if (n - i >= LANES / 2) {
+                const vec sur = eq16(vand(load(buf + i), splat16(0xF800)), splat16(0xD800));
+                if (movemask(sur) == 0) {
+                    i += LANES / 2;
+                    continue;
+                }
+            }
+#endif
+            const std::uint16_t u = buf[i];
+            if (u >= 0xD800 && u <= 0xDFFF) {
+                if (u > 0xDBFF || n - i < 2 || buf[i + 1] < 0xDC00 || buf[i + 1] > 0xDFFF)
+                    return false;
+                i += 2;
+            } else {
+                ++i;
+            }
+        }
+        return true;
+    }
+
+    std::size_t count_utf8(const char* buf, std::size_t n) {
+        const unsigned char* s = reinterpret_cast<const unsigned char*>(buf);
+        std::size_t count = 0;
+        std::size_t i = 0;
+#if defined(JSTD_SIMD_SSE2)
+        // Продолжения 0x80..0xBF - это байты со знаком меньше -64.
+        for (; n - i >= LANES; i += LANES)
+            count += LANES - popcount(movemask(lt8(load(s + i), splat8(-64))));
+#endif
+        for (; i < n; ++i)
+            count += !is_continuation(s[i]);
+        return count;
+    }
+
+    std::size_t utf16_length_from_utf8(const char* buf, std::size_t n) {
+        const unsigned char* s = reinterpret_cast<const unsigned char*>(buf);
+        std::size_t count = 0;
+        std::size_t i = 0;
+#if defined(JSTD_SIMD_SSE2)
+        // Каждый символ - один 16-битный, и ещё один для четырёхбайтовых (ведущий байт >= 0xF0).
+        for (; n - i >= LANES; i += LANES) {
+            const vec v = load(s + i);
+            count += LANES - popcount(movemask(lt8(v, splat8(-64))));
+            count += popcount(movemask(eq8(max_u8(v, splat8(0xF0)), v)));
+        }
+#endif
+        for (; i < n; ++i)
+            count += !is_continuation(s[i]) + (s[i] >= 0xF0);
+        return count;
+    }
+
+    std::size_t utf8_length_from_utf16(const std::uint16_t* buf, std::size_t n) {
+        std::size_t count = 0;
+        std::size_t i = 0;
+#if defined(JSTD_SIMD_SSE2)
+        // 1 байт, +1 от 0x80, +1 от 0x800, -1 за каждую половину суррогатной пары (пара - 4 байта).
+        // Маски 16-битных сравнений дают по два бита на символ.
+        const std::size_t UNITS = LANES / 2;
+        for (; n - i >= UNITS; i += UNITS) {
+            const vec v = load(buf + i);
+            const std::size_t below_80  = popcount(movemask(eq16(subs_u16(v, splat16(0x7F)),  zero()))) / 2;
+            const std::size_t below_800 = popcount(movemask(eq16(subs_u16(v, splat16(0x7FF)), zero()))) / 2;
+            const std::size_t surrogate = popcount(movemask(eq16(vand(v, splat16(0xF800)), splat16(0xD800)))) / 2;
+            count += 3 * UNITS - below_80 - below_800 - surrogate;
+        }
+#endif
+        for (; i < n; ++i) {
+            const std::uint16_t u = buf[i];
+            count += u < 0x80 ? 1 : u < 0x800 ? 2 : (u & 0xF800) == 0xD800 ? 2 : 3;
+        }
+        return count;
+    }
+
+    std::size_t utf8_length_from_utf32(const std::uint32_t* buf, std::size_t n) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint32_t u = buf[i];
+            count += 1 + (u >= 0x80) + (u >= 0x800) + (u >= 0x10000);
+        }
+        return count;
+    }
+
+    std::size_t utf8_to_utf16(const char* src, std::size_t n, std::uint16_t* dst) {
+        const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+        std::size_t i = 0;
+        std::size_t o = 0;
+        while (i < n) {
+#if defined(JSTD_SIMD_SSE2)
+            if (n - i >= LANES && movemask(load(s + i)) == 0) {
+                widen16(dst + o, s + i);
+                i += LANES;
+                o += LANES;
+                continue;
+            }
+            // Блок с не-ASCII байтом разбираем скалярно целиком, чтобы не повторять векторную проверку на каждом символе.
+            const std::size_t block_end = n - i >= LANES ? i + LANES : n;
+#else
+            const std::size_t block_end = n;
+#endif
+            while (i < block_end) {
+                if (s[i] < 0x80) {
+                    dst[o++] = s[i++];
+                    continue;
+                }
+                utfpoint cp;
+                if (!decode_multibyte(s, n, i, cp))
+                    return INVALID;
+                if (cp < 0x10000) {
+                    dst[o++] = (std::uint16_t) cp;
+                } else {
+                    cp -= 0x10000;
+                    dst[o++] = (std::uint16_t) (0xD800 + (cp >> 10));
+                    dst[o++] = (std::uint16_t) (0xDC00 + (cp & 0x3FF));
+                }
+            }
+        }
+        return o;
+    }
+
+    std::size_t utf8_to_utf32(const char* src, std::size_t n, std::uint32_t* dst) {
+        const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+        std::size_t i = 0;
+        std::size_t o = 0;
+        while (i < n) {
+#if defined(JSTD_SIMD_SSE2)
+            if (n - i >= LANES && movemask(load(s + i)) == 0) {
+                widen32(dst + o, s + i);
+                i += LANES;
+                o += LANES;
+                continue;
+            }
+            const std::size_t block_end = n - i >= LANES ? i + LANES : n;
+#else
+            const std::size_t block_end = n;
+#endif
+            while (i < block_end) {
+                if (s[i] < 0x80) {
+                    dst[o++] = s[i++];
+                    continue;
+                }
+                utfpoint cp;
+                if (!decode_multibyte(s, n, i, cp))
+                    return INVALID;
+                dst[o++] = (std::uint32_t) cp;
+            }
+        }
+        return o;
+    }
+
+    std::size_t utf16_to_utf8(const std::uint16_t* src, std::size_t n, char* dst) {
+        std::size_t i = 0;
+        std::size_t o = 0;
+        while (i < n) {
+#if defined(JSTD_SIMD_SSE2)
+            if (n - i >= LANES && is_ascii16(src + i)) {
+                narrow16(reinterpret_cast<unsigned char*>(dst + o), src + i);
+                i += LANES;
+                o += LANES;
+                continue;
+            }
+            const std::size_t block_end = n - i >= LANES ? i + LANES : n;
+#else
+            const std::size_t block_end = n;
+#endif
+            while (i < block_end) {
+                const std::uint16_t u = src[i];
+                if (u < 0x80) {
+                    dst[o++] = (char) u;
+                    ++i;
+                } else if (u < 0xD800 || u > 0xDFFF) {
+                    o += encode_utf8(dst + o, u);
+                    ++i;
+                } else {
+                    if (u > 0xDBFF || n - i < 2 || src[i + 1] < 0xDC00 || src[i + 1] > 0xDFFF)
+                        return INVALID;
+                    const utfpoint cp = 0x10000 + (((utfpoint) (u - 0xD800) << 10) | (utfpoint) (src[i + 1] - 0xDC00));
+                    o += encode_utf8(dst + o, cp);
+                    i += 2;
+                }
+            }
+        }
+        return o;
+    }
+
+    std::size_t utf32_to_utf8(const std::uint32_t* src, std::size_t n, char* dst) {
+        std::size_t i = 0;
+        std::size_t o = 0;
+        while (i < n) {
+#if defined(JSTD_SIMD_SSE2)
+            if (n - i >= LANES && is_ascii32(src + i)) {
+                narrow32(reinterpret_cast<unsigned char*>(dst + o), src + i);
+                i += LANES;
+                o += LANES;
+                continue;
+            }
+            const std::size_t block_end = n - i >= LANES ? i + LANES : n;
+#else
+            const std::size_t block_end = n;
+#endif
+            for (; i < block_end; ++i) {
+                const std::uint32_t u = src[i];
+                if (u > 0x10FFFF || (u >= 0xD800 && u <= 0xDFFF))
+                    return INVALID;
+                o += encode_utf8(dst + o, (utfpoint) u);
+            }
+        }
+        return o;
+    }
+
+}//namespace utf
+}//namespace jstd
@@ -47,7 +47,7 @@ namespace jstd {
     }
 
     std::size_t cstr::hashcode() const {
-        return objects::hashcode(m_cstr, m_length);
+        return objects::hashcode(m_cstr, length());
     }
 
     bool cstr::is_empty() const {
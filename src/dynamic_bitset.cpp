@@ -0,0 +1,236 @@
+#include <cpp/lang/utils/bitset.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cstring>
+#include <utility>
+
+namespace jstd
+{
+
+    using namespace internal::bits;
+
+    dynamic_bitset::dynamic_bitset(tca::allocator* allocator) :
+    m_allocator(allocator),
+    m_words(nullptr),
+    m_size(0),
+    m_capacity(0) {
+
+    }
+
+    dynamic_bitset::dynamic_bitset(std::size_t size, tca::allocator* allocator) : dynamic_bitset(allocator) {
+        resize(size);
+    }
+
+    dynamic_bitset::dynamic_bitset(const dynamic_bitset& other) : dynamic_bitset(other.m_allocator) {
+        reserve(other.m_size);
+        if (other.m_size != 0)
+            std::memcpy(m_words, other.m_words, other.words() * sizeof(word_t));
+        m_size = other.m_size;
+    }
+
+    dynamic_bitset::dynamic_bitset(dynamic_bitset&& other) :
+    m_allocator(other.m_allocator),
+    m_words(other.m_words),
+    m_size(other.m_size),
+    m_capacity(other.m_capacity) {
+        other.m_words       = nullptr;
+        other.m_size        = 0;
+        other.m_capacity    = 0;
+    }
+
+    dynamic_bitset& dynamic_bitset::operator=(const dynamic_bitset& other) {
+        if (&other != this) {
+            dynamic_bitset tmp = other.clone(m_allocator);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    dynamic_bitset& dynamic_bitset::operator=(dynamic_bitset&& other) {
+        if (&other != this) {
+            cleanup();
+            m_allocator     = other.m_allocator;
+            m_words         = other.m_words;
+            m_size          = other.m_size;
+            m_capacity      = other.m_capacity;
+            other.m_words       = nullptr;
+            other.m_size        = 0;
+            other.m_capacity    = 0;
+        }
+        return *this;
+    }
+
+    dynamic_bitset dynamic_bitset::clone(tca::allocator* allocator) const {
+        if (allocator == nullptr)
+            allocator = m_allocator;
+        dynamic_bitset copy(allocator);
+        copy.reserve(m_size);
+        if (m_size != 0)
+            std::memcpy(copy.m_words, m_words, words() * sizeof(word_t));
+        copy.m_size = m_size;
+        return copy;
+    }
+
+    dynamic_bitset::~dynamic_bitset() {
+        cleanup();
+    }
+
+    void dynamic_bitset::cleanup() {
+        if (m_allocator != nullptr && m_words != nullptr)
+            m_allocator->deallocate(m_words);
+        m_words     = nullptr;
+        m_size      = 0;
+        m_capacity  = 0;
+    }
+
+    void dynamic_bitset::check_same_size(const dynamic_bitset& other) const {
+        if (m_size != other.m_size)
+            throw_except<illegal_argument_exception>("Bitset sizes differ: %zu and %zu!", m_size, other.m_size);
+    }
+
+    void dynamic_bitset::reserve(std::size_t new_capacity) {
+        std::size_t new_words = words_for(new_capacity);
+        if (new_words <= m_capacity)
+            return;
+
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator is null");
+        )
+
+        word_t* new_data = reinterpret_cast<word_t*>(m_allocator->allocate_align(sizeof(word_t) * new_words, alignof(word_t)));
+        if (new_data == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+
+        if (m_words != nullptr) {
+            std::memcpy(new_data, m_words, words() * sizeof(word_t));
+            m_allocator->deallocate(m_words);
+        }
+        m_words     = new_data;
+        m_capacity  = new_words;
+    }
+
+    void dynamic_bitset::resize(std::size_t new_size, bool value) {
+        if (new_size > capacity()) {
+            std::size_t grown = capacity() + capacity() / 2;
+            reserve(new_size > grown ? new_size : grown);
+        }
+
+        std::size_t old_words = words();
+        std::size_t new_words = words_for(new_size);
+        if (new_size > m_size) {
+            if (new_words > old_words)
+                std::memset(m_words + old_words, 0, (new_words - old_words) * sizeof(word_t));
+            if (value)
+                fill_range(m_words, m_size, new_size, true);
+        } else if (new_words != 0) {
+            m_words[new_words - 1] &= tail_mask(new_size);
+        }
+        m_size = new_size;
+    }
+
+    void dynamic_bitset::set_range(std::size_t from, std::size_t to, bool value) {
+        if (from > to || to > m_size)
+            throw_except<index_out_of_bound_exception>("Range [%zu, %zu) out of bound for length %zu!", from, to, m_size);
+        fill_range(m_words, from, to, value);
+    }
+
+    void dynamic_bitset::set_all() {
+        fill_range(m_words, 0, m_size, true);
+    }
+
+    void dynamic_bitset::reset_all() {
+        if (m_size != 0)
+            std::memset(m_words, 0, words() * sizeof(word_t));
+    }
+
+    void dynamic_bitset::flip_all() {
+        internal::bits::flip_all(m_words, m_size);
+    }
+
+    std::size_t dynamic_bitset::count() const {
+        return internal::bits::count(m_words, words());
+    }
+
+    bool dynamic_bitset::any() const {
+        return internal::bits::any(m_words, words());
+    }
+
+    bool dynamic_bitset::all() const {
+        return internal::bits::find_next_clear(m_words, m_size, 0) == null_val;
+    }
+
+    std::size_t dynamic_bitset::find_next(std::size_t from) const {
+        if (from >= m_size)
+            return null_val;
+        return internal::bits::find_next(m_words, words(), from);
+    }
+
+    std::size_t dynamic_bitset::find_last() const {
+        if (m_size == 0)
+            return null_val;
+        return internal::bits::find_prev(m_words, m_size - 1);
+    }
+
+    std::size_t dynamic_bitset::find_prev(std::size_t from) const {
+        if (m_size == 0)
+            return null_val;
+        if (from >= m_size)
+            from = m_size - 1;
+        return internal::bits::find_prev(m_words, from);
+    }
+
+    dynamic_bitset& dynamic_bitset::operator&=(const dynamic_bitset& other) {
+        check_same_size(other);
+        apply<OP_AND>(m_words, m_words, other.m_words, words());
+        return *this;
+    }
+
+    dynamic_bitset& dynamic_bitset::operator|=(const dynamic_bitset& other) {
+        check_same_size(other);
+        apply<OP_OR>(m_words, m_words, other.m_words, words());
+        return *this;
+    }
+
+    dynamic_bitset& dynamic_bitset::operator^=(const dynamic_bitset& other) {
+        check_same_size(other);
+        apply<OP_XOR>(m_words, m_words, other.m_words, words());
+        return *this;
+    }
+
+    dynamic_bitset& dynamic_bitset::and_not(const dynamic_bitset& other) {
+        check_same_size(other);
+        apply<OP_ANDNOT>(m_words, m_words, other.m_words, words());
+        return *this;
+    }
+
+    std::size_t dynamic_bitset::and_count(const dynamic_bitset& other) const {
+        check_same_size(other);
+        return internal::bits::count<OP_AND>(m_words, other.m_words, words());
+    }
+
+    bool dynamic_bitset::intersects(const dynamic_bitset& other) const {
+        check_same_size(other);
+        return internal::bits::any<OP_AND>(m_words, other.m_words, words());
+    }
+
+    bool dynamic_bitset::is_subset_of(const dynamic_bitset& other) const {
+        check_same_size(other);
+        return !internal::bits::any<OP_ANDNOT>(m_words, other.m_words, words());
+    }
+
+    bool dynamic_bitset::equals(const dynamic_bitset& other) const {
+        if (m_size != other.m_size)
+            return false;
+        return m_size == 0 || std::memcmp(m_words, other.m_words, words() * sizeof(word_t)) == 0;
+    }
+
+    std::size_t dynamic_bitset::hashcode() const {
+        if (m_size == 0)
+            return 0;
+        return objects::hashcode(m_words, words()) ^ m_size;
+    }
+
+    int dynamic_bitset::to_string(char buf[], std::size_t bufsize) const {
+        return internal::bits::to_string(m_words, m_size, buf, bufsize);
+    }
+}
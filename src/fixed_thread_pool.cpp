@@ -186,5 +186,9 @@ namespace concurrency
         shutdown();
     }
 
+    std::size_t fixed_thread_pool::get_count_threads() const {
+        return m_threads.length;
+    }
+
 }//namespace concurrency
 }//namespace jstd
\ No newline at end of file
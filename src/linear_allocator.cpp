@@ -73,8 +73,11 @@ namespace tca {
     }
 
     void* linear_allocator::allocate_align(std::size_t sz, std::size_t align) {
-        std::size_t off = align_up(_offset, align);
-        if ((_offset + off + sz > _capacity) || _buffer == nullptr)
+        if (_buffer == nullptr)
+            return nullptr;
+        const std::uintptr_t pos = (std::uintptr_t) _buffer + _offset;
+        const std::size_t off = (std::size_t) (((pos + align - 1) & ~((std::uintptr_t) align - 1)) - pos);
+        if (_offset + off + sz > _capacity)
             return nullptr;
         _offset += off;
         char* buf = ((char*) _buffer) + _offset;
@@ -86,6 +89,10 @@ namespace tca {
     
     }
 
+    bool linear_allocator::is_monotonic() const {
+        return true;
+    }
+
     int linear_allocator::to_string(char buf[], std::size_t buf_size) const {
         return snprintf(buf, buf_size, "[size %zu, offset %zu, free %zu]", _capacity, _offset, _capacity - _offset);
     }
@@ -1,4 +1,5 @@
 #include <cpp/lang/io/properties.hpp>
+#include <cpp/lang/string_view.hpp>
 #include <cpp/lang/utils/date.hpp>
 
 namespace jstd {
@@ -30,7 +31,11 @@ namespace jstd {
     }
 
     const string& properties::get(const char* key) const {
-        return get(string(key, m_allocator));
+        //Поиск по представлению, без временной строки.
+        const string* value = m_values.find(string_view(key));
+        if (value == nullptr)
+            throw_except<no_such_element_exception>("No such property: %s", key);
+        return *value;
     }
 
     void properties::save(ostream& out) const {
@@ -14,20 +14,9 @@ namespace jstd
     
     shared_ptr<const string>& scp::get(const char* str) {
         JSTD_DEBUG_CODE(if (m_allocator == nullptr) throw_except<illegal_state_exception>("allocator is null"));
-        shared_ptr<const string>& in_map = m_map.get(cstr(str));
-        if (!in_map)
-        {
-            shared_ptr<const string> shared = 
-                                                make_shared<const string>(
-                                                    string(str, m_allocator), m_allocator
-                                                );
-            m_map.put(str, shared);
-            return m_map.get(cstr(str));
-        }
-        else
-        {
-            return in_map;
-        }
+        if (!m_map.contains_key(cstr(str)))
+            intern(str);
+        return m_map.get(cstr(str));
     }
 
     bool scp::deintern(const char* str) {
@@ -52,11 +41,12 @@ namespace jstd
             if (m_allocator == nullptr)
                 throw_except<illegal_state_exception>("allocator is null");
         );
-        return m_map.put(str, 
-            make_shared<const string>(
-                string(str, m_allocator), m_allocator
-            )
-        );
+        if (m_map.contains_key(cstr(str)))
+            return false;
+        shared_ptr<const string> shared = make_shared<const string>(string(str, m_allocator), m_allocator);
+        // Ключ указывает на байты строки из пула, а не на буфер вызывающего.
+        const cstr key(shared->cstr());
+        return m_map.put(key, std::move(shared));
     }
 
     void scp::clear() {
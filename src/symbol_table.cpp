@@ -0,0 +1,332 @@
+#include <cpp/lang/symbol_table.hpp>
+#include <cpp/lang/exceptions.hpp>
+#include <cpp/lang/utils/objects.hpp>
+#include <cpp/lang/utils/simd.hpp>
+#include <cpp/lang/utils/cond_compile.hpp>
+#include <cstring>
+#include <new>
+
+namespace jstd
+{
+    /**
+     * Заголовок строки в блоке памяти. За ним следуют length байт строки и '\0'.
+     */
+    struct symbol_table::record {
+        std::uint64_t   hash;
+        std::uint32_t   length;
+        symbol          id;
+
+        const char* chars() const {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+    };
+
+    /**
+     * Таблица ячеек части. Ячейка - (старшие 32 бита хеш-кода << 32) | (id + 1), 0 - пустая ячейка.
+     * Ячейки лежат сразу за заголовком.
+     */
+    struct symbol_table::table {
+        std::size_t     capacity;
+        table*          retired;
+
+        std::atomic<std::uint64_t>* slots() {
+            return reinterpret_cast<std::atomic<std::uint64_t>*>(this + 1);
+        }
+
+        const std::atomic<std::uint64_t>* slots() const {
+            return reinterpret_cast<const std::atomic<std::uint64_t>*>(this + 1);
+        }
+    };
+
+    /**
+     * Блок памяти для строк. Данные лежат сразу за заголовком.
+     */
+    struct symbol_table::arena_block {
+        arena_block*    next;
+        std::size_t     capacity;
+        std::size_t     used;
+    };
+
+    /**
+     * Часть таблицы. Выровнена по строке кэша, чтобы блокировки соседних частей не делили её.
+     */
+    struct alignas(64) symbol_table::shard {
+        mutex                   lock;
+        std::atomic<table*>     slots;
+        std::size_t             count;
+        arena_block*            arena;
+        table*                  retired;
+
+        shard() : lock(), slots(nullptr), count(0), arena(nullptr), retired(nullptr) {
+
+        }
+    };
+
+    namespace
+    {
+        const std::size_t   SHARD_SHIFT         = 58;           // 64 - log2(SHARDS)
+        const std::size_t   INITIAL_CAPACITY    = 64;
+        const std::size_t   ARENA_BLOCK_SIZE    = 64 * 1024;
+        const unsigned      FIRST_SEGMENT_BITS  = 10;           // log2(FIRST_SEGMENT)
+
+        inline std::size_t align8(std::size_t n) {
+            return (n + 7) & ~((std::size_t) 7);
+        }
+    }
+
+    symbol_table::symbol_table(tca::allocator* allocator) : m_allocator(allocator), m_shards(nullptr), m_next_id(0) {
+        JSTD_DEBUG_CODE(
+            if (m_allocator == nullptr)
+                throw_except<illegal_state_exception>("allocator is null");
+        );
+        static_assert((SHARDS >> (64 - SHARD_SHIFT)) == 1, "SHARD_SHIFT must match SHARDS");
+        static_assert(((std::size_t) 1 << FIRST_SEGMENT_BITS) == FIRST_SEGMENT, "FIRST_SEGMENT_BITS must match FIRST_SEGMENT");
+        for (std::size_t i = 0; i < SEGMENTS; ++i)
+            m_segments[i].store(nullptr, std::memory_order_relaxed);
+        void* mem = m_allocator->allocate_align(sizeof(shard) * SHARDS, alignof(shard));
+        if (mem == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        m_shards = static_cast<shard*>(mem);
+        for (std::size_t i = 0; i < SHARDS; ++i)
+            new (m_shards + i) shard();
+    }
+
+    symbol_table::~symbol_table() {
+        for (std::size_t i = 0; i < SHARDS; ++i) {
+            shard& sh = m_shards[i];
+            arena_block* b = sh.arena;
+            while (b != nullptr) {
+                arena_block* next = b->next;
+                m_allocator->deallocate(b, sizeof(arena_block) + b->capacity);
+                b = next;
+            }
+            table* t = sh.slots.load(std::memory_order_relaxed);
+            if (t != nullptr)
+                t->retired = sh.retired;
+            else
+                t = sh.retired;
+            while (t != nullptr) {
+                table* next = t->retired;
+                m_allocator->deallocate(t, sizeof(table) + t->capacity * sizeof(std::atomic<std::uint64_t>));
+                t = next;
+            }
+            sh.~shard();
+        }
+        m_allocator->deallocate(m_shards, sizeof(shard) * SHARDS);
+        for (std::size_t k = 0; k < SEGMENTS; ++k) {
+            std::atomic<const record*>* seg = m_segments[k].load(std::memory_order_relaxed);
+            if (seg != nullptr)
+                m_allocator->deallocate(seg, (FIRST_SEGMENT << k) * sizeof(std::atomic<const record*>));
+        }
+    }
+
+    std::uint64_t symbol_table::hash_of(const char* str, std::size_t len) {
+        return mix_hash(objects::hashcode(str, len));
+    }
+
+    std::atomic<const symbol_table::record*>* symbol_table::slot_of(symbol id) {
+        const std::uint64_t x = (std::uint64_t) id + FIRST_SEGMENT;
+        const unsigned k = simd::internal::bsr64(x) - FIRST_SEGMENT_BITS;
+        std::atomic<const record*>* seg = m_segments[k].load(std::memory_order_acquire);
+        if (seg == nullptr) {
+            const std::size_t n = FIRST_SEGMENT << k;
+            void* mem = m_allocator->allocate(n * sizeof(std::atomic<const record*>));
+            if (mem == nullptr)
+                throw_except<out_of_memory_error>("Out of memory!");
+            std::atomic<const record*>* created = static_cast<std::atomic<const record*>*>(mem);
+            for (std::size_t i = 0; i < n; ++i)
+                new (created + i) std::atomic<const record*>(nullptr);
+            // Сегмент может одновременно создавать другая часть таблицы.
+            if (m_segments[k].compare_exchange_strong(seg, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                seg = created;
+            else
+                m_allocator->deallocate(created, n * sizeof(std::atomic<const record*>));
+        }
+        return seg + (x - ((std::uint64_t) FIRST_SEGMENT << k));
+    }
+
+    const symbol_table::record* symbol_table::record_of(symbol id) const {
+        if (id >= m_next_id.load(std::memory_order_acquire))
+            return nullptr;
+        const std::uint64_t x = (std::uint64_t) id + FIRST_SEGMENT;
+        const unsigned k = simd::internal::bsr64(x) - FIRST_SEGMENT_BITS;
+        const std::atomic<const record*>* seg = m_segments[k].load(std::memory_order_acquire);
+        if (seg == nullptr)
+            return nullptr;
+        return seg[x - ((std::uint64_t) FIRST_SEGMENT << k)].load(std::memory_order_acquire);
+    }
+
+    symbol symbol_table::probe(const table* t, std::uint64_t hash, const char* str, std::size_t len) const {
+        if (t == nullptr)
+            return null_symbol;
+        const std::size_t mask = t->capacity - 1;
+        const std::uint32_t tag = (std::uint32_t) (hash >> 32);
+        const std::atomic<std::uint64_t>* slots = t->slots();
+        for (std::size_t i = (std::size_t) hash & mask;; i = (i + 1) & mask) {
+            const std::uint64_t v = slots[i].load(std::memory_order_acquire);
+            if (v == 0)
+                return null_symbol;
+            if ((std::uint32_t) (v >> 32) != tag)
+                continue;
+            const symbol id = (symbol) (v & 0xFFFFFFFFu) - 1;
+            const record* r = record_of(id);
+            if (r != nullptr && r->hash == hash && r->length == len && std::memcmp(r->chars(), str, len) == 0)
+                return id;
+        }
+    }
+
+    symbol_table::table* symbol_table::new_table(std::size_t capacity) {
+        void* mem = m_allocator->allocate(sizeof(table) + capacity * sizeof(std::atomic<std::uint64_t>));
+        if (mem == nullptr)
+            throw_except<out_of_memory_error>("Out of memory!");
+        table* t = static_cast<table*>(mem);
+        t->capacity = capacity;
+        t->retired  = nullptr;
+        std::atomic<std::uint64_t>* slots = t->slots();
+        for (std::size_t i = 0; i < capacity; ++i)
+            new (slots + i) std::atomic<std::uint64_t>(0);
+        return t;
+    }
+
+    void symbol_table::grow(shard& sh) {
+        table* old = sh.slots.load(std::memory_order_relaxed);
+        table* t = new_table(old == nullptr ? INITIAL_CAPACITY : old->capacity * 2);
+        if (old != nullptr) {
+            const std::size_t mask = t->capacity - 1;
+            const std::atomic<std::uint64_t>* from = old->slots();
+            std::atomic<std::uint64_t>* to = t->slots();
+            for (std::size_t i = 0; i < old->capacity; ++i) {
+                const std::uint64_t v = from[i].load(std::memory_order_relaxed);
+                if (v == 0)
+                    continue;
+                const std::uint64_t h = record_of((symbol) (v & 0xFFFFFFFFu) - 1)->hash;
+                std::size_t j = (std::size_t) h & mask;
+                while (to[j].load(std::memory_order_relaxed) != 0)
+                    j = (j + 1) & mask;
+                to[j].store(v, std::memory_order_relaxed);
+            }
+            // Читатели могут ещё обходить старую таблицу, поэтому она освобождается только в деструкторе.
+            old->retired = sh.retired;
+            sh.retired   = old;
+        }
+        sh.slots.store(t, std::memory_order_release);
+    }
+
+    symbol_table::record* symbol_table::append(shard& sh, std::uint64_t hash, const char* str, std::size_t len) {
+        const std::size_t need = align8(sizeof(record) + len + 1);
+        arena_block* b = sh.arena;
+        if (b == nullptr || b->capacity - b->used < need) {
+            const std::size_t cap = need > ARENA_BLOCK_SIZE - sizeof(arena_block) ? need : ARENA_BLOCK_SIZE - sizeof(arena_block);
+            void* mem = m_allocator->allocate(sizeof(arena_block) + cap);
+            if (mem == nullptr)
+                throw_except<out_of_memory_error>("Out of memory!");
+            b = static_cast<arena_block*>(mem);
+            b->next     = sh.arena;
+            b->capacity = cap;
+            b->used     = 0;
+            sh.arena    = b;
+        }
+        record* r = reinterpret_cast<record*>(reinterpret_cast<char*>(b + 1) + b->used);
+        b->used += need;
+        r->hash     = hash;
+        r->length   = (std::uint32_t) len;
+        r->id       = null_symbol;
+        char* chars = reinterpret_cast<char*>(r + 1);
+        std::memcpy(chars, str, len);
+        chars[len] = '\0';
+        return r;
+    }
+
+    symbol symbol_table::intern(const char* str, std::size_t len) {
+        JSTD_DEBUG_CODE(
+            if (str == nullptr)
+                throw_except<null_pointer_exception>("str is null");
+        );
+        if (len > 0xFFFFFFFFu)
+            throw_except<illegal_argument_exception>("String is too long");
+        const std::uint64_t hash = hash_of(str, len);
+        shard& sh = m_shards[hash >> SHARD_SHIFT];
+        symbol id = probe(sh.slots.load(std::memory_order_acquire), hash, str, len);
+        if (id != null_symbol)
+            return id;
+
+        unique_lock lock(sh.lock);
+        table* t = sh.slots.load(std::memory_order_relaxed);
+        id = probe(t, hash, str, len);
+        if (id != null_symbol)
+            return id;
+
+        if (t == nullptr || (sh.count + 1) * 2 > t->capacity) {
+            grow(sh);
+            t = sh.slots.load(std::memory_order_relaxed);
+        }
+        record* r = append(sh, hash, str, len);
+
+        // Идентификаторы общие для всех частей.
+        id = m_next_id.load(std::memory_order_relaxed);
+        do {
+            if (id == null_symbol)
+                throw_except<illegal_state_exception>("symbol_table is full");
+        } while (!m_next_id.compare_exchange_weak(id, id + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+        r->id = id;
+
+        // Запись публикуется в каталоге раньше, чем в таблице ячеек: читатель, увидевший ячейку, найдёт и запись.
+        slot_of(id)->store(r, std::memory_order_release);
+
+        const std::size_t mask = t->capacity - 1;
+        std::atomic<std::uint64_t>* slots = t->slots();
+        std::size_t i = (std::size_t) hash & mask;
+        while (slots[i].load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & mask;
+        slots[i].store(((hash >> 32) << 32) | ((std::uint64_t) id + 1), std::memory_order_release);
+        ++sh.count;
+        return id;
+    }
+
+    symbol symbol_table::intern(const char* str) {
+        JSTD_DEBUG_CODE(
+            if (str == nullptr)
+                throw_except<null_pointer_exception>("str is null");
+        );
+        return intern(str, std::strlen(str));
+    }
+
+    symbol symbol_table::find(const char* str, std::size_t len) const {
+        JSTD_DEBUG_CODE(
+            if (str == nullptr)
+                throw_except<null_pointer_exception>("str is null");
+        );
+        const std::uint64_t hash = hash_of(str, len);
+        const shard& sh = m_shards[hash >> SHARD_SHIFT];
+        return probe(sh.slots.load(std::memory_order_acquire), hash, str, len);
+    }
+
+    symbol symbol_table::find(const char* str) const {
+        JSTD_DEBUG_CODE(
+            if (str == nullptr)
+                throw_except<null_pointer_exception>("str is null");
+        );
+        return find(str, std::strlen(str));
+    }
+
+    const char* symbol_table::name(symbol id) const {
+        const record* r = record_of(id);
+        if (r == nullptr)
+            throw_except<no_such_element_exception>("Unknown symbol");
+        return r->chars();
+    }
+
+    std::size_t symbol_table::length(symbol id) const {
+        const record* r = record_of(id);
+        if (r == nullptr)
+            throw_except<no_such_element_exception>("Unknown symbol");
+        return r->length;
+    }
+
+    std::uint64_t symbol_table::hash(symbol id) const {
+        const record* r = record_of(id);
+        if (r == nullptr)
+            throw_except<no_such_element_exception>("Unknown symbol");
+        return r->hash;
+    }
+}